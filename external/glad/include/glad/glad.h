@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifndef GLAPI
 #define GLAPI extern
@@ -31,6 +32,8 @@ typedef unsigned char GLboolean;
 typedef unsigned char GLubyte;
 typedef char GLchar;
 typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+typedef uint64_t GLuint64;
 
 #define GL_DEPTH_TEST                     0x0B71
 #define GL_CULL_FACE                      0x0B44
@@ -45,10 +48,27 @@ typedef ptrdiff_t GLsizeiptr;
 #define GL_ARRAY_BUFFER                   0x8892
 #define GL_ELEMENT_ARRAY_BUFFER           0x8893
 #define GL_STATIC_DRAW                    0x88E4
+#define GL_STREAM_DRAW                    0x88E0
+#define GL_DYNAMIC_DRAW                   0x88E8
+#define GL_UNIFORM_BUFFER                 0x8A11
+#define GL_ACTIVE_UNIFORMS                0x8B86
+#define GL_ACTIVE_UNIFORM_MAX_LENGTH      0x8B87
+#define GL_INVALID_INDEX                  0xFFFFFFFFu
 #define GL_TRIANGLES                      0x0004
 #define GL_LINES                          0x0001
 #define GL_UNSIGNED_INT                   0x1405
 #define GL_FLOAT                          0x1406
+#define GL_QUERY_RESULT                   0x8866
+#define GL_QUERY_RESULT_AVAILABLE         0x8867
+#define GL_TIME_ELAPSED                   0x88BF
+#define GL_COMPUTE_SHADER                 0x91B9
+#define GL_SHADER_STORAGE_BUFFER          0x90D2
+#define GL_DYNAMIC_COPY                   0x88EA
+#define GL_SHADER_STORAGE_BARRIER_BIT     0x00002000
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#define GL_BUFFER_UPDATE_BARRIER_BIT      0x00000200
+#define GL_MAJOR_VERSION                  0x821B
+#define GL_MINOR_VERSION                  0x821C
 #define GL_FALSE                          0x0
 #define GL_TRUE                           0x1
 
@@ -85,7 +105,26 @@ typedef void (APIENTRY *PFNGLDELETEBUFFERSPROC) (GLsizei n, const GLuint *buffer
 typedef GLint (APIENTRY *PFNGLGETUNIFORMLOCATIONPROC) (GLuint program, const GLchar *name);
 typedef void (APIENTRY *PFNGLUNIFORM1FPROC) (GLint location, GLfloat v0);
 typedef void (APIENTRY *PFNGLUNIFORM3FPROC) (GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+typedef void (APIENTRY *PFNGLUNIFORMMATRIX3FVPROC) (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
 typedef void (APIENTRY *PFNGLUNIFORMMATRIX4FVPROC) (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+typedef void (APIENTRY *PFNGLBUFFERSUBDATAPROC) (GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
+typedef void (APIENTRY *PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+typedef void (APIENTRY *PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount);
+typedef void (APIENTRY *PFNGLGETACTIVEUNIFORMPROC) (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name);
+typedef GLuint (APIENTRY *PFNGLGETUNIFORMBLOCKINDEXPROC) (GLuint program, const GLchar *uniformBlockName);
+typedef void (APIENTRY *PFNGLUNIFORMBLOCKBINDINGPROC) (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+typedef void (APIENTRY *PFNGLBINDBUFFERBASEPROC) (GLenum target, GLuint index, GLuint buffer);
+typedef void (APIENTRY *PFNGLGENQUERIESPROC) (GLsizei n, GLuint *ids);
+typedef void (APIENTRY *PFNGLDELETEQUERIESPROC) (GLsizei n, const GLuint *ids);
+typedef void (APIENTRY *PFNGLBEGINQUERYPROC) (GLenum target, GLuint id);
+typedef void (APIENTRY *PFNGLENDQUERYPROC) (GLenum target);
+typedef void (APIENTRY *PFNGLGETQUERYOBJECTIVPROC) (GLuint id, GLenum pname, GLint *params);
+typedef void (APIENTRY *PFNGLGETQUERYOBJECTUI64VPROC) (GLuint id, GLenum pname, GLuint64 *params);
+typedef void (APIENTRY *PFNGLGETINTEGERVPROC) (GLenum pname, GLint *data);
+typedef void (APIENTRY *PFNGLUNIFORM1UIPROC) (GLint location, GLuint v0);
+typedef void (APIENTRY *PFNGLGETBUFFERSUBDATAPROC) (GLenum target, GLintptr offset, GLsizeiptr size, void *data);
+typedef void (APIENTRY *PFNGLDISPATCHCOMPUTEPROC) (GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+typedef void (APIENTRY *PFNGLMEMORYBARRIERPROC) (GLbitfield barriers);
 
 GLAPI PFNGLCLEARPROC glClear;
 GLAPI PFNGLCLEARCOLORPROC glClearColor;
@@ -120,7 +159,26 @@ GLAPI PFNGLDELETEBUFFERSPROC glDeleteBuffers;
 GLAPI PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 GLAPI PFNGLUNIFORM1FPROC glUniform1f;
 GLAPI PFNGLUNIFORM3FPROC glUniform3f;
+GLAPI PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv;
 GLAPI PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
+GLAPI PFNGLBUFFERSUBDATAPROC glBufferSubData;
+GLAPI PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
+GLAPI PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
+GLAPI PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
+GLAPI PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
+GLAPI PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
+GLAPI PFNGLBINDBUFFERBASEPROC glBindBufferBase;
+GLAPI PFNGLGENQUERIESPROC glGenQueries;
+GLAPI PFNGLDELETEQUERIESPROC glDeleteQueries;
+GLAPI PFNGLBEGINQUERYPROC glBeginQuery;
+GLAPI PFNGLENDQUERYPROC glEndQuery;
+GLAPI PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
+GLAPI PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+GLAPI PFNGLGETINTEGERVPROC glGetIntegerv;
+GLAPI PFNGLUNIFORM1UIPROC glUniform1ui;
+GLAPI PFNGLGETBUFFERSUBDATAPROC glGetBufferSubData;
+GLAPI PFNGLDISPATCHCOMPUTEPROC glDispatchCompute;
+GLAPI PFNGLMEMORYBARRIERPROC glMemoryBarrier;
 
 typedef void* (*GLADloadproc)(const char *name);
 int gladLoadGLLoader(GLADloadproc load);
@@ -35,7 +35,26 @@ PFNGLDELETEBUFFERSPROC glDeleteBuffers;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 PFNGLUNIFORM1FPROC glUniform1f;
 PFNGLUNIFORM3FPROC glUniform3f;
+PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
+PFNGLBUFFERSUBDATAPROC glBufferSubData;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
+PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
+PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
+PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
+PFNGLBINDBUFFERBASEPROC glBindBufferBase;
+PFNGLGENQUERIESPROC glGenQueries;
+PFNGLDELETEQUERIESPROC glDeleteQueries;
+PFNGLBEGINQUERYPROC glBeginQuery;
+PFNGLENDQUERYPROC glEndQuery;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+PFNGLGETINTEGERVPROC glGetIntegerv;
+PFNGLUNIFORM1UIPROC glUniform1ui;
+PFNGLGETBUFFERSUBDATAPROC glGetBufferSubData;
+PFNGLDISPATCHCOMPUTEPROC glDispatchCompute;
+PFNGLMEMORYBARRIERPROC glMemoryBarrier;
 
 int gladLoadGLLoader(GLADloadproc load) {
     if (load == NULL) {
@@ -75,7 +94,28 @@ int gladLoadGLLoader(GLADloadproc load) {
     glGetUniformLocation = (PFNGLGETUNIFORMLOCATIONPROC)load("glGetUniformLocation");
     glUniform1f = (PFNGLUNIFORM1FPROC)load("glUniform1f");
     glUniform3f = (PFNGLUNIFORM3FPROC)load("glUniform3f");
+    glUniformMatrix3fv = (PFNGLUNIFORMMATRIX3FVPROC)load("glUniformMatrix3fv");
     glUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)load("glUniformMatrix4fv");
+    glBufferSubData = (PFNGLBUFFERSUBDATAPROC)load("glBufferSubData");
+    glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)load("glVertexAttribDivisor");
+    glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)load("glDrawElementsInstanced");
+    glGetActiveUniform = (PFNGLGETACTIVEUNIFORMPROC)load("glGetActiveUniform");
+    glGetUniformBlockIndex = (PFNGLGETUNIFORMBLOCKINDEXPROC)load("glGetUniformBlockIndex");
+    glUniformBlockBinding = (PFNGLUNIFORMBLOCKBINDINGPROC)load("glUniformBlockBinding");
+    glBindBufferBase = (PFNGLBINDBUFFERBASEPROC)load("glBindBufferBase");
+    glGenQueries = (PFNGLGENQUERIESPROC)load("glGenQueries");
+    glDeleteQueries = (PFNGLDELETEQUERIESPROC)load("glDeleteQueries");
+    glBeginQuery = (PFNGLBEGINQUERYPROC)load("glBeginQuery");
+    glEndQuery = (PFNGLENDQUERYPROC)load("glEndQuery");
+    glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)load("glGetQueryObjectiv");
+    glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)load("glGetQueryObjectui64v");
+    glGetIntegerv = (PFNGLGETINTEGERVPROC)load("glGetIntegerv");
+    glUniform1ui = (PFNGLUNIFORM1UIPROC)load("glUniform1ui");
+    glGetBufferSubData = (PFNGLGETBUFFERSUBDATAPROC)load("glGetBufferSubData");
+
+    /* GL 4.3 compute; NULL on older contexts */
+    glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)load("glDispatchCompute");
+    glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)load("glMemoryBarrier");
 
     return 1;
 } 
\ No newline at end of file
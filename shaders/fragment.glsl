@@ -4,16 +4,20 @@
 in vec3 FragPos;    // Fragment position in world space
 in vec3 Normal;     // Fragment normal in world space
 in vec2 TexCoord;   // Texture coordinates
+in vec3 ObjectColor; // Surface color
 
 // Output color
 out vec4 FragColor;
 
-// Uniform variables
-uniform vec3 objectColor;   // Color of the object
-uniform vec3 lightPos;      // Position of light source
-uniform vec3 lightColor;    // Color of light source
-uniform vec3 viewPos;       // Position of camera/viewer
-uniform float shininess;    // Shininess factor for specular highlights
+// Per-frame data shared by every program (std140, binding point 0)
+layout (std140) uniform FrameData {
+    mat4 view;          // View matrix (world to camera)
+    mat4 projection;    // Projection matrix (camera to screen)
+    vec3 lightPos;      // Position of light source
+    float shininess;    // Shininess factor for specular highlights
+    vec3 lightColor;    // Color of light source
+    vec3 viewPos;       // Position of camera/viewer
+};
 
 /**
  * Fragment shader main function
@@ -39,7 +43,7 @@ void main()
     vec3 specular = specularStrength * spec * lightColor;
     
     // Combine all lighting components
-    vec3 result = (ambient + diffuse + specular) * objectColor;
+    vec3 result = (ambient + diffuse + specular) * ObjectColor;
     
     // Apply gamma correction for more realistic lighting
     result = pow(result, vec3(1.0/2.2));
@@ -0,0 +1,48 @@
+#version 330 core
+
+// Input vertex attributes
+layout (location = 0) in vec3 aPos;        // Vertex position
+layout (location = 1) in vec3 aNormal;     // Vertex normal
+layout (location = 2) in vec2 aTexCoord;   // Texture coordinates
+
+// Output to fragment shader
+out vec3 FragPos;       // Fragment position in world space
+out vec3 Normal;        // Fragment normal in world space
+out vec2 TexCoord;      // Texture coordinates
+out vec3 ObjectColor;   // Surface color
+
+// Per-frame data shared by every program (std140, binding point 0)
+layout (std140) uniform FrameData {
+    mat4 view;          // View matrix (world to camera)
+    mat4 projection;    // Projection matrix (camera to screen)
+    vec3 lightPos;      // Position of light source
+    float shininess;    // Shininess factor for specular highlights
+    vec3 lightColor;    // Color of light source
+    vec3 viewPos;       // Position of camera/viewer
+};
+
+// Per-mesh uniforms
+uniform mat4 model;         // Model matrix (object to world)
+uniform mat3 normalMatrix;  // Inverse transpose of the model's upper 3x3, computed on the CPU
+uniform vec3 objectColor;   // Color of the object
+
+/**
+ * Vertex shader main function for single meshes drawn with a model matrix
+ * Transforms vertex position and normal from object space to world space
+ * and calculates final screen position
+ */
+void main()
+{
+    // Transform vertex position to world space
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    
+    // Transform normal to world space (precomputed normal matrix handles non-uniform scaling)
+    Normal = normalMatrix * aNormal;
+    
+    // Pass through texture coordinates and color
+    TexCoord = aTexCoord;
+    ObjectColor = objectColor;
+    
+    // Calculate final vertex position in clip space
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+} 
\ No newline at end of file
@@ -1,36 +1,47 @@
 #version 330 core
 
 // Input vertex attributes
-layout (location = 0) in vec3 aPos;        // Vertex position
+layout (location = 0) in vec3 aPos;        // Vertex position (unit sphere)
 layout (location = 1) in vec3 aNormal;     // Vertex normal
 layout (location = 2) in vec2 aTexCoord;   // Texture coordinates
 
+// Per-instance attributes
+layout (location = 3) in vec4 aInstance;   // xyz = sphere center, w = radius
+layout (location = 4) in vec3 aColor;      // Sphere color
+
 // Output to fragment shader
 out vec3 FragPos;       // Fragment position in world space
 out vec3 Normal;        // Fragment normal in world space
 out vec2 TexCoord;      // Texture coordinates
+out vec3 ObjectColor;   // Surface color
 
-// Uniform matrices
-uniform mat4 model;      // Model matrix (object to world)
-uniform mat4 view;       // View matrix (world to camera)
-uniform mat4 projection; // Projection matrix (camera to screen)
+// Per-frame data shared by every program (std140, binding point 0)
+layout (std140) uniform FrameData {
+    mat4 view;          // View matrix (world to camera)
+    mat4 projection;    // Projection matrix (camera to screen)
+    vec3 lightPos;      // Position of light source
+    float shininess;    // Shininess factor for specular highlights
+    vec3 lightColor;    // Color of light source
+    vec3 viewPos;       // Position of camera/viewer
+};
 
 /**
- * Vertex shader main function
- * Transforms vertex position and normal from object space to world space
- * and calculates final screen position
+ * Vertex shader main function for instanced spheres
+ * Each instance is a translate plus uniform scale, so the normal needs no
+ * normal matrix and is passed through unchanged
  */
 void main()
 {
-    // Transform vertex position to world space
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    // Scale the unit sphere and move it to the instance center
+    FragPos = aInstance.xyz + aPos * aInstance.w;
     
-    // Transform normal to world space (using normal matrix for non-uniform scaling)
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Uniform scale keeps normals unchanged
+    Normal = aNormal;
     
-    // Pass through texture coordinates
+    // Pass through texture coordinates and color
     TexCoord = aTexCoord;
+    ObjectColor = aColor;
     
     // Calculate final vertex position in clip space
     gl_Position = projection * view * vec4(FragPos, 1.0);
-} 
\ No newline at end of file
+}
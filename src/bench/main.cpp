@@ -0,0 +1,346 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+#include "physics/PhysicsWorld.h"
+#include "physics/SceneDescription.h"
+
+/**
+ * One solver/broadphase configuration to benchmark
+ */
+struct BenchVariant {
+    const char* name;                   // Column label
+    BroadphaseMode broadphase;          // Broadphase algorithm
+    ContactSolveMode contacts;          // Contact solve mode
+    int solverIterations;               // Solver iterations per step
+    bool warmStarting;                  // Reuse cached impulses
+    bool quadratic;                     // Cost grows with n², so it is skipped for large scenes
+};
+
+/**
+ * Benchmark settings from the command line
+ */
+struct BenchOptions {
+    std::vector<size_t> bodyCounts { 100, 1000, 10000, 100000 };
+    std::vector<float> densities { 0.05f, 0.2f };    // Fraction of the world volume filled by balls
+    std::vector<int> substeps { 1 };                 // Steps per 1/60 s frame
+    int warmupFrames = 10;                           // Untimed frames before measuring
+    int minFrames = 5;                               // Frames always measured
+    int maxFrames = 600;                             // Measuring stops here...
+    double minSeconds = 0.5;                         // ...or once this much time has been measured
+    size_t quadraticLimit = 5000;                    // Largest scene the O(n²) variant runs on
+    size_t threads = 0;                              // Physics threads (0 = one per hardware thread)
+    bool compare = false;                            // Run every variant instead of the default one
+    bool csv = false;                                // Comma-separated output
+};
+
+/**
+ * Measured result of one case
+ */
+struct BenchResult {
+    int frames = 0;                     // Frames measured
+    double seconds = 0.0;               // Wall time of those frames
+    StepTimings timings;                // Phase breakdown
+};
+
+/**
+ * Print command line usage
+ * @param program Executable name
+ */
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "Times PhysicsWorld steps over a sweep of scene sizes, densities and substep counts.\n"
+              << "\n"
+              << "Options:\n"
+              << "  --bodies <list>      Body counts, e.g. 100,1000,1000000 (default 100,1000,10000,100000)\n"
+              << "  --density <list>     Volume fractions filled by balls (default 0.05,0.2)\n"
+              << "  --substeps <list>    Steps per 1/60 s frame (default 1)\n"
+              << "  --compare            Run every broadphase/solver variant, with speedups against the first\n"
+              << "  --quadratic-max <n>  Largest scene for the O(n^2) variant (default 5000)\n"
+              << "  --warmup <n>         Untimed frames per case (default 10)\n"
+              << "  --frames <min>:<max> Frames measured per case (default 5:600, stopping after 0.5 s)\n"
+              << "  --threads <n>        Physics threads, 0 = one per hardware thread (default 0)\n"
+              << "  --csv                Print comma-separated values\n"
+              << "  --help               Show this message\n";
+}
+
+/**
+ * Split a comma-separated list of numbers
+ * @param text List text
+ * @param values Receives the parsed values
+ * @return False if any entry is malformed or not positive
+ */
+template <typename T>
+static bool parseList(const std::string& text, std::vector<T>& values) {
+    values.clear();
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        std::istringstream number(item);
+        double value = 0.0;
+        if (!(number >> value) || !(number >> std::ws).eof() || value <= 0.0) {
+            return false;
+        }
+        values.push_back((T)value);
+    }
+    return !values.empty();
+}
+
+/**
+ * Parse the command line
+ * @return False (after printing why) if the arguments are unusable
+ */
+static bool parseOptions(int argc, char** argv, BenchOptions& options, bool& showHelp) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            showHelp = true;
+            return true;
+        }
+        if (arg == "--compare") {
+            options.compare = true;
+            continue;
+        }
+        if (arg == "--csv") {
+            options.csv = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+        bool valid = true;
+        if (arg == "--bodies") {
+            valid = parseList(value, options.bodyCounts);
+        } else if (arg == "--density") {
+            valid = parseList(value, options.densities);
+            for (float density : options.densities) {
+                valid = valid && density < 0.6f;  // Random packing cannot get much denser
+            }
+        } else if (arg == "--substeps") {
+            valid = parseList(value, options.substeps);
+        } else if (arg == "--quadratic-max") {
+            std::vector<size_t> limit;
+            valid = parseList(value, limit);
+            options.quadraticLimit = valid ? limit[0] : 0;
+        } else if (arg == "--warmup") {
+            options.warmupFrames = std::atoi(value.c_str());
+            valid = options.warmupFrames >= 0;
+        } else if (arg == "--frames") {
+            size_t colon = value.find(':');
+            options.minFrames = std::atoi(value.substr(0, colon).c_str());
+            options.maxFrames = colon == std::string::npos ? options.minFrames : std::atoi(value.substr(colon + 1).c_str());
+            valid = options.minFrames > 0 && options.maxFrames >= options.minFrames;
+        } else if (arg == "--threads") {
+            options.threads = (size_t)std::atoi(value.c_str());
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Build a cubic room that the given number of balls fills to the given density
+ * @param bodies Ball count
+ * @param density Fraction of the room volume occupied by balls
+ * @param threads Physics threads
+ * @param variant Configuration to apply
+ */
+static SceneDescription makeScene(size_t bodies, float density, size_t threads, const BenchVariant& variant) {
+    const float ballRadius = 0.25f;  // PhysicsWorld::createBall
+    float ballVolume = 4.0f / 3.0f * 3.14159265f * ballRadius * ballRadius * ballRadius;
+    float side = std::max(std::cbrt((float)bodies * ballVolume / density), 4.0f * ballRadius);
+
+    SceneDescription scene;
+    scene.bounds[0] = -side * 0.5f;
+    scene.bounds[1] = side * 0.5f;
+    scene.bounds[2] = 0.0f;
+    scene.bounds[3] = side;
+    scene.bounds[4] = -side * 0.5f;
+    scene.bounds[5] = side * 0.5f;
+    scene.seed = 12345;
+    scene.threads = threads;
+    scene.broadphase = variant.broadphase;
+    scene.contacts = variant.contacts;
+    scene.solverIterations = variant.solverIterations;
+    scene.warmStarting = variant.warmStarting;
+
+    Vector3 margin(ballRadius, ballRadius, ballRadius);
+    scene.addBalls(bodies, Vector3(scene.bounds[0], scene.bounds[2], scene.bounds[4]) + margin,
+                   Vector3(scene.bounds[1], scene.bounds[3], scene.bounds[5]) - margin, 2.0f);
+    return scene;
+}
+
+/**
+ * Run one case: warm up, then measure whole frames
+ * @param world World to use (reconfigured for the case)
+ * @param scene Starting state
+ * @param substeps Steps per 1/60 s frame
+ * @param options Frame counts and time budget
+ * @return Measured frames, time and phase breakdown
+ */
+static BenchResult runCase(PhysicsWorld& world, const SceneDescription& scene, int substeps, const BenchOptions& options) {
+    scene.apply(world);
+    float stepLength = (1.0f / 60.0f) / (float)substeps;
+
+    for (int frame = 0; frame < options.warmupFrames; ++frame) {
+        for (int s = 0; s < substeps; ++s) {
+            world.step(stepLength);
+        }
+    }
+
+    world.resetStepTimings();
+    world.setStepTimingEnabled(true);
+    BenchResult result;
+    auto start = std::chrono::steady_clock::now();
+    while (result.frames < options.maxFrames) {
+        for (int s = 0; s < substeps; ++s) {
+            world.step(stepLength);
+        }
+        result.frames++;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (result.frames >= options.minFrames && result.seconds >= options.minSeconds) {
+            break;
+        }
+    }
+    world.setStepTimingEnabled(false);
+    result.timings = world.getStepTimings();
+    return result;
+}
+
+static const int variantWidth = 11;    // Width of the variant column
+static const int columnWidth = 13;     // Width of every other column
+
+/**
+ * Print the table header
+ */
+static void printHeader(bool csv) {
+    const char* columns[] = { "variant", "bodies", "density", "substeps", "steps/s", "ns/body-step", "speedup",
+                              "integrate", "broadphase", "narrowphase", "solve", "ccd", "boundaries", "sleep" };
+    for (size_t c = 0; c < sizeof(columns) / sizeof(columns[0]); ++c) {
+        if (csv) {
+            std::cout << (c ? "," : "") << columns[c];
+        } else {
+            std::cout << std::setw(c == 0 ? variantWidth : columnWidth) << columns[c];
+        }
+    }
+    std::cout << (csv ? "\n" : "\n  (phase columns are microseconds per step)\n");
+}
+
+/**
+ * Print one result row
+ * @param speedup Baseline ns per body-step divided by this one (0 = no baseline)
+ */
+static void printRow(bool csv, const BenchVariant& variant, size_t bodies, float density, int substeps,
+                     const BenchResult& result, double nsPerBodyStep, double speedup) {
+    const StepTimings& t = result.timings;
+    double steps = std::max<double>((double)t.steps, 1.0);
+    double stepsPerSecond = t.steps / std::max(result.seconds, 1e-9);
+    double phases[] = { t.integrate, t.broadphase, t.narrowphase, t.solve, t.continuous, t.boundaries, t.sleep };
+
+    if (csv) {
+        std::cout << variant.name << ',' << bodies << ',' << density << ',' << substeps << ','
+                  << stepsPerSecond << ',' << nsPerBodyStep << ',' << speedup;
+        for (double phase : phases) {
+            std::cout << ',' << phase / steps * 1e6;
+        }
+        std::cout << "\n";
+        return;
+    }
+
+    std::cout << std::setw(variantWidth) << variant.name << std::setw(columnWidth) << bodies
+              << std::setw(columnWidth) << density << std::setw(columnWidth) << substeps
+              << std::fixed << std::setprecision(1)
+              << std::setw(columnWidth) << stepsPerSecond << std::setw(columnWidth) << nsPerBodyStep;
+    if (speedup > 0.0) {
+        std::cout << std::setw(columnWidth - 1) << std::setprecision(2) << speedup << 'x';
+    } else {
+        std::cout << std::setw(columnWidth) << "-";
+    }
+    std::cout << std::setprecision(1);
+    for (double phase : phases) {
+        std::cout << std::setw(columnWidth) << phase / steps * 1e6;
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+/**
+ * Benchmark entry point
+ * @return Exit code (0 for success, non-zero for error)
+ */
+int main(int argc, char** argv) {
+    BenchOptions options;
+    bool showHelp = false;
+    if (!parseOptions(argc, argv, options, showHelp)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (showHelp) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    // The first variant is the baseline for speedups when comparing
+    const std::vector<BenchVariant> allVariants = {
+        { "brute",      BroadphaseMode::BruteForce,  ContactSolveMode::Colored,    8, true,  true  },
+        { "grid",       BroadphaseMode::UniformGrid, ContactSolveMode::Colored,    8, true,  false },
+        { "sequential", BroadphaseMode::UniformGrid, ContactSolveMode::Sequential, 8, true,  false },
+        { "cold",       BroadphaseMode::UniformGrid, ContactSolveMode::Colored,    8, false, false },
+        { "iter1",      BroadphaseMode::UniformGrid, ContactSolveMode::Colored,    1, true,  false },
+    };
+    std::vector<BenchVariant> variants;
+    if (options.compare) {
+        variants = allVariants;
+    } else {
+        variants.push_back(allVariants[1]);
+    }
+
+    auto world = std::make_unique<PhysicsWorld>();
+    world->setThreadCount(options.threads);
+    if (!options.csv) {
+        std::cout << "physics_bench: " << world->getThreadCount() << " threads, "
+                  << options.warmupFrames << " warm-up frames per case" << std::endl;
+    }
+    printHeader(options.csv);
+
+    for (size_t bodies : options.bodyCounts) {
+        for (float density : options.densities) {
+            for (int substeps : options.substeps) {
+                double baseline = 0.0;
+                for (size_t v = 0; v < variants.size(); ++v) {
+                    const BenchVariant& variant = variants[v];
+                    if (variant.quadratic && bodies > options.quadraticLimit) {
+                        continue;
+                    }
+
+                    SceneDescription scene = makeScene(bodies, density, options.threads, variant);
+                    BenchResult result = runCase(*world, scene, substeps, options);
+
+                    double bodySteps = (double)result.timings.steps * (double)bodies;
+                    double nsPerBodyStep = bodySteps > 0.0 ? result.seconds * 1e9 / bodySteps : 0.0;
+                    if (v == 0) {
+                        baseline = nsPerBodyStep;
+                    }
+                    double speedup = (options.compare && v > 0 && baseline > 0.0 && nsPerBodyStep > 0.0)
+                                         ? baseline / nsPerBodyStep : 0.0;
+                    printRow(options.csv, variant, bodies, density, substeps, result, nsPerBodyStep, speedup);
+                }
+            }
+        }
+    }
+    return 0;
+}
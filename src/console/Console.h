@@ -3,12 +3,18 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <deque>
 #include <sstream>
+#include <fstream>
 #include <iostream>
 
 /**
  * Console class provides a command-line interface for game commands
- * Supports commands like "summon <number>" to create balls
+ * Supports commands like "summon <number>" to create balls.
+ * Submitted command lines are queued and run by runPending() at a fixed point
+ * of the frame. Commands that are too big for one frame can start a task,
+ * which runPending() advances once per frame; the queue waits behind it, so
+ * scripts run in the same order and at the same frames every time.
  */
 class Console {
 private:
@@ -26,6 +32,24 @@ private:
     std::vector<std::string> outputMessages;
     int maxOutputMessages;
     
+    /**
+     * A queued command line
+     */
+    struct PendingCommand {
+        std::string line;           // Command line
+        int scriptDepth;            // exec nesting it came from (0 = typed)
+    };
+    
+    // Deferred execution
+    std::deque<PendingCommand> pendingCommands;                 // Command lines waiting to run
+    int runningDepth;                                           // scriptDepth of the command being run
+    std::function<bool()> task;                                 // Multi-frame command step (true when done)
+    int waitFrames;                                             // Frames the queue still sleeps for (wait command)
+    std::string commandName;                                    // Scratch: name of the command being run
+    std::vector<std::string> commandArgs;                       // Scratch: arguments, reused between commands
+    static constexpr size_t commandsPerFrame = 64;              // Queued commands run per runPending() call
+    static constexpr int maxScriptDepth = 8;                    // exec nesting limit (guards self-including scripts)
+    
 public:
     /**
      * Constructor - initializes console with default settings
@@ -35,7 +59,9 @@ public:
         , isActive(false)
         , maxHistorySize(100)
         , historyIndex(-1)
-        , maxOutputMessages(50) {
+        , maxOutputMessages(50)
+        , runningDepth(0)
+        , waitFrames(0) {
         
         // Register built-in commands
         registerCommand("help", [this](const std::vector<std::string>& args) {
@@ -50,6 +76,23 @@ public:
             showHistory();
         });
         
+        registerCommand("exec", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                addOutput("Usage: exec <file>");
+                return;
+            }
+            runScript(args[0]);
+        });
+        
+        registerCommand("wait", [this](const std::vector<std::string>& args) {
+            int frames = args.empty() ? 1 : std::stoi(args[0]);
+            if (frames < 0) {
+                addOutput("Usage: wait [frames]");
+                return;
+            }
+            waitFrames = frames;
+        });
+        
         // Welcome message
         addOutput("Physics Engine Console");
         addOutput("Type 'help' for available commands");
@@ -77,7 +120,7 @@ public:
                 currentInput.pop_back();
             }
         } else if (c == '\r' || c == '\n') {  // Enter
-            executeCommand(currentInput);
+            submit(currentInput);
             currentInput.clear();
             historyIndex = -1;
         } else if (c >= 32 && c <= 126) {  // Printable characters
@@ -182,10 +225,11 @@ public:
     }
 
     /**
-     * Execute a command string
-     * @param commandLine Full command line to execute
+     * Queue a command line typed by the user
+     * It is added to the history now and runs at the next runPending().
+     * @param commandLine Full command line
      */
-    void executeCommand(const std::string& commandLine) {
+    void submit(const std::string& commandLine) {
         if (commandLine.empty()) return;
         
         // Add to history
@@ -195,27 +239,118 @@ public:
                 history.erase(history.begin());
             }
         }
+        pendingCommands.push_back({ commandLine, 0 });
+    }
+
+    /**
+     * Run queued commands - call once per frame
+     * Advances a running task first; queued commands wait until it finishes,
+     * and at most commandsPerFrame of them run in one call.
+     * @return Number of commands run
+     */
+    size_t runPending() {
+        if (task) {
+            bool done = true;
+            try {
+                done = task();
+            } catch (const std::exception& e) {
+                addOutput("Error executing command: " + std::string(e.what()));
+            }
+            if (!done) {
+                return 0;
+            }
+            task = nullptr;
+        }
+        if (waitFrames > 0) {
+            waitFrames--;
+            return 0;
+        }
+        
+        size_t ran = 0;
+        while (!pendingCommands.empty() && ran < commandsPerFrame && !task && waitFrames == 0) {
+            PendingCommand pending = std::move(pendingCommands.front());
+            pendingCommands.pop_front();
+            runningDepth = pending.scriptDepth;
+            executeCommand(pending.line);
+            runningDepth = 0;
+            ran++;
+        }
+        return ran;
+    }
+
+    /**
+     * Start a command step that runs once per frame until it reports done
+     * Call from a command callback; later queued commands wait for it.
+     * @param step Function returning true once the work is finished
+     */
+    void startTask(std::function<bool()> step) {
+        task = std::move(step);
+    }
+
+    /**
+     * Check whether commands are queued or a task is running
+     * @return True if runPending() has work left
+     */
+    bool isBusy() const {
+        return task || waitFrames > 0 || !pendingCommands.empty();
+    }
+
+    /**
+     * Queue the commands of a script file ahead of anything already queued
+     * One command per line; blank lines and lines starting with # are skipped.
+     * @param path Script file path
+     * @return False if the file cannot be read
+     */
+    bool runScript(const std::string& path) {
+        if (runningDepth >= maxScriptDepth) {
+            addOutput("Script nesting too deep: " + path);
+            return false;
+        }
+        std::ifstream file(path);
+        if (!file) {
+            addOutput("Cannot read script: " + path);
+            return false;
+        }
+        
+        std::vector<PendingCommand> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') {
+                continue;
+            }
+            lines.push_back({ line.substr(first), runningDepth + 1 });
+        }
+        // The script runs where the exec was, before commands queued after it
+        pendingCommands.insert(pendingCommands.begin(), lines.begin(), lines.end());
+        addOutput("Running " + std::to_string(lines.size()) + " commands from " + path);
+        return true;
+    }
+
+    /**
+     * Execute a command string now, bypassing the queue
+     * Not for use inside command callbacks, which share the parse scratch; submit() instead.
+     * @param commandLine Full command line to execute
+     */
+    void executeCommand(const std::string& commandLine) {
+        if (commandLine.empty()) return;
         
         // Echo command
         addOutput("> " + commandLine);
         
         // Parse command
-        std::vector<std::string> tokens = parseCommand(commandLine);
-        if (tokens.empty()) return;
-        
-        std::string command = tokens[0];
-        std::vector<std::string> args(tokens.begin() + 1, tokens.end());
+        if (!parseCommand(commandLine)) return;
         
         // Execute command
-        auto it = commands.find(command);
+        auto it = commands.find(commandName);
         if (it != commands.end()) {
             try {
-                it->second(args);
+                it->second(commandArgs);
             } catch (const std::exception& e) {
                 addOutput("Error executing command: " + std::string(e.what()));
             }
         } else {
-            addOutput("Unknown command: " + command);
+            addOutput("Unknown command: " + commandName);
             addOutput("Type 'help' for available commands");
         }
     }
@@ -230,20 +365,40 @@ public:
 
 private:
     /**
-     * Parse a command line into tokens
+     * Parse a command line into command and args
+     * Tokens are assigned into the existing strings, so steady-state parsing
+     * does not allocate.
      * @param commandLine Command line to parse
-     * @return Vector of tokens
+     * @return False if the line has no tokens
      */
-    std::vector<std::string> parseCommand(const std::string& commandLine) {
-        std::vector<std::string> tokens;
-        std::istringstream iss(commandLine);
-        std::string token;
-        
-        while (iss >> token) {
-            tokens.push_back(token);
+    bool parseCommand(const std::string& commandLine) {
+        size_t count = 0;
+        size_t position = 0;
+        while (true) {
+            size_t begin = commandLine.find_first_not_of(" \t\r\n", position);
+            if (begin == std::string::npos) {
+                break;
+            }
+            size_t end = commandLine.find_first_of(" \t\r\n", begin);
+            if (end == std::string::npos) {
+                end = commandLine.size();
+            }
+            if (count == 0) {
+                commandName.assign(commandLine, begin, end - begin);
+            } else {
+                if (count > commandArgs.size()) {
+                    commandArgs.emplace_back();
+                }
+                commandArgs[count - 1].assign(commandLine, begin, end - begin);
+            }
+            count++;
+            position = end;
         }
-        
-        return tokens;
+        if (count == 0) {
+            return false;
+        }
+        commandArgs.resize(count - 1);
+        return true;
     }
 
     /**
@@ -281,9 +436,30 @@ private:
     void showHelp() {
         addOutput("Available commands:");
         addOutput("  summon <number> - Summon the specified number of balls");
+        addOutput("  spawn <box|capsule> [number] - Drop boxes or capsules into the room");
+        addOutput("  clear_balls [all|resting|far <distance>] - Remove balls");
+        addOutput("  physics_info - Show body counts and physics settings");
+        addOutput("  physics_backend [cpu|gpu] - Show or switch the physics backend");
+        addOutput("  raycast [distance] - Report the first body along the view");
+        addOutput("  broadphase <grid|brute> - Select the collision broadphase");
+        addOutput("  simd <auto|scalar|sse2|avx2|neon> - Select the integration kernels");
+        addOutput("  physics_verify [bodies] [steps] - Check the SIMD kernels against the reference paths");
+        addOutput("  threads <count|auto> - Set the physics worker count");
+        addOutput("  shards <count> - Step the world as spatial shards");
+        addOutput("  contacts <colored|sequential> - Select the contact solve order");
+        addOutput("  solver <iterations> [warm|cold] - Set solver iterations and warm starting");
+        addOutput("  sleeping <on|off> - Toggle putting resting bodies to sleep");
+        addOutput("  ccd <on|off> - Toggle continuous collision for fast balls");
+        addOutput("  lockstep [on|off] - Toggle deterministic mode and show the state hash");
+        addOutput("  perf [on|off|reset|trace <file> [frames]] - Frame profiling");
+        addOutput("  quality [on [budget_ms]|off|budget <ms>] - Frame-budget quality governor");
+        addOutput("  checkpoint <save|load> <file> - Save or restore the world");
+        addOutput("  record <start <file>|stop> - Record a replay");
         addOutput("  clear - Clear console output");
         addOutput("  help - Show this help message");
         addOutput("  history - Show command history");
+        addOutput("  exec <file> - Run the commands of a script file");
+        addOutput("  wait [frames] - Delay the queued commands by frames (scripts)");
         addOutput("");
         addOutput("Controls:");
         addOutput("  WASD - Move camera");
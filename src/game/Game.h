@@ -5,11 +5,20 @@
 #include <chrono>
 #include <random>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
 #include "../physics/PhysicsWorld.h"
+#include "../physics/PhysicsThread.h"
+#include "../physics/KernelCheck.h"
+#include "../physics/Profiler.h"
+#include "../physics/WorldCheckpoint.h"
+#include "../physics/ReplayRecorder.h"
 #include "../renderer/Renderer.h"
+#include "../renderer/GpuPhysics.h"
 #include "../renderer/Camera.h"
 #include "../input/InputHandler.h"
 #include "../console/Console.h"
+#include "QualityGovernor.h"
 
 /**
  * Game class is the main controller for the 3D physics engine
@@ -24,24 +33,33 @@ private:
     
     // Core systems
     std::unique_ptr<PhysicsWorld> physicsWorld;
+    std::unique_ptr<ReplayRecorder> recorder;      // Streams ticks to a replay file while recording
+    std::unique_ptr<PhysicsThread> physicsThread;  // Steps physicsWorld at a fixed tick
     std::unique_ptr<Renderer> renderer;
+    std::unique_ptr<GpuPhysics> gpuPhysics;        // Optional compute backend (physics_backend gpu)
     std::unique_ptr<Camera> camera;
     std::unique_ptr<InputHandler> inputHandler;
     std::unique_ptr<Console> console;
+    std::unique_ptr<QualityGovernor> qualityGovernor;  // Trades quality for the frame budget
     
     // Game state
     bool isRunning;
     bool isPaused;
     
     // Player state
-    Ball* heldBall;                    // Ball currently held by player
+    BodyHandle heldBall;               // Ball currently held by player (only touched from physics commands)
     float pickupRange;                 // Range for picking up balls
     float throwForce;                  // Force to apply when throwing
+    static constexpr float restingSpeed = 0.1f;  // Speed below which clear_balls resting removes a ball
+    static constexpr int maxSummonCount = 1000000;   // Largest summon request
+    static constexpr int summonBatchSize = 2000;     // Balls summoned per frame by large summons
     
     // Timing
     std::chrono::high_resolution_clock::time_point lastFrameTime;
     float deltaTime;
     float targetFrameTime;
+    int swapZone;                      // Profiler zone of the buffer swap (-1 until registered)
+    uint64_t lastDroppedTicks;         // Physics ticks dropped as of the last quality sample
     
     // Random number generation
     std::random_device randomDevice;
@@ -57,11 +75,13 @@ public:
         , windowHeight(720)
         , isRunning(false)
         , isPaused(false)
-        , heldBall(nullptr)
+        , heldBall()
         , pickupRange(3.0f)
         , throwForce(15.0f)
         , deltaTime(0.0f)
         , targetFrameTime(1.0f / 60.0f)
+        , swapZone(-1)
+        , lastDroppedTicks(0)
         , randomGenerator(randomDevice()) {
     }
 
@@ -83,13 +103,18 @@ public:
             return false;
         }
 
-        // Set OpenGL version and profile
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        // Set OpenGL version and profile: 4.3 enables the compute physics backend, 3.3 is the minimum
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
         
         // Create window
         window = glfwCreateWindow(windowWidth, windowHeight, "3D Physics Engine", NULL, NULL);
+        if (!window) {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            window = glfwCreateWindow(windowWidth, windowHeight, "3D Physics Engine", NULL, NULL);
+        }
         if (!window) {
             std::cerr << "Failed to create GLFW window!" << std::endl;
             glfwTerminate();
@@ -124,6 +149,13 @@ public:
             return false;
         }
         
+        // The compute backend is optional; without it physics_backend stays on the CPU
+        gpuPhysics = std::make_unique<GpuPhysics>();
+        if (!gpuPhysics->initialize()) {
+            std::cout << "GPU physics unavailable (needs OpenGL 4.3)" << std::endl;
+        }
+        renderer->setGpuPhysics(gpuPhysics.get());
+        
         // Set up input callbacks
         setupInputCallbacks();
         
@@ -133,6 +165,25 @@ public:
         // Set up initial scene
         setupScene();
         
+        // Collect frame and step phase timings for the perf command
+        Profiler::get().setEnabled(true);
+        Profiler::get().setThreadName("main");
+        physicsWorld->setStepTimingEnabled(true);
+        
+        // Start the simulation thread
+        physicsThread = std::make_unique<PhysicsThread>(*physicsWorld);
+        
+        // Hold the frame budget by degrading from the settings chosen so far
+        QualityGovernor::Settings fullQuality;
+        fullQuality.catchUpTicks = physicsThread->getMaxCatchUpTicks();
+        fullQuality.solverIterations = physicsWorld->getSolverIterations();
+        fullQuality.sleepEnergy = physicsWorld->getSleepEnergy();
+        fullQuality.lodBias = renderer->getLodBias();
+        qualityGovernor = std::make_unique<QualityGovernor>(fullQuality);
+        qualityGovernor->setEnabled(true);
+        
+        physicsThread->start();
+        
         // Initialize timing
         lastFrameTime = std::chrono::high_resolution_clock::now();
         
@@ -142,6 +193,15 @@ public:
         return true;
     }
 
+    /**
+     * Queue a console script to run from the first frame
+     * @param path Script file path (one console command per line)
+     * @return False if the file cannot be read
+     */
+    bool queueScript(const std::string& path) {
+        return console->runScript(path);
+    }
+
     /**
      * Run the main game loop
      */
@@ -163,14 +223,33 @@ public:
             glfwPollEvents();
             inputHandler->update();
             
+            // Run queued console commands (and script lines) at one point of the frame
+            {
+                PROFILE_SCOPE("frame.console");
+                console->runPending();
+            }
+            
             // Update game systems
             update(deltaTime);
             
             // Render the scene
             render();
             
-            // Swap buffers
-            glfwSwapBuffers(window);
+            // Swap buffers (waits for V-Sync)
+            {
+                PROFILE_SCOPE("frame.swap");
+                glfwSwapBuffers(window);
+            }
+            
+            // Close the frame's profile; report a finished trace capture
+            std::string traceMessage;
+            if (Profiler::get().endFrame(traceMessage)) {
+                console->addOutput(traceMessage);
+                std::cout << traceMessage << std::endl;
+            }
+            
+            // Adapt quality to the frame just measured
+            updateQuality();
         }
     }
 
@@ -178,6 +257,8 @@ public:
      * Shutdown the game engine
      */
     void shutdown() {
+        physicsThread.reset();
+        gpuPhysics.reset();  // Needs the context alive to delete its buffers
         if (window) {
             glfwDestroyWindow(window);
             window = nullptr;
@@ -191,6 +272,7 @@ private:
      * @param dt Delta time since last update
      */
     void update(float dt) {
+        PROFILE_SCOPE("game.update");
         if (isPaused) return;
         
         // Update camera based on input
@@ -199,22 +281,76 @@ private:
         // Update player actions
         updatePlayer(dt);
         
-        // Update physics simulation
-        physicsWorld->update(dt);
+        // The compute backend steps on this thread, which owns the GL context
+        if (gpuPhysics->isActive()) {
+            gpuPhysics->update(dt);
+            return;
+        }
+        
+        // Physics runs on its own thread; move the held ball before its next tick
+        Vector3 holdPosition = camera->getPosition() + camera->getFront() * 2.0f;
+        physicsThread->post([this, holdPosition](PhysicsWorld& world) {
+            if (Ball* ball = world.getBall(heldBall)) {
+                ball->position() = holdPosition;
+            }
+        });
+    }
+
+    /**
+     * Feed the last frame's costs to the quality governor and apply its settings when they change
+     * The render cost is the frame minus the V-Sync wait in frame.swap (or the
+     * GPU zones when they are larger), so it needs the profiling timers.
+     */
+    void updateQuality() {
+        uint64_t dropped = physicsThread->getDroppedTicks();
+        uint64_t newlyDropped = dropped - lastDroppedTicks;
+        lastDroppedTicks = dropped;
+        if (!qualityGovernor->isEnabled()) {
+            return;
+        }
         
-        // Update held ball position
-        if (heldBall) {
-            Vector3 cameraPos = camera->getPosition();
-            Vector3 cameraFront = camera->getFront();
-            heldBall->position = cameraPos + cameraFront * 2.0f;
+        Profiler& profiler = Profiler::get();
+        if (swapZone < 0) {
+            swapZone = profiler.findZone("frame.swap");
+        }
+        double frameMs = 0.0;
+        if (swapZone < 0 || !profiler.getLastFrameMs(frameMs)) {
+            return;
+        }
+        
+        QualityGovernor::Sample sample;
+        sample.renderMs = std::max(frameMs - profiler.getLastZoneMs(swapZone), profiler.getLastGpuMs());
+        sample.physicsMs = physicsThread->getLastTickMilliseconds();
+        sample.droppedTicks = newlyDropped;
+        if (qualityGovernor->update(sample)) {
+            applyQuality();
         }
     }
 
+    /**
+     * Push the quality governor's current settings to the renderer and the physics thread
+     */
+    void applyQuality() {
+        QualityGovernor::Settings settings = qualityGovernor->getSettings();
+        renderer->setLodBias(settings.lodBias);
+        physicsThread->setMaxCatchUpTicks(settings.catchUpTicks);
+        physicsThread->post([settings](PhysicsWorld& world) {
+            // Lockstep peers must step with identical settings; only the pacing adapts
+            if (!world.isDeterministicEnabled()) {
+                world.setSolverIterations(settings.solverIterations);
+                world.setSleepEnergy(settings.sleepEnergy);
+            }
+        });
+    }
+
     /**
      * Render the scene
      */
     void render() {
-        renderer->render(*camera, *physicsWorld, deltaTime);
+        const PhysicsSnapshot& snapshot = physicsThread->acquireSnapshot();
+        float alpha = snapshot.interpolationFactor(PhysicsSnapshot::Clock::now());
+        renderer->render(*camera, snapshot, alpha, deltaTime);
+        Profiler::get().setFrameCounters(renderer->getDrawCallCount(), snapshot.contactCount);
         
         // Render console if visible
         if (console->getVisible()) {
@@ -262,52 +398,73 @@ private:
      * @param dt Delta time
      */
     void updatePlayer(float dt) {
-        // Pick up/drop balls with E key
-        if (inputHandler->wasKeyPressed(GLFW_KEY_E)) {
-            if (heldBall) {
+        // Balls on the GPU backend cannot be held or thrown
+        if (gpuPhysics->isActive()) return;
+        
+        // Apply pickups and throws at the physics tick their key press happened in
+        for (const InputEvent& event : inputHandler->getFrameEvents()) {
+            if (event.type != InputEventType::Key || event.action != GLFW_PRESS) {
+                continue;
+            }
+            if (event.code == GLFW_KEY_E) {
+                pickUpOrDrop(event.time);
+            } else if (event.code == GLFW_KEY_F) {
+                throwHeldBall(event.time);
+            }
+        }
+    }
+
+    /**
+     * Pick up the nearest ball, or drop the held one
+     * @param time When the key was pressed
+     */
+    void pickUpOrDrop(InputEvent::Clock::time_point time) {
+        Vector3 cameraPos = camera->getPosition();
+        physicsThread->postAt(time, [this, cameraPos](PhysicsWorld& world) {
+            if (Ball* ball = world.getBall(heldBall)) {
                 // Drop the held ball
-                heldBall->setHeld(false);
-                heldBall = nullptr;
+                ball->setHeld(false);
+                heldBall = BodyHandle();
             } else {
                 // Try to pick up a nearby ball
-                Ball* nearestBall = findNearestBall();
+                Ball* nearestBall = findNearestBall(cameraPos);
                 if (nearestBall) {
-                    heldBall = nearestBall;
-                    heldBall->setHeld(true);
+                    heldBall = nearestBall->getHandle();
+                    nearestBall->setHeld(true);
                 }
             }
-        }
-        
-        // Throw held ball with F key
-        if (inputHandler->wasKeyPressed(GLFW_KEY_F) && heldBall) {
-            Vector3 throwVelocity = camera->getFront() * throwForce;
-            heldBall->throwBall(throwVelocity);
-            heldBall = nullptr;
-        }
+        });
     }
 
     /**
-     * Find the nearest ball to the player
+     * Throw the held ball along the view direction
+     * @param time When the key was pressed
+     */
+    void throwHeldBall(InputEvent::Clock::time_point time) {
+        Vector3 throwVelocity = camera->getFront() * throwForce;
+        physicsThread->postAt(time, [this, throwVelocity](PhysicsWorld& world) {
+            if (Ball* ball = world.getBall(heldBall)) {
+                ball->throwBall(throwVelocity);
+                heldBall = BodyHandle();
+            }
+        });
+    }
+
+    /**
+     * Find the nearest ball to the player (call from a physics command)
+     * @param cameraPos Player position
      * @return Pointer to nearest ball, or nullptr if none in range
      */
-    Ball* findNearestBall() {
-        Vector3 cameraPos = camera->getPosition();
-        std::vector<Ball*> balls = physicsWorld->getBalls();
-        
-        Ball* nearestBall = nullptr;
-        float nearestDistance = pickupRange;
+    Ball* findNearestBall(const Vector3& cameraPos) {
+        QueryFilter filter;
+        filter.requiredFlags = BODY_ACTIVE | BODY_BALL;
+        filter.excludedFlags = BODY_HELD;  // Skip already held balls
         
-        for (Ball* ball : balls) {
-            if (ball->isHeld) continue;  // Skip already held balls
-            
-            float distance = (ball->position - cameraPos).magnitude();
-            if (distance < nearestDistance) {
-                nearestDistance = distance;
-                nearestBall = ball;
-            }
+        std::vector<BodyHandle> nearest;
+        if (physicsWorld->findNearest(cameraPos, 1, pickupRange, nearest, filter) == 0) {
+            return nullptr;
         }
-        
-        return nearestBall;
+        return physicsWorld->getBall(nearest[0]);
     }
 
     /**
@@ -330,6 +487,7 @@ private:
                         break;
                     case GLFW_KEY_P:
                         isPaused = !isPaused;
+                        physicsThread->setPaused(isPaused || gpuPhysics->isActive());
                         break;
                 }
             }
@@ -351,7 +509,7 @@ private:
      */
     void setupConsoleCommands() {
         // Summon command
-        console->registerCommand("summon", [this](const std::vector<std::string>& args) {
+        registerWorldCommand("summon", [this](const std::vector<std::string>& args) {
             if (args.empty()) {
                 console->addOutput("Usage: summon <number>");
                 return;
@@ -363,35 +521,714 @@ private:
                     console->addOutput("Number must be positive");
                     return;
                 }
-                if (count > 100) {
-                    console->addOutput("Maximum 100 balls at once");
+                if (count > maxSummonCount) {
+                    console->addOutput("Maximum " + std::to_string(maxSummonCount) + " balls at once");
+                    return;
+                }
+                
+                if (count <= summonBatchSize) {
+                    summonBalls(count);
+                    console->addOutput("Summoned " + std::to_string(count) + " balls");
                     return;
                 }
                 
-                summonBalls(count);
-                console->addOutput("Summoned " + std::to_string(count) + " balls");
+                // Spread large summons over frames so none of them hitches
+                int batches = (count + summonBatchSize - 1) / summonBatchSize;
+                console->addOutput("Summoning " + std::to_string(count) + " balls over " +
+                                   std::to_string(batches) + " frames");
+                auto remaining = std::make_shared<int>(count);
+                console->startTask([this, remaining, count]() {
+                    int batch = std::min(*remaining, summonBatchSize);
+                    runWorldCommand([this, batch]() {
+                        summonBalls(batch);
+                    });
+                    *remaining -= batch;
+                    if (*remaining > 0) {
+                        return false;
+                    }
+                    console->addOutput("Summoned " + std::to_string(count) + " balls");
+                    return true;
+                });
                 
             } catch (const std::exception& e) {
                 console->addOutput("Invalid number: " + args[0]);
             }
         });
         
+        // Spawn boxes or capsules
+        registerWorldCommand("spawn", [this](const std::vector<std::string>& args) {
+            if (args.empty() || (args[0] != "box" && args[0] != "capsule")) {
+                console->addOutput("Usage: spawn <box|capsule> [number]");
+                return;
+            }
+            
+            int count = 1;
+            if (args.size() >= 2) {
+                try {
+                    count = std::stoi(args[1]);
+                } catch (const std::exception& e) {
+                    console->addOutput("Invalid number: " + args[1]);
+                    return;
+                }
+            }
+            if (count <= 0 || count > 100) {
+                console->addOutput("Number must be between 1 and 100");
+                return;
+            }
+            
+            spawnShapes(args[0] == "box" ? ShapeType::Box : ShapeType::Capsule, count);
+            std::string noun = count == 1 ? args[0] : (args[0] == "box" ? "boxes" : "capsules");
+            console->addOutput("Spawned " + std::to_string(count) + " " + noun);
+        });
+        
         // Clear balls command
-        console->registerCommand("clear_balls", [this](const std::vector<std::string>& args) {
-            physicsWorld->clear();
-            heldBall = nullptr;
-            console->addOutput("Cleared all balls");
+        registerWorldCommand("clear_balls", [this](const std::vector<std::string>& args) {
+            if (args.empty() || args[0] == "all") {
+                physicsWorld->clear();
+                heldBall = BodyHandle();
+                console->addOutput("Cleared all balls");
+                return;
+            }
+            
+            size_t removed = 0;
+            if (args[0] == "resting") {
+                // Balls that have settled (held balls are kept)
+                removed = physicsWorld->removeBallsIf([](const Ball& ball) {
+                    return !ball.isHeld() && ball.velocity().magnitude() < restingSpeed;
+                });
+            } else if (args[0] == "far" && args.size() >= 2) {
+                float range;
+                try {
+                    range = std::stof(args[1]);
+                } catch (const std::exception& e) {
+                    console->addOutput("Invalid distance: " + args[1]);
+                    return;
+                }
+                Vector3 cameraPos = camera->getPosition();
+                removed = physicsWorld->removeBallsIf([cameraPos, range](const Ball& ball) {
+                    return !ball.isHeld() && (ball.position() - cameraPos).magnitude() > range;
+                });
+            } else {
+                console->addOutput("Usage: clear_balls [all|resting|far <distance>]");
+                return;
+            }
+            console->addOutput("Cleared " + std::to_string(removed) + " balls");
         });
         
         // Physics info command
-        console->registerCommand("physics_info", [this](const std::vector<std::string>& args) {
-            size_t ballCount = physicsWorld->getBalls().size();
+        registerWorldCommand("physics_info", [this](const std::vector<std::string>& args) {
+            size_t ballCount = physicsWorld->getBallCount();
             console->addOutput("Physics Info:");
-            console->addOutput("  Balls: " + std::to_string(ballCount));
-            console->addOutput("  Held ball: " + (heldBall ? "Yes" : "No"));
+            console->addOutput("  Balls: " + std::to_string(ballCount) + " of " +
+                               std::to_string(physicsWorld->getBodyCount()) + " bodies");
+            console->addOutput("  Visible balls: " + std::to_string(renderer->getVisibleBallCount()));
+            console->addOutput("  Held ball: " + std::string(physicsWorld->getBall(heldBall) ? "Yes" : "No"));
+            console->addOutput("  Backend: " + std::string(gpuPhysics->isActive()
+                ? "gpu, " + std::to_string(gpuPhysics->getStepCount()) + " steps since it started" : "cpu"));
+            console->addOutput("  Broadphase: " + std::string(
+                physicsWorld->getBroadphaseMode() == BroadphaseMode::UniformGrid ? "grid" : "brute"));
+            console->addOutput("  Threads: " + std::to_string(physicsWorld->getThreadCount()));
+            console->addOutput("  Tick: " + std::to_string(physicsThread->getLastTickMilliseconds()) + " ms, " +
+                               std::to_string(physicsThread->getDroppedTicks()) + " ticks dropped");
+            console->addOutput("  Contacts: " + std::string(
+                physicsWorld->getContactSolveMode() == ContactSolveMode::Colored ? "colored" : "sequential"));
+            console->addOutput("  Solver: " + std::to_string(physicsWorld->getSolverIterations()) + " iterations, " +
+                               (physicsWorld->isWarmStartingEnabled()
+                                    ? std::to_string(physicsWorld->getCachedContactCount()) + " contacts cached"
+                                    : std::string("cold start")));
+            console->addOutput("  Sleeping: " + (physicsWorld->isSleepingEnabled()
+                ? std::to_string(physicsWorld->getSleepingCount()) + " bodies" : std::string("off")));
+            console->addOutput("  CCD: " + (physicsWorld->isContinuousCollisionEnabled()
+                ? std::to_string(physicsWorld->getSweptCount()) + " bodies swept" : std::string("off")));
+            const WorldShards& shards = physicsThread->getShards();
+            if (shards.getShardCount() > 1) {
+                console->addOutput("  Shards: " + std::to_string(shards.getShardCount()) + ", " +
+                                   std::to_string(shards.getGhostCount()) + " ghosts, " +
+                                   std::to_string(shards.getMigrationCount()) + " migrated last tick");
+            }
+        });
+
+        // Switch between the CPU world and the compute-shader backend
+        console->registerCommand("physics_backend", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Physics backend: " + std::string(gpuPhysics->isActive() ? "gpu" : "cpu") +
+                                   (gpuPhysics->isAvailable() ? "" : " (gpu unavailable)"));
+                console->addOutput("Usage: physics_backend [cpu|gpu]");
+                return;
+            }
+
+            if (args[0] == "gpu") {
+                if (gpuPhysics->isActive()) {
+                    console->addOutput("Physics backend: gpu");
+                    return;
+                }
+                // Stop ticking first so the uploaded state is the one the CPU last stepped
+                physicsThread->setPaused(true);
+                std::string error;
+                bool uploaded = false;
+                physicsThread->withWorld([&](PhysicsWorld& world) {
+                    if (Ball* ball = world.getBall(heldBall)) {
+                        ball->setHeld(false);
+                    }
+                    heldBall = BodyHandle();
+                    uploaded = gpuPhysics->upload(world, error);
+                });
+                if (!uploaded) {
+                    physicsThread->setPaused(isPaused);
+                    console->addOutput(error);
+                    return;
+                }
+                console->addOutput("Physics backend: gpu (" + std::to_string(gpuPhysics->getBallCount()) + " balls)");
+            } else if (args[0] == "cpu") {
+                if (gpuPhysics->isActive()) {
+                    physicsThread->withWorld([this](PhysicsWorld& world) {
+                        gpuPhysics->download(world);
+                        gpuPhysics->deactivate();
+                    });
+                    physicsThread->setPaused(isPaused);
+                }
+                console->addOutput("Physics backend: cpu");
+            } else {
+                console->addOutput("Usage: physics_backend [cpu|gpu]");
+            }
+        });
+
+        // Raycast from the camera
+        registerWorldCommand("raycast", [this](const std::vector<std::string>& args) {
+            float distance = 100.0f;
+            if (!args.empty()) {
+                try {
+                    distance = std::stof(args[0]);
+                } catch (const std::exception& e) {
+                    console->addOutput("Invalid distance: " + args[0]);
+                    return;
+                }
+            }
+
+            Ray ray = { camera->getPosition(), camera->getFront(), distance };
+            RayHit hit;
+            if (!physicsWorld->raycast(ray, hit)) {
+                console->addOutput("Nothing within " + std::to_string(distance) + " m");
+                return;
+            }
+            static const char* shapeNames[] = { "ball", "box", "capsule", "plane" };
+            PhysicsBody* body = physicsWorld->getBody(hit.body);
+            std::ostringstream report;
+            report << std::fixed << std::setprecision(2) << "Hit " << shapeNames[(int)body->getShape()]
+                   << " at " << hit.distance << " m (" << hit.point.x << ", " << hit.point.y << ", "
+                   << hit.point.z << ")";
+            console->addOutput(report.str());
+        });
+
+        // Broadphase selection command
+        registerWorldCommand("broadphase", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Usage: broadphase <grid|brute>");
+                return;
+            }
+            
+            if (args[0] == "grid") {
+                physicsWorld->setBroadphaseMode(BroadphaseMode::UniformGrid);
+                console->addOutput("Broadphase set to uniform grid");
+            } else if (args[0] == "brute") {
+                physicsWorld->setBroadphaseMode(BroadphaseMode::BruteForce);
+                console->addOutput("Broadphase set to brute force O(n^2)");
+            } else {
+                console->addOutput("Unknown broadphase: " + args[0]);
+            }
+        });
+        
+        // SIMD kernel selection command
+        registerWorldCommand("simd", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("SIMD kernels: " + std::string(SimdKernels::getName(physicsWorld->getSimdLevel())));
+                console->addOutput("Usage: simd <auto|scalar|sse2|avx2|neon>");
+                return;
+            }
+            
+            SimdLevel level;
+            if (args[0] == "auto") {
+                level = SimdKernels::detectSimdLevel();
+            } else if (!parseSimdLevel(args[0], level)) {
+                console->addOutput("Unknown SIMD level: " + args[0]);
+                return;
+            }
+            
+            if (physicsWorld->setSimdLevel(level)) {
+                console->addOutput("SIMD kernels set to " + std::string(SimdKernels::getName(level)));
+            } else {
+                console->addOutput("SIMD level not supported on this CPU: " + args[0]);
+            }
+        });
+        
+        // Kernel verification command
+        console->registerCommand("physics_verify", [this](const std::vector<std::string>& args) {
+            try {
+                size_t bodies = args.size() > 0 ? (size_t)std::stoul(args[0]) : 4096;
+                int steps = args.size() > 1 ? std::stoi(args[1]) : 240;
+                
+                KernelCheckResult result = KernelCheck::run(physicsWorld->getSimdLevel(), bodies, steps);
+                console->addOutput("Kernel check (" + std::string(SimdKernels::getName(result.level)) + ", " +
+                                   std::to_string(result.bodyCount) + " bodies, " +
+                                   std::to_string(result.steps) + " steps): " +
+                                   (result.passed() ? "PASS" : "FAIL"));
+                console->addOutput("  vs scalar kernels: " + std::to_string(result.simdMismatches) +
+                                   " mismatches, max error " + std::to_string(result.simdMaxError));
+                console->addOutput("  vs per-body path: " + std::to_string(result.legacyMismatches) +
+                                   " outside tolerance, max error " + std::to_string(result.legacyMaxError));
+            } catch (const std::exception& e) {
+                console->addOutput("Usage: physics_verify [bodies] [steps]");
+            }
+        });
+        
+        // Physics worker pool size command
+        registerWorldCommand("threads", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Physics threads: " + std::to_string(physicsWorld->getThreadCount()));
+                console->addOutput("Usage: threads <count|auto>");
+                return;
+            }
+            
+            try {
+                int count = args[0] == "auto" ? 0 : std::stoi(args[0]);
+                if (count < 0 || count > 256) {
+                    console->addOutput("Thread count must be between 0 (auto) and 256");
+                    return;
+                }
+                physicsWorld->setThreadCount((size_t)count);
+                console->addOutput("Physics threads set to " + std::to_string(physicsWorld->getThreadCount()));
+            } catch (const std::exception& e) {
+                console->addOutput("Invalid thread count: " + args[0]);
+            }
+        });
+        
+        // Spatial shard count (takes the world itself, so not a world command)
+        console->registerCommand("shards", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Usage: shards <count>");
+                return;
+            }
+            
+            try {
+                int count = std::stoi(args[0]);
+                if (count < 1 || count > (int)WorldShards::maxShards) {
+                    console->addOutput("Shard count must be between 1 and " + std::to_string(WorldShards::maxShards));
+                    return;
+                }
+                physicsThread->setShardCount((size_t)count);
+                console->addOutput(count == 1 ? std::string("World stepped as one shard")
+                                              : "World split into " + std::to_string(count) + " shards");
+            } catch (const std::exception& e) {
+                console->addOutput("Invalid shard count: " + args[0]);
+            }
+        });
+        
+        // Contact resolution mode command
+        registerWorldCommand("contacts", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Usage: contacts <colored|sequential>");
+                return;
+            }
+            
+            if (args[0] == "colored") {
+                physicsWorld->setContactSolveMode(ContactSolveMode::Colored);
+                console->addOutput("Contacts resolved by color in parallel");
+            } else if (args[0] == "sequential") {
+                physicsWorld->setContactSolveMode(ContactSolveMode::Sequential);
+                console->addOutput("Contacts resolved sequentially");
+            } else {
+                console->addOutput("Unknown contact mode: " + args[0]);
+            }
+        });
+        
+        // Contact solver settings
+        registerWorldCommand("solver", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Usage: solver <iterations> [warm|cold]");
+                return;
+            }
+            
+            int iterations = 0;
+            try {
+                iterations = std::stoi(args[0]);
+            } catch (const std::exception&) {
+                console->addOutput("Invalid iteration count: " + args[0]);
+                return;
+            }
+            if (iterations < 1 || iterations > 64) {
+                console->addOutput("Iterations must be between 1 and 64");
+                return;
+            }
+            
+            if (args.size() > 1) {
+                if (args[1] == "warm") {
+                    physicsWorld->setWarmStartingEnabled(true);
+                } else if (args[1] == "cold") {
+                    physicsWorld->setWarmStartingEnabled(false);
+                } else {
+                    console->addOutput("Unknown start mode: " + args[1]);
+                    return;
+                }
+            }
+            
+            physicsWorld->setSolverIterations(iterations);
+            console->addOutput("Solver: " + std::to_string(iterations) + " iterations, " +
+                               (physicsWorld->isWarmStartingEnabled() ? "warm started" : "cold started"));
+            
+            // The governor scales down from the new count
+            QualityGovernor::Settings fullQuality = qualityGovernor->getBaseline();
+            fullQuality.solverIterations = iterations;
+            qualityGovernor->setBaseline(fullQuality);
+            if (qualityGovernor->getPhysicsLevel() > 0) {
+                applyQuality();
+            }
+        });
+        
+        // Sleeping toggle
+        registerWorldCommand("sleeping", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Usage: sleeping <on|off>");
+                return;
+            }
+            
+            if (args[0] == "on") {
+                physicsWorld->setSleepingEnabled(true);
+                console->addOutput("Resting bodies will fall asleep");
+            } else if (args[0] == "off") {
+                physicsWorld->setSleepingEnabled(false);
+                console->addOutput("Sleeping disabled, all bodies awake");
+            } else {
+                console->addOutput("Unknown sleeping mode: " + args[0]);
+            }
+        });
+        
+        // Continuous collision toggle
+        registerWorldCommand("ccd", [this](const std::vector<std::string>& args) {
+            if (args.empty()) {
+                console->addOutput("Usage: ccd <on|off>");
+                return;
+            }
+            
+            if (args[0] == "on") {
+                physicsWorld->setContinuousCollisionEnabled(true);
+                console->addOutput("Fast bodies will be swept against spheres and walls");
+            } else if (args[0] == "off") {
+                physicsWorld->setContinuousCollisionEnabled(false);
+                console->addOutput("Continuous collision disabled, fast bodies may tunnel");
+            } else {
+                console->addOutput("Unknown ccd mode: " + args[0]);
+            }
+        });
+        
+        // Deterministic lockstep mode and state hash
+        registerWorldCommand("lockstep", [this](const std::vector<std::string>& args) {
+            if (!args.empty() && args[0] == "on") {
+                physicsWorld->setDeterministicEnabled(true);
+                // Peers start from the full-quality settings whatever the governor had picked
+                physicsWorld->setSolverIterations(qualityGovernor->getBaseline().solverIterations);
+                physicsWorld->setSleepEnergy(qualityGovernor->getBaseline().sleepEnergy);
+            } else if (!args.empty() && args[0] == "off") {
+                physicsWorld->setDeterministicEnabled(false);
+                console->addOutput("Deterministic mode disabled");
+                return;
+            } else if (!args.empty()) {
+                console->addOutput("Usage: lockstep [on|off]");
+                return;
+            }
+            
+            if (!physicsWorld->isDeterministicEnabled()) {
+                console->addOutput("Deterministic mode is off; run lockstep on");
+                return;
+            }
+            std::ostringstream hash;
+            hash << std::hex << std::setw(16) << std::setfill('0') << physicsWorld->getStateHash();
+            console->addOutput("Lockstep: step " + std::to_string(physicsWorld->getStepCount()) +
+                               ", state hash " + hash.str());
+        });
+        
+        // Profiler report and trace capture
+        setupPerfCommand();
+        
+        // Frame-budget quality governor
+        setupQualityCommand();
+        
+        // World checkpoints and replay recording
+        setupReplayCommands();
+    }
+
+    /**
+     * Register the perf command, which reports the Profiler's rolling statistics
+     * Runs on the render thread without stopping the simulation
+     */
+    void setupPerfCommand() {
+        console->registerCommand("perf", [this](const std::vector<std::string>& args) {
+            Profiler& profiler = Profiler::get();
+            if (args.empty()) {
+                reportPerf();
+            } else if (args[0] == "on" || args[0] == "off") {
+                bool enable = args[0] == "on";
+                profiler.setEnabled(enable);
+                profiler.reset();
+                physicsThread->post([enable](PhysicsWorld& world) {
+                    world.setStepTimingEnabled(enable);
+                });
+                console->addOutput(enable ? "Profiling enabled" : "Profiling disabled");
+            } else if (args[0] == "reset") {
+                profiler.reset();
+                console->addOutput("Profile history cleared");
+            } else if (args[0] == "trace" && args.size() >= 2) {
+                int frames = 120;
+                if (args.size() > 2) {
+                    try {
+                        frames = std::stoi(args[2]);
+                    } catch (const std::exception&) {
+                        frames = 0;
+                    }
+                    if (frames < 1 || frames > 10000) {
+                        console->addOutput("Frame count must be between 1 and 10000");
+                        return;
+                    }
+                }
+                if (!profiler.isEnabled()) {
+                    console->addOutput("Profiling is off; run perf on first");
+                } else if (!profiler.beginTrace(args[1], frames)) {
+                    console->addOutput("A trace is already being captured");
+                } else {
+                    console->addOutput("Capturing " + std::to_string(frames) + " frames to " + args[1]);
+                }
+            } else {
+                console->addOutput("Usage: perf [on|off|reset|trace <file> [frames]]");
+            }
         });
     }
 
+    /**
+     * Register the quality command, which reports and steers the quality governor
+     */
+    void setupQualityCommand() {
+        registerWorldCommand("quality", [this](const std::vector<std::string>& args) {
+            if (!args.empty() && (args[0] == "on" || args[0] == "budget")) {
+                if (args.size() > 1) {
+                    float budget = 0.0f;
+                    try {
+                        budget = std::stof(args[1]);
+                    } catch (const std::exception&) {
+                        budget = 0.0f;
+                    }
+                    if (budget < 1.0f || budget > 100.0f) {
+                        console->addOutput("Budget must be between 1 and 100 ms");
+                        return;
+                    }
+                    qualityGovernor->setBudgetMs(budget);
+                } else if (args[0] == "budget") {
+                    console->addOutput("Usage: quality budget <ms>");
+                    return;
+                }
+                if (args[0] == "on" && !qualityGovernor->isEnabled()) {
+                    qualityGovernor->setEnabled(true);
+                    lastDroppedTicks = physicsThread->getDroppedTicks();
+                }
+            } else if (!args.empty() && args[0] == "off") {
+                qualityGovernor->setEnabled(false);
+                applyQuality();
+            } else if (!args.empty()) {
+                console->addOutput("Usage: quality [on [budget_ms]|off|budget <ms>]");
+                return;
+            }
+            reportQuality();
+        });
+    }
+
+    /**
+     * Print the quality governor's state and its recent decisions to the console
+     */
+    void reportQuality() {
+        std::ostringstream budget;
+        budget << std::fixed << std::setprecision(1) << qualityGovernor->getBudgetMs();
+        console->addOutput("Quality governor: " + std::string(qualityGovernor->isEnabled() ? "on" : "off") +
+                           ", budget " + budget.str() + " ms");
+        if (!qualityGovernor->isEnabled()) {
+            return;
+        }
+        if (!PHYSICS_PROFILING || !Profiler::get().isEnabled()) {
+            console->addOutput("  Waiting for frame timings; run perf on (needs PHYSICS_PROFILING=1)");
+        }
+        
+        QualityGovernor::Settings settings = qualityGovernor->getSettings();
+        std::ostringstream lodBias;
+        lodBias << std::setprecision(2) << settings.lodBias;
+        std::ostringstream sleepEnergy;
+        sleepEnergy << std::fixed << std::setprecision(3) << settings.sleepEnergy;
+        console->addOutput("  Render: level " + std::to_string(qualityGovernor->getRenderLevel()) + ", " +
+                           formatMilliseconds(qualityGovernor->getRenderMs()) + " per frame, LOD bias " + lodBias.str());
+        console->addOutput("  Physics: level " + std::to_string(qualityGovernor->getPhysicsLevel()) + ", " +
+                           formatMilliseconds(qualityGovernor->getPhysicsMs()) + " per tick, " +
+                           std::to_string(settings.catchUpTicks) + " catch-up ticks, " +
+                           std::to_string(settings.solverIterations) + " solver iterations, sleep below " +
+                           sleepEnergy.str() + " J");
+        if (physicsWorld->isDeterministicEnabled()) {
+            console->addOutput("  Lockstep is on: solver and sleeping stay at full quality");
+        }
+        for (const std::string& decision : qualityGovernor->getDecisions()) {
+            console->addOutput("  " + decision);
+        }
+    }
+
+    /**
+     * Register the checkpoint and record commands
+     */
+    void setupReplayCommands() {
+        registerWorldCommand("checkpoint", [this](const std::vector<std::string>& args) {
+            if (args.size() < 2 || (args[0] != "save" && args[0] != "load")) {
+                console->addOutput("Usage: checkpoint <save|load> <file>");
+                return;
+            }
+            
+            std::string error;
+            if (args[0] == "save") {
+                if (WorldCheckpoint::save(*physicsWorld, args[1], error)) {
+                    console->addOutput("Saved " + std::to_string(physicsWorld->getBodyStore().size()) +
+                                       " bodies to " + args[1]);
+                } else {
+                    console->addOutput(error);
+                }
+                return;
+            }
+            
+            auto loadStart = std::chrono::high_resolution_clock::now();
+            if (!WorldCheckpoint::load(*physicsWorld, args[1], error)) {
+                console->addOutput(error);
+                return;
+            }
+            heldBall = BodyHandle();
+            float loadMs = std::chrono::duration<float, std::milli>(
+                std::chrono::high_resolution_clock::now() - loadStart).count();
+            console->addOutput("Loaded " + std::to_string(physicsWorld->getBodyStore().size()) + " bodies from " +
+                               args[1] + " in " + formatMilliseconds(loadMs));
+        });
+        
+        console->registerCommand("record", [this](const std::vector<std::string>& args) {
+            if (!args.empty() && args[0] == "start" && args.size() >= 2) {
+                if (!recorder) {
+                    recorder = std::make_unique<ReplayRecorder>();
+                }
+                physicsThread->setRecorder(nullptr);
+                std::string error;
+                if (!recorder->start(args[1], error)) {
+                    console->addOutput(error);
+                    return;
+                }
+                physicsThread->setRecorder(recorder.get());
+                console->addOutput("Recording every tick to " + args[1]);
+            } else if (!args.empty() && args[0] == "stop") {
+                if (!recorder || (!recorder->isRecording() && !recorder->hasFailed())) {
+                    console->addOutput("Not recording");
+                    return;
+                }
+                physicsThread->setRecorder(nullptr);
+                recorder->stop();
+                console->addOutput("Recorded " + std::to_string(recorder->getFramesWritten()) + " ticks (" +
+                                   std::to_string(recorder->getBytesWritten() / 1024) + " KB, " +
+                                   std::to_string(recorder->getFramesDropped()) + " dropped)" +
+                                   (recorder->hasFailed() ? ", write failed" : ""));
+            } else {
+                console->addOutput("Usage: record <start <file>|stop>");
+            }
+        });
+    }
+
+    /**
+     * Print frame-time percentiles, counters and per-zone times to the console
+     */
+    void reportPerf() {
+        const Profiler& profiler = Profiler::get();
+        Profiler::FrameSummary frame = profiler.getFrameSummary();
+        if (!profiler.isEnabled() || frame.frames == 0) {
+            console->addOutput("No profile data; run perf on");
+            return;
+        }
+        
+        console->addOutput("Perf (last " + std::to_string(frame.frames) + " frames):");
+        console->addOutput("  Frame: avg " + formatMilliseconds(frame.averageMs) + ", p50 " +
+                           formatMilliseconds(frame.p50Ms) + ", p90 " + formatMilliseconds(frame.p90Ms) +
+                           ", p99 " + formatMilliseconds(frame.p99Ms) + ", max " + formatMilliseconds(frame.maxMs));
+        console->addOutput("  Draw calls: " + std::to_string((int)std::lround(frame.drawCalls)) +
+                           ", contact pairs: " + std::to_string((long)std::lround(frame.contacts)));
+        if (!PHYSICS_PROFILING) {
+            console->addOutput("  Zones compiled out (PHYSICS_PROFILING=0)");
+        }
+        for (const Profiler::ZoneSummary& zone : profiler.getZoneSummaries()) {
+            console->addOutput("  " + std::string(zone.name) + (zone.gpu ? " (GPU)" : "") + ": avg " +
+                               formatMilliseconds(zone.averageMs) + ", max " + formatMilliseconds(zone.maxMs));
+        }
+    }
+
+    /**
+     * Format a duration for console output
+     * @param milliseconds Duration in milliseconds
+     * @return Text such as "1.234 ms"
+     */
+    static std::string formatMilliseconds(double milliseconds) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3) << milliseconds << " ms";
+        return text.str();
+    }
+
+    /**
+     * Register a console command that runs while the physics thread is between ticks
+     * @param command Command name
+     * @param callback Command body, free to use physicsWorld and heldBall
+     */
+    void registerWorldCommand(const std::string& command, std::function<void(const std::vector<std::string>&)> callback) {
+        console->registerCommand(command, [this, callback](const std::vector<std::string>& args) {
+            runWorldCommand([&]() {
+                callback(args);
+            });
+        });
+    }
+
+    /**
+     * Run code while the physics thread is between ticks
+     * @param body Code free to use physicsWorld and heldBall
+     */
+    void runWorldCommand(const std::function<void()>& body) {
+        std::string error;
+        bool fellBack = false;
+        physicsThread->withWorld([&](PhysicsWorld& world) {
+            // On the GPU backend the world is refreshed around the command and its edits written back
+            bool onGpu = gpuPhysics->isActive();
+            if (onGpu) {
+                gpuPhysics->download(world);
+            }
+            body();
+            if (onGpu && !gpuPhysics->refresh(world, error)) {
+                gpuPhysics->deactivate();
+                fellBack = true;
+            }
+        });
+        if (fellBack) {
+            physicsThread->setPaused(isPaused);
+            console->addOutput(error);
+            console->addOutput("Physics backend: cpu");
+        }
+    }
+
+    /**
+     * Parse a SIMD level name
+     * @param name Level name (scalar, sse2, avx2, neon)
+     * @param level Output level
+     * @return True if the name is recognized
+     */
+    static bool parseSimdLevel(const std::string& name, SimdLevel& level) {
+        for (SimdLevel candidate : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON }) {
+            if (name == SimdKernels::getName(candidate)) {
+                level = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * Set up the initial scene
      */
@@ -408,23 +1245,57 @@ private:
         Vector3 cameraPos = camera->getPosition();
         std::uniform_real_distribution<float> posDistribution(-5.0f, 5.0f);
         std::uniform_real_distribution<float> heightDistribution(2.0f, 8.0f);
+        std::uniform_real_distribution<float> velDistribution(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> colorDistribution(0.3f, 1.0f);
         
-        for (int i = 0; i < count; i++) {
-            Vector3 position(
+        physicsWorld->createBalls((size_t)count, [&](size_t, PhysicsWorld::BallSpawn& spawn) {
+            spawn.position = Vector3(
                 cameraPos.x + posDistribution(randomGenerator),
                 heightDistribution(randomGenerator),
                 cameraPos.z + posDistribution(randomGenerator)
             );
             
-            Ball* ball = physicsWorld->createBall(position);
-            
             // Give the ball a small random initial velocity
-            std::uniform_real_distribution<float> velDistribution(-2.0f, 2.0f);
-            ball->velocity = Vector3(
+            spawn.velocity = Vector3(
                 velDistribution(randomGenerator),
                 0.0f,
                 velDistribution(randomGenerator)
             );
+            
+            spawn.color = Vector3(
+                colorDistribution(randomGenerator),
+                colorDistribution(randomGenerator),
+                colorDistribution(randomGenerator)
+            );
+        });
+    }
+
+    /**
+     * Drop boxes or capsules of random size around the camera
+     * @param shape ShapeType::Box or ShapeType::Capsule
+     * @param count Number of bodies to create
+     */
+    void spawnShapes(ShapeType shape, int count) {
+        Vector3 cameraPos = camera->getPosition();
+        std::uniform_real_distribution<float> posDistribution(-5.0f, 5.0f);
+        std::uniform_real_distribution<float> heightDistribution(2.0f, 8.0f);
+        std::uniform_real_distribution<float> sizeDistribution(0.2f, 0.6f);
+        std::uniform_real_distribution<float> colorDistribution(0.3f, 1.0f);
+        
+        for (int i = 0; i < count; ++i) {
+            Vector3 position(cameraPos.x + posDistribution(randomGenerator), heightDistribution(randomGenerator),
+                             cameraPos.z + posDistribution(randomGenerator));
+            PhysicsBody* body;
+            if (shape == ShapeType::Box) {
+                Vector3 halfExtents(sizeDistribution(randomGenerator), sizeDistribution(randomGenerator),
+                                    sizeDistribution(randomGenerator));
+                body = physicsWorld->createBox(position, 1.0f, halfExtents);
+            } else {
+                float radius = sizeDistribution(randomGenerator) * 0.5f;
+                body = physicsWorld->createCapsule(position, 1.0f, radius, sizeDistribution(randomGenerator));
+            }
+            body->color() = Vector3(colorDistribution(randomGenerator), colorDistribution(randomGenerator),
+                                    colorDistribution(randomGenerator));
         }
     }
 
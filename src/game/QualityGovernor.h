@@ -0,0 +1,282 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+/**
+ * QualityGovernor trades simulation and rendering quality for a frame-time budget
+ * Each frame it is fed the frame's render cost (CPU work before the buffer
+ * swap, or GPU time when that is larger) and the physics thread's tick cost.
+ * Both are smoothed, and each drives its own ladder of quality levels:
+ * - Render: a coarser sphere LOD bias
+ * - Physics: fewer catch-up ticks, fewer solver iterations and a higher
+ *   sleeping threshold, all relative to the baseline it was started from
+ *
+ * A ladder steps down quickly while its cost stays over budget and climbs
+ * back slowly once the cost is well under it, so a single spike does not
+ * make the quality flap. Every change is logged for the quality command.
+ */
+class QualityGovernor {
+public:
+    /**
+     * Quality knobs applied by the game
+     */
+    struct Settings {
+        int catchUpTicks;               // PhysicsThread ticks run back to back before dropping backlog
+        int solverIterations;           // Contact solver iterations per step
+        float sleepEnergy;              // Kinetic energy (J) under which a body counts as resting
+        float lodBias;                  // Factor on projected ball radii when picking sphere LODs
+    };
+
+    /**
+     * Costs measured for one frame
+     */
+    struct Sample {
+        double renderMs;                // Frame work excluding the V-Sync wait
+        double physicsMs;               // CPU time of the physics thread's last tick
+        uint64_t droppedTicks;          // Ticks dropped by the physics thread since the last sample
+    };
+
+    static constexpr float defaultBudgetMs = 8.3f;      // Frame budget at 120 Hz
+    static constexpr int levelCount = 5;                // Rungs on each ladder, 0 = full quality
+    static constexpr double smoothing = 0.1;            // Weight of a new sample in the running averages
+    static constexpr double headroom = 0.7;             // Cost below this fraction of the budget allows a step up
+    static constexpr double spikeLimit = 4.0;           // Samples are clamped to this many budgets before smoothing
+    static constexpr uint64_t downCooldown = 15;        // Frames between two steps down on one ladder
+    static constexpr uint64_t upCooldown = 120;         // Frames in headroom before stepping up
+    static constexpr size_t maxDecisions = 8;           // Decisions kept for the quality command
+
+private:
+    /**
+     * One rung of the physics ladder, relative to the baseline settings
+     */
+    struct PhysicsLevel {
+        int catchUpTicks;               // Upper limit on catch-up ticks
+        float iterationScale;           // Factor on the baseline solver iterations
+        float sleepEnergyScale;         // Factor on the baseline sleeping threshold
+    };
+
+    static constexpr PhysicsLevel physicsLevels[levelCount] = {
+        { 8, 1.0f, 1.0f },
+        { 6, 0.75f, 2.0f },
+        { 4, 0.5f, 4.0f },
+        { 2, 0.35f, 8.0f },
+        { 1, 0.25f, 16.0f }
+    };
+    static constexpr float lodBiasLevels[levelCount] = { 1.0f, 0.75f, 0.5f, 0.35f, 0.25f };
+
+    /**
+     * One smoothed cost and the ladder it drives
+     */
+    struct Ladder {
+        int level = 0;                  // Current rung
+        double averageMs = 0.0;         // Smoothed cost
+        bool primed = false;            // averageMs holds at least one sample
+        uint64_t lastChange = 0;        // Frame of the last step
+        uint64_t headroomSince = 0;     // First frame of the current run under headroom
+        bool inHeadroom = false;        // The cost is currently in headroom
+    };
+
+    bool enabled;                       // Levels follow the measured costs
+    float budgetMs;                     // Target frame time
+    Settings baseline;                  // Settings at full quality
+    Ladder render;                      // Drives lodBias
+    Ladder physics;                     // Drives catch-up ticks, solver iterations and sleepEnergy
+    uint64_t frame;                     // Samples taken so far
+    std::deque<std::string> decisions;  // Most recent changes, oldest first
+
+public:
+    /**
+     * Constructor - creates a disabled governor at full quality
+     * @param fullQuality Settings used at level 0
+     */
+    explicit QualityGovernor(const Settings& fullQuality)
+        : enabled(false)
+        , budgetMs(defaultBudgetMs)
+        , baseline(fullQuality)
+        , frame(0) {
+    }
+
+    /**
+     * Start or stop adapting; stopping returns both ladders to full quality
+     * @param enable True to follow the measured costs
+     */
+    void setEnabled(bool enable) {
+        enabled = enable;
+        render = Ladder();
+        physics = Ladder();
+    }
+
+    /**
+     * Check whether the governor is adapting
+     * @return True if enabled
+     */
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    /**
+     * Set the frame-time target
+     * @param milliseconds Budget per frame (positive)
+     */
+    void setBudgetMs(float milliseconds) {
+        budgetMs = std::max(milliseconds, 0.1f);
+    }
+
+    /**
+     * Get the frame-time target
+     * @return Budget per frame in milliseconds
+     */
+    float getBudgetMs() const {
+        return budgetMs;
+    }
+
+    /**
+     * Replace the full-quality settings the levels are derived from
+     * @param fullQuality Settings used at level 0
+     */
+    void setBaseline(const Settings& fullQuality) {
+        baseline = fullQuality;
+    }
+
+    /**
+     * Get the full-quality settings
+     * @return Settings used at level 0
+     */
+    const Settings& getBaseline() const {
+        return baseline;
+    }
+
+    /**
+     * Feed one frame's costs and move the ladders
+     * @param sample Costs measured this frame
+     * @return True if the settings changed and need applying
+     */
+    bool update(const Sample& sample) {
+        frame++;
+        if (!enabled) {
+            return false;
+        }
+        // A dropped tick means the physics thread already missed its deadline
+        double physicsCost = sample.droppedTicks > 0 ? std::max(sample.physicsMs, (double)budgetMs * 2.0)
+                                                     : sample.physicsMs;
+        bool changed = adjust(render, "render", sample.renderMs);
+        changed = adjust(physics, "physics", physicsCost) || changed;
+        return changed;
+    }
+
+    /**
+     * Get the settings for the current levels
+     * @return Knobs to apply
+     */
+    Settings getSettings() const {
+        const PhysicsLevel& level = physicsLevels[physics.level];
+        Settings settings;
+        settings.catchUpTicks = std::min(baseline.catchUpTicks, level.catchUpTicks);
+        settings.solverIterations = std::max(1, (int)std::lround(baseline.solverIterations * level.iterationScale));
+        settings.sleepEnergy = baseline.sleepEnergy * level.sleepEnergyScale;
+        settings.lodBias = baseline.lodBias * lodBiasLevels[render.level];
+        return settings;
+    }
+
+    /**
+     * Get the render ladder's level
+     * @return 0 (full quality) to levelCount - 1
+     */
+    int getRenderLevel() const {
+        return render.level;
+    }
+
+    /**
+     * Get the physics ladder's level
+     * @return 0 (full quality) to levelCount - 1
+     */
+    int getPhysicsLevel() const {
+        return physics.level;
+    }
+
+    /**
+     * Get the smoothed render cost
+     * @return Milliseconds per frame
+     */
+    double getRenderMs() const {
+        return render.averageMs;
+    }
+
+    /**
+     * Get the smoothed physics tick cost
+     * @return Milliseconds per tick
+     */
+    double getPhysicsMs() const {
+        return physics.averageMs;
+    }
+
+    /**
+     * Get the most recent level changes
+     * @return Decision lines, oldest first
+     */
+    const std::deque<std::string>& getDecisions() const {
+        return decisions;
+    }
+
+private:
+    /**
+     * Smooth a cost into its ladder and step the ladder when the average leaves the band
+     * @param ladder Ladder to update
+     * @param name Ladder name for the decision log
+     * @param costMs Cost measured this frame
+     * @return True if the ladder's level changed
+     */
+    bool adjust(Ladder& ladder, const char* name, double costMs) {
+        // Clamp so one long frame (a shader compile, a huge summon) costs at most one step
+        costMs = std::min(costMs, budgetMs * spikeLimit);
+        ladder.averageMs = ladder.primed ? ladder.averageMs + (costMs - ladder.averageMs) * smoothing : costMs;
+        ladder.primed = true;
+
+        if (ladder.averageMs > budgetMs) {
+            ladder.inHeadroom = false;
+            if (ladder.level + 1 < levelCount && frame - ladder.lastChange >= downCooldown) {
+                step(ladder, name, ladder.level + 1);
+                return true;
+            }
+            return false;
+        }
+
+        if (ladder.averageMs >= budgetMs * headroom) {
+            ladder.inHeadroom = false;
+            return false;
+        }
+        if (!ladder.inHeadroom) {
+            ladder.inHeadroom = true;
+            ladder.headroomSince = frame;
+        }
+        if (ladder.level > 0 && frame - ladder.headroomSince >= upCooldown && frame - ladder.lastChange >= upCooldown) {
+            step(ladder, name, ladder.level - 1);
+            ladder.headroomSince = frame;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Move a ladder to a new level and log why
+     * @param ladder Ladder to move
+     * @param name Ladder name for the decision log
+     * @param level New level
+     */
+    void step(Ladder& ladder, const char* name, int level) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << "frame " << frame << ": " << name << " " << ladder.averageMs
+             << " ms vs " << budgetMs << " ms budget, level " << ladder.level << " -> " << level;
+        ladder.level = level;
+        ladder.lastChange = frame;
+        decisions.push_back(line.str());
+        if (decisions.size() > maxDecisions) {
+            decisions.pop_front();
+        }
+    }
+};
@@ -0,0 +1,354 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
+#include "physics/PhysicsWorld.h"
+#include "physics/SceneDescription.h"
+#include "physics/WorldCheckpoint.h"
+#include "physics/ReplayRecorder.h"
+#include "physics/ReplayReader.h"
+#include "physics/WorldShards.h"
+#include "physics/KernelCheck.h"
+#include "physics/CheckpointCheck.h"
+
+/**
+ * Print command line usage
+ * @param program Executable name
+ */
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [scene-file] [options]\n"
+              << "Steps a PhysicsWorld as fast as possible and reports throughput.\n"
+              << "Without a scene file, 10000 balls are scattered through the default room.\n"
+              << "\n"
+              << "Options:\n"
+              << "  --ticks <n>       Fixed steps to simulate (default 600)\n"
+              << "  --balls <n>       Replace the scene's balls with n scattered balls\n"
+              << "  --threads <n>     Physics threads, 0 = one per hardware thread (overrides the scene)\n"
+              << "  --shards <n>      Step the world as n spatial shards on separate workers (default 1)\n"
+              << "  --report <n>      Print progress every n ticks (default 0 = only at the end)\n"
+              << "  --lockstep        Deterministic mode: print the state hash with every report and at the end\n"
+              << "  --load <file>     Start from a checkpoint instead of the scene\n"
+              << "  --save <file>     Write a checkpoint after the last tick\n"
+              << "  --record <file>   Record every tick to a replay file\n"
+              << "  --replay <file>   Re-simulate a replay and report drift from the recording, then exit\n"
+              << "  --verify-kernels  Check every supported SIMD kernel against the scalar and per-body paths, then exit\n"
+              << "  --verify-checkpoints  Restore intact, truncated and corrupted checkpoints, then exit\n"
+              << "  --help            Show this message\n";
+}
+
+/**
+ * Parse a non-negative integer option value
+ * @param text Option value
+ * @param value Receives the parsed value
+ * @return False if the text is not a non-negative integer
+ */
+static bool parseCount(const char* text, long long& value) {
+    char* end = nullptr;
+    value = std::strtoll(text, &end, 10);
+    return end != text && *end == '\0' && value >= 0;
+}
+
+/**
+ * Format a state hash as 16 hex digits
+ * @param hash Hash value
+ * @return Hex text
+ */
+static std::string formatHash(uint64_t hash) {
+    std::ostringstream text;
+    text << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return text.str();
+}
+
+/**
+ * Re-simulate a replay from its keyframes and compare every record with the world
+ * The world is restored from the first keyframe and from every later one, so
+ * drift never accumulates for more than one keyframe interval.
+ * @param path Replay file
+ * @return Exit code (0 for success, non-zero for error)
+ */
+static int runReplay(const std::string& path) {
+    ReplayReader reader;
+    std::string error;
+    if (!reader.open(path, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    auto world = std::make_unique<PhysicsWorld>();
+    bool restored = false;
+    uint64_t keyframes = 0;
+    uint64_t deltas = 0;
+    uint64_t compared = 0;
+    uint64_t bodyTicks = 0;
+    double maxDrift = 0.0;
+    auto runStart = std::chrono::steady_clock::now();
+    while (reader.next(error)) {
+        reader.isKeyframe() ? keyframes++ : deltas++;
+        bodyTicks += reader.getBodyCount();
+
+        if (restored && reader.getTick() > world->getStepCount() && reader.getBodyCount() == world->getBodyCount()) {
+            while (world->getStepCount() < reader.getTick()) {
+                world->step(world->getTimeStep());
+            }
+            BodyStateView state = world->getBodyStore().stateView();
+            for (size_t i = 0; i < state.count; ++i) {
+                Vector3 offset = state.positions[i] - reader.getPosition(i);
+                maxDrift = std::max(maxDrift, (double)offset.magnitude());
+            }
+            compared++;
+        } else if (!reader.isKeyframe()) {
+            continue;  // Dropped ticks or changed bodies: wait for the keyframe that follows
+        }
+
+        if (reader.isKeyframe()) {
+            reader.restoreWorld(*world, error);
+            restored = true;
+        }
+    }
+    if (!error.empty()) {
+        std::cerr << path << ": " << error << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+    uint64_t records = keyframes + deltas;
+    std::cout << std::setprecision(3) << "Replay: " << records << " records (" << keyframes << " keyframes, "
+              << deltas << " deltas), " << reader.getFileSize() / 1024 << " KB, "
+              << (bodyTicks > 0 ? (double)reader.getFileSize() / bodyTicks : 0.0) << " bytes per body-tick\n"
+              << "  " << compared << " ticks re-simulated in " << seconds << " s ("
+              << (seconds > 0.0 ? compared / seconds : 0.0) << " ticks/s), max drift " << maxDrift << " m"
+              << std::endl;
+    return 0;
+}
+
+/**
+ * Run KernelCheck at every SIMD level this CPU supports
+ * @return Exit code (0 if every level passed, 1 otherwise)
+ */
+static int runKernelCheck() {
+    const size_t bodies = 4096;
+    const int steps = 240;
+    bool passed = true;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON }) {
+        if (!SimdKernels::isSupported(level)) {
+            continue;
+        }
+        KernelCheckResult result = KernelCheck::run(level, bodies, steps);
+        passed = passed && result.passed();
+        std::cout << "Kernel check (" << SimdKernels::getName(level) << ", " << bodies << " bodies, " << steps
+                  << " steps): " << (result.passed() ? "PASS" : "FAIL") << "\n"
+                  << "  vs scalar kernels: " << result.simdMismatches << " mismatches, max error "
+                  << result.simdMaxError << "\n"
+                  << "  vs per-body path: " << result.legacyMismatches << " outside tolerance, max error "
+                  << result.legacyMaxError << std::endl;
+    }
+    return passed ? 0 : 1;
+}
+
+/**
+ * Run CheckpointCheck
+ * @return Exit code (0 if every case passed, 1 otherwise)
+ */
+static int runCheckpointCheck() {
+    CheckpointCheckResult result = CheckpointCheck::run();
+    std::cout << "Checkpoint check (" << result.cases << " checkpoints): " << (result.passed() ? "PASS" : "FAIL")
+              << std::endl;
+    for (const std::string& failure : result.failures) {
+        std::cout << "  " << failure << std::endl;
+    }
+    return result.passed() ? 0 : 1;
+}
+
+/**
+ * Headless entry point: no window, no OpenGL, just the physics library
+ * @return Exit code (0 for success, non-zero for error)
+ */
+int main(int argc, char** argv) {
+    SceneDescription scene;
+    bool loadedScene = false;
+    long long ticks = 600;
+    long long ballOverride = -1;
+    long long threadOverride = -1;
+    long long reportEvery = 0;
+    long long shardCount = 1;
+    std::string loadPath;
+    std::string savePath;
+    std::string recordPath;
+    std::string replayPath;
+    bool lockstep = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        long long* target = nullptr;
+        std::string* path = nullptr;
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--lockstep") {
+            lockstep = true;
+            continue;
+        } else if (arg == "--verify-kernels") {
+            return runKernelCheck();
+        } else if (arg == "--verify-checkpoints") {
+            return runCheckpointCheck();
+        } else if (arg == "--load") {
+            path = &loadPath;
+        } else if (arg == "--save") {
+            path = &savePath;
+        } else if (arg == "--record") {
+            path = &recordPath;
+        } else if (arg == "--replay") {
+            path = &replayPath;
+        } else if (arg == "--ticks") {
+            target = &ticks;
+        } else if (arg == "--balls") {
+            target = &ballOverride;
+        } else if (arg == "--threads") {
+            target = &threadOverride;
+        } else if (arg == "--report") {
+            target = &reportEvery;
+        } else if (arg == "--shards") {
+            target = &shardCount;
+        } else if (!loadedScene && arg.compare(0, 2, "--") != 0) {
+            std::string error;
+            if (!scene.loadFile(arg, error)) {
+                std::cerr << arg << ": " << error << std::endl;
+                return 1;
+            }
+            loadedScene = true;
+            continue;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        if (path) {
+            if (i + 1 >= argc) {
+                std::cerr << arg << " needs a file name" << std::endl;
+                return 1;
+            }
+            *path = argv[++i];
+            continue;
+        }
+        if (i + 1 >= argc || !parseCount(argv[i + 1], *target)) {
+            std::cerr << arg << " needs a non-negative integer" << std::endl;
+            return 1;
+        }
+        i++;
+    }
+
+    if (!replayPath.empty()) {
+        return runReplay(replayPath);
+    }
+
+    // Default or overridden ball cloud fills the room below the ceiling
+    if (ballOverride >= 0 || (!loadedScene && scene.ballGroups.empty())) {
+        scene.ballGroups.clear();
+        scene.addBalls(ballOverride >= 0 ? (size_t)ballOverride : 10000,
+                       Vector3(scene.bounds[0] + 0.5f, scene.bounds[2] + 0.5f, scene.bounds[4] + 0.5f),
+                       Vector3(scene.bounds[1] - 0.5f, scene.bounds[3] - 0.5f, scene.bounds[5] - 0.5f), 2.0f);
+    }
+    if (threadOverride >= 0) {
+        scene.threads = (size_t)threadOverride;
+    }
+
+    auto world = std::make_unique<PhysicsWorld>();
+    auto setupStart = std::chrono::steady_clock::now();
+    scene.apply(*world);
+    if (!loadPath.empty()) {
+        std::string error;
+        auto loadStart = std::chrono::steady_clock::now();
+        if (!WorldCheckpoint::load(*world, loadPath, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        std::cout << "Loaded " << world->getBodyCount() << " bodies from " << loadPath << " in " << std::fixed
+                  << std::setprecision(3) << loadMs << " ms" << std::endl;
+    }
+    if (lockstep) {
+        world->setDeterministicEnabled(true);
+    }
+    double setupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+    size_t bodies = world->getBodyCount();
+    float timeStep = world->getTimeStep();
+    std::cout << "Scene: " << bodies << " bodies, " << world->getThreadCount() << " threads, "
+              << ticks << " ticks of " << timeStep * 1000.0f << " ms (setup " << std::fixed
+              << std::setprecision(1) << setupMs << " ms)" << std::endl;
+
+    WorldShards shards;
+    shards.setShardCount((size_t)std::max(shardCount, 1LL));
+    if (shards.getShardCount() > 1) {
+        std::cout << "Sharded into " << shards.getShardCount() << " slabs" << std::endl;
+    }
+
+    ReplayRecorder recorder;
+    if (!recordPath.empty()) {
+        std::string error;
+        if (!recorder.start(recordPath, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        recorder.capture(*world);
+    }
+
+    auto runStart = std::chrono::steady_clock::now();
+    auto reportStart = runStart;
+    for (long long tick = 1; tick <= ticks; ++tick) {
+        shards.step(*world, timeStep);
+        recorder.capture(*world);
+
+        if (reportEvery > 0 && tick % reportEvery == 0) {
+            auto now = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(now - reportStart).count();
+            reportStart = now;
+            std::cout << "  tick " << tick << ": " << std::setprecision(3) << ms / reportEvery << " ms/tick, "
+                      << world->getSleepingCount() << " sleeping";
+            if (lockstep) {
+                std::cout << ", hash " << formatHash(world->getStateHash());
+            }
+            std::cout << std::endl;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+    double ticksPerSecond = seconds > 0.0 ? ticks / seconds : 0.0;
+    double bodyStepsPerSecond = ticksPerSecond * (double)bodies;
+    double nsPerBodyStep = bodyStepsPerSecond > 0.0 ? 1e9 / bodyStepsPerSecond : 0.0;
+    std::cout << std::setprecision(3)
+              << "Simulated " << ticks * timeStep << " s in " << seconds << " s ("
+              << ticks * timeStep / (seconds > 0.0 ? seconds : 1.0) << "x real time)\n"
+              << "  " << ticksPerSecond << " ticks/s, " << seconds * 1000.0 / (ticks > 0 ? ticks : 1) << " ms/tick\n"
+              << "  " << bodyStepsPerSecond / 1e6 << " M body-steps/s, " << nsPerBodyStep << " ns per body-step\n"
+              << "  " << world->getSleepingCount() << " bodies asleep at the end" << std::endl;
+    if (lockstep) {
+        std::cout << "State hash after step " << world->getStepCount() << ": " << formatHash(world->getStateHash())
+                  << std::endl;
+    }
+
+    if (!recordPath.empty()) {
+        recorder.stop();
+        std::cout << "Recorded " << recorder.getFramesWritten() << " ticks to " << recordPath << " ("
+                  << recorder.getBytesWritten() / 1024 << " KB, " << recorder.getFramesDropped() << " dropped)"
+                  << std::endl;
+        if (recorder.hasFailed()) {
+            std::cerr << "Failed to write " << recordPath << std::endl;
+            return 1;
+        }
+    }
+    if (!savePath.empty()) {
+        std::string error;
+        if (!WorldCheckpoint::save(*world, savePath, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << "Saved checkpoint to " << savePath << std::endl;
+    }
+    return 0;
+}
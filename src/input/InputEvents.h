@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Kinds of input event delivered by the window system
+ */
+enum class InputEventType : uint8_t {
+    Key,            // Keyboard key (code = GLFW key, action = press/release/repeat)
+    MouseButton,    // Mouse button (code = GLFW button, action = press/release)
+    CursorMove,     // Cursor position (x, y in screen coordinates)
+    Scroll          // Scroll wheel (x, y offsets)
+};
+
+/**
+ * One timestamped input event
+ * The time is taken when the window system hands the event over, on the same
+ * steady clock the physics thread schedules ticks with, so commands triggered
+ * by an event can be applied at the tick it happened in.
+ */
+struct InputEvent {
+    using Clock = std::chrono::steady_clock;
+
+    InputEventType type;        // What happened
+    int code;                   // Key or button code
+    int scancode;               // System scancode (keys only)
+    int action;                 // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    int mods;                   // Modifier key bits
+    double x;                   // Cursor X / scroll X offset
+    double y;                   // Cursor Y / scroll Y offset
+    Clock::time_point time;     // When the event was received
+};
+
+/**
+ * Bounded lock-free queue with one producer and one consumer thread
+ * Each side owns one index and only reads the other's; a full queue rejects
+ * the push instead of blocking or allocating.
+ * @tparam T Element type (copyable)
+ * @tparam Capacity Slot count, a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+    T slots[Capacity];                          // Ring storage
+    alignas(64) std::atomic<size_t> head;       // Next slot to pop (owned by the consumer)
+    alignas(64) std::atomic<size_t> tail;       // Next slot to push (owned by the producer)
+
+    static constexpr size_t mask = Capacity - 1;
+
+public:
+    /**
+     * Constructor - creates an empty queue
+     */
+    SpscQueue()
+        : head(0)
+        , tail(0) {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * Append an element (producer thread only)
+     * @param value Element to copy in
+     * @return False if the queue is full
+     */
+    bool push(const T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[position & mask] = value;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest element (consumer thread only)
+     * @param value Receives the element
+     * @return False if the queue is empty
+     */
+    bool pop(T& value) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[position & mask];
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Get the number of queued elements (exact only on the consumer thread)
+     * @return Element count
+     */
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
@@ -1,20 +1,32 @@
 #pragma once
 #include <GLFW/glfw3.h>
+#include "InputEvents.h"
 #include <functional>
-#include <map>
-#include <set>
+#include <bitset>
+#include <vector>
+#include <cstdint>
 
 /**
  * InputHandler class manages keyboard and mouse input
- * Provides callback system for handling input events
+ * Provides callback system for handling input events.
+ * The GLFW callbacks only timestamp events into a lock-free queue; update()
+ * drains it once per frame, applies the events to the key bitsets and mouse
+ * state in arrival order and then calls the user callbacks.
  */
 class InputHandler {
 private:
+    static constexpr size_t keyCount = GLFW_KEY_LAST + 1;  // Key codes tracked (GLFW_KEY_UNKNOWN is ignored)
+    static constexpr size_t eventCapacity = 4096;          // Events buffered between two update() calls
+    
     GLFWwindow* window;                                    // GLFW window handle
-    std::map<int, bool> keyStates;                        // Current key states
-    std::map<int, bool> previousKeyStates;                // Previous frame key states
-    std::set<int> keysPressed;                            // Keys pressed this frame
-    std::set<int> keysReleased;                           // Keys released this frame
+    std::bitset<keyCount> keyStates;                      // Keys currently held
+    std::bitset<keyCount> keysPressed;                    // Keys pressed this frame
+    std::bitset<keyCount> keysReleased;                   // Keys released this frame
+    
+    // Event path
+    SpscQueue<InputEvent, eventCapacity> events;          // Filled by the GLFW callbacks
+    std::vector<InputEvent> frameEvents;                  // Events drained by the last update()
+    uint64_t droppedEvents;                               // Events lost to a full queue
     
     // Mouse state
     double mouseX, mouseY;                                // Current mouse position
@@ -36,6 +48,7 @@ public:
      */
     InputHandler(GLFWwindow* win) 
         : window(win)
+        , droppedEvents(0)
         , mouseX(0.0)
         , mouseY(0.0)
         , lastMouseX(0.0)
@@ -44,6 +57,7 @@ public:
         , mouseDeltaY(0.0)
         , firstMouse(true)
         , mouseGrabbed(false) {
+        frameEvents.reserve(eventCapacity);
         
         // Set up GLFW callbacks
         glfwSetWindowUserPointer(window, this);
@@ -54,28 +68,19 @@ public:
     }
 
     /**
-     * Update input state - call this every frame
-     * Processes key press/release events and updates mouse delta
+     * Update input state - call this every frame after glfwPollEvents()
+     * Applies the queued events in order, runs the user callbacks and updates mouse delta
      */
     void update() {
-        // Update previous key states
-        previousKeyStates = keyStates;
-        
         // Clear frame-specific sets
-        keysPressed.clear();
-        keysReleased.clear();
+        keysPressed.reset();
+        keysReleased.reset();
+        frameEvents.clear();
         
-        // Check for key state changes
-        for (auto& pair : keyStates) {
-            int key = pair.first;
-            bool currentState = pair.second;
-            bool previousState = previousKeyStates[key];
-            
-            if (currentState && !previousState) {
-                keysPressed.insert(key);
-            } else if (!currentState && previousState) {
-                keysReleased.insert(key);
-            }
+        InputEvent event;
+        while (events.pop(event)) {
+            frameEvents.push_back(event);
+            applyEvent(event);
         }
         
         // Update mouse delta
@@ -97,8 +102,7 @@ public:
      * @return True if key is pressed
      */
     bool isKeyPressed(int key) const {
-        auto it = keyStates.find(key);
-        return it != keyStates.end() && it->second;
+        return isKeyCode(key) && keyStates.test((size_t)key);
     }
 
     /**
@@ -107,7 +111,7 @@ public:
      * @return True if key was just pressed
      */
     bool wasKeyPressed(int key) const {
-        return keysPressed.count(key) > 0;
+        return isKeyCode(key) && keysPressed.test((size_t)key);
     }
 
     /**
@@ -116,7 +120,23 @@ public:
      * @return True if key was just released
      */
     bool wasKeyReleased(int key) const {
-        return keysReleased.count(key) > 0;
+        return isKeyCode(key) && keysReleased.test((size_t)key);
+    }
+
+    /**
+     * Get the events applied by the last update(), oldest first
+     * @return Timestamped events of this frame
+     */
+    const std::vector<InputEvent>& getFrameEvents() const {
+        return frameEvents;
+    }
+
+    /**
+     * Get the number of events dropped because the queue was full
+     * @return Dropped event count
+     */
+    uint64_t getDroppedEventCount() const {
+        return droppedEvents;
     }
 
     /**
@@ -220,7 +240,7 @@ private:
     static void keyCallbackStatic(GLFWwindow* window, int key, int scancode, int action, int mods) {
         InputHandler* handler = static_cast<InputHandler*>(glfwGetWindowUserPointer(window));
         if (handler) {
-            handler->keyCallbackImpl(key, scancode, action, mods);
+            handler->enqueue({ InputEventType::Key, key, scancode, action, mods, 0.0, 0.0, InputEvent::Clock::now() });
         }
     }
 
@@ -233,7 +253,7 @@ private:
     static void mouseCallbackStatic(GLFWwindow* window, double xpos, double ypos) {
         InputHandler* handler = static_cast<InputHandler*>(glfwGetWindowUserPointer(window));
         if (handler) {
-            handler->mouseCallbackImpl(xpos, ypos);
+            handler->enqueue({ InputEventType::CursorMove, 0, 0, 0, 0, xpos, ypos, InputEvent::Clock::now() });
         }
     }
 
@@ -247,7 +267,7 @@ private:
     static void mouseButtonCallbackStatic(GLFWwindow* window, int button, int action, int mods) {
         InputHandler* handler = static_cast<InputHandler*>(glfwGetWindowUserPointer(window));
         if (handler) {
-            handler->mouseButtonCallbackImpl(button, action, mods);
+            handler->enqueue({ InputEventType::MouseButton, button, 0, action, mods, 0.0, 0.0, InputEvent::Clock::now() });
         }
     }
 
@@ -260,7 +280,47 @@ private:
     static void scrollCallbackStatic(GLFWwindow* window, double xoffset, double yoffset) {
         InputHandler* handler = static_cast<InputHandler*>(glfwGetWindowUserPointer(window));
         if (handler) {
-            handler->scrollCallbackImpl(xoffset, yoffset);
+            handler->enqueue({ InputEventType::Scroll, 0, 0, 0, 0, xoffset, yoffset, InputEvent::Clock::now() });
+        }
+    }
+
+    /**
+     * Check whether a key code has a slot in the key bitsets
+     * @param key GLFW key code
+     * @return True for codes 0..GLFW_KEY_LAST
+     */
+    static bool isKeyCode(int key) {
+        return key >= 0 && (size_t)key < keyCount;
+    }
+
+    /**
+     * Queue an event from a GLFW callback
+     * @param event Timestamped event
+     */
+    void enqueue(const InputEvent& event) {
+        if (!events.push(event)) {
+            droppedEvents++;
+        }
+    }
+
+    /**
+     * Apply one drained event to the input state and the user callbacks
+     * @param event Event to apply
+     */
+    void applyEvent(const InputEvent& event) {
+        switch (event.type) {
+            case InputEventType::Key:
+                keyCallbackImpl(event.code, event.scancode, event.action, event.mods);
+                break;
+            case InputEventType::MouseButton:
+                mouseButtonCallbackImpl(event.code, event.action, event.mods);
+                break;
+            case InputEventType::CursorMove:
+                mouseCallbackImpl(event.x, event.y);
+                break;
+            case InputEventType::Scroll:
+                scrollCallbackImpl(event.x, event.y);
+                break;
         }
     }
 
@@ -272,10 +332,19 @@ private:
      * @param mods Modifier keys
      */
     void keyCallbackImpl(int key, int scancode, int action, int mods) {
-        if (action == GLFW_PRESS) {
-            keyStates[key] = true;
-        } else if (action == GLFW_RELEASE) {
-            keyStates[key] = false;
+        if (isKeyCode(key)) {
+            size_t slot = (size_t)key;
+            if (action == GLFW_PRESS) {
+                if (!keyStates.test(slot)) {
+                    keysPressed.set(slot);
+                }
+                keyStates.set(slot);
+            } else if (action == GLFW_RELEASE) {
+                if (keyStates.test(slot)) {
+                    keysReleased.set(slot);
+                }
+                keyStates.reset(slot);
+            }
         }
         
         // Call user callback if set
@@ -5,9 +5,10 @@
 /**
  * Main entry point for the 3D Physics Engine
  * Initializes the game engine and runs the main game loop
+ * Usage: 3DPhysicsEngine [--script <file>]
  * @return Exit code (0 for success, non-zero for error)
  */
-int main() {
+int main(int argc, char* argv[]) {
     try {
         // Create game instance
         auto game = std::make_unique<Game>();
@@ -18,6 +19,20 @@ int main() {
             return -1;
         }
         
+        // Queue a console script (load scenarios, benchmarks) for the first frames
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--script" && i + 1 < argc) {
+                if (!game->queueScript(argv[++i])) {
+                    std::cerr << "Cannot read script: " << argv[i] << std::endl;
+                    return -1;
+                }
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--script <file>]" << std::endl;
+                return -1;
+            }
+        }
+        
         // Run the main game loop
         game->Run();
         
@@ -1,7 +1,10 @@
 #pragma once
 #include "PhysicsBody.h"
-#include <random>
+#include "CounterRng.h"
 #include <string>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
 
 /**
  * Ball class representing a bouncy sphere in the physics simulation
@@ -9,62 +12,66 @@
  */
 class Ball : public PhysicsBody {
 public:
-    Vector3 color;          // RGB color of the ball (0.0 to 1.0)
-    bool isHeld;            // True if ball is being held by player
-    float spinDamping;      // How quickly the ball stops spinning
-    static int ballCount;   // Static counter for total balls created
+    static inline std::atomic<int> ballCount{0};  // Total balls created (shards create balls concurrently)
     int ballId;             // Unique identifier for this ball
 
     /**
-     * Default constructor - creates a ball with random color
+     * Constructor - binds a ball proxy to a body slot and gives it a random color
+     * @param bodyStore Store holding the body state
+     * @param bodyHandle Handle of the body in the store
      */
-    Ball() : PhysicsBody(), isHeld(false), spinDamping(0.95f) {
+    Ball(BodyStore& bodyStore, BodyHandle bodyHandle) : PhysicsBody(bodyStore, bodyHandle) {
         ballId = ++ballCount;
         generateRandomColor();
-        
-        // Set ball-specific physics properties
-        mass = 0.5f;            // 500 grams
-        radius = 0.25f;         // 25 cm radius
-        restitution = 0.8f;     // Very bouncy
-        friction = 0.3f;        // Low friction for rolling
+        initializeBallProperties();
     }
 
     /**
-     * Constructor with position
-     * @param pos Initial position of the ball
+     * Constructor with color
+     * @param bodyStore Store holding the body state
+     * @param bodyHandle Handle of the body in the store
+     * @param col RGB color of the ball
      */
-    Ball(const Vector3& pos) : PhysicsBody(pos, 0.5f, 0.25f), isHeld(false), spinDamping(0.95f) {
+    Ball(BodyStore& bodyStore, BodyHandle bodyHandle, const Vector3& col)
+        : PhysicsBody(bodyStore, bodyHandle) {
         ballId = ++ballCount;
-        generateRandomColor();
-        
-        // Set ball-specific physics properties
-        restitution = 0.8f;     // Very bouncy
-        friction = 0.3f;        // Low friction for rolling
+        color() = col;
+        initializeBallProperties();
     }
 
     /**
-     * Constructor with position and color
-     * @param pos Initial position of the ball
-     * @param col RGB color of the ball
+     * Check if ball is being held by player
+     * @return True if held
      */
-    Ball(const Vector3& pos, const Vector3& col) 
-        : PhysicsBody(pos, 0.5f, 0.25f), color(col), isHeld(false), spinDamping(0.95f) {
-        ballId = ++ballCount;
-        
-        // Set ball-specific physics properties
-        restitution = 0.8f;     // Very bouncy
-        friction = 0.3f;        // Low friction for rolling
+    bool isHeld() const {
+        return (store->flags[slot()] & BODY_HELD) != 0;
+    }
+
+    /**
+     * Get how quickly the ball stops spinning
+     * @return Per-step velocity damping factor
+     */
+    float getSpinDamping() const {
+        return store->spinDampings[slot()];
+    }
+
+    /**
+     * Set how quickly the ball stops spinning
+     * @param damping Per-step velocity damping factor
+     */
+    void setSpinDamping(float damping) {
+        store->spinDampings[slot()] = damping;
     }
 
     /**
      * Generate a random bright color for the ball
+     * Drawn from the ball's handle, so a replayed or lockstep world colors its balls identically
      */
     void generateRandomColor() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<float> dis(0.3f, 1.0f);
-        
-        color = Vector3(dis(gen), dis(gen), dis(gen));
+        uint64_t key = randomKey();
+        color() = Vector3(0.3f + 0.7f * CounterRng::uniform(key, 0),
+                          0.3f + 0.7f * CounterRng::uniform(key, 1),
+                          0.3f + 0.7f * CounterRng::uniform(key, 2));
     }
 
     /**
@@ -74,20 +81,22 @@ public:
      */
     void bounce(const Vector3& normal, float impactVelocity) {
         // Calculate bounce direction
-        Vector3 bounceDirection = velocity - normal * (2.0f * velocity.dot(normal));
+        Vector3 bounceDirection = velocity() - normal * (2.0f * velocity().dot(normal));
         
         // Apply restitution with some randomness for realistic bounce
-        float bounceStrength = restitution * impactVelocity;
-        
-        // Add slight randomness to make bounces more interesting
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<float> randomness(-0.1f, 0.1f);
+        float bounceStrength = getRestitution() * impactVelocity;
         
-        Vector3 randomVector(randomness(gen), randomness(gen), randomness(gen));
+        // Add slight randomness to make bounces more interesting, keyed on the
+        // ball and its impact so the same bounce always scatters the same way
+        uint32_t impactBits;
+        std::memcpy(&impactBits, &impactVelocity, sizeof(impactBits));
+        uint64_t key = CounterRng::combine(randomKey(), impactBits);
+        Vector3 randomVector((CounterRng::uniform(key, 0) - 0.5f) * 0.2f,
+                             (CounterRng::uniform(key, 1) - 0.5f) * 0.2f,
+                             (CounterRng::uniform(key, 2) - 0.5f) * 0.2f);
         bounceDirection += randomVector;
         
-        velocity = bounceDirection.normalized() * bounceStrength;
+        velocity() = bounceDirection.normalized() * bounceStrength;
     }
 
     /**
@@ -95,12 +104,12 @@ public:
      * @param held True if ball is being held
      */
     void setHeld(bool held) {
-        isHeld = held;
+        setFlag(BODY_HELD, held);
+        wake();
         if (held) {
             // Stop the ball when picked up
-            velocity = Vector3::ZERO;
-            acceleration = Vector3::ZERO;
-            force = Vector3::ZERO;
+            velocity() = Vector3::ZERO;
+            force() = Vector3::ZERO;
         }
     }
 
@@ -109,21 +118,23 @@ public:
      * @param throwVelocity Velocity to throw the ball with
      */
     void throwBall(const Vector3& throwVelocity) {
-        if (isHeld) {
-            isHeld = false;
-            velocity = throwVelocity;
+        if (isHeld()) {
+            setFlag(BODY_HELD, false);
+            wake();
+            velocity() = throwVelocity;
             
             // Add slight upward component to make throwing feel natural
-            velocity.y += 2.0f;
+            velocity().y += 2.0f;
         }
     }
 
     /**
      * Update ball physics with ball-specific behaviors
+     * Scalar reference for the ball path of PhysicsWorld's batched integrator
      * @param deltaTime Time step in seconds
      */
     void update(float deltaTime) override {
-        if (isHeld) {
+        if (isHeld()) {
             // Ball is being held, don't update physics
             return;
         }
@@ -132,16 +143,18 @@ public:
         PhysicsBody::update(deltaTime);
         
         // Apply spin damping
-        velocity *= spinDamping;
+        velocity() *= getSpinDamping();
         
         // Ensure ball doesn't fall through floor (basic floor collision)
-        if (position.y < radius) {
-            position.y = radius;
-            if (velocity.y < 0) {
-                velocity.y = -velocity.y * restitution;
+        Vector3& pos = position();
+        Vector3& vel = velocity();
+        if (pos.y < getRadius()) {
+            pos.y = getRadius();
+            if (vel.y < 0) {
+                vel.y = -vel.y * getRestitution();
                 
                 // Add bounce sound trigger or effect here if needed
-                if (velocity.y > 1.0f) {
+                if (vel.y > 1.0f) {
                     // Significant bounce - could trigger sound effect
                 }
             }
@@ -153,7 +166,7 @@ public:
      * @return True if ball is moving
      */
     bool isMoving() const {
-        return velocity.magnitude() > 0.1f;
+        return velocity().magnitude() > 0.1f;
     }
 
     /**
@@ -161,7 +174,7 @@ public:
      * @return Kinetic energy (0.5 * mass * velocity^2)
      */
     float getKineticEnergy() const {
-        return 0.5f * mass * velocity.magnitudeSquared();
+        return 0.5f * getMass() * velocity().magnitudeSquared();
     }
 
     /**
@@ -169,11 +182,11 @@ public:
      * @param safePosition Position to reset to
      */
     void resetToPosition(const Vector3& safePosition) {
-        position = safePosition;
-        velocity = Vector3::ZERO;
-        acceleration = Vector3::ZERO;
-        force = Vector3::ZERO;
-        isHeld = false;
+        position() = safePosition;
+        velocity() = Vector3::ZERO;
+        force() = Vector3::ZERO;
+        setFlag(BODY_HELD, false);
+        wake();
     }
 
     /**
@@ -182,11 +195,32 @@ public:
      */
     std::string toString() const {
         return "Ball " + std::to_string(ballId) + 
-               " at " + position.toString() + 
-               " with velocity " + velocity.toString() +
-               (isHeld ? " (HELD)" : "");
+               " at " + position().toString() + 
+               " with velocity " + velocity().toString() +
+               (isHeld() ? " (HELD)" : "");
     }
-};
 
-// Initialize static counter
-int Ball::ballCount = 0; 
\ No newline at end of file
+private:
+    /**
+     * Set ball-specific physics properties on the body slot
+     */
+    void initializeBallProperties() {
+        uint32_t i = slot();
+        store->flags[i] |= BODY_BALL;
+        store->spinDampings[i] = 0.95f;
+        setMass(0.5f);          // 500 grams
+        setRadius(0.25f);       // 25 cm radius
+        setRestitution(0.8f);   // Very bouncy
+        setFriction(0.3f);      // Low friction for rolling
+    }
+
+    /**
+     * Key of this ball's random stream
+     * @return Key derived from the ball's handle
+     */
+    uint64_t randomKey() const {
+        BodyHandle bodyHandle = getHandle();
+        return CounterRng::combine(CounterRng::mix(bodyHandle.index), bodyHandle.generation);
+    }
+};
+ 
\ No newline at end of file
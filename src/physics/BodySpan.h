@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * Non-owning view over an array of body pointers
+ * Returned by PhysicsWorld queries so callers can walk bodies without copying
+ * them into a new vector. The view is invalidated when bodies are added or removed.
+ */
+template <typename T>
+class BodySpan {
+private:
+    T* const* items;    // First pointer in the viewed array
+    size_t count;       // Number of pointers in the view
+
+public:
+    /**
+     * Constructor - views count pointers starting at first
+     * @param first First pointer in the array
+     * @param size Number of pointers
+     */
+    BodySpan(T* const* first, size_t size)
+        : items(first)
+        , count(size) {
+    }
+
+    T* const* begin() const { return items; }
+    T* const* end() const { return items + count; }
+
+    /**
+     * Get the number of bodies in the view
+     * @return Body count
+     */
+    size_t size() const {
+        return count;
+    }
+
+    /**
+     * Check whether the view is empty
+     * @return True if there are no bodies
+     */
+    bool empty() const {
+        return count == 0;
+    }
+
+    /**
+     * Get a body by position in the view
+     * @param index Position in [0, size())
+     * @return Body pointer
+     */
+    T* operator[](size_t index) const {
+        return items[index];
+    }
+};
@@ -0,0 +1,457 @@
+#pragma once
+#include "Vector3.h"
+#include "Shapes.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+class PhysicsBody;
+
+/**
+ * Per-body state flags kept in the BodyStore flags array
+ */
+enum BodyFlags : uint8_t {
+    BODY_ACTIVE = 1 << 0,   // Body is simulated and collides
+    BODY_STATIC = 1 << 1,   // Body never moves (infinite mass)
+    BODY_HELD   = 1 << 2,   // Ball is being held by the player
+    BODY_BALL   = 1 << 3,   // Body gets ball-specific integration (floor clamp)
+    BODY_SLEEPING = 1 << 4, // Body is at rest and skipped by the simulation until woken
+    BODY_SHAPED = 1 << 5    // Body is not a sphere (see shapes); the boundary pass clamps its extents
+};
+
+/**
+ * Stable generational handle to a body in a BodyStore
+ * Handles stay valid while other bodies are added or removed. Destroying a
+ * body bumps its slot's generation, so old handles to a reused slot go stale
+ * instead of aliasing the new body (check with BodyStore::isAlive).
+ */
+struct BodyHandle {
+    static constexpr uint32_t invalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = invalidIndex;  // Slot in the store's handle table
+    uint32_t generation = 0;        // Generation of the slot when the handle was issued
+
+    bool isValid() const {
+        return index != invalidIndex;
+    }
+
+    bool operator==(const BodyHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const BodyHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Read-only view of the persistent dense arrays of a BodyStore
+ * Lets body state be saved from a store or restored from memory the store does
+ * not own (such as a memory-mapped checkpoint). Proxies and handles are not part
+ * of the state: they are rebuilt by whoever restores the bodies.
+ */
+struct BodyStateView {
+    size_t count = 0;                       // Number of bodies
+    const Vector3* positions = nullptr;
+    const Vector3* velocities = nullptr;
+    const Vector3* forces = nullptr;
+    const float* masses = nullptr;
+    const float* inverseMasses = nullptr;
+    const float* radii = nullptr;
+    const float* restitutions = nullptr;
+    const float* frictions = nullptr;
+    const float* spinDampings = nullptr;
+    const Vector3* colors = nullptr;
+    const uint8_t* flags = nullptr;
+    const uint16_t* restSteps = nullptr;
+    const uint8_t* shapes = nullptr;         // Optional: every body is a sphere when absent
+    const Vector3* extents = nullptr;        // Optional, present with shapes
+    const uint32_t* handleSlots = nullptr;   // Optional: handle slot of each body
+};
+
+/**
+ * Structure-of-arrays storage for physics body state
+ * Live bodies are packed densely so the simulation can run tight loops over
+ * each array; handles map onto dense indices through an indirection table
+ */
+class BodyStore {
+public:
+    // Dense per-body arrays, all indexed by the same dense index
+    std::vector<Vector3> positions;         // Position in world space
+    std::vector<Vector3> velocities;        // Linear velocity
+    std::vector<Vector3> forces;            // Accumulated force for the next step
+    std::vector<float> masses;              // Mass (kg)
+    std::vector<float> inverseMasses;       // 1 / mass, or 0 for static bodies
+    std::vector<float> radii;               // Collision sphere radius
+    std::vector<float> restitutions;        // Bounciness coefficient
+    std::vector<float> frictions;           // Friction coefficient
+    std::vector<float> spinDampings;        // Per-step velocity damping (1 = none)
+    std::vector<Vector3> colors;            // Render color (0.0 to 1.0)
+    std::vector<uint8_t> flags;             // BodyFlags bit set
+    std::vector<uint16_t> restSteps;        // Consecutive steps spent under the sleep energy threshold
+    std::vector<uint8_t> shapes;            // ShapeType
+    std::vector<Vector3> extents;           // Shape dimensions (see ShapeType)
+    std::vector<PhysicsBody*> owners;       // Proxy object for each body
+    std::vector<uint32_t> denseToHandle;    // Handle slot for each dense index
+
+private:
+    std::vector<uint32_t> handleToDense;    // Dense index for each handle slot
+    std::vector<uint32_t> handleGenerations; // Current generation of each handle slot
+    std::vector<uint32_t> freeHandles;      // Released handle slots available for reuse
+    uint64_t revision = 0;                  // Bumped whenever bodies are added, removed, replaced or reshaped
+
+public:
+    /**
+     * Create a sphere body with default material properties
+     * @param position Initial position
+     * @param mass Mass of the body
+     * @param radius Collision radius
+     * @param slot Handle slot to use, or BodyHandle::invalidIndex for any free one;
+     *             a requested slot must not hold a live body
+     * @return Handle to the new body
+     */
+    BodyHandle create(const Vector3& position, float mass, float radius,
+                      uint32_t slot = BodyHandle::invalidIndex) {
+        uint32_t dense = (uint32_t)positions.size();
+        revision++;
+
+        positions.push_back(position);
+        velocities.push_back(Vector3::ZERO);
+        forces.push_back(Vector3::ZERO);
+        masses.push_back(mass);
+        inverseMasses.push_back(1.0f / mass);
+        radii.push_back(radius);
+        restitutions.push_back(0.7f);
+        frictions.push_back(0.5f);
+        spinDampings.push_back(1.0f);
+        colors.push_back(Vector3(1.0f, 1.0f, 1.0f));
+        flags.push_back(BODY_ACTIVE);
+        restSteps.push_back(0);
+        shapes.push_back((uint8_t)ShapeType::Sphere);
+        extents.push_back(Vector3(radius, radius, radius));
+        owners.push_back(nullptr);
+
+        // Requested slots stay on the free list; skip any that were taken that way
+        while (slot == BodyHandle::invalidIndex && !freeHandles.empty() &&
+               handleToDense[freeHandles.back()] != BodyHandle::invalidIndex) {
+            freeHandles.pop_back();
+        }
+
+        BodyHandle handle;
+        if (slot != BodyHandle::invalidIndex) {
+            handle.index = slot;
+            if (slot >= handleToDense.size()) {
+                handleToDense.resize(slot + 1, BodyHandle::invalidIndex);
+                handleGenerations.resize(slot + 1, 0);
+            }
+            handleToDense[slot] = dense;
+        } else if (!freeHandles.empty()) {
+            handle.index = freeHandles.back();
+            freeHandles.pop_back();
+            handleToDense[handle.index] = dense;
+        } else {
+            handle.index = (uint32_t)handleToDense.size();
+            handleToDense.push_back(dense);
+            handleGenerations.push_back(0);
+        }
+        handle.generation = handleGenerations[handle.index];
+        denseToHandle.push_back(handle.index);
+
+        return handle;
+    }
+
+    /**
+     * Destroy a body, moving the last body into its dense slot
+     * @param handle Handle of the body to destroy
+     */
+    void destroy(BodyHandle handle) {
+        uint32_t dense = handleToDense[handle.index];
+        uint32_t last = (uint32_t)positions.size() - 1;
+        revision++;
+
+        if (dense != last) {
+            positions[dense] = positions[last];
+            velocities[dense] = velocities[last];
+            forces[dense] = forces[last];
+            masses[dense] = masses[last];
+            inverseMasses[dense] = inverseMasses[last];
+            radii[dense] = radii[last];
+            restitutions[dense] = restitutions[last];
+            frictions[dense] = frictions[last];
+            spinDampings[dense] = spinDampings[last];
+            colors[dense] = colors[last];
+            flags[dense] = flags[last];
+            restSteps[dense] = restSteps[last];
+            shapes[dense] = shapes[last];
+            extents[dense] = extents[last];
+            owners[dense] = owners[last];
+            denseToHandle[dense] = denseToHandle[last];
+            handleToDense[denseToHandle[dense]] = dense;
+        }
+
+        positions.pop_back();
+        velocities.pop_back();
+        forces.pop_back();
+        masses.pop_back();
+        inverseMasses.pop_back();
+        radii.pop_back();
+        restitutions.pop_back();
+        frictions.pop_back();
+        spinDampings.pop_back();
+        colors.pop_back();
+        flags.pop_back();
+        restSteps.pop_back();
+        shapes.pop_back();
+        extents.pop_back();
+        owners.pop_back();
+        denseToHandle.pop_back();
+
+        releaseHandle(handle.index);
+    }
+
+    /**
+     * Check whether a handle still refers to a live body
+     * @param handle Body handle
+     * @return False if the handle is invalid or its body was destroyed
+     */
+    bool isAlive(BodyHandle handle) const {
+        return handle.index < handleToDense.size() &&
+               handleGenerations[handle.index] == handle.generation &&
+               handleToDense[handle.index] != BodyHandle::invalidIndex;
+    }
+
+    /**
+     * Get the handle of the body at a dense index
+     * @param dense Index into the dense arrays
+     * @return Current handle of that body
+     */
+    BodyHandle handleAt(uint32_t dense) const {
+        BodyHandle handle;
+        handle.index = denseToHandle[dense];
+        handle.generation = handleGenerations[handle.index];
+        return handle;
+    }
+
+    /**
+     * Look up the dense index of a body
+     * @param handle Body handle
+     * @return Index into the dense arrays
+     */
+    uint32_t denseIndex(BodyHandle handle) const {
+        return handleToDense[handle.index];
+    }
+
+    /**
+     * Reserve capacity in every array
+     * @param count Number of bodies to reserve for
+     */
+    void reserve(size_t count) {
+        positions.reserve(count);
+        velocities.reserve(count);
+        forces.reserve(count);
+        masses.reserve(count);
+        inverseMasses.reserve(count);
+        radii.reserve(count);
+        restitutions.reserve(count);
+        frictions.reserve(count);
+        spinDampings.reserve(count);
+        colors.reserve(count);
+        flags.reserve(count);
+        restSteps.reserve(count);
+        shapes.reserve(count);
+        extents.reserve(count);
+        owners.reserve(count);
+        denseToHandle.reserve(count);
+        handleToDense.reserve(count);
+        handleGenerations.reserve(count);
+    }
+
+    /**
+     * Remove every body and release all handles
+     * Handle slots are kept (with bumped generations) so old handles stay stale
+     */
+    void clear() {
+        revision++;
+        for (uint32_t index : denseToHandle) {
+            releaseHandle(index);
+        }
+
+        positions.clear();
+        velocities.clear();
+        forces.clear();
+        masses.clear();
+        inverseMasses.clear();
+        radii.clear();
+        restitutions.clear();
+        frictions.clear();
+        spinDampings.clear();
+        colors.clear();
+        flags.clear();
+        restSteps.clear();
+        shapes.clear();
+        extents.clear();
+        owners.clear();
+        denseToHandle.clear();
+    }
+
+    /**
+     * Get the number of live bodies
+     * @return Body count
+     */
+    size_t size() const {
+        return positions.size();
+    }
+
+    /**
+     * Get the layout revision of the store
+     * Changes whenever bodies are added, removed, overwritten from saved state
+     * or given a new shape, so caches keyed on dense indices can tell they are stale
+     * @return Revision counter
+     */
+    uint64_t getRevision() const {
+        return revision;
+    }
+
+    /**
+     * View the persistent state of every body
+     * @return View valid until bodies are added or removed
+     */
+    BodyStateView stateView() const {
+        BodyStateView view;
+        view.count = size();
+        view.positions = positions.data();
+        view.velocities = velocities.data();
+        view.forces = forces.data();
+        view.masses = masses.data();
+        view.inverseMasses = inverseMasses.data();
+        view.radii = radii.data();
+        view.restitutions = restitutions.data();
+        view.frictions = frictions.data();
+        view.spinDampings = spinDampings.data();
+        view.colors = colors.data();
+        view.flags = flags.data();
+        view.restSteps = restSteps.data();
+        view.shapes = shapes.data();
+        view.extents = extents.data();
+        view.handleSlots = denseToHandle.data();
+        return view;
+    }
+
+    /**
+     * Overwrite the state of the first bodies with saved state
+     * @param state Saved state; state.count must not exceed size()
+     */
+    void assignState(const BodyStateView& state) {
+        size_t n = state.count;
+        revision++;
+        std::copy(state.positions, state.positions + n, positions.begin());
+        std::copy(state.velocities, state.velocities + n, velocities.begin());
+        std::copy(state.forces, state.forces + n, forces.begin());
+        std::copy(state.masses, state.masses + n, masses.begin());
+        std::copy(state.inverseMasses, state.inverseMasses + n, inverseMasses.begin());
+        std::copy(state.radii, state.radii + n, radii.begin());
+        std::copy(state.restitutions, state.restitutions + n, restitutions.begin());
+        std::copy(state.frictions, state.frictions + n, frictions.begin());
+        std::copy(state.spinDampings, state.spinDampings + n, spinDampings.begin());
+        std::copy(state.colors, state.colors + n, colors.begin());
+        std::copy(state.flags, state.flags + n, flags.begin());
+        std::copy(state.restSteps, state.restSteps + n, restSteps.begin());
+        if (state.shapes) {
+            std::copy(state.shapes, state.shapes + n, shapes.begin());
+            std::copy(state.extents, state.extents + n, extents.begin());
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                shapes[i] = (uint8_t)ShapeType::Sphere;
+                extents[i] = Vector3(radii[i], radii[i], radii[i]);
+            }
+        }
+    }
+
+    /**
+     * Move every body onto the given handle slots
+     * Restores the slot layout of saved state, so anything keyed on handle slots
+     * (collision jitter, the state hash) matches the world it was saved from.
+     * Generations are left as they are, so handles issued before stay stale.
+     * @param slots Handle slot for each dense index, all distinct
+     */
+    void assignHandleSlots(const uint32_t* slots) {
+        revision++;
+        for (uint32_t index : denseToHandle) {
+            handleToDense[index] = BodyHandle::invalidIndex;
+        }
+        for (size_t dense = 0; dense < denseToHandle.size(); ++dense) {
+            uint32_t index = slots[dense];
+            if (index >= handleToDense.size()) {
+                handleToDense.resize(index + 1, BodyHandle::invalidIndex);
+                handleGenerations.resize(index + 1, 0);
+            }
+            denseToHandle[dense] = index;
+            handleToDense[index] = (uint32_t)dense;
+        }
+
+        // Lowest free slot is handed out first, as in a store that never released any
+        freeHandles.clear();
+        for (size_t index = handleToDense.size(); index-- > 0;) {
+            if (handleToDense[index] == BodyHandle::invalidIndex) {
+                freeHandles.push_back((uint32_t)index);
+            }
+        }
+    }
+
+    /**
+     * Overwrite the state of one body with one body of other state
+     * @param dense Dense index of the body to overwrite
+     * @param state Source state
+     * @param index Dense index of the source body within state
+     */
+    void assignBody(uint32_t dense, const BodyStateView& state, size_t index) {
+        revision++;
+        positions[dense] = state.positions[index];
+        velocities[dense] = state.velocities[index];
+        forces[dense] = state.forces[index];
+        masses[dense] = state.masses[index];
+        inverseMasses[dense] = state.inverseMasses[index];
+        radii[dense] = state.radii[index];
+        restitutions[dense] = state.restitutions[index];
+        frictions[dense] = state.frictions[index];
+        spinDampings[dense] = state.spinDampings[index];
+        colors[dense] = state.colors[index];
+        flags[dense] = state.flags[index];
+        restSteps[dense] = state.restSteps[index];
+        shapes[dense] = state.shapes ? state.shapes[index] : (uint8_t)ShapeType::Sphere;
+        extents[dense] = state.extents ? state.extents[index] : Vector3(radii[dense], radii[dense], radii[dense]);
+    }
+
+    /**
+     * Give a body a collision shape
+     * Also sets the bounding radius used by the broadphase and continuous
+     * collision, and the BODY_SHAPED flag
+     * @param dense Dense index of the body
+     * @param shape Shape type
+     * @param shapeExtents Shape dimensions as described by ShapeType
+     */
+    void setShape(uint32_t dense, ShapeType shape, const Vector3& shapeExtents) {
+        revision++;
+        shapes[dense] = (uint8_t)shape;
+        extents[dense] = shape == ShapeType::Sphere ? Vector3(shapeExtents.x, shapeExtents.x, shapeExtents.x)
+                                                    : shapeExtents;
+        radii[dense] = shape == ShapeType::Sphere  ? shapeExtents.x
+                     : shape == ShapeType::Box     ? shapeExtents.magnitude()
+                     : shape == ShapeType::Capsule ? shapeExtents.y
+                     : 0.0f;
+        flags[dense] = shape == ShapeType::Sphere ? (uint8_t)(flags[dense] & ~BODY_SHAPED)
+                                                  : (uint8_t)(flags[dense] | BODY_SHAPED);
+    }
+
+private:
+    /**
+     * Invalidate a handle slot and make it available for reuse
+     * @param index Handle slot
+     */
+    void releaseHandle(uint32_t index) {
+        handleToDense[index] = BodyHandle::invalidIndex;
+        handleGenerations[index]++;
+        freeHandles.push_back(index);
+    }
+};
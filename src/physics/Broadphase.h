@@ -0,0 +1,534 @@
+#pragma once
+#include "Vector3.h"
+#include "BodyStore.h"
+#include "JobSystem.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+/**
+ * Broadphase collision detection modes
+ */
+enum class BroadphaseMode {
+    BruteForce,     // All-pairs O(n²) test, kept as the reference path
+    UniformGrid     // Uniform grid sized from world bounds and largest radius
+};
+
+/**
+ * Uniform grid broadphase for sphere bodies
+ * Buckets bodies into cells at least as wide as the largest diameter, so any
+ * touching pair is guaranteed to share a cell or sit in neighbouring cells
+ */
+class UniformGridBroadphase {
+public:
+    using Pair = std::pair<uint32_t, uint32_t>;
+
+private:
+    float origin[3];                    // Minimum corner of the grid (world bounds min)
+    float cellSize;                     // Edge length of one grid cell
+    float inverseCellSize;              // Cached 1 / cellSize
+    int dims[3];                        // Number of cells along each axis
+
+    std::vector<uint32_t> bodyCell;     // Cell index of every body
+    std::vector<uint32_t> cellStart;    // Prefix offsets into cellBodies (cellCount + 1 entries)
+    std::vector<uint32_t> cellBodies;   // Body indices sorted by cell
+    std::vector<uint32_t> cellAwake;    // Number of awake bodies in each cell
+    const uint8_t* bodyFlags;           // Body flags of the current build (nullptr = all awake)
+    std::vector<Pair> pairs;            // Candidate pairs from the last build
+
+    /**
+     * Pair output and scratch space for one chunk of bodies
+     */
+    struct PairChunk {
+        std::vector<Pair> pairs;            // Pairs whose first body lies in this chunk
+        std::vector<uint32_t> neighbours;   // Scratch list of candidates for a single body
+    };
+    std::vector<PairChunk> chunks;      // Per-chunk pair buffers, reused across builds
+
+    static constexpr size_t maxCells = 1u << 21;        // Cap on grid size for tiny radii
+    static constexpr size_t pairChunkSize = 1024;       // Bodies per pair-gathering chunk
+
+public:
+    /**
+     * Constructor - creates an empty grid
+     */
+    UniformGridBroadphase()
+        : cellSize(1.0f)
+        , inverseCellSize(1.0f)
+        , bodyFlags(nullptr) {
+        origin[0] = origin[1] = origin[2] = 0.0f;
+        dims[0] = dims[1] = dims[2] = 1;
+    }
+
+    /**
+     * Rebuild the grid and collect candidate pairs
+     * Pairs are emitted with first < second in ascending lexicographic order,
+     * matching the visiting order of the brute-force loop. When flags are given,
+     * pairs of two BODY_SLEEPING bodies are skipped, and a sleeping body with no
+     * awake body in its neighbouring cells is not visited at all.
+     * @param positions Body positions
+     * @param radii Body radii
+     * @param count Number of bodies
+     * @param bounds World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+     * @param jobs Optional job system used to gather pairs in parallel
+     * @param flags Optional body flags used to skip sleeping pairs
+     */
+    void build(const Vector3* positions, const float* radii, size_t count, const float* bounds,
+               JobSystem* jobs = nullptr, const uint8_t* flags = nullptr) {
+        pairs.clear();
+        if (count < 2) {
+            bodyFlags = flags;
+            bodyCell.clear();
+            cellBodies.clear();
+            return;
+        }
+        buildCells(positions, radii, count, bounds, flags);
+
+        // Gather pairs in fixed-size body chunks (in parallel when a job system
+        // is given) and concatenate them in chunk order, so the output does not
+        // depend on the thread count
+        size_t chunkCount = (count + pairChunkSize - 1) / pairChunkSize;
+        if (chunks.size() < chunkCount) {
+            chunks.resize(chunkCount);
+        }
+
+        auto gatherChunks = [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                size_t begin = c * pairChunkSize;
+                size_t end = std::min(begin + pairChunkSize, count);
+                gatherPairs(positions, radii, begin, end, chunks[c]);
+            }
+        };
+        if (jobs) {
+            jobs->parallelFor(chunkCount, 1, gatherChunks);
+        } else {
+            gatherChunks(0, chunkCount);
+        }
+
+        size_t total = 0;
+        for (size_t c = 0; c < chunkCount; ++c) {
+            total += chunks[c].pairs.size();
+        }
+        pairs.reserve(total);
+        for (size_t c = 0; c < chunkCount; ++c) {
+            pairs.insert(pairs.end(), chunks[c].pairs.begin(), chunks[c].pairs.end());
+        }
+    }
+
+    /**
+     * Rebuild the grid's cell lists without collecting pairs
+     * Spatial queries use this on its own, since they only walk the cells
+     * @param positions Body positions
+     * @param radii Body radii
+     * @param count Number of bodies
+     * @param bounds World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+     * @param flags Optional body flags used to count awake bodies per cell
+     */
+    void buildCells(const Vector3* positions, const float* radii, size_t count, const float* bounds,
+                    const uint8_t* flags = nullptr) {
+        bodyFlags = flags;
+        float maxRadius = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            maxRadius = std::max(maxRadius, radii[i]);
+        }
+        configureGrid(bounds, maxRadius);
+
+        // Counting sort of bodies into cells
+        size_t cellCount = (size_t)dims[0] * dims[1] * dims[2];
+        cellStart.assign(cellCount + 1, 0);
+        cellAwake.assign(flags ? cellCount : 0, 0);
+        bodyCell.resize(count);
+        cellBodies.resize(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t cell = cellIndex(cellCoord(positions[i].x, 0),
+                                      cellCoord(positions[i].y, 1),
+                                      cellCoord(positions[i].z, 2));
+            bodyCell[i] = cell;
+            cellStart[cell + 1]++;
+            if (flags && !(flags[i] & BODY_SLEEPING)) {
+                cellAwake[cell]++;
+            }
+        }
+        for (size_t c = 0; c < cellCount; ++c) {
+            cellStart[c + 1] += cellStart[c];
+        }
+
+        // Fill back to front so each cell lists its bodies in ascending order
+        for (size_t i = count; i-- > 0;) {
+            cellBodies[--cellStart[bodyCell[i] + 1]] = (uint32_t)i;
+        }
+        // cellStart[c + 1] now holds the start of cell c; shift back into place
+        for (size_t c = 0; c < cellCount; ++c) {
+            cellStart[c] = cellStart[c + 1];
+        }
+        cellStart[cellCount] = (uint32_t)count;
+    }
+
+    /**
+     * Get candidate pairs from the last build
+     * @return Candidate pairs (indices into the arrays passed to build)
+     */
+    const std::vector<Pair>& getPairs() const {
+        return pairs;
+    }
+
+    /**
+     * Get body indices from the last build, grouped by cell in cell order
+     * Bodies in neighbouring entries are spatially close, which makes this a
+     * cheap spatially coherent ordering for other passes (e.g. culling)
+     * @return Body indices sorted by cell (empty if fewer than two bodies were built)
+     */
+    const std::vector<uint32_t>& getCellBodies() const {
+        return cellBodies;
+    }
+
+    /**
+     * Check whether the last build covers a given body count
+     * @param count Number of bodies expected
+     * @return True if cell queries are valid for that many bodies
+     */
+    bool isBuiltFor(size_t count) const {
+        return count >= 2 && cellBodies.size() == count;
+    }
+
+    /**
+     * Visit every body whose center fell in a cell overlapping a box
+     * The box is in world space and is clamped to the grid
+     * @param min Minimum corner
+     * @param max Maximum corner
+     * @param visit Called with each body index
+     */
+    template <typename Visitor>
+    void forEachInBox(const Vector3& min, const Vector3& max, Visitor visit) const {
+        int x0 = cellCoord(min.x, 0), x1 = cellCoord(max.x, 0);
+        int y0 = cellCoord(min.y, 1), y1 = cellCoord(max.y, 1);
+        int z0 = cellCoord(min.z, 2), z1 = cellCoord(max.z, 2);
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    uint32_t cell = cellIndex(x, y, z);
+                    for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                        visit(cellBodies[k]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Visit every body in the 3x3x3 block of cells around a cell
+     * A body whose radius is at most half the cell size and whose center
+     * lies in the cell can only reach this block
+     * @param x Cell x coordinate
+     * @param y Cell y coordinate
+     * @param z Cell z coordinate
+     * @param visit Called with each body index
+     */
+    template <typename Visitor>
+    void forEachAround(int x, int y, int z, Visitor visit) const {
+        forEachInCells(x - 1, x + 1, y - 1, y + 1, z - 1, z + 1, visit);
+    }
+
+    /**
+     * Visit every body in the cells at exactly a given Chebyshev distance from a cell
+     * Rings 0, 1, 2... together cover the grid outward from the center cell
+     * @param x Center cell x coordinate
+     * @param y Center cell y coordinate
+     * @param z Center cell z coordinate
+     * @param ring Distance in cells (0 = the center cell alone)
+     * @param visit Called with each body index
+     */
+    template <typename Visitor>
+    void forEachInRing(int x, int y, int z, int ring, Visitor visit) const {
+        if (ring == 0) {
+            forEachInCells(x, x, y, y, z, z, visit);
+            return;
+        }
+        // The two z faces whole, then the y faces and x faces without the rows
+        // already covered
+        forEachInCells(x - ring, x + ring, y - ring, y + ring, z - ring, z - ring, visit);
+        forEachInCells(x - ring, x + ring, y - ring, y + ring, z + ring, z + ring, visit);
+        forEachInCells(x - ring, x + ring, y - ring, y - ring, z - ring + 1, z + ring - 1, visit);
+        forEachInCells(x - ring, x + ring, y + ring, y + ring, z - ring + 1, z + ring - 1, visit);
+        forEachInCells(x - ring, x - ring, y - ring + 1, y + ring - 1, z - ring + 1, z + ring - 1, visit);
+        forEachInCells(x + ring, x + ring, y - ring + 1, y + ring - 1, z - ring + 1, z + ring - 1, visit);
+    }
+
+    /**
+     * Walk the cells a ray passes through, in order along the ray (3D DDA)
+     * The ray is clipped to the grid first; cells are reported until the
+     * visitor returns false, the ray leaves the grid or maxDistance is passed.
+     * @param start Ray origin
+     * @param direction Unit ray direction
+     * @param maxDistance Length of the ray
+     * @param visit Called with (x, y, z, entry distance) of each cell; return false to stop
+     */
+    template <typename Visitor>
+    void forEachCellOnRay(const Vector3& start, const Vector3& direction, float maxDistance, Visitor visit) const {
+        float from[3] = { start.x, start.y, start.z };
+        float dir[3] = { direction.x, direction.y, direction.z };
+
+        // Clip against the grid box
+        float enter = 0.0f;
+        float exit = maxDistance;
+        for (int axis = 0; axis < 3; ++axis) {
+            float low = origin[axis];
+            float high = origin[axis] + dims[axis] * cellSize;
+            if (std::fabs(dir[axis]) < 1e-12f) {
+                if (from[axis] < low || from[axis] > high) {
+                    return;
+                }
+                continue;
+            }
+            float inverse = 1.0f / dir[axis];
+            float t0 = (low - from[axis]) * inverse;
+            float t1 = (high - from[axis]) * inverse;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            enter = std::max(enter, t0);
+            exit = std::min(exit, t1);
+        }
+        if (enter > exit) {
+            return;
+        }
+
+        int cell[3];
+        int step[3];
+        float next[3];      // Distance at which the ray crosses into the next cell on each axis
+        float delta[3];     // Distance between cell crossings on each axis
+        for (int axis = 0; axis < 3; ++axis) {
+            cell[axis] = cellCoord(from[axis] + dir[axis] * enter, axis);
+            if (dir[axis] > 0.0f) {
+                step[axis] = 1;
+                delta[axis] = cellSize / dir[axis];
+                next[axis] = (origin[axis] + (cell[axis] + 1) * cellSize - from[axis]) / dir[axis];
+            } else if (dir[axis] < 0.0f) {
+                step[axis] = -1;
+                delta[axis] = -cellSize / dir[axis];
+                next[axis] = (origin[axis] + cell[axis] * cellSize - from[axis]) / dir[axis];
+            } else {
+                step[axis] = 0;
+                delta[axis] = INFINITY;
+                next[axis] = INFINITY;
+            }
+        }
+
+        float entry = enter;
+        for (;;) {
+            if (!visit(cell[0], cell[1], cell[2], entry)) {
+                return;
+            }
+            int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+            entry = next[axis];
+            if (entry > exit) {
+                return;
+            }
+            cell[axis] += step[axis];
+            if (cell[axis] < 0 || cell[axis] >= dims[axis]) {
+                return;
+            }
+            next[axis] += delta[axis];
+        }
+    }
+
+    /**
+     * Find the cell holding a point, clamped to the grid like body centers
+     * @param point World position
+     * @param cell Receives the x, y and z cell coordinates
+     */
+    void cellOf(const Vector3& point, int* cell) const {
+        cell[0] = cellCoord(point.x, 0);
+        cell[1] = cellCoord(point.y, 1);
+        cell[2] = cellCoord(point.z, 2);
+    }
+
+    /**
+     * Get the number of cells along an axis
+     * @param axis Axis index (0 = x, 1 = y, 2 = z)
+     * @return Cell count
+     */
+    int getDim(int axis) const {
+        return dims[axis];
+    }
+
+    /**
+     * Get the minimum corner of the grid along an axis
+     * @param axis Axis index (0 = x, 1 = y, 2 = z)
+     * @return World coordinate
+     */
+    float getOrigin(int axis) const {
+        return origin[axis];
+    }
+
+    /**
+     * Get the cell size used by the last build
+     * @return Cell edge length
+     */
+    float getCellSize() const {
+        return cellSize;
+    }
+
+private:
+    /**
+     * Visit every body in a block of cells, clamped to the grid
+     * @param visit Called with each body index
+     */
+    template <typename Visitor>
+    void forEachInCells(int x0, int x1, int y0, int y1, int z0, int z1, Visitor& visit) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        z0 = std::max(z0, 0);
+        x1 = std::min(x1, dims[0] - 1);
+        y1 = std::min(y1, dims[1] - 1);
+        z1 = std::min(z1, dims[2] - 1);
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    uint32_t cell = cellIndex(x, y, z);
+                    for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                        visit(cellBodies[k]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Collect candidate pairs whose first body lies in [begin, end)
+     * @param positions Body positions
+     * @param radii Body radii
+     * @param begin First body index
+     * @param end One past the last body index
+     * @param chunk Output chunk
+     */
+    void gatherPairs(const Vector3* positions, const float* radii, size_t begin, size_t end,
+                     PairChunk& chunk) const {
+        chunk.pairs.clear();
+        std::vector<uint32_t>& neighbours = chunk.neighbours;
+
+        for (size_t i = begin; i < end; ++i) {
+            neighbours.clear();
+
+            uint32_t cell = bodyCell[i];
+            int cx = (int)(cell % dims[0]);
+            int cy = (int)((cell / dims[0]) % dims[1]);
+            int cz = (int)(cell / ((size_t)dims[0] * dims[1]));
+
+            // A sleeping body can only pair with awake neighbours
+            bool asleep = bodyFlags && (bodyFlags[i] & BODY_SLEEPING);
+            if (asleep && !awakeNearby(cx, cy, cz)) {
+                continue;
+            }
+
+            for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, dims[2] - 1); ++z) {
+                for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, dims[1] - 1); ++y) {
+                    for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, dims[0] - 1); ++x) {
+                        uint32_t neighbourCell = cellIndex(x, y, z);
+                        for (uint32_t k = cellStart[neighbourCell]; k < cellStart[neighbourCell + 1]; ++k) {
+                            uint32_t j = cellBodies[k];
+                            if (j > i && !(asleep && (bodyFlags[j] & BODY_SLEEPING)) &&
+                                boundsOverlap(positions[i], radii[i], positions[j], radii[j])) {
+                                neighbours.push_back(j);
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::sort(neighbours.begin(), neighbours.end());
+            for (uint32_t j : neighbours) {
+                chunk.pairs.emplace_back((uint32_t)i, j);
+            }
+        }
+    }
+
+    /**
+     * Check whether any awake body lies in a cell or its neighbours
+     * @return True if the 3x3x3 block around (cx, cy, cz) holds an awake body
+     */
+    bool awakeNearby(int cx, int cy, int cz) const {
+        for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, dims[2] - 1); ++z) {
+            for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, dims[1] - 1); ++y) {
+                for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, dims[0] - 1); ++x) {
+                    if (cellAwake[cellIndex(x, y, z)] != 0) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Size the grid from the world bounds and the largest body radius
+     * @param bounds World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+     * @param maxRadius Largest body radius
+     */
+    void configureGrid(const float* bounds, float maxRadius) {
+        float extent[3] = {
+            std::max(bounds[1] - bounds[0], 0.0f),
+            std::max(bounds[3] - bounds[2], 0.0f),
+            std::max(bounds[5] - bounds[4], 0.0f)
+        };
+
+        cellSize = std::max(2.0f * maxRadius, 0.001f);
+
+        // Grow cells until the grid fits under the cell cap
+        for (;;) {
+            size_t total = 1;
+            for (int axis = 0; axis < 3; ++axis) {
+                dims[axis] = std::max(1, (int)std::ceil(extent[axis] / cellSize));
+                total *= (size_t)dims[axis];
+            }
+            if (total <= maxCells) {
+                break;
+            }
+            cellSize *= 2.0f;
+        }
+
+        inverseCellSize = 1.0f / cellSize;
+        origin[0] = bounds[0];
+        origin[1] = bounds[2];
+        origin[2] = bounds[4];
+    }
+
+    /**
+     * Map a coordinate onto a cell coordinate, clamping bodies outside the bounds
+     * @param value World coordinate
+     * @param axis Axis index (0 = x, 1 = y, 2 = z)
+     * @return Cell coordinate in [0, dims[axis] - 1]
+     */
+    int cellCoord(float value, int axis) const {
+        float local = (value - origin[axis]) * inverseCellSize;
+        if (!(local > 0.0f)) {
+            return 0;  // Also catches NaN
+        }
+        if (local >= (float)dims[axis]) {
+            return dims[axis] - 1;
+        }
+        return (int)local;
+    }
+
+    /**
+     * Flatten a 3D cell coordinate
+     * @return Linear cell index
+     */
+    uint32_t cellIndex(int x, int y, int z) const {
+        return (uint32_t)(x + dims[0] * (y + dims[1] * z));
+    }
+
+    /**
+     * Check whether the bounding boxes of two spheres overlap
+     * @return True if the boxes overlap on every axis
+     */
+    static bool boundsOverlap(const Vector3& a, float ra, const Vector3& b, float rb) {
+        float reach = ra + rb;
+        return std::fabs(a.x - b.x) < reach &&
+               std::fabs(a.y - b.y) < reach &&
+               std::fabs(a.z - b.z) < reach;
+    }
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "WorldCheckpoint.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Results of feeding intact and damaged checkpoints to WorldCheckpoint
+ */
+struct CheckpointCheckResult {
+    size_t cases;                       // Checkpoints restored
+    std::vector<std::string> failures;  // One line per case that did not behave
+
+    bool passed() const {
+        return failures.empty();
+    }
+};
+
+/**
+ * Self-check for WorldCheckpoint
+ * Saves a small mixed scene, checks that it restores to the same state hash,
+ * then restores truncated and corrupted copies of it. Every damaged copy must
+ * be rejected with an error and leave the target world untouched.
+ */
+class CheckpointCheck {
+public:
+    /**
+     * Run every case
+     * @return Check result
+     */
+    static CheckpointCheckResult run() {
+        CheckpointCheckResult result = { 0, {} };
+
+        PhysicsWorld source;
+        populate(source);
+        std::vector<uint8_t> bytes;
+        WorldCheckpoint::serialize(source, bytes);
+
+        PhysicsWorld restored;
+        std::string error;
+        result.cases++;
+        if (!WorldCheckpoint::restore(bytes.data(), bytes.size(), restored, error)) {
+            result.failures.push_back("intact checkpoint: " + error);
+        } else if (restored.computeStateHash() != source.computeStateHash()) {
+            result.failures.push_back("intact checkpoint: state hash differs after restore");
+        }
+
+        // Cut inside the header, the section table, the sections and the last byte of rest counters
+        WorldCheckpoint::Contents intact;
+        WorldCheckpoint::parse(bytes.data(), bytes.size(), intact, error);
+        size_t restEnd = sectionOffset(bytes, intact.bodies.restSteps) + intact.bodies.count * sizeof(uint16_t);
+        for (size_t size : { (size_t)0, sizeof(WorldCheckpoint::Header) - 1, sizeof(WorldCheckpoint::Header) + 8,
+                             bytes.size() / 2, restEnd - 1 }) {
+            expectRejected(result, bytes, "truncated to " + std::to_string(size) + " bytes",
+                           [size](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents&) {
+                damaged.resize(size);
+            });
+        }
+
+        expectRejected(result, bytes, "unknown option bits",
+                       [](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents&) {
+            damaged[offsetof(WorldCheckpoint::Header, options)] |= 0x80;
+        });
+        expectRejected(result, bytes, "section element size changed",
+                       [](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents&) {
+            damaged[sizeof(WorldCheckpoint::Header) + offsetof(WorldCheckpoint::SectionEntry, elementSize)] += 1;
+        });
+        expectRejected(result, bytes, "unknown flag bits",
+                       [&bytes](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents& contents) {
+            damaged[sectionOffset(bytes, contents.bodies.flags)] |= 0x80;
+        });
+        expectRejected(result, bytes, "duplicate handle slots",
+                       [&bytes](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents& contents) {
+            std::memcpy(damaged.data() + sectionOffset(bytes, contents.bodies.handleSlots) + sizeof(uint32_t),
+                        contents.bodies.handleSlots, sizeof(uint32_t));
+        });
+        expectRejected(result, bytes, "unknown shapes",
+                       [&bytes](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents& contents) {
+            std::memset(damaged.data() + sectionOffset(bytes, contents.bodies.shapes), 200, contents.bodies.count);
+        });
+        expectRejected(result, bytes, "ball flag on a box",
+                       [&bytes](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents& contents) {
+            damaged[sectionOffset(bytes, contents.bodies.flags) + boxIndex] |= BODY_BALL;
+        });
+        expectRejected(result, bytes, "box without the shaped flag",
+                       [&bytes](std::vector<uint8_t>& damaged, const WorldCheckpoint::Contents& contents) {
+            damaged[sectionOffset(bytes, contents.bodies.flags) + boxIndex] &= (uint8_t)~BODY_SHAPED;
+        });
+        return result;
+    }
+
+private:
+    static constexpr size_t ballCount = 64;        // Balls in the scene
+    static constexpr size_t boxIndex = ballCount;  // Dense index of the box, created after the balls
+
+    using Damage = std::function<void(std::vector<uint8_t>&, const WorldCheckpoint::Contents&)>;
+
+    /**
+     * Fill a world with balls, a box, a capsule and a plane, then step it so
+     * contacts and sleeping state are saved too
+     * @param world World to fill
+     */
+    static void populate(PhysicsWorld& world) {
+        for (int i = 0; i < (int)ballCount; ++i) {
+            world.createBall(Vector3((float)(i % 8) - 3.5f, 1.0f + (float)(i / 8) * 0.6f, (float)(i % 5) - 2.0f));
+        }
+        world.createBox(Vector3(4.0f, 1.0f, 4.0f), 2.0f, Vector3(0.5f, 0.5f, 0.5f));
+        world.createCapsule(Vector3(-4.0f, 1.5f, -4.0f), 1.0f, 0.3f, 0.5f);
+        world.createPlane(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        for (int step = 0; step < 30; ++step) {
+            world.step(world.getTimeStep());
+        }
+    }
+
+    /**
+     * Damage a copy of a checkpoint and check that restoring it fails cleanly
+     * @param result Result to update
+     * @param bytes Intact checkpoint
+     * @param name Case description
+     * @param damage Changes the copy; gets the intact checkpoint's parsed views
+     */
+    static void expectRejected(CheckpointCheckResult& result, const std::vector<uint8_t>& bytes,
+                               const std::string& name, const Damage& damage) {
+        WorldCheckpoint::Contents contents;
+        std::string error;
+        WorldCheckpoint::parse(bytes.data(), bytes.size(), contents, error);
+
+        std::vector<uint8_t> damaged = bytes;
+        damage(damaged, contents);
+
+        PhysicsWorld world;
+        world.createBall(Vector3(0.0f, 1.0f, 0.0f));
+        result.cases++;
+        error.clear();
+        if (WorldCheckpoint::restore(damaged.data(), damaged.size(), world, error)) {
+            result.failures.push_back(name + ": accepted");
+        } else if (error.empty()) {
+            result.failures.push_back(name + ": rejected without an error");
+        } else if (world.getBodyCount() != 1) {
+            result.failures.push_back(name + ": world changed after a failed restore");
+        }
+    }
+
+    /**
+     * Find the byte offset of a section from a view into the intact checkpoint
+     * @param bytes Intact checkpoint
+     * @param array View into bytes from parse
+     * @return Offset of the section
+     */
+    static size_t sectionOffset(const std::vector<uint8_t>& bytes, const void* array) {
+        return (size_t)((const uint8_t*)array - bytes.data());
+    }
+};
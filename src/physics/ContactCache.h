@@ -0,0 +1,237 @@
+#pragma once
+#include "BodyStore.h"
+#include "CounterRng.h"
+#include "Vector3.h"
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Impulses the solver accumulated on one contact
+ */
+struct CachedImpulse {
+    float normal;       // Accumulated normal impulse
+    Vector3 tangent;    // Accumulated friction impulse
+};
+
+/**
+ * A cached contact addressed by dense body indices, as stored in checkpoints
+ * Unlike pair keys these survive a save and load, which hands out new handle
+ * generations. An index at or above PhysicsWorld's plane key base names a world
+ * plane rather than a body.
+ */
+struct SavedContact {
+    uint32_t bodyA;     // Dense index of one body
+    uint32_t bodyB;     // Dense index of the other body (or plane)
+    float normal;       // Accumulated normal impulse
+    Vector3 tangent;    // Accumulated friction impulse
+};
+
+/**
+ * Contact cache that persists solved impulses across steps, keyed on the body-pair handle
+ * The solver looks up each contact's impulses from the previous step to warm
+ * start, then records the new ones. Two open-addressing tables alternate:
+ * lookups read the table recorded last step while the other one is refilled,
+ * so pairs that stop touching drop out on their own. Keys include handle
+ * generations, so a recycled handle slot never inherits a stale impulse.
+ */
+class ContactCache {
+public:
+    /**
+     * Order-independent key of a body pair
+     */
+    struct PairKey {
+        uint64_t low;       // (generation << 32) | slot of the body with the lower handle slot
+        uint64_t high;      // Same for the other body
+
+        bool operator==(const PairKey& other) const {
+            return low == other.low && high == other.high;
+        }
+    };
+
+private:
+    /**
+     * One table slot; valid only when its stamp matches the table's
+     */
+    struct Entry {
+        PairKey key;
+        CachedImpulse impulse;
+        uint32_t stamp;
+    };
+
+    /**
+     * Open-addressing table with linear probing and power-of-two capacity
+     */
+    struct Table {
+        std::vector<Entry> slots;
+        size_t count = 0;
+        uint32_t stamp = 1;
+    };
+
+    Table tables[2];        // Previous step's contacts and the ones being recorded
+    int previous;           // Index of the table lookups read from
+
+public:
+    /**
+     * Constructor - creates an empty cache
+     */
+    ContactCache()
+        : previous(0) {
+    }
+
+    /**
+     * Build the key for a pair of bodies
+     * @param a Handle of one body
+     * @param b Handle of the other body
+     * @return Key that is the same for (a, b) and (b, a)
+     */
+    static PairKey makeKey(BodyHandle a, BodyHandle b) {
+        uint64_t packedA = ((uint64_t)a.generation << 32) | a.index;
+        uint64_t packedB = ((uint64_t)b.generation << 32) | b.index;
+        PairKey key;
+        key.low = a.index < b.index ? packedA : packedB;
+        key.high = a.index < b.index ? packedB : packedA;
+        return key;
+    }
+
+    /**
+     * Look up the impulses a pair ended the previous step with
+     * Safe to call from several threads while nothing is being recorded
+     * @param key Pair key
+     * @param impulse Receives the cached impulses if found
+     * @return True if the pair was touching last step
+     */
+    bool find(const PairKey& key, CachedImpulse& impulse) const {
+        const Table& table = tables[previous];
+        if (table.count == 0) {
+            return false;
+        }
+        size_t mask = table.slots.size() - 1;
+        for (size_t slot = hash(key) & mask; table.slots[slot].stamp == table.stamp; slot = (slot + 1) & mask) {
+            if (table.slots[slot].key == key) {
+                impulse = table.slots[slot].impulse;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Start recording this step's contacts, forgetting whatever the recording table held
+     * @param expected Number of contacts that will be recorded
+     */
+    void beginRecording(size_t expected) {
+        Table& table = tables[1 - previous];
+        size_t capacity = 16;
+        while (capacity < expected * 2) {
+            capacity *= 2;
+        }
+
+        if (capacity != table.slots.size() || table.stamp == UINT32_MAX) {
+            table.slots.assign(capacity, Entry());  // Value-initialized: every stamp is 0
+            table.stamp = 1;
+        } else {
+            table.stamp++;  // Invalidates every slot without touching them
+        }
+        table.count = 0;
+    }
+
+    /**
+     * Record the impulses a pair ended this step with
+     * Each pair must be recorded at most once per step
+     * @param key Pair key
+     * @param impulse Solved impulses
+     */
+    void record(const PairKey& key, const CachedImpulse& impulse) {
+        Table& table = tables[1 - previous];
+        size_t mask = table.slots.size() - 1;
+        size_t slot = hash(key) & mask;
+        while (table.slots[slot].stamp == table.stamp) {
+            slot = (slot + 1) & mask;
+        }
+        table.slots[slot].key = key;
+        table.slots[slot].impulse = impulse;
+        table.slots[slot].stamp = table.stamp;
+        table.count++;
+    }
+
+    /**
+     * Make the recorded contacts the ones the next step looks up
+     */
+    void finishRecording() {
+        previous = 1 - previous;
+    }
+
+    /**
+     * Forget every cached contact
+     */
+    void clear() {
+        for (Table& table : tables) {
+            table.count = 0;
+            table.stamp++;
+            if (table.stamp == UINT32_MAX) {
+                table.slots.clear();
+                table.stamp = 1;
+            }
+        }
+    }
+
+    /**
+     * Get the number of contacts available for warm starting
+     * @return Contacts recorded on the last step
+     */
+    size_t size() const {
+        return tables[previous].count;
+    }
+
+    /**
+     * Call visit(key, impulse) for every contact available for warm starting, in table order
+     * @param visit Callback
+     */
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        const Table& table = tables[previous];
+        for (const Entry& entry : table.slots) {
+            if (entry.stamp == table.stamp) {
+                visit(entry.key, entry.impulse);
+            }
+        }
+    }
+
+    /**
+     * Hash the contacts available for warm starting
+     * Independent of table layout and insertion order. Handle generations are
+     * left out, since a checkpoint load reissues them while the pairs are the same.
+     * @param seed Hash to extend
+     * @param isLive isLive(key) is false for pairs whose bodies were removed; those are skipped
+     * @return Extended hash
+     */
+    template <typename IsLive>
+    uint64_t hashContents(uint64_t seed, IsLive isLive) const {
+        uint64_t sum = 0;
+        uint64_t live = 0;
+        forEach([&](const PairKey& key, const CachedImpulse& impulse) {
+            if (!isLive(key)) {
+                return;
+            }
+            uint32_t bits[4];
+            std::memcpy(&bits[0], &impulse.normal, sizeof(float));
+            std::memcpy(&bits[1], &impulse.tangent.x, 3 * sizeof(float));
+            uint64_t entry = CounterRng::combine(CounterRng::mix(key.low & 0xFFFFFFFFu), key.high & 0xFFFFFFFFu);
+            entry = CounterRng::combine(entry, ((uint64_t)bits[0] << 32) | bits[1]);
+            entry = CounterRng::combine(entry, ((uint64_t)bits[2] << 32) | bits[3]);
+            sum += entry;
+            live++;
+        });
+        return CounterRng::combine(CounterRng::combine(seed, live), sum);
+    }
+
+private:
+    /**
+     * Hash a pair key
+     */
+    static size_t hash(const PairKey& key) {
+        return (size_t)CounterRng::combine(CounterRng::mix(key.low), key.high);
+    }
+};
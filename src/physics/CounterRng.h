@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Stateless counter-based random numbers
+ * Each value is a pure hash of a key and a counter, so draws need no shared
+ * state or locks and come out the same on any thread and in any order.
+ * Keys are mixed with the SplitMix64 finalizer.
+ */
+class CounterRng {
+public:
+    /**
+     * Mix 64 bits into a well-distributed 64-bit value
+     * @param value Input bits
+     * @return Hashed bits
+     */
+    static uint64_t mix(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * Combine a key with another value
+     * @param key Existing key
+     * @param value Value to fold in
+     * @return New key
+     */
+    static uint64_t combine(uint64_t key, uint64_t value) {
+        return mix(key ^ (value + 0x632BE59BD9B4E019ull + (key << 6) + (key >> 2)));
+    }
+
+    /**
+     * Uniform float for a key and counter
+     * @param key Stream key
+     * @param counter Draw index within the stream
+     * @return Value in [0, 1)
+     */
+    static float uniform(uint64_t key, uint32_t counter) {
+        uint64_t bits = mix(key + counter * 0xD1B54A32D192ED03ull);
+        return (float)(bits >> 40) * (1.0f / 16777216.0f);
+    }
+};
@@ -0,0 +1,251 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * JobSystem runs data-parallel loops on a pool of worker threads
+ * Each parallelFor splits its iteration space into fixed-size chunks and hands
+ * every participant a contiguous run of chunks. Participants take chunks from
+ * the front of their own run and steal from the back of other runs when idle,
+ * so uneven chunks balance out without any per-chunk allocation.
+ */
+class JobSystem {
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+private:
+    /**
+     * Run of chunk indices owned by one participant, packed as (end << 32 | begin)
+     * so both ends can be claimed with a single compare-and-swap
+     */
+    struct alignas(64) ChunkRange {
+        std::atomic<uint64_t> packed{0};
+    };
+
+    std::vector<std::thread> workers;           // Worker threads (participants 1..N-1)
+    std::unique_ptr<ChunkRange[]> ranges;       // One chunk run per participant
+    size_t participantCount;                    // Workers plus the calling thread
+
+    std::mutex mutex;                           // Guards dispatch state below
+    std::condition_variable wakeCondition;      // Signals workers that a loop is ready
+    std::condition_variable doneCondition;      // Signals the caller that workers are idle
+    uint64_t dispatchGeneration;                // Incremented for every parallel loop
+    size_t busyWorkers;                         // Workers still inside the current loop
+    bool stopping;                              // Set when the pool shuts down
+
+    const RangeFunction* task;                  // Loop body of the current dispatch
+    size_t taskCount;                           // Iteration count of the current dispatch
+    size_t taskGrain;                           // Iterations per chunk
+
+public:
+    /**
+     * Constructor - starts a pool
+     * @param threadCount Total threads including the caller (0 = hardware concurrency)
+     */
+    explicit JobSystem(size_t threadCount = 1)
+        : participantCount(1)
+        , dispatchGeneration(0)
+        , busyWorkers(0)
+        , stopping(false)
+        , task(nullptr)
+        , taskCount(0)
+        , taskGrain(1) {
+        setThreadCount(threadCount);
+    }
+
+    /**
+     * Destructor - joins all worker threads
+     */
+    ~JobSystem() {
+        stopWorkers();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Resize the pool
+     * @param threadCount Total threads including the caller (0 = hardware concurrency)
+     */
+    void setThreadCount(size_t threadCount) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        stopWorkers();
+
+        participantCount = threadCount;
+        ranges.reset(new ChunkRange[participantCount]);
+        stopping = false;
+        uint64_t generation = dispatchGeneration;
+        for (size_t i = 1; i < participantCount; ++i) {
+            workers.emplace_back([this, i, generation]() { workerLoop(i, generation); });
+        }
+    }
+
+    /**
+     * Get the pool size
+     * @return Total threads including the caller
+     */
+    size_t getThreadCount() const {
+        return participantCount;
+    }
+
+    /**
+     * Run fn over [0, count) in chunks of at most grain iterations
+     * Blocks until every chunk has finished. The calling thread takes part.
+     * Not reentrant: fn must not call parallelFor on the same pool.
+     * @param count Number of iterations
+     * @param grain Iterations per chunk
+     * @param fn Loop body receiving a [begin, end) sub-range
+     */
+    void parallelFor(size_t count, size_t grain, const RangeFunction& fn) {
+        if (count == 0) {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        if (participantCount == 1 || count <= grain) {
+            fn(0, count);
+            return;
+        }
+
+        size_t chunkCount = (count + grain - 1) / grain;
+        for (size_t p = 0; p < participantCount; ++p) {
+            uint64_t begin = chunkCount * p / participantCount;
+            uint64_t end = chunkCount * (p + 1) / participantCount;
+            ranges[p].packed.store((end << 32) | begin, std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &fn;
+            taskCount = count;
+            taskGrain = grain;
+            busyWorkers = workers.size();
+            dispatchGeneration++;
+        }
+        wakeCondition.notify_all();
+
+        runChunks(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this]() { return busyWorkers == 0; });
+        task = nullptr;
+    }
+
+private:
+    /**
+     * Worker thread main loop
+     * @param participant Participant index of this worker
+     * @param seenGeneration Last dispatch generation before the worker started
+     */
+    void workerLoop(size_t participant, uint64_t seenGeneration) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeCondition.wait(lock, [&]() { return stopping || dispatchGeneration != seenGeneration; });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = dispatchGeneration;
+            }
+
+            runChunks(participant);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                busyWorkers--;
+            }
+            doneCondition.notify_one();
+        }
+    }
+
+    /**
+     * Execute chunks from this participant's run, then steal until none remain
+     * @param participant Participant index
+     */
+    void runChunks(size_t participant) {
+        size_t chunk;
+        while (popFront(participant, chunk)) {
+            runChunk(chunk);
+        }
+        for (size_t offset = 1; offset < participantCount; ++offset) {
+            size_t victim = (participant + offset) % participantCount;
+            while (popBack(victim, chunk)) {
+                runChunk(chunk);
+            }
+        }
+    }
+
+    /**
+     * Run the loop body over one chunk
+     * @param chunk Chunk index
+     */
+    void runChunk(size_t chunk) {
+        size_t begin = chunk * taskGrain;
+        size_t end = std::min(begin + taskGrain, taskCount);
+        (*task)(begin, end);
+    }
+
+    /**
+     * Claim the first chunk of a participant's run
+     * @return True if a chunk was claimed
+     */
+    bool popFront(size_t participant, size_t& chunk) {
+        std::atomic<uint64_t>& packed = ranges[participant].packed;
+        uint64_t current = packed.load(std::memory_order_acquire);
+        for (;;) {
+            uint64_t begin = current & 0xFFFFFFFFu;
+            uint64_t end = current >> 32;
+            if (begin >= end) {
+                return false;
+            }
+            if (packed.compare_exchange_weak(current, (end << 32) | (begin + 1), std::memory_order_acq_rel)) {
+                chunk = (size_t)begin;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Steal the last chunk of another participant's run
+     * @return True if a chunk was claimed
+     */
+    bool popBack(size_t victim, size_t& chunk) {
+        std::atomic<uint64_t>& packed = ranges[victim].packed;
+        uint64_t current = packed.load(std::memory_order_acquire);
+        for (;;) {
+            uint64_t begin = current & 0xFFFFFFFFu;
+            uint64_t end = current >> 32;
+            if (begin >= end) {
+                return false;
+            }
+            if (packed.compare_exchange_weak(current, ((end - 1) << 32) | begin, std::memory_order_acq_rel)) {
+                chunk = (size_t)(end - 1);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Signal all workers to exit and join them
+     */
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+};
@@ -0,0 +1,241 @@
+#pragma once
+#include "BodyStore.h"
+#include "Ball.h"
+#include "SimdKernels.h"
+#include <vector>
+#include <memory>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * Results of comparing the batched kernels against their references
+ */
+struct KernelCheckResult {
+    SimdLevel level;            // SIMD level that was checked
+    size_t bodyCount;           // Bodies in the synthetic scene
+    int steps;                  // Steps simulated
+    size_t simdMismatches;      // Components of SIMD output that differ from the scalar kernel
+    float simdMaxError;         // Largest absolute difference from the scalar kernel
+    size_t legacyMismatches;    // Components outside tolerance against the per-body path
+    float legacyMaxError;       // Largest absolute difference from the per-body path
+
+    // Tolerance against the per-body path, whose acceleration uses force / mass
+    // instead of force * inverseMass and may round differently by 1 ulp
+    static constexpr float legacyTolerance = 1e-4f;
+
+    bool passed() const {
+        return simdMismatches == 0 && legacyMismatches == 0;
+    }
+};
+
+/**
+ * Self-check for SimdKernels
+ * Runs a synthetic scene through the selected SIMD kernels, the scalar kernels
+ * and the original per-body path (PhysicsBody::update + Ball::update, then the
+ * branchy per-body wall loop the kernels replaced), then compares positions and
+ * velocities. SIMD must match the scalar kernels bit for bit.
+ */
+class KernelCheck {
+public:
+    /**
+     * Run the comparison
+     * @param level SIMD level to check (must be supported)
+     * @param bodyCount Number of bodies to simulate
+     * @param steps Number of steps to run
+     * @param seed Seed for the synthetic scene
+     * @return Comparison result
+     */
+    static KernelCheckResult run(SimdLevel level, size_t bodyCount, int steps, unsigned int seed = 1234u) {
+        const float bounds[6] = { -15.0f, 15.0f, 0.0f, 10.0f, -15.0f, 15.0f };
+        const float dt = 1.0f / 60.0f;
+
+        BodyStore simdStore, scalarStore, legacyStore;
+        std::vector<std::unique_ptr<PhysicsBody>> legacyBodies;
+        populate(simdStore, nullptr, bodyCount, seed);
+        populate(scalarStore, nullptr, bodyCount, seed);
+        populate(legacyStore, &legacyBodies, bodyCount, seed);
+
+        SimdKernels::IntegrationParams params;
+        params.deltaTime = dt;
+        params.gravity = Vector3(0, -9.81f, 0);
+        params.airResistance = 0.999f;
+
+        KernelCheckResult result = { level, bodyCount, steps, 0, 0.0f, 0, 0.0f };
+        std::mt19937 forceGen(seed ^ 0x9e3779b9u);
+        std::uniform_real_distribution<float> forceDis(-20.0f, 20.0f);
+
+        for (int step = 0; step < steps; ++step) {
+            // Push a few bodies each step so the force path is exercised too
+            for (size_t i = 0; i < bodyCount; i += 7) {
+                Vector3 push(forceDis(forceGen), forceDis(forceGen), forceDis(forceGen));
+                simdStore.forces[i] += push;
+                scalarStore.forces[i] += push;
+                legacyBodies[i]->applyForce(push);
+            }
+
+            BodyArrays simdArrays(simdStore);
+            BodyArrays scalarArrays(scalarStore);
+
+            SimdKernels::integrate(level, simdArrays, 0, simdArrays.count, params);
+            SimdKernels::integrateScalar(scalarArrays, 0, scalarArrays.count, params);
+            for (auto& body : legacyBodies) {
+                body->update(dt);
+            }
+
+            SimdKernels::boundaries(level, simdArrays, 0, simdArrays.count, bounds);
+            SimdKernels::boundariesScalar(scalarArrays, 0, scalarArrays.count, bounds);
+            legacyBoundaries(legacyStore, bounds);
+        }
+
+        compare(simdStore, scalarStore, 0.0f, result.simdMismatches, result.simdMaxError);
+        compare(scalarStore, legacyStore, KernelCheckResult::legacyTolerance,
+                result.legacyMismatches, result.legacyMaxError);
+        return result;
+    }
+
+private:
+    /**
+     * Reference wall handling: the per-body loop PhysicsWorld ran before SimdKernels
+     * @param store Store to update
+     * @param bounds World bounds (minX, maxX, minY, maxY, minZ, maxZ)
+     */
+    static void legacyBoundaries(BodyStore& store, const float* bounds) {
+        for (size_t i = 0; i < store.size(); ++i) {
+            // Skip static bodies
+            if (store.flags[i] & BODY_STATIC) {
+                continue;
+            }
+            
+            Vector3& position = store.positions[i];
+            Vector3& velocity = store.velocities[i];
+            float radius = store.radii[i];
+            float restitution = store.restitutions[i];
+            bool collided = false;
+            
+            // Check X boundaries (left/right walls)
+            if (position.x - radius < bounds[0]) {
+                position.x = bounds[0] + radius;
+                if (velocity.x < 0) {
+                    velocity.x = -velocity.x * restitution;
+                    collided = true;
+                }
+            } else if (position.x + radius > bounds[1]) {
+                position.x = bounds[1] - radius;
+                if (velocity.x > 0) {
+                    velocity.x = -velocity.x * restitution;
+                    collided = true;
+                }
+            }
+            
+            // Check Y boundaries (floor/ceiling)
+            if (position.y - radius < bounds[2]) {
+                position.y = bounds[2] + radius;
+                if (velocity.y < 0) {
+                    velocity.y = -velocity.y * restitution;
+                    collided = true;
+                }
+            } else if (position.y + radius > bounds[3]) {
+                position.y = bounds[3] - radius;
+                if (velocity.y > 0) {
+                    velocity.y = -velocity.y * restitution;
+                    collided = true;
+                }
+            }
+            
+            // Check Z boundaries (front/back walls)
+            if (position.z - radius < bounds[4]) {
+                position.z = bounds[4] + radius;
+                if (velocity.z < 0) {
+                    velocity.z = -velocity.z * restitution;
+                    collided = true;
+                }
+            } else if (position.z + radius > bounds[5]) {
+                position.z = bounds[5] - radius;
+                if (velocity.z > 0) {
+                    velocity.z = -velocity.z * restitution;
+                    collided = true;
+                }
+            }
+            
+            // Apply friction for ground contact
+            if (position.y <= bounds[2] + radius + 0.1f && collided) {
+                velocity.x *= (1.0f - store.frictions[i]);
+                velocity.z *= (1.0f - store.frictions[i]);
+            }
+        }
+    }
+
+    /**
+     * Fill a store with a deterministic mix of balls, plain, static, held and inactive bodies
+     * @param store Store to fill
+     * @param proxies If set, receives proxy objects for the per-body path
+     * @param count Number of bodies
+     * @param seed Scene seed
+     */
+    static void populate(BodyStore& store, std::vector<std::unique_ptr<PhysicsBody>>* proxies,
+                         size_t count, unsigned int seed) {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> posDis(-16.0f, 16.0f);
+        std::uniform_real_distribution<float> heightDis(-0.5f, 10.5f);
+        std::uniform_real_distribution<float> velDis(-30.0f, 30.0f);
+        std::uniform_real_distribution<float> radiusDis(0.1f, 0.6f);
+        std::uniform_int_distribution<int> kindDis(0, 9);
+
+        store.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            Vector3 position(posDis(gen), heightDis(gen), posDis(gen));
+            Vector3 velocity(velDis(gen), velDis(gen), velDis(gen));
+            float radius = radiusDis(gen);
+            int kind = kindDis(gen);
+
+            BodyHandle handle = store.create(position, 1.0f, radius);
+            uint32_t slot = store.denseIndex(handle);
+
+            // Every store gets a proxy so flags and properties are set identically
+            std::unique_ptr<PhysicsBody> body;
+            if (kind < 6) {
+                body = std::make_unique<Ball>(store, handle, Vector3(1.0f, 1.0f, 1.0f));
+                static_cast<Ball*>(body.get())->setHeld(kind == 5);
+            } else {
+                body = std::make_unique<PhysicsBody>(store, handle);
+                body->setStatic(kind == 8);
+                body->setActive(kind != 9);
+            }
+            body->setRadius(radius);
+            store.velocities[slot] = kind == 8 ? Vector3::ZERO : velocity;
+
+            if (proxies) {
+                proxies->push_back(std::move(body));
+            }
+        }
+    }
+
+    /**
+     * Compare positions and velocities of two stores
+     * @param a First store
+     * @param b Second store
+     * @param tolerance Allowed absolute difference per component
+     * @param mismatches Incremented for every component outside tolerance
+     * @param maxError Updated with the largest difference seen
+     */
+    static void compare(const BodyStore& a, const BodyStore& b, float tolerance,
+                        size_t& mismatches, float& maxError) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            const float* pa = &a.positions[i].x;
+            const float* pb = &b.positions[i].x;
+            const float* va = &a.velocities[i].x;
+            const float* vb = &b.velocities[i].x;
+            for (int c = 0; c < 3; ++c) {
+                float dp = std::fabs(pa[c] - pb[c]);
+                float dv = std::fabs(va[c] - vb[c]);
+                maxError = std::max(maxError, std::max(dp, dv));
+                bool equal = tolerance == 0.0f ? (pa[c] == pb[c] && va[c] == vb[c])
+                                               : (dp <= tolerance && dv <= tolerance);
+                if (!equal) {
+                    mismatches++;
+                }
+            }
+        }
+    }
+};
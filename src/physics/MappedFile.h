@@ -0,0 +1,137 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Read-only view of a whole file
+ * On POSIX systems the file is memory-mapped, so opening copies nothing and
+ * pages are read in on first touch; elsewhere the file is read into memory.
+ */
+class MappedFile {
+private:
+    const uint8_t* bytes;           // Start of the file contents
+    size_t length;                  // File size in bytes
+    void* mapping;                  // mmap result, or nullptr when read into buffer
+    std::vector<uint8_t> buffer;    // Contents when the file could not be mapped
+
+public:
+    /**
+     * Constructor - creates an empty view
+     */
+    MappedFile()
+        : bytes(nullptr)
+        , length(0)
+        , mapping(nullptr) {
+    }
+
+    /**
+     * Destructor - unmaps the file
+     */
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Open a file, replacing any file already open
+     * @param path File to open
+     * @param error Receives a description on failure
+     * @return True if the contents are available through data()
+     */
+    bool open(const std::string& path, std::string& error) {
+        close();
+#if !defined(_WIN32)
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            error = "Failed to open " + path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(descriptor, &info) != 0) {
+            ::close(descriptor);
+            error = "Failed to read the size of " + path;
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length > 0) {
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address != MAP_FAILED) {
+                mapping = address;
+                bytes = (const uint8_t*)address;
+            }
+        }
+        ::close(descriptor);
+        if (mapping || length == 0) {
+            return true;
+        }
+#endif
+        // Not mappable here: fall back to reading the whole file
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            error = "Failed to open " + path;
+            return false;
+        }
+        length = (size_t)file.tellg();
+        buffer.resize(length);
+        file.seekg(0);
+        if (length > 0 && !file.read((char*)buffer.data(), (std::streamsize)length)) {
+            close();
+            error = "Failed to read " + path;
+            return false;
+        }
+        bytes = buffer.data();
+        return true;
+    }
+
+    /**
+     * Release the file
+     */
+    void close() {
+#if !defined(_WIN32)
+        if (mapping) {
+            munmap(mapping, length);
+        }
+#endif
+        mapping = nullptr;
+        bytes = nullptr;
+        length = 0;
+        buffer.clear();
+        buffer.shrink_to_fit();
+    }
+
+    /**
+     * Get the file contents
+     * @return First byte (nullptr when nothing is open or the file is empty)
+     */
+    const uint8_t* data() const {
+        return bytes;
+    }
+
+    /**
+     * Get the file size
+     * @return Size in bytes
+     */
+    size_t size() const {
+        return length;
+    }
+
+    /**
+     * Check whether the contents are memory-mapped rather than copied
+     * @return True if mapped
+     */
+    bool isMapped() const {
+        return mapping != nullptr;
+    }
+};
@@ -0,0 +1,251 @@
+#pragma once
+#include "BodyStore.h"
+#include "Shapes.h"
+#include <array>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Builds a body's shape from the store arrays
+ */
+template <typename Shape>
+struct ShapeLoader;
+
+template <>
+struct ShapeLoader<SphereShape> {
+    static SphereShape load(const BodyStore& store, uint32_t body) {
+        return SphereShape{ store.positions[body], store.radii[body] };
+    }
+};
+
+template <>
+struct ShapeLoader<BoxShape> {
+    static BoxShape load(const BodyStore& store, uint32_t body) {
+        return BoxShape{ store.positions[body], store.extents[body] };
+    }
+};
+
+template <>
+struct ShapeLoader<CapsuleShape> {
+    static CapsuleShape load(const BodyStore& store, uint32_t body) {
+        const Vector3& extents = store.extents[body];
+        return CapsuleShape{ store.positions[body], extents.y - extents.x, extents.x };
+    }
+};
+
+template <>
+struct ShapeLoader<PlaneShape> {
+    static PlaneShape load(const BodyStore& store, uint32_t body) {
+        const Vector3& normal = store.extents[body];
+        return PlaneShape{ normal, normal.dot(store.positions[body]) };
+    }
+};
+
+/**
+ * Shape-pair dispatch over the collide<ShapeA, ShapeB> kernels
+ * Every ordered pair of shape types gets a kernel instantiated at compile
+ * time, and the kernels are gathered into constexpr tables indexed by pair
+ * kind (shape of a * shapeTypeCount + shape of b). A pair is dispatched
+ * through one table lookup; there are no virtual calls. Batches of same-kind
+ * pairs run one kernel over the whole batch, so the loop body is the
+ * specialized kernel inlined.
+ */
+class Narrowphase {
+public:
+    using Pair = std::pair<uint32_t, uint32_t>;
+    using Shapes = std::tuple<SphereShape, BoxShape, CapsuleShape, PlaneShape>;   // In ShapeType order
+
+    static constexpr size_t shapeTypeCount = std::tuple_size<Shapes>::value;
+    static constexpr size_t pairKindCount = shapeTypeCount * shapeTypeCount;
+
+    /**
+     * Test one pair of bodies
+     * @return True if the bodies overlap
+     */
+    using PairFunction = bool (*)(const BodyStore& store, uint32_t a, uint32_t b, ContactPoint& point);
+
+    /**
+     * Test a batch of same-kind pairs
+     * Pair k of the batch is pairs[order[k]] (or pairs[k] without an order);
+     * its result goes to touching and normals at that same pair index
+     */
+    using BatchFunction = void (*)(const BodyStore& store, const Pair* pairs, const uint32_t* order,
+                                   size_t begin, size_t end, uint8_t* touching, Vector3* normals);
+
+    /**
+     * Get the pair kind of two bodies
+     * @param store Body store
+     * @param a Dense index of the first body
+     * @param b Dense index of the second body
+     * @return Index into the kernel tables
+     */
+    static size_t pairKind(const BodyStore& store, uint32_t a, uint32_t b) {
+        return store.shapes[a] * shapeTypeCount + store.shapes[b];
+    }
+
+    /**
+     * Get the pair kind of a shape-type pair
+     */
+    static constexpr size_t pairKind(ShapeType a, ShapeType b) {
+        return (size_t)a * shapeTypeCount + (size_t)b;
+    }
+
+    /**
+     * Check whether two bodies take part in collision at all
+     * @return True if both are active and they are not both asleep
+     */
+    static bool canCollide(const BodyStore& store, uint32_t a, uint32_t b) {
+        uint8_t shared = store.flags[a] & store.flags[b];
+        return (shared & BODY_ACTIVE) && !(shared & BODY_SLEEPING);
+    }
+
+    /**
+     * Test two bodies, whatever their shapes
+     * Sphere pairs, by far the most common, skip the table
+     * @param store Body store
+     * @param a Dense index of the first body
+     * @param b Dense index of the second body
+     * @param point Receives the normal from b toward a and the depth on overlap
+     * @return True if the shapes overlap
+     */
+    static bool collideBodies(const BodyStore& store, uint32_t a, uint32_t b, ContactPoint& point) {
+        size_t kind = pairKind(store, a, b);
+        if (kind == pairKind(ShapeType::Sphere, ShapeType::Sphere)) {
+            return collide(ShapeLoader<SphereShape>::load(store, a), ShapeLoader<SphereShape>::load(store, b),
+                           point);
+        }
+        return pairTable()[kind](store, a, b, point);
+    }
+
+    /**
+     * Intersect a ray with a body, whatever its shape
+     * @param store Body store
+     * @param body Dense body index
+     * @param start Ray origin
+     * @param direction Unit ray direction
+     * @param maxDistance Length of the ray
+     * @param hit Receives the distance and normal of the first hit
+     * @return True if the ray hits the body within maxDistance
+     */
+    static bool raycastBody(const BodyStore& store, uint32_t body, const Vector3& start, const Vector3& direction,
+                            float maxDistance, RayContact& hit) {
+        return rayTable()[store.shapes[body]](store, body, start, direction, maxDistance, hit);
+    }
+
+    /**
+     * Test a query sphere against a body, whatever its shape
+     * @param store Body store
+     * @param sphere Query sphere
+     * @param body Dense body index
+     * @param point Receives the normal from the body toward the sphere and the depth on overlap
+     * @return True if they overlap
+     */
+    static bool sphereOverlapsBody(const BodyStore& store, const SphereShape& sphere, uint32_t body,
+                                   ContactPoint& point) {
+        return sphereTable()[store.shapes[body]](store, sphere, body, point);
+    }
+
+    /**
+     * Get the batch kernel of a pair kind
+     * @param kind Pair kind
+     * @return Kernel that tests a batch of pairs of that kind
+     */
+    static BatchFunction batchFunction(size_t kind) {
+        return batchTable()[kind];
+    }
+
+private:
+    using RayFunction = bool (*)(const BodyStore& store, uint32_t body, const Vector3& start,
+                                 const Vector3& direction, float maxDistance, RayContact& hit);
+    using SphereFunction = bool (*)(const BodyStore& store, const SphereShape& sphere, uint32_t body,
+                                    ContactPoint& point);
+
+    template <size_t Kind>
+    using ShapeA = std::tuple_element_t<Kind / shapeTypeCount, Shapes>;
+    template <size_t Kind>
+    using ShapeB = std::tuple_element_t<Kind % shapeTypeCount, Shapes>;
+
+    template <size_t Kind>
+    static bool collidePair(const BodyStore& store, uint32_t a, uint32_t b, ContactPoint& point) {
+        return collide(ShapeLoader<ShapeA<Kind>>::load(store, a), ShapeLoader<ShapeB<Kind>>::load(store, b),
+                       point);
+    }
+
+    template <size_t Kind>
+    static void collideBatch(const BodyStore& store, const Pair* pairs, const uint32_t* order,
+                             size_t begin, size_t end, uint8_t* touching, Vector3* normals) {
+        for (size_t k = begin; k < end; ++k) {
+            uint32_t p = order ? order[k] : (uint32_t)k;
+            uint32_t a = pairs[p].first;
+            uint32_t b = pairs[p].second;
+            ContactPoint point;
+            bool hit = canCollide(store, a, b) &&
+                       collide(ShapeLoader<ShapeA<Kind>>::load(store, a), ShapeLoader<ShapeB<Kind>>::load(store, b),
+                               point);
+            touching[p] = hit ? 1 : 0;
+            if (hit) {
+                normals[p] = point.normal;
+            }
+        }
+    }
+
+    template <size_t Type>
+    static bool raycastShape(const BodyStore& store, uint32_t body, const Vector3& start, const Vector3& direction,
+                             float maxDistance, RayContact& hit) {
+        using Shape = std::tuple_element_t<Type, Shapes>;
+        return raycast(start, direction, maxDistance, ShapeLoader<Shape>::load(store, body), hit);
+    }
+
+    template <size_t Type>
+    static bool sphereAgainstShape(const BodyStore& store, const SphereShape& sphere, uint32_t body,
+                                   ContactPoint& point) {
+        using Shape = std::tuple_element_t<Type, Shapes>;
+        return collide(sphere, ShapeLoader<Shape>::load(store, body), point);
+    }
+
+    template <size_t... Kinds>
+    static constexpr std::array<PairFunction, sizeof...(Kinds)> makePairTable(std::index_sequence<Kinds...>) {
+        return { { &collidePair<Kinds>... } };
+    }
+
+    template <size_t... Kinds>
+    static constexpr std::array<BatchFunction, sizeof...(Kinds)> makeBatchTable(std::index_sequence<Kinds...>) {
+        return { { &collideBatch<Kinds>... } };
+    }
+
+    template <size_t... Types>
+    static constexpr std::array<RayFunction, sizeof...(Types)> makeRayTable(std::index_sequence<Types...>) {
+        return { { &raycastShape<Types>... } };
+    }
+
+    template <size_t... Types>
+    static constexpr std::array<SphereFunction, sizeof...(Types)> makeSphereTable(std::index_sequence<Types...>) {
+        return { { &sphereAgainstShape<Types>... } };
+    }
+
+    static const PairFunction* pairTable() {
+        static constexpr std::array<PairFunction, pairKindCount> table =
+            makePairTable(std::make_index_sequence<pairKindCount>());
+        return table.data();
+    }
+
+    static const BatchFunction* batchTable() {
+        static constexpr std::array<BatchFunction, pairKindCount> table =
+            makeBatchTable(std::make_index_sequence<pairKindCount>());
+        return table.data();
+    }
+
+    static const RayFunction* rayTable() {
+        static constexpr std::array<RayFunction, shapeTypeCount> table =
+            makeRayTable(std::make_index_sequence<shapeTypeCount>());
+        return table.data();
+    }
+
+    static const SphereFunction* sphereTable() {
+        static constexpr std::array<SphereFunction, shapeTypeCount> table =
+            makeSphereTable(std::make_index_sequence<shapeTypeCount>());
+        return table.data();
+    }
+};
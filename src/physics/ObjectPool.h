@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+/**
+ * Fixed-type object pool backed by large blocks
+ * Objects are constructed in place inside blocks of blockSize slots, and freed
+ * slots are recycled through a free list, so creating and destroying objects
+ * does not touch the general heap once enough blocks exist. Addresses stay
+ * stable for the object's lifetime.
+ *
+ * The pool only releases memory; every live object must be destroyed through
+ * destroy() before the pool goes away.
+ */
+template <typename T, size_t blockSize = 4096>
+class ObjectPool {
+private:
+    /**
+     * Raw storage for blockSize objects
+     */
+    struct Block {
+        alignas(T) unsigned char storage[sizeof(T) * blockSize];
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;     // Allocated blocks
+    std::vector<T*> freeSlots;                      // Unused slots, most recently freed last
+    size_t liveCount;                               // Objects currently constructed
+
+public:
+    /**
+     * Constructor - creates an empty pool
+     */
+    ObjectPool()
+        : liveCount(0) {
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * Make sure at least count more objects can be created without allocating
+     * @param count Number of additional objects
+     */
+    void reserve(size_t count) {
+        while (freeSlots.size() < count) {
+            addBlock();
+        }
+    }
+
+    /**
+     * Construct an object in a free slot
+     * @param args Constructor arguments
+     * @return Pointer to the new object
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (freeSlots.empty()) {
+            addBlock();
+        }
+        T* slot = freeSlots.back();
+        T* object = new (slot) T(std::forward<Args>(args)...);
+        freeSlots.pop_back();
+        liveCount++;
+        return object;
+    }
+
+    /**
+     * Destroy an object created by this pool and recycle its slot
+     * @param object Object to destroy
+     */
+    void destroy(T* object) {
+        object->~T();
+        freeSlots.push_back(object);
+        liveCount--;
+    }
+
+    /**
+     * Get the number of live objects
+     * @return Object count
+     */
+    size_t size() const {
+        return liveCount;
+    }
+
+    /**
+     * Get the number of slots allocated
+     * @return Slot count
+     */
+    size_t capacity() const {
+        return blocks.size() * blockSize;
+    }
+
+private:
+    /**
+     * Allocate one block and push its slots on the free list
+     * Slots are pushed in reverse so they are handed out in address order
+     */
+    void addBlock() {
+        blocks.push_back(std::unique_ptr<Block>(new Block));  // Default-init: storage is not zeroed
+        T* first = reinterpret_cast<T*>(blocks.back()->storage);
+        freeSlots.reserve(freeSlots.size() + blockSize);
+        for (size_t i = blockSize; i-- > 0;) {
+            freeSlots.push_back(first + i);
+        }
+    }
+};
@@ -1,104 +1,234 @@
 #pragma once
 #include "Vector3.h"
+#include "BodyStore.h"
+#include <algorithm>
 
 /**
  * Physics Body class representing a physical object in the simulation
- * Handles position, velocity, forces, and basic physics properties
+ * Acts as a proxy onto the body's slot in a BodyStore, where position,
+ * velocity, forces and material properties are kept as contiguous arrays
  */
 class PhysicsBody {
+protected:
+    BodyStore* store;       // Store holding this body's state
+    BodyHandle handle;      // Stable handle into the store
+
 public:
-    Vector3 position;       // Current position in world space
-    Vector3 velocity;       // Current velocity vector
-    Vector3 acceleration;   // Current acceleration vector
-    Vector3 force;          // Net force acting on the body
-    
-    float mass;             // Mass of the object (kg)
-    float restitution;      // Bounciness coefficient (0 = no bounce, 1 = perfect bounce)
-    float friction;         // Friction coefficient
-    float radius;           // Radius for sphere collision (simplified collision)
-    
-    bool isStatic;          // If true, object doesn't move (infinite mass)
-    bool isActive;          // If false, object is not updated
-    
-    /**
-     * Default constructor - creates a default physics body
-     */
-    PhysicsBody() 
-        : position(0, 0, 0)
-        , velocity(0, 0, 0)
-        , acceleration(0, 0, 0)
-        , force(0, 0, 0)
-        , mass(1.0f)
-        , restitution(0.7f)
-        , friction(0.5f)
-        , radius(0.5f)
-        , isStatic(false)
-        , isActive(true) {}
-
-    /**
-     * Constructor with position and mass
-     * @param pos Initial position
-     * @param m Mass of the object
-     * @param r Radius of the object
-     */
-    PhysicsBody(const Vector3& pos, float m, float r)
-        : position(pos)
-        , velocity(0, 0, 0)
-        , acceleration(0, 0, 0)
-        , force(0, 0, 0)
-        , mass(m)
-        , restitution(0.7f)
-        , friction(0.5f)
-        , radius(r)
-        , isStatic(false)
-        , isActive(true) {}
-
-    /**
-     * Apply a force to the physics body
+    /**
+     * Constructor - binds the proxy to an existing body slot
+     * @param bodyStore Store holding the body state
+     * @param bodyHandle Handle of the body in the store
+     */
+    PhysicsBody(BodyStore& bodyStore, BodyHandle bodyHandle)
+        : store(&bodyStore)
+        , handle(bodyHandle) {
+        store->owners[slot()] = this;
+    }
+
+    virtual ~PhysicsBody() = default;
+
+    /**
+     * Get the handle of this body in its store
+     * @return Body handle
+     */
+    BodyHandle getHandle() const {
+        return handle;
+    }
+
+    /**
+     * Current position in world space
+     * @return Reference to the stored position (valid until bodies are added or removed)
+     */
+    Vector3& position() { return store->positions[slot()]; }
+    const Vector3& position() const { return store->positions[slot()]; }
+
+    /**
+     * Current velocity vector
+     * @return Reference to the stored velocity (valid until bodies are added or removed)
+     */
+    Vector3& velocity() { return store->velocities[slot()]; }
+    const Vector3& velocity() const { return store->velocities[slot()]; }
+
+    /**
+     * Net force acting on the body
+     * @return Reference to the stored force (valid until bodies are added or removed)
+     */
+    Vector3& force() { return store->forces[slot()]; }
+    const Vector3& force() const { return store->forces[slot()]; }
+
+    /**
+     * RGB render color (0.0 to 1.0)
+     * @return Reference to the stored color (valid until bodies are added or removed)
+     */
+    Vector3& color() { return store->colors[slot()]; }
+    const Vector3& color() const { return store->colors[slot()]; }
+
+    /**
+     * Get the mass of the object
+     * @return Mass (kg)
+     */
+    float getMass() const {
+        return store->masses[slot()];
+    }
+
+    /**
+     * Set the mass of the object
+     * @param m New mass (kg)
+     */
+    void setMass(float m) {
+        uint32_t i = slot();
+        store->masses[i] = m;
+        store->inverseMasses[i] = isStatic() ? 0.0f : 1.0f / m;
+    }
+
+    /**
+     * Get the collision radius
+     * @return Sphere radius, or the bounding radius of other shapes
+     */
+    float getRadius() const {
+        return store->radii[slot()];
+    }
+
+    /**
+     * Set the collision radius
+     * @param r New radius
+     */
+    void setRadius(float r) {
+        store->radii[slot()] = r;
+    }
+
+    /**
+     * Get the collision shape
+     * @return Shape type
+     */
+    ShapeType getShape() const {
+        return (ShapeType)store->shapes[slot()];
+    }
+
+    /**
+     * Get the shape dimensions
+     * @return Extents as described by ShapeType
+     */
+    const Vector3& getExtents() const {
+        return store->extents[slot()];
+    }
+
+    /**
+     * Change the collision shape (also updates the bounding radius)
+     * @param shape Shape type
+     * @param extents Shape dimensions as described by ShapeType
+     */
+    void setShape(ShapeType shape, const Vector3& extents) {
+        store->setShape(slot(), shape, extents);
+    }
+
+    /**
+     * Get the bounciness coefficient
+     * @return Restitution (0 = no bounce, 1 = perfect bounce)
+     */
+    float getRestitution() const {
+        return store->restitutions[slot()];
+    }
+
+    /**
+     * Get the friction coefficient
+     * @return Friction value
+     */
+    float getFriction() const {
+        return store->frictions[slot()];
+    }
+
+    /**
+     * Check if the body is static (infinite mass)
+     * @return True if the object doesn't move
+     */
+    bool isStatic() const {
+        return (store->flags[slot()] & BODY_STATIC) != 0;
+    }
+
+    /**
+     * Check if the body is active
+     * @return False if the object is not updated
+     */
+    bool isActive() const {
+        return (store->flags[slot()] & BODY_ACTIVE) != 0;
+    }
+
+    /**
+     * Set whether the body is updated and collides
+     * @param active True to activate, false to deactivate
+     */
+    void setActive(bool active) {
+        setFlag(BODY_ACTIVE, active);
+    }
+
+    /**
+     * Check if the body is asleep
+     * @return True if the simulation is skipping this body until it is woken
+     */
+    bool isSleeping() const {
+        return (store->flags[slot()] & BODY_SLEEPING) != 0;
+    }
+
+    /**
+     * Wake the body so it is simulated again
+     */
+    void wake() {
+        uint32_t i = slot();
+        store->flags[i] &= (uint8_t)~BODY_SLEEPING;
+        store->restSteps[i] = 0;
+    }
+
+    /**
+     * Apply a force to the physics body (wakes it)
      * @param f Force vector to apply
      */
     void applyForce(const Vector3& f) {
-        if (!isStatic) {
-            force += f;
+        if (!isStatic()) {
+            wake();
+            force() += f;
         }
     }
 
     /**
-     * Apply an impulse (instantaneous change in momentum)
+     * Apply an impulse (instantaneous change in momentum, wakes the body)
      * @param impulse Impulse vector to apply
      */
     void applyImpulse(const Vector3& impulse) {
-        if (!isStatic) {
-            velocity += impulse / mass;
+        if (!isStatic()) {
+            wake();
+            velocity() += impulse / getMass();
         }
     }
 
     /**
      * Update physics body for one time step using Euler integration
+     * PhysicsWorld integrates the store arrays directly; this per-body path is
+     * kept as the scalar reference for the batched integrator
      * @param deltaTime Time step in seconds
      */
     virtual void update(float deltaTime) {
-        if (!isActive || isStatic) {
+        if (!isActive() || isStatic() || isSleeping()) {
             return;
         }
 
         // Calculate acceleration from force (F = ma -> a = F/m)
-        acceleration = force / mass;
-        
+        Vector3 acceleration = force() / getMass();
+
         // Apply gravity
         acceleration += Vector3(0, -9.81f, 0);
-        
+
         // Update velocity using acceleration
-        velocity += acceleration * deltaTime;
-        
+        velocity() += acceleration * deltaTime;
+
         // Apply air resistance (simple drag)
-        velocity *= 0.999f;
-        
+        velocity() *= 0.999f;
+
         // Update position using velocity
-        position += velocity * deltaTime;
-        
+        position() += velocity() * deltaTime;
+
         // Reset forces for next frame
-        force = Vector3::ZERO;
+        force() = Vector3::ZERO;
     }
 
     /**
@@ -106,7 +236,7 @@ public:
      * @return Inverse mass (0 for static objects)
      */
     float getInverseMass() const {
-        return isStatic ? 0.0f : 1.0f / mass;
+        return store->inverseMasses[slot()];
     }
 
     /**
@@ -115,12 +245,12 @@ public:
      * @return True if bodies are colliding
      */
     bool isCollidingWith(const PhysicsBody& other) const {
-        if (!isActive || !other.isActive) {
+        if (!isActive() || !other.isActive()) {
             return false;
         }
-        
-        float distance = (position - other.position).magnitude();
-        return distance < (radius + other.radius);
+
+        float distance = (position() - other.position()).magnitude();
+        return distance < (getRadius() + other.getRadius());
     }
 
     /**
@@ -129,7 +259,7 @@ public:
      * @return Distance between centers
      */
     float getDistanceTo(const PhysicsBody& other) const {
-        return (position - other.position).magnitude();
+        return (position() - other.position()).magnitude();
     }
 
     /**
@@ -137,11 +267,12 @@ public:
      * @param static_state True to make static, false to make dynamic
      */
     void setStatic(bool static_state) {
-        isStatic = static_state;
-        if (isStatic) {
-            velocity = Vector3::ZERO;
-            acceleration = Vector3::ZERO;
-            force = Vector3::ZERO;
+        uint32_t i = slot();
+        setFlag(BODY_STATIC, static_state);
+        store->inverseMasses[i] = static_state ? 0.0f : 1.0f / store->masses[i];
+        if (static_state) {
+            store->velocities[i] = Vector3::ZERO;
+            store->forces[i] = Vector3::ZERO;
         }
     }
 
@@ -150,7 +281,7 @@ public:
      * @param rest Restitution value (0.0 to 1.0)
      */
     void setRestitution(float rest) {
-        restitution = std::max(0.0f, std::min(1.0f, rest));
+        store->restitutions[slot()] = std::max(0.0f, std::min(1.0f, rest));
     }
 
     /**
@@ -158,6 +289,25 @@ public:
      * @param frict Friction value (0.0 to 1.0)
      */
     void setFriction(float frict) {
-        friction = std::max(0.0f, std::min(1.0f, frict));
+        store->frictions[slot()] = std::max(0.0f, std::min(1.0f, frict));
+    }
+
+protected:
+    /**
+     * Resolve this body's dense index in the store
+     * @return Index into the store arrays
+     */
+    uint32_t slot() const {
+        return store->denseIndex(handle);
+    }
+
+    /**
+     * Set or clear a flag bit
+     * @param flag Flag to change
+     * @param enabled True to set, false to clear
+     */
+    void setFlag(BodyFlags flag, bool enabled) {
+        uint8_t& bits = store->flags[slot()];
+        bits = enabled ? (uint8_t)(bits | flag) : (uint8_t)(bits & ~flag);
     }
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include "Vector3.h"
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Render-side copy of the state needed to draw the world after one physics tick
+ * Holds ball positions from the start and end of the tick so the renderer can
+ * interpolate between them
+ */
+struct PhysicsSnapshot {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Vector3> previousPositions;    // Ball positions before the tick
+    std::vector<Vector3> positions;            // Ball positions after the tick
+    std::vector<float> radii;                  // Ball radii
+    std::vector<Vector3> colors;               // Ball colors
+    std::vector<uint32_t> clusterStart;        // Cluster k holds balls [clusterStart[k], clusterStart[k + 1])
+    std::vector<Vector3> clusterMin;           // Per-cluster bounds minimum over the whole tick
+    std::vector<Vector3> clusterMax;           // Per-cluster bounds maximum over the whole tick
+    std::vector<Vector3> previousBoxPositions; // Box and capsule positions before the tick
+    std::vector<Vector3> boxPositions;         // Box and capsule positions after the tick
+    std::vector<Vector3> boxExtents;           // Bounding-box half size of each box and capsule
+    std::vector<Vector3> boxColors;            // Box and capsule colors
+    float worldBounds[6] = { 0, 0, 0, 0, 0, 0 };  // World boundaries [minX, maxX, minY, maxY, minZ, maxZ]
+
+    uint64_t tick = 0;                         // Number of ticks simulated when this was taken
+    Clock::time_point tickTime;                // Wall-clock time the tick was scheduled for
+    float tickDuration = 1.0f / 60.0f;         // Simulated seconds per tick
+    uint32_t contactCount = 0;                 // Touching body pairs found by the tick
+
+    /**
+     * Get the number of balls in the snapshot
+     * @return Ball count
+     */
+    size_t size() const {
+        return positions.size();
+    }
+
+    /**
+     * Remove all balls, keeping capacity
+     */
+    void clear() {
+        previousPositions.clear();
+        positions.clear();
+        radii.clear();
+        colors.clear();
+        clusterStart.clear();
+        clusterMin.clear();
+        clusterMax.clear();
+        previousBoxPositions.clear();
+        boxPositions.clear();
+        boxExtents.clear();
+        boxColors.clear();
+    }
+
+    /**
+     * Get the number of culling clusters
+     * @return Cluster count
+     */
+    size_t clusterCount() const {
+        return clusterMin.size();
+    }
+
+    /**
+     * Split the balls into runs of clusterSize and bound each run
+     * Bounds cover both the start and end of the tick, so they hold for any
+     * interpolation factor. Balls should already be in spatially coherent order.
+     * @param clusterSize Balls per cluster
+     */
+    void buildClusters(size_t clusterSize) {
+        clusterStart.clear();
+        clusterMin.clear();
+        clusterMax.clear();
+
+        size_t count = size();
+        for (size_t begin = 0; begin < count; begin += clusterSize) {
+            size_t end = begin + clusterSize < count ? begin + clusterSize : count;
+            Vector3 low = positions[begin];
+            Vector3 high = positions[begin];
+            for (size_t i = begin; i < end; ++i) {
+                const Vector3* ends[2] = { &previousPositions[i], &positions[i] };
+                for (const Vector3* p : ends) {
+                    low = Vector3(std::min(low.x, p->x - radii[i]), std::min(low.y, p->y - radii[i]),
+                                  std::min(low.z, p->z - radii[i]));
+                    high = Vector3(std::max(high.x, p->x + radii[i]), std::max(high.y, p->y + radii[i]),
+                                   std::max(high.z, p->z + radii[i]));
+                }
+            }
+            clusterStart.push_back((uint32_t)begin);
+            clusterMin.push_back(low);
+            clusterMax.push_back(high);
+        }
+        clusterStart.push_back((uint32_t)count);
+    }
+
+    /**
+     * Interpolation factor for rendering at a given time
+     * Rendering runs one tick behind the simulation, so the factor is how far
+     * the render time has advanced past this tick's scheduled time
+     * @param now Current wall-clock time
+     * @return Blend factor in [0, 1] from previousPositions to positions
+     */
+    float interpolationFactor(Clock::time_point now) const {
+        float elapsed = std::chrono::duration<float>(now - tickTime).count();
+        float alpha = elapsed / tickDuration;
+        return alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+    }
+
+    /**
+     * Get an interpolated ball position
+     * @param index Ball index
+     * @param alpha Blend factor from interpolationFactor
+     * @return Position between the start and end of the tick
+     */
+    Vector3 interpolatedPosition(size_t index, float alpha) const {
+        return previousPositions[index] + (positions[index] - previousPositions[index]) * alpha;
+    }
+
+    /**
+     * Get an interpolated box or capsule position
+     * @param index Index into boxPositions
+     * @param alpha Blend factor from interpolationFactor
+     * @return Position between the start and end of the tick
+     */
+    Vector3 interpolatedBoxPosition(size_t index, float alpha) const {
+        return previousBoxPositions[index] + (boxPositions[index] - previousBoxPositions[index]) * alpha;
+    }
+};
+
+/**
+ * Lock-free triple buffer of snapshots with one writer and one reader
+ * The writer fills its private slot and swaps it with the shared middle slot;
+ * the reader swaps the middle slot for its own whenever a newer one is there.
+ * Neither side ever waits for the other.
+ */
+class SnapshotBuffer {
+private:
+    PhysicsSnapshot slots[3];           // Snapshot storage
+    int writeIndex;                     // Slot owned by the writer
+    int readIndex;                      // Slot owned by the reader
+    std::atomic<int> middle;            // Shared slot index, with freshBit set when unread
+
+    static constexpr int freshBit = 4;  // Marks a published snapshot the reader has not taken yet
+    static constexpr int indexMask = 3;
+
+public:
+    /**
+     * Constructor - creates three empty snapshots
+     */
+    SnapshotBuffer()
+        : writeIndex(0)
+        , readIndex(1)
+        , middle(2) {
+    }
+
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    /**
+     * Get the writer's slot to fill (writer thread only)
+     * @return Snapshot to overwrite
+     */
+    PhysicsSnapshot& writeSlot() {
+        return slots[writeIndex];
+    }
+
+    /**
+     * Publish the writer's slot and take over the previous middle slot (writer thread only)
+     */
+    void publish() {
+        int previous = middle.exchange(writeIndex | freshBit, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    /**
+     * Get the newest published snapshot (reader thread only)
+     * The reference stays valid until the next call
+     * @return Latest snapshot
+     */
+    const PhysicsSnapshot& acquire() {
+        if (middle.load(std::memory_order_relaxed) & freshBit) {
+            int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previous & indexMask;
+        }
+        return slots[readIndex];
+    }
+};
@@ -0,0 +1,405 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "PhysicsSnapshot.h"
+#include "ReplayRecorder.h"
+#include "WorldShards.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * PhysicsThread steps a PhysicsWorld at a fixed tick on its own thread
+ * Wall-clock time feeds an accumulator, so simulated time keeps pace with real
+ * time regardless of the frame rate. Every tick publishes a PhysicsSnapshot
+ * for the renderer through a triple buffer, so neither side waits on the other.
+ *
+ * The world may only be touched from commands: post() queues a command without
+ * blocking and withWorld() runs one immediately while the physics thread is
+ * between ticks. Queued commands always run before the next tick or withWorld().
+ */
+class PhysicsThread {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Command = std::function<void(PhysicsWorld&)>;
+
+private:
+    PhysicsWorld& world;                        // World owned by the caller
+    std::thread thread;                         // Simulation thread
+    std::mutex worldMutex;                      // Held while ticking or running withWorld
+    /**
+     * A command that waits for the tick covering its time
+     */
+    struct TimedCommand {
+        Clock::time_point time;                 // When the triggering event happened
+        Command command;                        // Command to run
+    };
+
+    std::mutex commandMutex;                    // Guards pendingCommands and timedCommands
+    std::vector<Command> pendingCommands;       // Commands posted since the last drain
+    std::vector<Command> runningCommands;       // Commands being executed (drain scratch)
+    std::vector<TimedCommand> timedCommands;    // Timed commands not yet due, oldest first
+    std::vector<TimedCommand> dueCommands;      // Timed commands being executed (drain scratch)
+
+    SnapshotBuffer snapshots;                   // Physics -> render snapshot hand-off
+    std::vector<uint32_t> snapshotBodies;       // Dense indices captured in the current snapshot
+    std::vector<uint32_t> snapshotBoxes;        // Dense indices of the boxes and capsules captured
+    ReplayRecorder* recorder;                   // Captures every tick when set (guarded by worldMutex)
+    WorldShards shards;                         // Spatial shards the world is stepped through (guarded by worldMutex)
+
+    std::atomic<bool> running;                  // Cleared to stop the thread
+    std::atomic<bool> paused;                   // Ticks are skipped while set
+    std::atomic<bool> snapshotStale;            // World changed outside a tick
+    float tickDuration;                         // Simulated seconds per tick
+    uint64_t tickCount;                         // Ticks simulated so far (physics thread only)
+
+    std::atomic<uint64_t> droppedTicks;         // Ticks skipped because the simulation fell behind
+    std::atomic<float> lastTickMilliseconds;    // CPU time of the most recent tick
+    std::atomic<int> maxCatchUpTicks;           // Ticks run back to back before dropping backlog
+
+    static constexpr int defaultCatchUpTicks = 8;   // Initial maxCatchUpTicks
+    static constexpr size_t clusterSize = 64;   // Snapshot balls per culling cluster
+
+public:
+    /**
+     * Constructor - prepares the thread without starting it
+     * @param physicsWorld World to simulate (must outlive this object)
+     */
+    explicit PhysicsThread(PhysicsWorld& physicsWorld)
+        : world(physicsWorld)
+        , recorder(nullptr)
+        , running(false)
+        , paused(false)
+        , snapshotStale(true)
+        , tickDuration(physicsWorld.getTimeStep())
+        , tickCount(0)
+        , droppedTicks(0)
+        , lastTickMilliseconds(0.0f)
+        , maxCatchUpTicks(defaultCatchUpTicks) {
+    }
+
+    /**
+     * Destructor - stops the thread
+     */
+    ~PhysicsThread() {
+        stop();
+    }
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    /**
+     * Start ticking the world
+     */
+    void start() {
+        if (running.exchange(true)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(worldMutex);
+            publishSnapshot(Clock::now(), false);
+        }
+        thread = std::thread([this]() { threadLoop(); });
+    }
+
+    /**
+     * Stop ticking and join the thread
+     */
+    void stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        thread.join();
+    }
+
+    /**
+     * Queue a command to run on the world before the next tick (never blocks on a tick)
+     * @param command Command to run
+     */
+    void post(Command command) {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        pendingCommands.push_back(std::move(command));
+    }
+
+    /**
+     * Queue a command for the first tick scheduled at or after a time (never blocks on a tick)
+     * Use for input: when the simulation is catching up several ticks at once, the
+     * command lands in the tick its event happened in instead of the first one.
+     * A time already covered by an earlier tick runs before the next tick.
+     * @param time When the triggering event happened (Clock, e.g. InputEvent::time)
+     * @param command Command to run
+     */
+    void postAt(Clock::time_point time, Command command) {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        timedCommands.push_back({ time, std::move(command) });
+    }
+
+    /**
+     * Run a command on the calling thread while the simulation is between ticks
+     * Blocks until any tick in progress finishes. Posted commands run first.
+     * @param command Command to run
+     */
+    void withWorld(const Command& command) {
+        std::lock_guard<std::mutex> lock(worldMutex);
+        drainCommands();
+        command(world);
+        snapshotStale = true;
+    }
+
+    /**
+     * Capture every tick into a replay recorder
+     * @param replayRecorder Recorder to feed (must outlive its use), or nullptr to stop
+     */
+    void setRecorder(ReplayRecorder* replayRecorder) {
+        std::lock_guard<std::mutex> lock(worldMutex);
+        recorder = replayRecorder;
+    }
+
+    /**
+     * Step the world as spatial shards on separate workers
+     * @param count Number of shards (1 = step the world directly)
+     */
+    void setShardCount(size_t count) {
+        std::lock_guard<std::mutex> lock(worldMutex);
+        shards.setShardCount(count);
+    }
+
+    /**
+     * Get the shards the world is stepped through
+     * Only valid while holding the world (inside a withWorld command)
+     * @return Shards
+     */
+    const WorldShards& getShards() const {
+        return shards;
+    }
+
+    /**
+     * Get the newest snapshot (render thread only)
+     * @return Snapshot, valid until the next call
+     */
+    const PhysicsSnapshot& acquireSnapshot() {
+        return snapshots.acquire();
+    }
+
+    /**
+     * Pause or resume the simulation
+     * @param pause True to stop ticking
+     */
+    void setPaused(bool pause) {
+        paused = pause;
+    }
+
+    /**
+     * Check whether the simulation is paused
+     * @return True if paused
+     */
+    bool isPaused() const {
+        return paused;
+    }
+
+    /**
+     * Get the number of ticks dropped because the simulation could not keep up
+     * @return Dropped tick count
+     */
+    uint64_t getDroppedTicks() const {
+        return droppedTicks;
+    }
+
+    /**
+     * Limit how many ticks run back to back when the simulation falls behind
+     * Fewer catch-up ticks drop backlog sooner: the simulation runs slower than
+     * real time under load instead of stalling the ticks after it.
+     * @param ticks Catch-up ticks per wake (at least 1)
+     */
+    void setMaxCatchUpTicks(int ticks) {
+        maxCatchUpTicks = std::max(ticks, 1);
+    }
+
+    /**
+     * Get how many ticks run back to back when the simulation falls behind
+     * @return Catch-up ticks per wake
+     */
+    int getMaxCatchUpTicks() const {
+        return maxCatchUpTicks;
+    }
+
+    /**
+     * Get the CPU time of the most recent tick
+     * @return Tick duration in milliseconds
+     */
+    float getLastTickMilliseconds() const {
+        return lastTickMilliseconds;
+    }
+
+    /**
+     * Get the simulated time per tick
+     * @return Tick length in seconds
+     */
+    float getTickDuration() const {
+        return tickDuration;
+    }
+
+private:
+    /**
+     * Simulation thread main loop
+     */
+    void threadLoop() {
+        auto tickLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(tickDuration));
+        Clock::time_point nextTick = Clock::now() + tickLength;
+        Profiler::get().setThreadName("physics");
+
+        while (running) {
+            Clock::time_point now = Clock::now();
+
+            if (paused) {
+                // Keep serving commands so the scene still reflects console changes
+                {
+                    std::lock_guard<std::mutex> lock(worldMutex);
+                    drainCommands();
+                    if (snapshotStale) {
+                        publishSnapshot(now, false);
+                    }
+                }
+                nextTick = now + tickLength;
+                std::this_thread::sleep_until(nextTick);
+                continue;
+            }
+
+            int ticks = 0;
+            int catchUpTicks = maxCatchUpTicks;
+            while (now >= nextTick && ticks < catchUpTicks) {
+                Clock::time_point tickStart = Clock::now();
+                {
+                    PROFILE_SCOPE("physics.tick");
+                    std::lock_guard<std::mutex> lock(worldMutex);
+                    drainCommands(nextTick);
+                    beginSnapshot();
+                    shards.step(world, tickDuration);
+                    tickCount++;
+                    if (recorder) {
+                        recorder->capture(world);
+                    }
+                    publishSnapshot(nextTick, true);
+                }
+                lastTickMilliseconds = std::chrono::duration<float, std::milli>(Clock::now() - tickStart).count();
+                nextTick += tickLength;
+                ticks++;
+            }
+
+            // Too far behind to catch up: drop the backlog instead of spiralling
+            if (now >= nextTick) {
+                uint64_t behind = (uint64_t)((now - nextTick) / tickLength) + 1;
+                droppedTicks += behind;
+                nextTick += tickLength * behind;
+            }
+
+            std::this_thread::sleep_until(nextTick);
+        }
+    }
+
+    /**
+     * Run every posted command, then the timed commands that are due (caller holds worldMutex)
+     * @param tickTime Scheduled time of the tick about to run; max() runs every timed command
+     */
+    void drainCommands(Clock::time_point tickTime = Clock::time_point::max()) {
+        {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            runningCommands.swap(pendingCommands);
+            size_t due = 0;
+            while (due < timedCommands.size() && timedCommands[due].time <= tickTime) {
+                due++;
+            }
+            dueCommands.assign(std::make_move_iterator(timedCommands.begin()),
+                               std::make_move_iterator(timedCommands.begin() + due));
+            timedCommands.erase(timedCommands.begin(), timedCommands.begin() + due);
+        }
+        for (Command& command : runningCommands) {
+            command(world);
+        }
+        for (TimedCommand& timed : dueCommands) {
+            timed.command(world);
+        }
+        if (!runningCommands.empty() || !dueCommands.empty()) {
+            snapshotStale = true;
+        }
+        runningCommands.clear();
+        dueCommands.clear();
+    }
+
+    /**
+     * Record which bodies are drawn and where they start the tick (caller holds worldMutex)
+     */
+    void beginSnapshot() {
+        const BodyStore& store = world.getBodyStore();
+        PhysicsSnapshot& snapshot = snapshots.writeSlot();
+        snapshot.clear();
+        snapshotBodies.clear();
+        snapshotBoxes.clear();
+
+        // Walk bodies in broadphase cell order when the last grid still matches the
+        // store, so consecutive snapshot balls are close together and form tight
+        // culling clusters; otherwise fall back to storage order
+        const std::vector<uint32_t>& cellBodies = world.getGridBroadphase().getCellBodies();
+        bool cellOrder = world.getBroadphaseMode() == BroadphaseMode::UniformGrid &&
+                         cellBodies.size() == store.size();
+
+        for (size_t k = 0; k < store.size(); ++k) {
+            uint32_t i = cellOrder ? cellBodies[k] : (uint32_t)k;
+            if ((store.flags[i] & (BODY_BALL | BODY_ACTIVE)) == (BODY_BALL | BODY_ACTIVE)) {
+                snapshotBodies.push_back(i);
+                snapshot.previousPositions.push_back(store.positions[i]);
+            }
+        }
+
+        // Planes are infinite and not drawn
+        for (uint32_t i = 0; i < (uint32_t)store.size(); ++i) {
+            if ((store.flags[i] & (BODY_SHAPED | BODY_ACTIVE)) == (BODY_SHAPED | BODY_ACTIVE) &&
+                store.shapes[i] != (uint8_t)ShapeType::Plane) {
+                snapshotBoxes.push_back(i);
+                snapshot.previousBoxPositions.push_back(store.positions[i]);
+            }
+        }
+    }
+
+    /**
+     * Fill in end-of-tick state and hand the snapshot to the renderer (caller holds worldMutex)
+     * @param tickTime Wall-clock time the tick was scheduled for
+     * @param afterTick True if beginSnapshot ran before this tick, false to capture a still frame
+     */
+    void publishSnapshot(Clock::time_point tickTime, bool afterTick) {
+        const BodyStore& store = world.getBodyStore();
+        if (!afterTick) {
+            beginSnapshot();
+        }
+
+        PhysicsSnapshot& snapshot = snapshots.writeSlot();
+        for (uint32_t i : snapshotBodies) {
+            snapshot.positions.push_back(store.positions[i]);
+            snapshot.radii.push_back(store.radii[i]);
+            snapshot.colors.push_back(store.colors[i]);
+        }
+        snapshot.buildClusters(clusterSize);
+        for (uint32_t i : snapshotBoxes) {
+            snapshot.boxPositions.push_back(store.positions[i]);
+            snapshot.boxExtents.push_back(store.extents[i]);
+            snapshot.boxColors.push_back(store.colors[i]);
+        }
+
+        const float* bounds = world.getWorldBounds();
+        for (int i = 0; i < 6; ++i) {
+            snapshot.worldBounds[i] = bounds[i];
+        }
+        snapshot.tick = tickCount;
+        snapshot.tickTime = tickTime;
+        snapshot.tickDuration = tickDuration;
+        snapshot.contactCount = (uint32_t)world.getContactCount();
+
+        snapshots.publish();
+        snapshotStale = false;
+    }
+};
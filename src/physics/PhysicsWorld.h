@@ -1,10 +1,64 @@
 #pragma once
+#include "BodyStore.h"
 #include "PhysicsBody.h"
 #include "Ball.h"
+#include "Broadphase.h"
+#include "Narrowphase.h"
+#include "SpatialQueries.h"
+#include "SimdKernels.h"
+#include "JobSystem.h"
+#include "BodySpan.h"
+#include "CounterRng.h"
+#include "ObjectPool.h"
+#include "ContactCache.h"
+#include "Profiler.h"
 #include <vector>
-#include <memory>
 #include <algorithm>
-#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+
+/**
+ * Contact resolution strategies
+ */
+enum class ContactSolveMode {
+    Sequential,     // Solve contacts one by one in detection order on the calling thread
+    Colored         // Graph-color contacts and solve each color in parallel, deterministic for any thread count
+};
+
+/**
+ * Wall-clock time spent in each phase of PhysicsWorld::step, summed over the
+ * steps since the last reset (collected only while step timing is enabled)
+ */
+struct StepTimings {
+    double integrate = 0.0;        // Euler integration (seconds)
+    double broadphase = 0.0;       // Grid build and candidate pairs
+    double narrowphase = 0.0;      // Overlap tests and contact collection (all pairs in brute force)
+    double solve = 0.0;            // Contact coloring and the impulse solver
+    double continuous = 0.0;       // Fast-body collection and sweeps
+    double boundaries = 0.0;       // World boundary clamping
+    double sleep = 0.0;            // Island sleep pass
+    uint64_t steps = 0;            // Steps timed
+
+    /**
+     * Get the total time across every phase
+     * @return Seconds
+     */
+    double total() const {
+        return integrate + broadphase + narrowphase + solve + continuous + boundaries + sleep;
+    }
+};
+
+/**
+ * Counters of a step simulated outside PhysicsWorld::step (see finishExternalStep)
+ */
+struct ExternalStepStats {
+    size_t sleeping = 0;           // Bodies asleep after the step
+    size_t swept = 0;              // Bodies swept by continuous collision
+    size_t contacts = 0;           // Body-pair contacts
+    size_t cachedContacts = 0;     // Contacts held for warm starting
+};
 
 /**
  * PhysicsWorld class manages all physics bodies and handles collision detection/resolution
@@ -12,11 +66,121 @@
  */
 class PhysicsWorld {
 private:
-    std::vector<std::unique_ptr<PhysicsBody>> bodies;  // All physics bodies in the world
+    using Clock = std::chrono::steady_clock;
+    
+    BodyStore store;                                   // SoA state of every body in the world
+    ObjectPool<PhysicsBody> bodyPool;                  // Storage for generic body proxies
+    ObjectPool<Ball> ballPool;                         // Storage for ball proxies
+    std::vector<PhysicsBody*> bodies;                  // Proxy objects handed out to callers, in dense order
+    std::vector<Ball*> balls;                          // Per-type index of the ball proxies
+    std::vector<uint32_t> ballSlots;                   // Position in balls of each ball, by handle slot
+    std::vector<BodyHandle> removalHandles;            // Scratch for batched removal
     Vector3 gravity;                                   // Global gravity vector
     float worldBounds[6];                              // World boundaries [minX, maxX, minY, maxY, minZ, maxZ]
     float timeStep;                                    // Fixed time step for physics simulation
     int maxSubsteps;                                   // Maximum substeps per frame
+    float accumulator;                                 // Unsimulated time carried between updates
+    uint64_t randomSeed;                               // Seed of the collision jitter stream
+    uint64_t stepCount;                                // Steps simulated so far (keys the jitter stream)
+    
+    // Broadphase collision detection
+    BroadphaseMode broadphaseMode;                     // Active broadphase algorithm
+    float broadphaseRegion[6];                         // Box the grid covers when hasBroadphaseRegion is set
+    bool hasBroadphaseRegion;                          // Grid covers broadphaseRegion instead of worldBounds
+    UniformGridBroadphase gridBroadphase;              // Uniform grid used in UniformGrid mode
+    uint64_t gridStep;                                 // Step count when gridBroadphase was last built
+    uint64_t gridRevision;                             // Store revision when gridBroadphase was last built
+    SimdLevel simdLevel;                               // Instruction set for integration/boundary kernels
+    
+    // Multithreading
+    JobSystem jobs;                                    // Worker pool for the parallel phases (one thread per core by default)
+    ContactSolveMode contactSolveMode;                 // How contacts are resolved
+    
+    /**
+     * Contact found during detection, resolved later by color
+     */
+    struct Contact {
+        uint32_t a;                                    // Dense index of the first body
+        uint32_t b;                                    // Dense index of the second body
+        Vector3 normal;                                // Narrowphase normal from b toward a (body pairs only)
+    };
+    std::vector<Contact> contacts;                     // Contacts in detection order
+    std::vector<uint8_t> contactColors;                // Color assigned to each contact
+    std::vector<uint8_t> pairTouching;                 // Narrowphase result per grid pair
+    std::vector<Vector3> pairNormals;                  // Narrowphase normal per touching grid pair
+    std::vector<uint32_t> pairOrder;                   // Grid pairs bucketed by shape-pair kind
+    std::vector<uint32_t> kindStart;                   // Offsets of each pair kind in pairOrder
+    std::vector<uint32_t> planeBodies;                 // Dense indices of Plane-shaped bodies
+    bool hasShapedBodies;                              // Some body is not a sphere (found by scanShapes)
+    std::vector<uint64_t> bodyColorMasks;              // Colors already used by each body
+    std::vector<Contact> coloredContacts;              // Contacts bucketed by color
+    std::vector<uint32_t> colorStart;                  // Offsets of each color in coloredContacts
+    std::vector<uint32_t> bucketCursor;                // Scratch write cursors for bucketing
+    
+    /**
+     * Solver state of one contact, stored in solve order
+     */
+    struct ContactConstraint {
+        Vector3 normal;                                // Unit normal pointing from b toward a
+        float normalMass;                              // 1 / (inverse mass a + inverse mass b)
+        float bias;                                    // Separating speed targeted along the normal (restitution)
+        float friction;                                // Combined friction coefficient
+        float normalImpulse;                           // Accumulated normal impulse (never negative)
+        Vector3 tangentImpulse;                        // Accumulated friction impulse
+        ContactCache::PairKey key;                     // Body-pair key into the contact cache
+        bool impact;                                   // Bodies approached faster than restitutionThreshold
+    };
+    std::vector<ContactConstraint> constraints;        // One per contact, parallel to the solve order
+    std::vector<Contact> planeContacts;                // Bodies touching a world plane (b = plane index)
+    std::vector<ContactConstraint> planeConstraints;   // One per plane contact
+    ContactCache contactCache;                         // Impulses of last step's contacts, for warm starting
+    int solverIterations;                              // Velocity iterations per step
+    bool warmStarting;                                 // Start each contact from last step's impulses
+    
+    // Sleeping
+    bool sleepingEnabled;                              // Put resting islands to sleep
+    float sleepEnergy;                                 // Kinetic energy (J) under which a body counts as resting
+    size_t sleepingCount;                              // Bodies asleep after the last step
+    std::vector<uint32_t> islandParent;                // Union-find parent of each body over this step's contacts
+    std::vector<uint16_t> islandRest;                  // Fewest rest steps of any body in each island (by root)
+    
+    // Continuous collision detection
+    bool ccdEnabled;                                   // Sweep fast bodies instead of relying on substeps
+    size_t sweptCount;                                 // Bodies swept in the last step
+    std::vector<uint32_t> fastBodies;                  // Candidates for sweeping this step
+    std::vector<Vector3> fastStarts;                   // Their positions before integration
+    std::vector<uint32_t> sweptMoved;                  // Swept bodies pulled back out of their grid cell
+    
+    // Steps simulated outside step() (see finishExternalStep)
+    bool externalStep;                                 // The last step was external; counters come from externalStats
+    ExternalStepStats externalStats;                   // Counters reported for the last external step
+    
+    // Spatial queries
+    SpatialQueries queries;                            // Query grid over the bodies, rebuilt lazily
+    bool queriesBuilt;                                 // The query grid has been built for the current bounds
+    uint64_t queryStep;                                // Step count when the query grid was built
+    uint64_t queryRevision;                            // Store revision when the query grid was built
+    
+    // Determinism
+    bool deterministic;                                // Lockstep mode: fixed step length and a per-step state hash
+    uint64_t stateHash;                                // Hash of the state after the last deterministic step
+    
+    // Step timing
+    bool stepTimingEnabled;                            // Time each phase of step()
+    StepTimings stepTimings;                           // Phase times since the last reset
+    Clock::time_point phaseStart;                      // Start of the phase being timed
+    
+    static constexpr float airResistance = 0.999f;     // Per-step velocity drag factor
+    static constexpr size_t maxColors = 64;            // Colors tracked per body; the rest resolve serially
+    static constexpr size_t bodyGrain = 4096;          // Bodies per job in integration/boundaries (multiple of 8)
+    static constexpr size_t contactGrain = 512;        // Contacts per job in narrowphase/resolution
+    static constexpr float defaultSleepEnergy = 0.005f; // Initial sleepEnergy
+    static constexpr uint16_t sleepSteps = 30;         // Resting steps before an island falls asleep
+    static constexpr float ccdMotionFraction = 0.5f;   // Bodies moving more than this many radii per step are swept
+    static constexpr float baumgarte = 0.2f;           // Fraction of penetration removed per step by the position pass
+    static constexpr uint32_t planeKeyBase = 0xFFFFFFF0u; // Pseudo handle slots of the six world planes in cache keys
+    static constexpr float penetrationSlop = 0.01f;    // Penetration left alone so resting contacts persist
+    static constexpr float restitutionThreshold = 1.0f; // Approach speed (m/s) below which contacts do not bounce
     
 public:
     /**
@@ -25,7 +189,33 @@ public:
     PhysicsWorld() 
         : gravity(0, -9.81f, 0)
         , timeStep(1.0f / 60.0f)
-        , maxSubsteps(4) {
+        , maxSubsteps(4)
+        , accumulator(0.0f)
+        , randomSeed(0x5EEDull)
+        , stepCount(0)
+        , broadphaseMode(BroadphaseMode::UniformGrid)
+        , hasBroadphaseRegion(false)
+        , gridStep(0)
+        , gridRevision(0)
+        , simdLevel(SimdKernels::detectSimdLevel())
+        , jobs(0)
+        , contactSolveMode(ContactSolveMode::Colored)
+        , hasShapedBodies(false)
+        , solverIterations(8)
+        , warmStarting(true)
+        , sleepingEnabled(true)
+        , sleepEnergy(defaultSleepEnergy)
+        , sleepingCount(0)
+        , ccdEnabled(true)
+        , sweptCount(0)
+        , externalStep(false)
+        , externalStats()
+        , queriesBuilt(false)
+        , queryStep(0)
+        , queryRevision(0)
+        , deterministic(false)
+        , stateHash(0)
+        , stepTimingEnabled(false) {
         
         // Set default world bounds (30x30 room, 10m high)
         worldBounds[0] = -15.0f;  // minX
@@ -37,14 +227,78 @@ public:
     }
 
     /**
-     * Add a physics body to the world
-     * @param body Unique pointer to the physics body
-     * @return Raw pointer to the added body for reference
+     * Destructor - returns every body proxy to its pool
+     */
+    ~PhysicsWorld() {
+        clear();
+    }
+
+    // Bodies keep a pointer to the world's store, so the world must stay put
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    /**
+     * Initial state of one ball created by createBalls
+     */
+    struct BallSpawn {
+        Vector3 position;                              // Starting position
+        Vector3 velocity;                              // Starting velocity
+        Vector3 color;                                 // Render color (0.0 to 1.0)
+    };
+
+    /**
+     * Create and add a generic physics body to the world
+     * @param position Starting position of the body
+     * @param mass Mass of the body
+     * @param radius Collision radius of the body
+     * @return Pointer to the created body
+     */
+    PhysicsBody* createBody(const Vector3& position, float mass, float radius) {
+        BodyHandle handle = store.create(position, mass, radius);
+        PhysicsBody* body = bodyPool.create(store, handle);
+        bodies.push_back(body);
+        return body;
+    }
+
+    /**
+     * Create and add an axis-aligned box to the world
+     * @param position Center of the box
+     * @param mass Mass of the box
+     * @param halfExtents Half size along x, y and z
+     * @return Pointer to the created body
+     */
+    PhysicsBody* createBox(const Vector3& position, float mass, const Vector3& halfExtents) {
+        PhysicsBody* body = createBody(position, mass, halfExtents.magnitude());
+        body->setShape(ShapeType::Box, halfExtents);
+        return body;
+    }
+
+    /**
+     * Create and add a vertical capsule to the world
+     * @param position Center of the capsule
+     * @param mass Mass of the capsule
+     * @param radius Radius of the capsule
+     * @param halfHeight Half length of the segment between the end caps
+     * @return Pointer to the created body
+     */
+    PhysicsBody* createCapsule(const Vector3& position, float mass, float radius, float halfHeight) {
+        PhysicsBody* body = createBody(position, mass, radius + halfHeight);
+        body->setShape(ShapeType::Capsule, Vector3(radius, halfHeight + radius, radius));
+        return body;
+    }
+
+    /**
+     * Create and add a static infinite plane to the world
+     * Everything behind the plane (against its normal) is solid
+     * @param point Any point on the plane
+     * @param normal Direction the plane faces (normalized here)
+     * @return Pointer to the created body
      */
-    PhysicsBody* addBody(std::unique_ptr<PhysicsBody> body) {
-        PhysicsBody* rawPtr = body.get();
-        bodies.push_back(std::move(body));
-        return rawPtr;
+    PhysicsBody* createPlane(const Vector3& point, const Vector3& normal) {
+        PhysicsBody* body = createBody(point, 1.0f, 0.0f);
+        body->setShape(ShapeType::Plane, normal.normalized());
+        body->setStatic(true);
+        return body;
     }
 
     /**
@@ -53,280 +307,1971 @@ public:
      * @return Pointer to the created ball
      */
     Ball* createBall(const Vector3& position) {
-        auto ball = std::make_unique<Ball>(position);
-        Ball* ballPtr = ball.get();
-        bodies.push_back(std::move(ball));
-        return ballPtr;
+        BodyHandle handle = store.create(position, 0.5f, 0.25f);
+        Ball* ball = ballPool.create(store, handle);
+        addBall(ball);
+        return ball;
+    }
+
+    /**
+     * Create many balls at once
+     * Storage for every array is reserved up front, so the loop only fills slots
+     * @param count Number of balls to create
+     * @param generator Called as generator(i, BallSpawn&) to fill in ball i; the
+     *                  spawn starts at the origin, at rest and white
+     * @return View of the new balls (invalidated when bodies are added or removed)
+     */
+    template <typename Generator>
+    BodySpan<Ball> createBalls(size_t count, Generator generator) {
+        size_t firstBall = balls.size();
+        store.reserve(store.size() + count);
+        bodies.reserve(bodies.size() + count);
+        balls.reserve(balls.size() + count);
+        ballPool.reserve(count);
+        
+        for (size_t i = 0; i < count; ++i) {
+            BallSpawn spawn = { Vector3::ZERO, Vector3::ZERO, Vector3(1.0f, 1.0f, 1.0f) };
+            generator(i, spawn);
+            
+            BodyHandle handle = store.create(spawn.position, 0.5f, 0.25f);
+            Ball* ball = ballPool.create(store, handle, spawn.color);
+            ball->velocity() = spawn.velocity;
+            addBall(ball);
+        }
+        return BodySpan<Ball>(balls.data() + firstBall, count);
+    }
+
+    /**
+     * Replace every body with saved state (checkpoint loading)
+     * Bodies are recreated in the saved dense order, with Ball proxies for those
+     * flagged BODY_BALL. Handles are reissued, so handles from before go stale;
+     * when the state carries handle slots the new handles reuse those slots.
+     * @param state Saved body state
+     */
+    void restoreBodies(const BodyStateView& state) {
+        clear();
+        size_t ballTotal = 0;
+        for (size_t i = 0; i < state.count; ++i) {
+            ballTotal += (state.flags[i] & BODY_BALL) ? 1 : 0;
+        }
+        store.reserve(state.count);
+        bodies.reserve(state.count);
+        balls.reserve(ballTotal);
+        ballPool.reserve(ballTotal);
+        bodyPool.reserve(state.count - ballTotal);
+        
+        for (size_t i = 0; i < state.count; ++i) {
+            store.create(state.positions[i], state.masses[i], state.radii[i]);
+        }
+        if (state.handleSlots) {
+            store.assignHandleSlots(state.handleSlots);
+        }
+        for (size_t i = 0; i < state.count; ++i) {
+            BodyHandle handle = store.handleAt((uint32_t)i);
+            if (state.flags[i] & BODY_BALL) {
+                addBall(ballPool.create(store, handle, state.colors[i]));
+            } else {
+                bodies.push_back(bodyPool.create(store, handle));
+            }
+        }
+        store.assignState(state);
     }
 
     /**
-     * Remove a physics body from the world
-     * @param body Pointer to the body to remove
+     * Remove a physics body from the world in O(1)
+     * The last body is moved into the freed slot, so dense order is not kept
+     * @param body Pointer to the body to remove (deleted by this call)
      */
     void removeBody(PhysicsBody* body) {
-        bodies.erase(
-            std::remove_if(bodies.begin(), bodies.end(),
-                [body](const std::unique_ptr<PhysicsBody>& ptr) {
-                    return ptr.get() == body;
-                }),
-            bodies.end()
-        );
+        removeBody(body->getHandle());
     }
 
     /**
-     * Update the physics world for one frame
-     * @param deltaTime Time elapsed since last update
+     * Remove a physics body from the world in O(1)
+     * @param handle Handle of the body to remove
+     * @return False if the handle was already stale
      */
-    void update(float deltaTime) {
-        // Use fixed time step with substeps for stability
-        float remainingTime = deltaTime;
-        int substeps = 0;
+    bool removeBody(BodyHandle handle) {
+        if (!store.isAlive(handle)) {
+            return false;
+        }
         
-        while (remainingTime > 0.0f && substeps < maxSubsteps) {
-            float currentStep = std::min(remainingTime, timeStep);
-            
-            // Update all physics bodies
-            for (auto& body : bodies) {
-                body->update(currentStep);
+        uint32_t dense = store.denseIndex(handle);
+        if (store.flags[dense] & BODY_BALL) {
+            // Swap-and-pop the ball index
+            uint32_t slot = ballSlots[handle.index];
+            Ball* last = balls.back();
+            balls[slot] = last;
+            ballSlots[last->getHandle().index] = slot;
+            balls.pop_back();
+        }
+        
+        // Mirror the store's swap-and-pop so bodies stays in dense order
+        releaseProxy(bodies[dense], store.flags[dense]);
+        store.destroy(handle);
+        bodies[dense] = bodies.back();
+        bodies.pop_back();
+        return true;
+    }
+
+    /**
+     * Remove many bodies in one pass
+     * Stale or repeated handles are skipped
+     * @param handles Handles of the bodies to remove
+     * @param count Number of handles
+     * @return Number of bodies removed
+     */
+    size_t removeBodies(const BodyHandle* handles, size_t count) {
+        size_t removed = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (removeBody(handles[i])) {
+                removed++;
             }
-            
-            // Handle collisions
-            handleCollisions();
-            
-            // Handle world boundary collisions
-            handleWorldBoundaries();
-            
-            remainingTime -= currentStep;
-            substeps++;
         }
+        return removed;
     }
 
     /**
-     * Handle collision detection and resolution between all bodies
+     * Remove every ball matching a predicate
+     * @param predicate Called with each const Ball&; return true to remove it
+     * @return Number of balls removed
      */
-    void handleCollisions() {
-        // Simple O(n²) collision detection - can be optimized with spatial partitioning
-        for (size_t i = 0; i < bodies.size(); ++i) {
-            for (size_t j = i + 1; j < bodies.size(); ++j) {
-                PhysicsBody* bodyA = bodies[i].get();
-                PhysicsBody* bodyB = bodies[j].get();
-                
-                if (bodyA->isCollidingWith(*bodyB)) {
-                    resolveCollision(bodyA, bodyB);
-                }
+    template <typename Predicate>
+    size_t removeBallsIf(Predicate predicate) {
+        removalHandles.clear();
+        for (const Ball* ball : balls) {
+            if (predicate(*ball)) {
+                removalHandles.push_back(ball->getHandle());
             }
         }
+        return removeBodies(removalHandles.data(), removalHandles.size());
     }
 
     /**
-     * Resolve collision between two physics bodies
-     * @param bodyA First colliding body
-     * @param bodyB Second colliding body
+     * Look up a body by handle
+     * @param handle Body handle
+     * @return Body, or nullptr if the handle is stale
+     */
+    PhysicsBody* getBody(BodyHandle handle) const {
+        return store.isAlive(handle) ? bodies[store.denseIndex(handle)] : nullptr;
+    }
+
+    /**
+     * Look up a ball by handle
+     * @param handle Body handle
+     * @return Ball, or nullptr if the handle is stale or not a ball
+     */
+    Ball* getBall(BodyHandle handle) const {
+        if (!store.isAlive(handle)) {
+            return nullptr;
+        }
+        uint32_t dense = store.denseIndex(handle);
+        return (store.flags[dense] & BODY_BALL) ? static_cast<Ball*>(bodies[dense]) : nullptr;
+    }
+
+    /**
+     * Update the physics world for one frame
+     * Runs whole fixed steps and carries the remainder to the next call. Backlog
+     * beyond maxSubsteps steps is discarded so a long stall cannot snowball.
+     * @param deltaTime Time elapsed since last update
      */
-    void resolveCollision(PhysicsBody* bodyA, PhysicsBody* bodyB) {
-        // Calculate collision normal
-        Vector3 normal = (bodyA->position - bodyB->position).normalized();
+    void update(float deltaTime) {
+        accumulator += deltaTime;
         
-        // Calculate relative velocity
-        Vector3 relativeVelocity = bodyA->velocity - bodyB->velocity;
+        int substeps = 0;
+        while (accumulator >= timeStep && substeps < maxSubsteps) {
+            step(timeStep);
+            accumulator -= timeStep;
+            substeps++;
+        }
         
-        // Calculate relative velocity along normal
-        float velocityAlongNormal = relativeVelocity.dot(normal);
+        accumulator = std::min(accumulator, timeStep);
+    }
+
+    /**
+     * Advance the simulation by exactly one step
+     * @param deltaTime Step length in seconds (ignored in deterministic mode, which always uses the fixed step)
+     */
+    void step(float deltaTime) {
+        if (deterministic) {
+            deltaTime = timeStep;
+        }
+        externalStep = false;
+        beginPhaseTiming();
         
-        // Don't resolve if objects are separating
-        if (velocityAlongNormal > 0) {
-            return;
+        // Handle collisions, solving against this step's velocities before they move anything
+        handleCollisions(deltaTime);
+        
+        // Remember where fast bodies start so their motion can be swept
+        if (ccdEnabled) {
+            collectFastBodies(deltaTime);
+            endPhase(&StepTimings::continuous);
         }
         
-        // Calculate restitution (bounciness)
-        float restitution = std::min(bodyA->restitution, bodyB->restitution);
+        // Integrate all physics bodies
+        integrateBodies(deltaTime);
+        endPhase(&StepTimings::integrate);
         
-        // Calculate impulse scalar
-        float impulseScalar = -(1 + restitution) * velocityAlongNormal;
-        impulseScalar /= bodyA->getInverseMass() + bodyB->getInverseMass();
+        // Catch fast bodies that passed through something during the step
+        if (ccdEnabled) {
+            sweepFastBodies();
+            endPhase(&StepTimings::continuous);
+        }
         
-        // Apply impulse
-        Vector3 impulse = normal * impulseScalar;
-        bodyA->applyImpulse(impulse * bodyA->getInverseMass());
-        bodyB->applyImpulse(impulse * -bodyB->getInverseMass());
+        // Handle world boundary collisions
+        handleWorldBoundaries();
+        endPhase(&StepTimings::boundaries);
         
-        // Position correction to prevent sinking
-        float penetrationDepth = (bodyA->radius + bodyB->radius) - (bodyA->position - bodyB->position).magnitude();
-        if (penetrationDepth > 0) {
-            float correctionPercent = 0.8f;  // How much to correct
-            float correctionSlop = 0.01f;    // Penetration allowance
-            
-            Vector3 correction = normal * (correctionPercent * 
-                std::max(penetrationDepth - correctionSlop, 0.0f) / 
-                (bodyA->getInverseMass() + bodyB->getInverseMass()));
-            
-            bodyA->position += correction * bodyA->getInverseMass();
-            bodyB->position -= correction * bodyB->getInverseMass();
+        // Put resting islands to sleep and wake disturbed ones
+        if (sleepingEnabled) {
+            updateSleepStates();
+            endPhase(&StepTimings::sleep);
         }
         
-        // Special handling for ball-to-ball collisions
-        Ball* ballA = dynamic_cast<Ball*>(bodyA);
-        Ball* ballB = dynamic_cast<Ball*>(bodyB);
+        if (stepTimingEnabled) {
+            stepTimings.steps++;
+        }
+        stepCount++;
         
-        if (ballA && ballB) {
-            // Add slight randomness to ball-ball collisions for more interesting behavior
-            float randomFactor = 0.1f;
-            Vector3 randomOffset(
-                ((float)rand() / RAND_MAX - 0.5f) * randomFactor,
-                ((float)rand() / RAND_MAX - 0.5f) * randomFactor,
-                ((float)rand() / RAND_MAX - 0.5f) * randomFactor
-            );
-            ballA->velocity += randomOffset;
-            ballB->velocity -= randomOffset;
+        if (deterministic) {
+            stateHash = computeStateHash();
         }
     }
 
     /**
-     * Handle collisions with world boundaries (walls, floor, ceiling)
+     * Integrate every body for one time step using Euler integration
+     * Batched equivalent of PhysicsBody::update and Ball::update over the store arrays
+     * @param deltaTime Time step in seconds
      */
-    void handleWorldBoundaries() {
-        for (auto& body : bodies) {
-            // Skip static bodies
-            if (body->isStatic) {
-                continue;
+    void integrateBodies(float deltaTime) {
+        SimdKernels::IntegrationParams params;
+        params.deltaTime = deltaTime;
+        params.gravity = gravity;
+        params.airResistance = airResistance;
+        
+        BodyArrays arrays(store);
+        jobs.parallelFor(arrays.count, bodyGrain, [&](size_t begin, size_t end) {
+            SimdKernels::integrate(simdLevel, arrays, begin, end, params);
+        });
+    }
+
+    /**
+     * Handle collision detection and resolution between all bodies
+     * Every touching pair and every body touching a world plane becomes a
+     * contact, and all contacts are then solved together (see solveContacts)
+     * @param deltaTime Step length in seconds
+     */
+    void handleCollisions(float deltaTime) {
+        contacts.clear();
+        planeContacts.clear();
+        
+        // Sleeping bodies never collide with each other, so a world at rest has no work
+        if (sleepingEnabled && !anyAwakeBody()) {
+            endPhase(&StepTimings::broadphase);
+            return;
+        }
+        
+        gatherContacts();
+        gatherPlaneContacts();
+        endPhase(&StepTimings::narrowphase);
+        
+        if (contactSolveMode == ContactSolveMode::Colored) {
+            colorContacts();
+        }
+        solveContacts(deltaTime);
+        endPhase(&StepTimings::solve);
+    }
+
+    /**
+     * Iterative sequential-impulse solver
+     * Each contact accumulates a normal impulse (clamped to push only) and a
+     * friction impulse (clamped to the friction cone). Contacts start from the
+     * impulses their pair ended last step with, then every contact is relaxed
+     * solverIterations times, so a pile converges to one consistent set of
+     * forces instead of a chain of pairwise fixes. Penetration is removed by a
+     * separate position pass, so resting bodies end the step without any
+     * leftover separating velocity.
+     *
+     * Contacts are solved before integration against the velocities bodies are
+     * about to move with (this step's gravity and forces applied), so a body
+     * resting on another ends the step with no approach speed and does not sink.
+     * @param deltaTime Step length in seconds
+     */
+    void solveContacts(float deltaTime) {
+        const std::vector<Contact>& order = solveOrder();
+        constraints.resize(order.size());
+        planeConstraints.resize(planeContacts.size());
+        if (constraints.empty() && planeConstraints.empty()) {
+            return;
+        }
+        applyStepAcceleration(deltaTime, 1.0f);
+        
+        // Setup and cache lookups only read shared state
+        jobs.parallelFor(order.size(), contactGrain, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                prepareContact(order[c], constraints[c]);
             }
-            
-            bool collided = false;
-            
-            // Check X boundaries (left/right walls)
-            if (body->position.x - body->radius < worldBounds[0]) {
-                body->position.x = worldBounds[0] + body->radius;
-                if (body->velocity.x < 0) {
-                    body->velocity.x = -body->velocity.x * body->restitution;
-                    collided = true;
-                }
-            } else if (body->position.x + body->radius > worldBounds[1]) {
-                body->position.x = worldBounds[1] - body->radius;
-                if (body->velocity.x > 0) {
-                    body->velocity.x = -body->velocity.x * body->restitution;
-                    collided = true;
-                }
+        });
+        for (size_t c = 0; c < planeContacts.size(); ++c) {
+            preparePlaneContact(planeContacts[c], planeConstraints[c]);
+        }
+        
+        if (warmStarting) {
+            forEachContact([&](size_t c) {
+                const ContactConstraint& constraint = constraints[c];
+                applyContactImpulse(order[c], constraint.normal * constraint.normalImpulse + constraint.tangentImpulse);
+            });
+            for (size_t c = 0; c < planeContacts.size(); ++c) {
+                const ContactConstraint& constraint = planeConstraints[c];
+                uint32_t body = planeContacts[c].a;
+                store.velocities[body] += (constraint.normal * constraint.normalImpulse + constraint.tangentImpulse) *
+                                          store.inverseMasses[body];
             }
+        }
+        
+        for (int iteration = 0; iteration < solverIterations; ++iteration) {
+            forEachContact([&](size_t c) {
+                const Contact& contact = order[c];
+                float inverseMassSum = store.inverseMasses[contact.a] + store.inverseMasses[contact.b];
+                Vector3 relativeVelocity = store.velocities[contact.a] - store.velocities[contact.b];
+                applyContactImpulse(contact, relaxContact(constraints[c], relativeVelocity, inverseMassSum));
+            });
             
-            // Check Y boundaries (floor/ceiling)
-            if (body->position.y - body->radius < worldBounds[2]) {
-                body->position.y = worldBounds[2] + body->radius;
-                if (body->velocity.y < 0) {
-                    body->velocity.y = -body->velocity.y * body->restitution;
-                    collided = true;
-                }
-            } else if (body->position.y + body->radius > worldBounds[3]) {
-                body->position.y = worldBounds[3] - body->radius;
-                if (body->velocity.y > 0) {
-                    body->velocity.y = -body->velocity.y * body->restitution;
-                    collided = true;
-                }
+            // Each plane contact touches one body, so after the colors they can run in any order
+            for (size_t c = 0; c < planeContacts.size(); ++c) {
+                uint32_t body = planeContacts[c].a;
+                float inverseMass = store.inverseMasses[body];
+                store.velocities[body] += relaxContact(planeConstraints[c], store.velocities[body], inverseMass) * inverseMass;
             }
-            
-            // Check Z boundaries (front/back walls)
-            if (body->position.z - body->radius < worldBounds[4]) {
-                body->position.z = worldBounds[4] + body->radius;
-                if (body->velocity.z < 0) {
-                    body->velocity.z = -body->velocity.z * body->restitution;
-                    collided = true;
-                }
-            } else if (body->position.z + body->radius > worldBounds[5]) {
-                body->position.z = worldBounds[5] - body->radius;
-                if (body->velocity.z > 0) {
-                    body->velocity.z = -body->velocity.z * body->restitution;
-                    collided = true;
-                }
+        }
+        
+        // Push overlapping bodies part of the way apart (the boundary pass clamps against planes),
+        // and give ball impacts a small random kick while resting contacts stay calm
+        forEachContact([&](size_t c) {
+            correctPenetration(order[c], constraints[c]);
+            if (constraints[c].impact && isBallPair(order[c].a, order[c].b)) {
+                applyCollisionJitter(order[c].a, order[c].b, collisionJitter(order[c].a, order[c].b));
             }
-            
-            // Apply friction for ground contact
-            if (body->position.y <= worldBounds[2] + body->radius + 0.1f && collided) {
-                body->velocity.x *= (1.0f - body->friction);
-                body->velocity.z *= (1.0f - body->friction);
+        });
+        
+        contactCache.beginRecording(constraints.size() + planeConstraints.size());
+        for (const std::vector<ContactConstraint>* solved : { &constraints, &planeConstraints }) {
+            for (const ContactConstraint& constraint : *solved) {
+                CachedImpulse impulse;
+                impulse.normal = constraint.normalImpulse;
+                impulse.tangent = constraint.tangentImpulse;
+                contactCache.record(constraint.key, impulse);
             }
         }
+        contactCache.finishRecording();
+        
+        // Integration adds the acceleration again
+        applyStepAcceleration(deltaTime, -1.0f);
     }
 
     /**
-     * Get all physics bodies in the world
-     * @return Vector of physics body pointers
+     * Add or remove one step of gravity and applied force on every body integration will move
+     * @param deltaTime Step length in seconds
+     * @param sign 1 to add, -1 to take it back off
      */
-    std::vector<PhysicsBody*> getBodies() const {
-        std::vector<PhysicsBody*> result;
-        for (const auto& body : bodies) {
-            result.push_back(body.get());
-        }
-        return result;
+    void applyStepAcceleration(float deltaTime, float sign) {
+        jobs.parallelFor(store.size(), bodyGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if ((store.flags[i] & (BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_SLEEPING)) == BODY_ACTIVE) {
+                    Vector3 acceleration = store.forces[i] * store.inverseMasses[i] + gravity;
+                    store.velocities[i] += acceleration * (deltaTime * sign);
+                }
+            }
+        });
     }
 
     /**
-     * Get all balls in the world
-     * @return Vector of ball pointers
+     * Contacts in the order the solver visits them
+     * @return Color-bucketed contacts in Colored mode, detection order otherwise
+     */
+    const std::vector<Contact>& solveOrder() const {
+        return contactSolveMode == ContactSolveMode::Colored ? coloredContacts : contacts;
+    }
+
+    /**
+     * Run a function over every body-pair contact index in solve order
+     * In Colored mode each color is split across the worker pool (no two contacts
+     * of one color share a body); the overflow bucket and Sequential mode run serially
+     * @param function Called with each position in solveOrder()
      */
-    std::vector<Ball*> getBalls() const {
-        std::vector<Ball*> result;
-        for (const auto& body : bodies) {
-            Ball* ball = dynamic_cast<Ball*>(body.get());
-            if (ball) {
-                result.push_back(ball);
+    template <typename Function>
+    void forEachContact(Function function) {
+        if (contactSolveMode != ContactSolveMode::Colored) {
+            for (size_t c = 0; c < contacts.size(); ++c) {
+                function(c);
             }
+            return;
+        }
+        
+        for (size_t color = 0; color < maxColors; ++color) {
+            size_t first = colorStart[color];
+            size_t count = colorStart[color + 1] - first;
+            jobs.parallelFor(count, contactGrain, [&](size_t begin, size_t end) {
+                for (size_t c = first + begin; c < first + end; ++c) {
+                    function(c);
+                }
+            });
+        }
+        
+        // Contacts whose bodies ran out of colors
+        for (size_t c = colorStart[maxColors]; c < colorStart[maxColors + 1]; ++c) {
+            function(c);
         }
-        return result;
     }
 
     /**
-     * Set world boundaries
-     * @param minX Minimum X coordinate
-     * @param maxX Maximum X coordinate
-     * @param minY Minimum Y coordinate (floor)
-     * @param maxY Maximum Y coordinate (ceiling)
-     * @param minZ Minimum Z coordinate
-     * @param maxZ Maximum Z coordinate
+     * Set up a body-pair contact and fetch its cached impulses
+     * @param contact Contact to set up
+     * @param constraint Receives the solver state
      */
-    void setWorldBounds(float minX, float maxX, float minY, float maxY, float minZ, float maxZ) {
-        worldBounds[0] = minX;
-        worldBounds[1] = maxX;
-        worldBounds[2] = minY;
-        worldBounds[3] = maxY;
-        worldBounds[4] = minZ;
-        worldBounds[5] = maxZ;
+    void prepareContact(const Contact& contact, ContactConstraint& constraint) const {
+        uint32_t a = contact.a;
+        uint32_t b = contact.b;
+        const Vector3& normal = contact.normal;
+        
+        setupConstraint(constraint, normal,
+                        (store.velocities[a] - store.velocities[b]).dot(normal),
+                        store.inverseMasses[a] + store.inverseMasses[b],
+                        std::min(store.restitutions[a], store.restitutions[b]),
+                        std::sqrt(store.frictions[a] * store.frictions[b]),
+                        ContactCache::makeKey(store.handleAt(a), store.handleAt(b)));
     }
 
     /**
-     * Get world boundaries
-     * @return Array of 6 floats [minX, maxX, minY, maxY, minZ, maxZ]
+     * Set up a body-plane contact and fetch its cached impulses
+     * The plane is immovable and uses the body's own restitution and friction
+     * @param contact Contact whose b is the plane index [minX, maxX, minY, maxY, minZ, maxZ]
+     * @param constraint Receives the solver state
      */
-    const float* getWorldBounds() const {
-        return worldBounds;
+    void preparePlaneContact(const Contact& contact, ContactConstraint& constraint) const {
+        uint32_t body = contact.a;
+        int axis = contact.b / 2;
+        float side = (contact.b % 2 == 0) ? 1.0f : -1.0f;
+        Vector3 normal(axis == 0 ? side : 0.0f, axis == 1 ? side : 0.0f, axis == 2 ? side : 0.0f);
+        
+        BodyHandle plane;
+        plane.index = planeKeyBase + contact.b;
+        setupConstraint(constraint, normal, store.velocities[body].dot(normal), store.inverseMasses[body],
+                        store.restitutions[body], store.frictions[body],
+                        ContactCache::makeKey(store.handleAt(body), plane));
     }
 
     /**
-     * Clear all physics bodies from the world
+     * Fill in the solver state shared by both contact kinds
+     * @param constraint Solver state to fill
+     * @param normal Unit normal pointing toward body a
+     * @param approach Relative velocity along the normal (negative when closing)
+     * @param inverseMassSum Sum of the inverse masses involved
+     * @param restitution Combined bounciness
+     * @param friction Combined friction coefficient
+     * @param key Cache key of the contact
      */
-    void clear() {
-        bodies.clear();
+    void setupConstraint(ContactConstraint& constraint, const Vector3& normal, float approach, float inverseMassSum,
+                         float restitution, float friction, const ContactCache::PairKey& key) const {
+        constraint.normal = normal;
+        constraint.normalMass = inverseMassSum > 0.0f ? 1.0f / inverseMassSum : 0.0f;
+        constraint.friction = friction;
+        
+        // Only real impacts bounce; slow contacts come to rest
+        constraint.impact = approach < -restitutionThreshold;
+        constraint.bias = constraint.impact ? -restitution * approach : 0.0f;
+        
+        constraint.key = key;
+        constraint.normalImpulse = 0.0f;
+        constraint.tangentImpulse = Vector3(0, 0, 0);
+        CachedImpulse cached;
+        if (warmStarting && contactCache.find(key, cached)) {
+            // The normal has turned a little since last step; keep the friction impulse tangent
+            constraint.normalImpulse = cached.normal;
+            constraint.tangentImpulse = cached.tangent - normal * cached.tangent.dot(normal);
+        }
     }
 
     /**
-     * Get the number of physics bodies in the world
-     * @return Number of bodies
+     * Relax one contact: move its accumulated impulses toward the values that
+     * stop the bodies approaching, within the push-only and friction-cone limits
+     * @param constraint Solver state of the contact
+     * @param relativeVelocity Velocity of body a relative to body b
+     * @param inverseMassSum Sum of the inverse masses involved
+     * @return Change in impulse to apply to body a (and its opposite to body b)
      */
-    size_t getBodyCount() const {
-        return bodies.size();
+    static Vector3 relaxContact(ContactConstraint& constraint, Vector3 relativeVelocity, float inverseMassSum) {
+        const Vector3& normal = constraint.normal;
+        
+        // Normal impulse
+        float normalSpeed = relativeVelocity.dot(normal);
+        float previousNormal = constraint.normalImpulse;
+        constraint.normalImpulse = std::max(previousNormal + constraint.normalMass * (constraint.bias - normalSpeed), 0.0f);
+        float normalDelta = constraint.normalImpulse - previousNormal;
+        relativeVelocity += normal * (normalDelta * inverseMassSum);
+        
+        // Friction impulse against the tangential slip left after the normal impulse
+        Vector3 slip = relativeVelocity - normal * relativeVelocity.dot(normal);
+        Vector3 previousTangent = constraint.tangentImpulse;
+        Vector3 tangent = previousTangent - slip * constraint.normalMass;
+        float maxFriction = constraint.friction * constraint.normalImpulse;
+        float tangentMagnitude = tangent.magnitude();
+        if (tangentMagnitude > maxFriction) {
+            tangent = tangentMagnitude > 0.0f ? tangent * (maxFriction / tangentMagnitude) : Vector3(0, 0, 0);
+        }
+        constraint.tangentImpulse = tangent;
+        
+        return normal * normalDelta + (tangent - previousTangent);
     }
 
     /**
-     * Set gravity for the world
-     * @param g Gravity vector
+     * Apply an impulse to body a and its opposite to body b
+     * @param contact Contact whose bodies receive the impulse
+     * @param impulse Impulse on body a
      */
-    void setGravity(const Vector3& g) {
-        gravity = g;
+    void applyContactImpulse(const Contact& contact, const Vector3& impulse) {
+        store.velocities[contact.a] += impulse * store.inverseMasses[contact.a];
+        store.velocities[contact.b] -= impulse * store.inverseMasses[contact.b];
     }
 
     /**
-     * Get current gravity
-     * @return Gravity vector
+     * Move a pair apart by baumgarte of its penetration beyond penetrationSlop, weighted by inverse mass
+     * The penetration is measured again by the pair's kernel, since earlier
+     * corrections may already have moved the bodies
+     * @param contact Contact to correct
+     * @param constraint Its solver state (for the inverse mass sum)
      */
-    const Vector3& getGravity() const {
-        return gravity;
+    void correctPenetration(const Contact& contact, const ContactConstraint& constraint) {
+        ContactPoint point;
+        if (!Narrowphase::collideBodies(store, contact.a, contact.b, point) || point.depth <= penetrationSlop) {
+            return;
+        }
+        Vector3 correction = constraint.normal * (baumgarte * (point.depth - penetrationSlop) * constraint.normalMass);
+        store.positions[contact.a] += correction * store.inverseMasses[contact.a];
+        store.positions[contact.b] -= correction * store.inverseMasses[contact.b];
+    }
+
+    /**
+     * Record bodies that may move more than ccdMotionFraction radii this step
+     * The estimate uses the velocity before integration plus one step of
+     * gravity and force, so it errs toward including a body. Only spheres are
+     * swept; shaped bodies rely on the discrete pass.
+     * @param deltaTime Time step in seconds
+     */
+    void collectFastBodies(float deltaTime) {
+        fastBodies.clear();
+        fastStarts.clear();
+        float gravityReach = gravity.magnitude() * deltaTime;
+        
+        // Compare squared motion against the squared margin left after gravity
+        // and force, so only pushed bodies cost a square root
+        for (size_t i = 0; i < store.size(); ++i) {
+            uint8_t state = BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_SLEEPING | BODY_SHAPED;
+            if ((store.flags[i] & state) != BODY_ACTIVE) {
+                continue;
+            }
+            const Vector3& force = store.forces[i];
+            float forceReach = (force.x != 0.0f || force.y != 0.0f || force.z != 0.0f)
+                ? force.magnitude() * store.inverseMasses[i] * deltaTime : 0.0f;
+            float margin = ccdMotionFraction * store.radii[i] - (gravityReach + forceReach) * deltaTime;
+            float motionSquared = store.velocities[i].magnitudeSquared() * deltaTime * deltaTime;
+            if (margin < 0.0f || motionSquared > margin * margin) {
+                fastBodies.push_back((uint32_t)i);
+                fastStarts.push_back(store.positions[i]);
+            }
+        }
+    }
+
+    /**
+     * Sweep each fast body from its start to its end position and stop it at the
+     * earliest time of impact with another sphere or a world plane
+     * A sphere hit is resolved like a discrete contact; a plane hit reflects the
+     * velocity. The rest of the step's motion is dropped (conservative advancement).
+     * Other bodies are treated as resting at their end-of-step positions; shaped
+     * bodies are left to the discrete pass.
+     */
+    void sweepFastBodies() {
+        sweptCount = 0;
+        sweptMoved.clear();
+        bool useGrid = broadphaseMode == BroadphaseMode::UniformGrid && gridBroadphase.isBuiltFor(store.size());
+        
+        for (size_t k = 0; k < fastBodies.size(); ++k) {
+            uint32_t i = fastBodies[k];
+            Vector3 start = fastStarts[k];
+            Vector3 motion = store.positions[i] - start;
+            float radius = store.radii[i];
+            if (motion.magnitude() <= ccdMotionFraction * radius) {
+                continue;
+            }
+            sweptCount++;
+            
+            float hitTime = 1.0f;
+            int hitAxis = sweepPlanes(start, motion, radius, hitTime);
+            int64_t hitBody = -1;
+            
+            auto testBody = [&](uint32_t j) {
+                float t;
+                if (j != i && (store.flags[j] & (BODY_ACTIVE | BODY_SHAPED)) == BODY_ACTIVE &&
+                    sweepSphere(start, motion, store.positions[j], radius + store.radii[j], t) && t < hitTime) {
+                    hitTime = t;
+                    hitBody = j;
+                }
+            };
+            if (useGrid) {
+                // Cells hold body centers, so pad by a cell to reach every sphere the sweep can touch
+                Vector3 end = start + motion;
+                float pad = radius + gridBroadphase.getCellSize();
+                Vector3 low(std::min(start.x, end.x) - pad, std::min(start.y, end.y) - pad, std::min(start.z, end.z) - pad);
+                Vector3 high(std::max(start.x, end.x) + pad, std::max(start.y, end.y) + pad, std::max(start.z, end.z) + pad);
+                gridBroadphase.forEachInBox(low, high, testBody);
+                for (uint32_t moved : sweptMoved) {
+                    testBody(moved);  // The grid still files these under their end-of-step cell
+                }
+            } else {
+                for (uint32_t j = 0; j < (uint32_t)store.size(); ++j) {
+                    testBody(j);
+                }
+            }
+            
+            if (hitBody < 0 && hitAxis < 0) {
+                continue;
+            }
+            store.positions[i] = start + motion * hitTime;
+            sweptMoved.push_back(i);
+            
+            if (hitBody >= 0) {
+                uint32_t j = (uint32_t)hitBody;
+                resolveSequential(std::min(i, j), std::max(i, j));
+            } else {
+                float& component = hitAxis == 0 ? store.velocities[i].x
+                                 : hitAxis == 1 ? store.velocities[i].y
+                                 : store.velocities[i].z;
+                float direction = hitAxis == 0 ? motion.x : hitAxis == 1 ? motion.y : motion.z;
+                if (component * direction > 0.0f) {
+                    component = -component * store.restitutions[i];
+                }
+            }
+        }
+    }
+
+    /**
+     * Earliest time a moving sphere reaches one of the six world planes
+     * @param start Sphere center at the start of the step
+     * @param motion Displacement over the step
+     * @param radius Sphere radius
+     * @param hitTime In: latest time of interest; out: time of the earliest hit
+     * @return Axis of the plane hit (0 = x, 1 = y, 2 = z), or -1 if none
+     */
+    int sweepPlanes(const Vector3& start, const Vector3& motion, float radius, float& hitTime) const {
+        const float startAxes[3] = { start.x, start.y, start.z };
+        const float motionAxes[3] = { motion.x, motion.y, motion.z };
+        int hitAxis = -1;
+        
+        for (int axis = 0; axis < 3; ++axis) {
+            float low = worldBounds[axis * 2] + radius;
+            float high = worldBounds[axis * 2 + 1] - radius;
+            float from = startAxes[axis];
+            float delta = motionAxes[axis];
+            
+            float t = hitTime;
+            if (delta > 0.0f && from + delta > high) {
+                t = (high - from) / delta;
+            } else if (delta < 0.0f && from + delta < low) {
+                t = (low - from) / delta;
+            }
+            t = std::max(t, 0.0f);
+            if (t < hitTime) {
+                hitTime = t;
+                hitAxis = axis;
+            }
+        }
+        return hitAxis;
+    }
+
+    /**
+     * Time of impact of a moving sphere against a resting one
+     * @param start Moving center at the start of the step
+     * @param motion Displacement over the step
+     * @param center Center of the resting sphere
+     * @param reach Sum of both radii
+     * @param t Out: impact time in [0, 1]
+     * @return True if the spheres first touch during the step (not already overlapping)
+     */
+    static bool sweepSphere(const Vector3& start, const Vector3& motion, const Vector3& center, float reach, float& t) {
+        Vector3 offset = start - center;
+        float c = offset.magnitudeSquared() - reach * reach;
+        float b = offset.dot(motion);
+        if (c <= 0.0f || b >= 0.0f) {
+            return false;  // Already touching (the discrete pass owns it) or moving apart
+        }
+        float a = motion.magnitudeSquared();
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) {
+            return false;
+        }
+        t = (-b - std::sqrt(discriminant)) / a;
+        return t <= 1.0f;
+    }
+
+    /**
+     * Check whether two bodies overlap
+     * @param a Dense index of the first body
+     * @param b Dense index of the second body
+     * @param point Receives the contact normal and depth on overlap
+     * @return True if both bodies are active, not both asleep, and their shapes overlap
+     */
+    bool bodiesColliding(size_t a, size_t b, ContactPoint& point) const {
+        return Narrowphase::canCollide(store, (uint32_t)a, (uint32_t)b) &&
+               Narrowphase::collideBodies(store, (uint32_t)a, (uint32_t)b, point);
+    }
+
+    /**
+     * Resolve a pair immediately with a single impulse, recording it as a contact for island building
+     * Used for swept impacts found after the solver has run
+     * @param a Dense index of the first colliding body
+     * @param b Dense index of the second colliding body
+     */
+    void resolveSequential(size_t a, size_t b) {
+        addContact(a, b, (store.positions[a] - store.positions[b]).normalized());
+        if (resolveCollision(a, b) && isBallPair(a, b)) {
+            applyCollisionJitter(a, b, collisionJitter(a, b));
+        }
+    }
+
+    /**
+     * Resolve collision between two physics bodies
+     * @param a Dense index of the first colliding body
+     * @param b Dense index of the second colliding body
+     * @return False if the bodies were already separating
+     */
+    bool resolveCollision(size_t a, size_t b) {
+        Vector3& positionA = store.positions[a];
+        Vector3& positionB = store.positions[b];
+        Vector3& velocityA = store.velocities[a];
+        Vector3& velocityB = store.velocities[b];
+        float inverseMassA = store.inverseMasses[a];
+        float inverseMassB = store.inverseMasses[b];
+        
+        // Calculate collision normal and center distance together
+        float distance;
+        Vector3 normal = (positionA - positionB).normalized(distance);
+        
+        // Calculate relative velocity
+        Vector3 relativeVelocity = velocityA - velocityB;
+        
+        // Calculate relative velocity along normal
+        float velocityAlongNormal = relativeVelocity.dot(normal);
+        
+        // Don't resolve if objects are separating
+        if (velocityAlongNormal > 0) {
+            return false;
+        }
+        
+        // Calculate restitution (bounciness)
+        float restitution = std::min(store.restitutions[a], store.restitutions[b]);
+        
+        // Calculate impulse scalar
+        float impulseScalar = -(1 + restitution) * velocityAlongNormal;
+        impulseScalar /= inverseMassA + inverseMassB;
+        
+        // Apply impulse
+        Vector3 impulse = normal * impulseScalar;
+        velocityA += impulse * inverseMassA;
+        velocityB -= impulse * inverseMassB;
+        
+        // Position correction to prevent sinking
+        float penetrationDepth = (store.radii[a] + store.radii[b]) - distance;
+        if (penetrationDepth > 0) {
+            float correctionPercent = 0.8f;  // How much to correct
+            float correctionSlop = 0.01f;    // Penetration allowance
+            
+            Vector3 correction = normal * (correctionPercent * 
+                std::max(penetrationDepth - correctionSlop, 0.0f) / 
+                (inverseMassA + inverseMassB));
+            
+            positionA += correction * inverseMassA;
+            positionB -= correction * inverseMassB;
+        }
+        
+        return true;
+    }
+
+    /**
+     * Check whether both bodies are balls
+     * @return True for a ball-to-ball pair
+     */
+    bool isBallPair(size_t a, size_t b) const {
+        return (store.flags[a] & store.flags[b] & BODY_BALL) != 0;
+    }
+
+    /**
+     * Random offset added to a ball-to-ball collision
+     * Keyed on the seed, the step and both body handle slots (lower slot first),
+     * so the same pair gets the same offset on the same step regardless of
+     * thread or solve order, or of which dense order the pair is stored in
+     * @param a Dense index of the first ball
+     * @param b Dense index of the second ball
+     * @return Random velocity offset
+     */
+    Vector3 collisionJitter(size_t a, size_t b) const {
+        // Add slight randomness to ball-ball collisions for more interesting behavior
+        float randomFactor = 0.1f;
+        uint32_t slotA = store.denseToHandle[a];
+        uint32_t slotB = store.denseToHandle[b];
+        bool ordered = slotA < slotB;
+        uint64_t pairKey = ordered ? ((uint64_t)slotA << 32) | slotB : ((uint64_t)slotB << 32) | slotA;
+        uint64_t key = CounterRng::combine(CounterRng::combine(randomSeed, stepCount), pairKey);
+        float sign = ordered ? randomFactor : -randomFactor;
+        return Vector3(
+            (CounterRng::uniform(key, 0) - 0.5f) * sign,
+            (CounterRng::uniform(key, 1) - 0.5f) * sign,
+            (CounterRng::uniform(key, 2) - 0.5f) * sign
+        );
+    }
+
+    /**
+     * Apply a ball-to-ball random offset
+     * @param a Dense index of the first ball
+     * @param b Dense index of the second ball
+     * @param offset Velocity offset added to a and subtracted from b
+     */
+    void applyCollisionJitter(size_t a, size_t b, const Vector3& offset) {
+        store.velocities[a] += offset;
+        store.velocities[b] -= offset;
+    }
+
+    /**
+     * Handle collisions with world boundaries (walls, floor, ceiling)
+     */
+    void handleWorldBoundaries() {
+        BodyArrays arrays(store);
+        jobs.parallelFor(arrays.count, bodyGrain, [&](size_t begin, size_t end) {
+            SimdKernels::boundaries(simdLevel, arrays, begin, end, worldBounds);
+        });
+    }
+
+    /**
+     * Get all physics bodies in the world, in dense store order
+     * @return View of the body proxies (invalidated when bodies are added or removed)
+     */
+    BodySpan<PhysicsBody> getBodies() const {
+        return BodySpan<PhysicsBody>(store.owners.data(), store.owners.size());
+    }
+
+    /**
+     * Get all balls in the world
+     * @return View of the ball proxies (invalidated when bodies are added or removed)
+     */
+    BodySpan<Ball> getBalls() const {
+        return BodySpan<Ball>(balls.data(), balls.size());
+    }
+
+    /**
+     * Get the number of balls in the world
+     * @return Number of balls
+     */
+    size_t getBallCount() const {
+        return balls.size();
+    }
+
+    /**
+     * Set world boundaries
+     * @param minX Minimum X coordinate
+     * @param maxX Maximum X coordinate
+     * @param minY Minimum Y coordinate (floor)
+     * @param maxY Maximum Y coordinate (ceiling)
+     * @param minZ Minimum Z coordinate
+     * @param maxZ Maximum Z coordinate
+     */
+    void setWorldBounds(float minX, float maxX, float minY, float maxY, float minZ, float maxZ) {
+        worldBounds[0] = minX;
+        worldBounds[1] = maxX;
+        worldBounds[2] = minY;
+        worldBounds[3] = maxY;
+        worldBounds[4] = minZ;
+        worldBounds[5] = maxZ;
+        queriesBuilt = false;
+        wakeAll();
+    }
+
+    /**
+     * Get world boundaries
+     * @return Array of 6 floats [minX, maxX, minY, maxY, minZ, maxZ]
+     */
+    const float* getWorldBounds() const {
+        return worldBounds;
+    }
+
+    /**
+     * Clear all physics bodies from the world
+     */
+    void clear() {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            releaseProxy(bodies[i], store.flags[i]);
+        }
+        balls.clear();
+        bodies.clear();
+        store.clear();
+        contactCache.clear();
+    }
+
+    /**
+     * Get the number of physics bodies in the world
+     * @return Number of bodies
+     */
+    size_t getBodyCount() const {
+        return bodies.size();
+    }
+
+    /**
+     * Get read-only access to the SoA body state
+     * @return Body store
+     */
+    const BodyStore& getBodyStore() const {
+        return store;
+    }
+
+    /**
+     * Get writable access to the SoA body state
+     * For tools that copy per-body state in bulk (such as WorldShards); bodies
+     * must still be created and removed through the world
+     * @return Body store
+     */
+    BodyStore& getBodyStore() {
+        return store;
+    }
+
+    /**
+     * Create a body that copies one body of saved or foreign state
+     * Creates a Ball proxy when the body is flagged BODY_BALL
+     * @param state Source body state
+     * @param index Dense index of the body within state
+     * @param slot Handle slot to use (see BodyStore::create), or BodyHandle::invalidIndex for any
+     * @return Handle of the new body
+     */
+    BodyHandle addBody(const BodyStateView& state, size_t index, uint32_t slot = BodyHandle::invalidIndex) {
+        BodyHandle handle = store.create(state.positions[index], state.masses[index], state.radii[index], slot);
+        if (state.flags[index] & BODY_BALL) {
+            addBall(ballPool.create(store, handle, state.colors[index]));
+        } else {
+            bodies.push_back(bodyPool.create(store, handle));
+        }
+        store.assignBody(store.denseIndex(handle), state, index);
+        return handle;
+    }
+
+    /**
+     * Limit the uniform grid to a box instead of the whole room
+     * For worlds whose bodies occupy only part of the room (such as one shard of
+     * WorldShards); bodies outside the box still collide, they just share the
+     * edge cells
+     * @param region Box [minX, maxX, minY, maxY, minZ, maxZ]
+     */
+    void setBroadphaseRegion(const float* region) {
+        for (int i = 0; i < 6; ++i) {
+            broadphaseRegion[i] = region[i];
+        }
+        hasBroadphaseRegion = true;
+    }
+
+    /**
+     * Let the uniform grid cover the whole room again
+     */
+    void clearBroadphaseRegion() {
+        hasBroadphaseRegion = false;
+    }
+
+    /**
+     * Account for a step that was simulated outside step()
+     * WorldShards steps the bodies in per-shard worlds and copies the results
+     * back; this advances the step count, refreshes the state hash and reports
+     * the shards' counters until the next regular step
+     * @param stats Counters summed over the shards
+     */
+    void finishExternalStep(const ExternalStepStats& stats) {
+        externalStep = true;
+        externalStats = stats;
+        stepCount++;
+        if (deterministic) {
+            stateHash = computeStateHash();
+        }
+    }
+
+    /**
+     * Find the first body a ray hits
+     * Queries use the grid the last step's collision pass built when it is
+     * current; otherwise the query grid is rebuilt first if a step ran or
+     * bodies were added, removed or reshaped since it was built.
+     * @param ray Ray to cast
+     * @param hit Receives the hit (hit.body is invalid on a miss)
+     * @param filter Bodies the ray may hit
+     * @return True if the ray hit a body
+     */
+    bool raycast(const Ray& ray, RayHit& hit, const QueryFilter& filter = QueryFilter()) {
+        prepareQueries();
+        return queries.raycast(ray, filter, hit);
+    }
+
+    /**
+     * Find every body overlapping a sphere
+     * @param center Sphere center
+     * @param radius Sphere radius
+     * @param out Receives the bodies found (appended)
+     * @param filter Bodies the query may report
+     * @return Number of bodies found
+     */
+    size_t overlapSphere(const Vector3& center, float radius, std::vector<BodyHandle>& out,
+                         const QueryFilter& filter = QueryFilter()) {
+        prepareQueries();
+        return queries.overlapSphere(center, radius, filter, out);
+    }
+
+    /**
+     * Find the k bodies whose centers are nearest a point
+     * @param point Query point
+     * @param k Largest number of bodies to report
+     * @param maxDistance Only bodies whose centers are closer than this are reported
+     * @param out Receives the bodies found, nearest first (appended)
+     * @param filter Bodies the query may report
+     * @return Number of bodies found
+     */
+    size_t findNearest(const Vector3& point, size_t k, float maxDistance, std::vector<BodyHandle>& out,
+                       const QueryFilter& filter = QueryFilter()) {
+        prepareQueries();
+        return queries.nearest(point, k, maxDistance, filter, out);
+    }
+
+    /**
+     * Cast a batch of rays across the worker threads
+     * @param rays Rays to cast
+     * @param count Number of rays
+     * @param hits Receives one hit per ray
+     * @param filter Bodies the rays may hit
+     */
+    void raycastBatch(const Ray* rays, size_t count, RayHit* hits, const QueryFilter& filter = QueryFilter()) {
+        prepareQueries();
+        queries.raycastBatch(rays, count, filter, hits, &jobs);
+    }
+
+    /**
+     * Run a batch of sphere overlap queries across the worker threads
+     * @param centers Sphere centers
+     * @param radii Sphere radii
+     * @param count Number of queries
+     * @param results Receives the bodies found by each query
+     * @param filter Bodies the queries may report
+     */
+    void overlapSphereBatch(const Vector3* centers, const float* radii, size_t count, QueryResults& results,
+                            const QueryFilter& filter = QueryFilter()) {
+        prepareQueries();
+        queries.overlapSphereBatch(centers, radii, count, filter, results, &jobs);
+    }
+
+    /**
+     * Run a batch of k-nearest queries across the worker threads
+     * @param points Query points
+     * @param count Number of queries
+     * @param k Largest number of bodies to report per query
+     * @param maxDistance Only bodies whose centers are closer than this are reported
+     * @param results Receives the bodies found by each query, nearest first
+     * @param filter Bodies the queries may report
+     */
+    void findNearestBatch(const Vector3* points, size_t count, size_t k, float maxDistance, QueryResults& results,
+                          const QueryFilter& filter = QueryFilter()) {
+        prepareQueries();
+        queries.nearestBatch(points, count, k, maxDistance, filter, results, &jobs);
+    }
+
+    /**
+     * Get the uniform grid built by the last UniformGrid collision pass
+     * @return Grid broadphase (stale if the mode is not UniformGrid)
+     */
+    const UniformGridBroadphase& getGridBroadphase() const {
+        return gridBroadphase;
+    }
+
+    /**
+     * Select the broadphase algorithm used by handleCollisions
+     * @param mode Broadphase mode
+     */
+    void setBroadphaseMode(BroadphaseMode mode) {
+        broadphaseMode = mode;
+    }
+
+    /**
+     * Get the active broadphase algorithm
+     * @return Broadphase mode
+     */
+    BroadphaseMode getBroadphaseMode() const {
+        return broadphaseMode;
+    }
+
+    /**
+     * Select the instruction set used by the integration and boundary kernels
+     * @param level SIMD level
+     * @return False if the level is not supported on this CPU
+     */
+    bool setSimdLevel(SimdLevel level) {
+        if (!SimdKernels::isSupported(level)) {
+            return false;
+        }
+        simdLevel = level;
+        return true;
+    }
+
+    /**
+     * Get the instruction set used by the integration and boundary kernels
+     * @return SIMD level
+     */
+    SimdLevel getSimdLevel() const {
+        return simdLevel;
+    }
+
+    /**
+     * Get the fixed simulation step
+     * @return Step length in seconds
+     */
+    float getTimeStep() const {
+        return timeStep;
+    }
+
+    /**
+     * Resize the physics worker pool
+     * @param threadCount Total threads including the caller (0 = hardware concurrency)
+     */
+    void setThreadCount(size_t threadCount) {
+        jobs.setThreadCount(threadCount);
+    }
+
+    /**
+     * Get the physics worker pool size
+     * @return Total threads including the caller
+     */
+    size_t getThreadCount() const {
+        return jobs.getThreadCount();
+    }
+
+    /**
+     * Enable or disable sleeping; disabling wakes every body
+     * @param enabled True to let resting islands fall asleep
+     */
+    void setSleepingEnabled(bool enabled) {
+        sleepingEnabled = enabled;
+        if (!enabled) {
+            wakeAll();
+        }
+    }
+
+    /**
+     * Check whether sleeping is enabled
+     * @return True if resting islands fall asleep
+     */
+    bool isSleepingEnabled() const {
+        return sleepingEnabled;
+    }
+
+    /**
+     * Set the kinetic energy under which a body counts as resting
+     * Higher thresholds put piles to sleep sooner, trading settling accuracy for step time
+     * @param energy Threshold in joules (not negative)
+     */
+    void setSleepEnergy(float energy) {
+        sleepEnergy = std::max(energy, 0.0f);
+    }
+
+    /**
+     * Get the kinetic energy under which a body counts as resting
+     * @return Threshold in joules
+     */
+    float getSleepEnergy() const {
+        return sleepEnergy;
+    }
+
+    /**
+     * Get the number of bodies asleep after the last step
+     * @return Sleeping body count
+     */
+    size_t getSleepingCount() const {
+        return externalStep ? externalStats.sleeping : sleepingCount;
+    }
+
+    /**
+     * Wake every body
+     */
+    void wakeAll() {
+        for (size_t i = 0; i < store.size(); ++i) {
+            store.flags[i] &= (uint8_t)~BODY_SLEEPING;
+            store.restSteps[i] = 0;
+        }
+        sleepingCount = 0;
+    }
+
+    /**
+     * Enable or disable swept collision for fast bodies
+     * @param enabled True to sweep bodies that move more than half a radius per step
+     */
+    void setContinuousCollisionEnabled(bool enabled) {
+        ccdEnabled = enabled;
+    }
+
+    /**
+     * Check whether swept collision is enabled
+     * @return True if fast bodies are swept
+     */
+    bool isContinuousCollisionEnabled() const {
+        return ccdEnabled;
+    }
+
+    /**
+     * Get the number of bodies swept in the last step
+     * @return Swept body count
+     */
+    size_t getSweptCount() const {
+        return externalStep ? externalStats.swept : sweptCount;
+    }
+
+    /**
+     * Seed the collision jitter stream
+     * @param seed Seed value
+     */
+    void setRandomSeed(uint64_t seed) {
+        randomSeed = seed;
+    }
+
+    /**
+     * Get the collision jitter seed
+     * @return Seed value
+     */
+    uint64_t getRandomSeed() const {
+        return randomSeed;
+    }
+
+    /**
+     * Set the number of steps simulated so far (keys the jitter stream)
+     * Restoring the count along with the bodies makes a resumed run repeat the original
+     * @param steps Step count
+     */
+    void setStepCount(uint64_t steps) {
+        stepCount = steps;
+    }
+
+    /**
+     * Get the number of steps simulated so far
+     * @return Step count
+     */
+    uint64_t getStepCount() const {
+        return stepCount;
+    }
+
+    /**
+     * Enable or disable deterministic (lockstep) mode
+     * The simulation itself is already repeatable: collision jitter is keyed on
+     * the seed, step count and body handles, pairs are visited in ascending
+     * index order, and the parallel phases give the same result for any thread
+     * count. Deterministic mode additionally pins every step to the fixed time
+     * step and hashes the state after each step, so peers that apply the same
+     * inputs on the same steps can compare hashes instead of exchanging bodies.
+     * @param enabled True to enable deterministic mode
+     */
+    void setDeterministicEnabled(bool enabled) {
+        deterministic = enabled;
+        stateHash = enabled ? computeStateHash() : 0;
+    }
+
+    /**
+     * Check whether deterministic mode is enabled
+     * @return True if enabled
+     */
+    bool isDeterministicEnabled() const {
+        return deterministic;
+    }
+
+    /**
+     * Get the hash of the state after the last step
+     * @return Hash from computeStateHash, or 0 outside deterministic mode
+     */
+    uint64_t getStateHash() const {
+        return stateHash;
+    }
+
+    /**
+     * Hash everything one step carries into the next
+     * Covers the step count, the seed, the settings that change what a step
+     * computes (time step, gravity, bounds, contact solve mode, solver
+     * iterations, warm starting, sleeping and CCD), body handle slots, the
+     * per-step body state (positions, velocities, forces, flags and rest
+     * counters) bit for bit, and the warm-start impulses in the contact cache.
+     * Worlds with equal hashes continue identically given the same inputs.
+     * Thread count, SIMD level and broadphase are left out: every choice gives
+     * the same result.
+     * @return 64-bit state hash
+     */
+    uint64_t computeStateHash() const {
+        size_t count = store.size();
+        uint64_t hash = CounterRng::combine(CounterRng::combine(randomSeed, stepCount), count);
+        float settings[] = { timeStep, gravity.x, gravity.y, gravity.z, sleepEnergy };
+        hash = hashBytes(hash, settings, sizeof(settings));
+        hash = hashBytes(hash, worldBounds, sizeof(worldBounds));
+        hash = CounterRng::combine(hash, ((uint64_t)contactSolveMode << 32) | (uint32_t)solverIterations);
+        hash = CounterRng::combine(hash, (warmStarting ? 1u : 0u) | (sleepingEnabled ? 2u : 0u) | (ccdEnabled ? 4u : 0u));
+        hash = hashBytes(hash, store.denseToHandle.data(), count * sizeof(uint32_t));
+        hash = hashBytes(hash, store.positions.data(), count * sizeof(Vector3));
+        hash = hashBytes(hash, store.velocities.data(), count * sizeof(Vector3));
+        hash = hashBytes(hash, store.forces.data(), count * sizeof(Vector3));
+        hash = hashBytes(hash, store.flags.data(), count * sizeof(uint8_t));
+        hash = hashBytes(hash, store.restSteps.data(), count * sizeof(uint16_t));
+        return contactCache.hashContents(hash, [this](const ContactCache::PairKey& key) {
+            return isCachedLive(key.low) && isCachedLive(key.high);
+        });
+    }
+
+    /**
+     * Select how contacts are resolved
+     * @param mode Contact solve mode
+     */
+    void setContactSolveMode(ContactSolveMode mode) {
+        contactSolveMode = mode;
+    }
+
+    /**
+     * Get how contacts are resolved
+     * @return Contact solve mode
+     */
+    ContactSolveMode getContactSolveMode() const {
+        return contactSolveMode;
+    }
+
+    /**
+     * Set the number of solver iterations per step
+     * More iterations let impulses travel further through a pile in one step
+     * @param iterations Velocity iterations (at least 1)
+     */
+    void setSolverIterations(int iterations) {
+        solverIterations = std::max(iterations, 1);
+    }
+
+    /**
+     * Get the number of solver iterations per step
+     * @return Velocity iterations
+     */
+    int getSolverIterations() const {
+        return solverIterations;
+    }
+
+    /**
+     * Enable or disable warm starting from the contact cache
+     * @param enabled True to start each contact from last step's impulses
+     */
+    void setWarmStartingEnabled(bool enabled) {
+        warmStarting = enabled;
+    }
+
+    /**
+     * Check whether contacts are warm started
+     * @return True if cached impulses are reused
+     */
+    bool isWarmStartingEnabled() const {
+        return warmStarting;
+    }
+
+    /**
+     * Get the number of contacts held in the cache
+     * @return Contacts solved on the last step that ran the solver
+     */
+    size_t getCachedContactCount() const {
+        return externalStep ? externalStats.cachedContacts : contactCache.size();
+    }
+
+    /**
+     * Copy the contact cache out, addressed by dense index (checkpoint saving)
+     * @param saved Receives the cached contacts, sorted so equal caches give equal lists
+     */
+    void getSavedContacts(std::vector<SavedContact>& saved) const {
+        saved.clear();
+        saved.reserve(contactCache.size());
+        auto toIndex = [&](uint64_t packed) {
+            BodyHandle handle;
+            handle.index = (uint32_t)packed;
+            handle.generation = (uint32_t)(packed >> 32);
+            return handle.index >= planeKeyBase ? handle.index : store.denseIndex(handle);
+        };
+        contactCache.forEach([&](const ContactCache::PairKey& key, const CachedImpulse& impulse) {
+            if (!isCachedLive(key.low) || !isCachedLive(key.high)) {
+                return;
+            }
+            SavedContact contact;
+            contact.bodyA = toIndex(key.low);
+            contact.bodyB = toIndex(key.high);
+            contact.normal = impulse.normal;
+            contact.tangent = impulse.tangent;
+            saved.push_back(contact);
+        });
+        std::sort(saved.begin(), saved.end(), [](const SavedContact& x, const SavedContact& y) {
+            return x.bodyA != y.bodyA ? x.bodyA < y.bodyA : x.bodyB < y.bodyB;
+        });
+    }
+
+    /**
+     * Replace the contact cache with saved contacts (checkpoint loading)
+     * Call after restoreBodies; entries naming bodies that do not exist are dropped
+     * @param saved Contacts from getSavedContacts
+     * @param count Number of contacts
+     */
+    void restoreSavedContacts(const SavedContact* saved, size_t count) {
+        contactCache.clear();
+        contactCache.beginRecording(count);
+        auto toHandle = [&](uint32_t index) {
+            BodyHandle handle;
+            handle.index = index;
+            return index >= planeKeyBase ? handle : store.handleAt(index);
+        };
+        for (size_t i = 0; i < count; ++i) {
+            const SavedContact& contact = saved[i];
+            bool bodyA = contact.bodyA < store.size();
+            bool bodyB = contact.bodyB < store.size();
+            bool planeB = contact.bodyB >= planeKeyBase && contact.bodyB < planeKeyBase + 6;
+            if (!bodyA || !(bodyB || planeB) || contact.bodyA == contact.bodyB) {
+                continue;
+            }
+            CachedImpulse impulse;
+            impulse.normal = contact.normal;
+            impulse.tangent = contact.tangent;
+            contactCache.record(ContactCache::makeKey(toHandle(contact.bodyA), toHandle(contact.bodyB)), impulse);
+        }
+        contactCache.finishRecording();
+    }
+
+    /**
+     * Get the number of touching body pairs found by the last step
+     * @return Contact pairs (plane contacts not included)
+     */
+    size_t getContactCount() const {
+        return externalStep ? externalStats.contacts : contacts.size();
+    }
+
+    /**
+     * Enable or disable per-phase timing of step()
+     * Timing costs a clock read per phase, so it is off by default.
+     * Timed phases are also charged to the Profiler while it is enabled.
+     * @param enabled True to collect StepTimings
+     */
+    void setStepTimingEnabled(bool enabled) {
+        stepTimingEnabled = enabled;
+    }
+
+    /**
+     * Check whether step phases are timed
+     * @return True if StepTimings are being collected
+     */
+    bool isStepTimingEnabled() const {
+        return stepTimingEnabled;
+    }
+
+    /**
+     * Get the phase times collected since the last reset
+     * @return Summed phase times
+     */
+    const StepTimings& getStepTimings() const {
+        return stepTimings;
+    }
+
+    /**
+     * Zero the collected phase times
+     */
+    void resetStepTimings() {
+        stepTimings = StepTimings();
+    }
+
+    /**
+     * Set gravity for the world
+     * @param g Gravity vector
+     */
+    void setGravity(const Vector3& g) {
+        gravity = g;
+        wakeAll();
+    }
+
+    /**
+     * Get current gravity
+     * @return Gravity vector
+     */
+    const Vector3& getGravity() const {
+        return gravity;
+    }
+
+private:
+    /**
+     * Check whether one half of a contact cache key still names a body or a plane
+     * @param packed (generation << 32) | slot from a PairKey
+     * @return False if the body was removed since the contact was cached
+     */
+    bool isCachedLive(uint64_t packed) const {
+        BodyHandle handle;
+        handle.index = (uint32_t)packed;
+        handle.generation = (uint32_t)(packed >> 32);
+        return handle.index >= planeKeyBase || store.isAlive(handle);
+    }
+
+    /**
+     * Fold a block of memory into a hash eight bytes at a time
+     * @param hash Hash so far
+     * @param data First byte
+     * @param bytes Number of bytes
+     * @return Updated hash
+     */
+    static uint64_t hashBytes(uint64_t hash, const void* data, size_t bytes) {
+        const uint8_t* cursor = (const uint8_t*)data;
+        for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t), cursor += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, cursor, sizeof(word));
+            hash = CounterRng::combine(hash, word);
+        }
+        if (bytes > 0) {
+            uint64_t word = 0;
+            std::memcpy(&word, cursor, bytes);
+            hash = CounterRng::combine(hash, word ^ ((uint64_t)bytes << 56));
+        }
+        return hash;
+    }
+
+    /**
+     * Register a newly created ball in bodies and the ball index
+     * @param ball Ball proxy
+     */
+    void addBall(Ball* ball) {
+        BodyHandle handle = ball->getHandle();
+        bodies.push_back(ball);
+        if (ballSlots.size() <= handle.index) {
+            ballSlots.resize(handle.index + 1);
+        }
+        ballSlots[handle.index] = (uint32_t)balls.size();
+        balls.push_back(ball);
+    }
+
+    /**
+     * Return a body proxy to the pool it came from
+     * @param body Body proxy
+     * @param flags The body's BodyFlags (BODY_BALL selects the ball pool)
+     */
+    void releaseProxy(PhysicsBody* body, uint8_t flags) {
+        if (flags & BODY_BALL) {
+            ballPool.destroy(static_cast<Ball*>(body));
+        } else {
+            bodyPool.destroy(body);
+        }
+    }
+
+    /**
+     * Start timing the first phase of a step
+     */
+    void beginPhaseTiming() {
+        if (stepTimingEnabled) {
+            phaseStart = Clock::now();
+        }
+    }
+
+    /**
+     * Charge the time since the previous phase ended to a phase
+     * @param phase StepTimings field to add to
+     */
+    void endPhase(double StepTimings::*phase) {
+        if (stepTimingEnabled) {
+            Clock::time_point now = Clock::now();
+            stepTimings.*phase += std::chrono::duration<double>(now - phaseStart).count();
+#if PHYSICS_PROFILING
+            Profiler::get().addTime(phaseZone(phase), phaseStart, now);
+#endif
+            phaseStart = now;
+        }
+    }
+
+    /**
+     * Get the profiler zone a step phase is charged to
+     * @param phase StepTimings field
+     * @return Zone index
+     */
+    static int phaseZone(double StepTimings::*phase) {
+        static const struct { double StepTimings::*phase; int zone; } zones[] = {
+            { &StepTimings::integrate, Profiler::get().registerZone("physics.integrate") },
+            { &StepTimings::broadphase, Profiler::get().registerZone("physics.broadphase") },
+            { &StepTimings::narrowphase, Profiler::get().registerZone("physics.narrowphase") },
+            { &StepTimings::solve, Profiler::get().registerZone("physics.solve") },
+            { &StepTimings::continuous, Profiler::get().registerZone("physics.continuous") },
+            { &StepTimings::boundaries, Profiler::get().registerZone("physics.boundaries") },
+            { &StepTimings::sleep, Profiler::get().registerZone("physics.sleep") }
+        };
+        for (const auto& entry : zones) {
+            if (entry.phase == phase) {
+                return entry.zone;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Check whether the collision grid was built by the last step over the current bodies
+     * Its cells hold the positions bodies started that step with, so queries
+     * can use it instead of filing every body into a grid of their own
+     * @return True if gridBroadphase can serve spatial queries
+     */
+    bool isGridCurrent() const {
+        return broadphaseMode == BroadphaseMode::UniformGrid && !externalStep && gridStep + 1 == stepCount &&
+               gridRevision == store.getRevision() && gridBroadphase.isBuiltFor(store.size());
+    }
+
+    /**
+     * Point the queries at the grid the last step built, or rebuild the query
+     * grid if that one is stale and a step ran or bodies were added, removed
+     * or reshaped since the query grid was built
+     */
+    void prepareQueries() {
+        if (queriesBuilt && queryStep == stepCount && queryRevision == store.getRevision()) {
+            return;
+        }
+        if (isGridCurrent()) {
+            queries.attach(store, gridBroadphase, planeBodies);
+        } else {
+            queries.build(store, worldBounds);
+        }
+        queriesBuilt = true;
+        queryStep = stepCount;
+        queryRevision = store.getRevision();
+    }
+
+    /**
+     * Find out which shapes are in the world this step
+     * Sets hasShapedBodies and collects the Plane-shaped bodies
+     */
+    void scanShapes() {
+        planeBodies.clear();
+        hasShapedBodies = false;
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (!(store.flags[i] & BODY_SHAPED)) {
+                continue;
+            }
+            hasShapedBodies = true;
+            if (store.shapes[i] == (uint8_t)ShapeType::Plane) {
+                planeBodies.push_back((uint32_t)i);
+            }
+        }
+    }
+
+    /**
+     * Collect every overlapping pair into contacts, in brute-force visiting order
+     * The grid's candidate pairs are bucketed by shape-pair kind and each
+     * bucket runs its own collide kernel over the whole batch (a world of
+     * spheres is a single bucket). Plane bodies are infinite, so they are kept
+     * out of the grid's results and tested against every body instead.
+     */
+    void gatherContacts() {
+        contacts.clear();
+        size_t count = store.size();
+        scanShapes();
+        
+        if (broadphaseMode == BroadphaseMode::BruteForce) {
+            ContactPoint point;
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t j = i + 1; j < count; ++j) {
+                    if (bodiesColliding(i, j, point)) {
+                        addContact(i, j, point.normal);
+                    }
+                }
+            }
+            return;
+        }
+        
+        gridBroadphase.build(store.positions.data(), store.radii.data(), count,
+                             hasBroadphaseRegion ? broadphaseRegion : worldBounds, &jobs,
+                             sleepingEnabled ? store.flags.data() : nullptr);
+        gridStep = stepCount;
+        gridRevision = store.getRevision();
+        endPhase(&StepTimings::broadphase);
+        const auto& pairs = gridBroadphase.getPairs();
+        
+        // Narrowphase in parallel, then compact in pair order
+        pairTouching.resize(pairs.size());
+        pairNormals.resize(pairs.size());
+        if (!hasShapedBodies) {
+            Narrowphase::BatchFunction kernel =
+                Narrowphase::batchFunction(Narrowphase::pairKind(ShapeType::Sphere, ShapeType::Sphere));
+            jobs.parallelFor(pairs.size(), contactGrain, [&](size_t begin, size_t end) {
+                kernel(store, pairs.data(), nullptr, begin, end, pairTouching.data(), pairNormals.data());
+            });
+        } else {
+            bucketPairsByKind(pairs);
+            for (size_t kind = 0; kind < Narrowphase::pairKindCount; ++kind) {
+                size_t first = kindStart[kind];
+                size_t kindCount = kindStart[kind + 1] - first;
+                if (kindCount == 0) {
+                    continue;
+                }
+                if (kind / Narrowphase::shapeTypeCount == (size_t)ShapeType::Plane ||
+                    kind % Narrowphase::shapeTypeCount == (size_t)ShapeType::Plane) {
+                    for (size_t k = first; k < first + kindCount; ++k) {
+                        pairTouching[pairOrder[k]] = 0;  // gatherPlaneBodyContacts tests these
+                    }
+                    continue;
+                }
+                Narrowphase::BatchFunction kernel = Narrowphase::batchFunction(kind);
+                jobs.parallelFor(kindCount, contactGrain, [&](size_t begin, size_t end) {
+                    kernel(store, pairs.data(), pairOrder.data(), first + begin, first + end,
+                           pairTouching.data(), pairNormals.data());
+                });
+            }
+        }
+        for (size_t p = 0; p < pairs.size(); ++p) {
+            if (pairTouching[p]) {
+                addContact(pairs[p].first, pairs[p].second, pairNormals[p]);
+            }
+        }
+        gatherPlaneBodyContacts();
+    }
+
+    /**
+     * Counting-sort grid pairs into pairOrder by shape-pair kind, keeping pair order within a kind
+     * @param pairs Candidate pairs
+     */
+    void bucketPairsByKind(const std::vector<UniformGridBroadphase::Pair>& pairs) {
+        kindStart.assign(Narrowphase::pairKindCount + 1, 0);
+        for (const auto& pair : pairs) {
+            kindStart[Narrowphase::pairKind(store, pair.first, pair.second) + 1]++;
+        }
+        for (size_t kind = 0; kind < Narrowphase::pairKindCount; ++kind) {
+            kindStart[kind + 1] += kindStart[kind];
+        }
+        pairOrder.resize(pairs.size());
+        bucketCursor.assign(kindStart.begin(), kindStart.end() - 1);
+        for (size_t p = 0; p < pairs.size(); ++p) {
+            size_t kind = Narrowphase::pairKind(store, pairs[p].first, pairs[p].second);
+            pairOrder[bucketCursor[kind]++] = (uint32_t)p;
+        }
+    }
+
+    /**
+     * Test every plane body against every other body (grid mode)
+     * Contacts are appended plane by plane in body order
+     */
+    void gatherPlaneBodyContacts() {
+        ContactPoint point;
+        for (uint32_t plane : planeBodies) {
+            if (!(store.flags[plane] & BODY_ACTIVE)) {
+                continue;
+            }
+            for (uint32_t i = 0; i < (uint32_t)store.size(); ++i) {
+                if (i == plane || store.shapes[i] == (uint8_t)ShapeType::Plane) {
+                    continue;
+                }
+                uint32_t a = std::min(i, plane);
+                uint32_t b = std::max(i, plane);
+                if (bodiesColliding(a, b, point)) {
+                    addContact(a, b, point.normal);
+                }
+            }
+        }
+    }
+
+    /**
+     * Collect every awake dynamic body touching a world plane into planeContacts
+     * Bodies within penetrationSlop count as touching, since integration clamps
+     * balls exactly onto the floor. Shaped bodies reach the planes with their
+     * extents instead of their radius. A body touches at most one plane per
+     * axis; b holds the plane index.
+     */
+    void gatherPlaneContacts() {
+        for (size_t i = 0; i < store.size(); ++i) {
+            if ((store.flags[i] & (BODY_ACTIVE | BODY_STATIC | BODY_SLEEPING)) != BODY_ACTIVE) {
+                continue;
+            }
+            const Vector3& position = store.positions[i];
+            float radius = store.radii[i] + penetrationSlop;
+            Vector3 reach = (store.flags[i] & BODY_SHAPED)
+                ? store.extents[i] + Vector3(penetrationSlop, penetrationSlop, penetrationSlop)
+                : Vector3(radius, radius, radius);
+            const float axes[3] = { position.x, position.y, position.z };
+            const float reaches[3] = { reach.x, reach.y, reach.z };
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                uint32_t plane = axis * 2;
+                if (axes[axis] - reaches[axis] < worldBounds[plane]) {
+                    addPlaneContact(i, plane);
+                } else if (axes[axis] + reaches[axis] > worldBounds[plane + 1]) {
+                    addPlaneContact(i, plane + 1);
+                }
+            }
+        }
+    }
+
+    /**
+     * Append a body-plane contact
+     */
+    void addPlaneContact(size_t body, uint32_t plane) {
+        Contact contact;
+        contact.a = (uint32_t)body;
+        contact.b = plane;
+        contact.normal = Vector3::ZERO;
+        planeContacts.push_back(contact);
+    }
+
+    /**
+     * Island-based sleep pass, run after each step
+     * Bodies connected through this step's contacts form islands. A body's rest
+     * counter grows while its kinetic energy stays under sleepEnergy; an island
+     * sleeps once every member has rested for sleepSteps, and wakes as soon as
+     * any member moves again (for example an awake body touching it).
+     */
+    void updateSleepStates() {
+        size_t count = store.size();
+        
+        // Nothing moved and nothing touched: every island is still asleep
+        if (contacts.empty() && !anyAwakeBody()) {
+            sleepingCount = 0;
+            for (uint8_t flags : store.flags) {
+                sleepingCount += (flags & BODY_SLEEPING) ? 1 : 0;
+            }
+            return;
+        }
+        
+        islandParent.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            islandParent[i] = (uint32_t)i;
+        }
+        for (const Contact& contact : contacts) {
+            // Static bodies would merge everything resting on them into one island
+            if (!((store.flags[contact.a] | store.flags[contact.b]) & BODY_STATIC)) {
+                uniteIslands(contact.a, contact.b);
+            }
+        }
+        
+        // Advance rest counters and find the least rested body of each island
+        islandRest.assign(count, UINT16_MAX);
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t flags = store.flags[i];
+            if ((flags & (BODY_ACTIVE | BODY_STATIC)) != BODY_ACTIVE) {
+                continue;
+            }
+            if (!(flags & BODY_SLEEPING)) {
+                float energy = 0.5f * store.masses[i] * store.velocities[i].magnitudeSquared();
+                bool resting = !(flags & BODY_HELD) && energy < sleepEnergy;
+                store.restSteps[i] = resting ? (uint16_t)std::min<int>(store.restSteps[i] + 1, UINT16_MAX) : 0;
+            }
+            uint32_t root = findIsland((uint32_t)i);
+            islandRest[root] = std::min(islandRest[root], store.restSteps[i]);
+        }
+        
+        sleepingCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t& flags = store.flags[i];
+            if ((flags & (BODY_ACTIVE | BODY_STATIC)) != BODY_ACTIVE) {
+                continue;
+            }
+            if (islandRest[findIsland((uint32_t)i)] >= sleepSteps) {
+                if (!(flags & BODY_SLEEPING)) {
+                    flags |= BODY_SLEEPING;
+                    store.velocities[i] = Vector3::ZERO;
+                    store.forces[i] = Vector3::ZERO;
+                }
+                sleepingCount++;
+            } else if (flags & BODY_SLEEPING) {
+                flags &= (uint8_t)~BODY_SLEEPING;
+                store.restSteps[i] = 0;
+            }
+        }
+    }
+
+    /**
+     * Check whether any active, non-static body is awake
+     * @return True if at least one body can move
+     */
+    bool anyAwakeBody() const {
+        for (uint8_t flags : store.flags) {
+            if ((flags & (BODY_ACTIVE | BODY_STATIC | BODY_SLEEPING)) == BODY_ACTIVE) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Find the island root of a body, halving the path as it goes
+     */
+    uint32_t findIsland(uint32_t body) {
+        while (islandParent[body] != body) {
+            islandParent[body] = islandParent[islandParent[body]];
+            body = islandParent[body];
+        }
+        return body;
+    }
+
+    /**
+     * Merge the islands of two bodies (the smaller root index becomes the root)
+     */
+    void uniteIslands(uint32_t a, uint32_t b) {
+        uint32_t rootA = findIsland(a);
+        uint32_t rootB = findIsland(b);
+        if (rootA < rootB) {
+            islandParent[rootB] = rootA;
+        } else if (rootB < rootA) {
+            islandParent[rootA] = rootB;
+        }
+    }
+
+    /**
+     * Append a contact
+     */
+    void addContact(size_t a, size_t b, const Vector3& normal) {
+        Contact contact;
+        contact.a = (uint32_t)a;
+        contact.b = (uint32_t)b;
+        contact.normal = normal;
+        contacts.push_back(contact);
+    }
+
+    /**
+     * Greedy coloring: each contact takes the lowest color unused by both bodies,
+     * then contacts are bucketed by color keeping detection order within a color
+     * Contacts that find no free color go to an overflow bucket at index maxColors
+     */
+    void colorContacts() {
+        bodyColorMasks.assign(store.size(), 0);
+        contactColors.resize(contacts.size());
+        colorStart.assign(maxColors + 2, 0);
+        
+        for (size_t c = 0; c < contacts.size(); ++c) {
+            uint64_t used = bodyColorMasks[contacts[c].a] | bodyColorMasks[contacts[c].b];
+            size_t color = maxColors;
+            if (used != ~(uint64_t)0) {
+                color = lowestClearBit(used);
+                uint64_t bit = (uint64_t)1 << color;
+                bodyColorMasks[contacts[c].a] |= bit;
+                bodyColorMasks[contacts[c].b] |= bit;
+            }
+            contactColors[c] = (uint8_t)color;
+            colorStart[color + 1]++;
+        }
+        
+        for (size_t color = 0; color <= maxColors; ++color) {
+            colorStart[color + 1] += colorStart[color];
+        }
+        
+        coloredContacts.resize(contacts.size());
+        std::vector<uint32_t>& cursor = bucketCursor;
+        cursor.assign(colorStart.begin(), colorStart.end() - 1);
+        for (size_t c = 0; c < contacts.size(); ++c) {
+            coloredContacts[cursor[contactColors[c]]++] = contacts[c];
+        }
+    }
+
+    /**
+     * Index of the lowest zero bit
+     * @param bits Bit mask with at least one zero bit
+     * @return Bit index
+     */
+    static size_t lowestClearBit(uint64_t bits) {
+        uint64_t freeBits = ~bits;
+        size_t index = 0;
+        while (!(freeBits & 1)) {
+            freeBits >>= 1;
+            index++;
+        }
+        return index;
     }
 }; 
\ No newline at end of file
@@ -0,0 +1,545 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// Build with -DPHYSICS_PROFILING=0 to compile every PROFILE_SCOPE out
+#ifndef PHYSICS_PROFILING
+#define PHYSICS_PROFILING 1
+#endif
+
+/**
+ * Profiler collects per-frame timings of named zones for the perf console command
+ * Zones are charged from any thread (scoped CPU timers, GPU timer queries,
+ * PhysicsWorld step phases) into per-zone atomics. Once per frame the render
+ * thread calls endFrame(), which moves the pending totals into a ring buffer of
+ * the last historySize frames; every statistic is computed from that ring on
+ * the render thread only.
+ *
+ * While a trace is being captured every CPU zone is also logged with its start
+ * time and thread, and written as Chrome trace JSON (chrome://tracing or
+ * Perfetto) once the requested number of frames has passed.
+ */
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int maxZones = 64;                 // Distinct zone names
+    static constexpr size_t historySize = 240;          // Frames kept for rolling statistics
+    static constexpr size_t maxTraceEvents = 1 << 20;   // Events kept per trace before dropping
+
+    /**
+     * Rolling frame statistics over the frames in the history ring
+     */
+    struct FrameSummary {
+        size_t frames = 0;              // Frames in the window
+        double averageMs = 0.0;         // Mean frame time
+        double p50Ms = 0.0;             // Median frame time
+        double p90Ms = 0.0;             // 90th percentile frame time
+        double p99Ms = 0.0;             // 99th percentile frame time
+        double maxMs = 0.0;             // Slowest frame
+        double drawCalls = 0.0;         // Mean draw calls per frame
+        double contacts = 0.0;          // Mean contact pairs per frame
+    };
+
+    /**
+     * Rolling time of one zone
+     */
+    struct ZoneSummary {
+        const char* name;               // Zone name
+        bool gpu;                       // Measured with GPU timer queries
+        double averageMs;               // Mean time per frame
+        double maxMs;                   // Largest time in one frame
+    };
+
+private:
+    /**
+     * One named zone and its per-frame history
+     */
+    struct Zone {
+        const char* name = nullptr;                     // Zone name (string literal)
+        bool gpu = false;                               // GPU time rather than CPU time
+        std::atomic<uint64_t> pendingNanoseconds{0};    // Time charged since the last endFrame
+        float history[historySize] = {};                // Milliseconds per frame
+    };
+
+    /**
+     * One complete zone captured for the trace
+     */
+    struct TraceEvent {
+        int zone;                       // Zone index, -1 for a whole frame
+        uint32_t thread;                // Profiler thread id
+        int64_t start;                  // Start in nanoseconds since the trace began
+        int64_t duration;               // Duration in nanoseconds
+    };
+
+    std::atomic<bool> enabled;                  // Zones are ignored while cleared
+    Zone zones[maxZones];                       // Registered zones, zoneCount of them valid
+    std::atomic<int> zoneCount;                 // Number of registered zones
+    std::mutex zoneMutex;                       // Serializes zone registration
+
+    float frameHistory[historySize];            // Frame times in milliseconds
+    uint32_t drawCallHistory[historySize];      // Draw calls per frame
+    uint32_t contactHistory[historySize];       // Contact pairs per frame
+    size_t frameCursor;                         // Ring slot the next frame goes into
+    size_t frameFilled;                         // Valid ring entries
+    Clock::time_point frameStart;               // When the current frame began
+    bool frameStarted;                          // frameStart is valid
+    uint32_t frameDrawCalls;                    // Counters reported for the current frame
+    uint32_t frameContacts;
+
+    std::atomic<bool> tracing;                  // Zones are being logged for a trace
+    std::mutex traceMutex;                      // Guards the trace state below
+    std::vector<TraceEvent> traceEvents;        // Events captured so far
+    std::vector<std::string> threadNames;       // Indexed by profiler thread id
+    Clock::time_point traceStart;               // Time origin of the trace
+    std::string tracePath;                      // File the trace is written to
+    int traceFramesLeft;                        // Frames still to capture
+    std::atomic<uint32_t> nextThreadId;         // Next profiler thread id to hand out
+
+    Profiler()
+        : enabled(false)
+        , zoneCount(0)
+        , frameHistory()
+        , drawCallHistory()
+        , contactHistory()
+        , frameCursor(0)
+        , frameFilled(0)
+        , frameStarted(false)
+        , frameDrawCalls(0)
+        , frameContacts(0)
+        , tracing(false)
+        , traceFramesLeft(0)
+        , nextThreadId(0) {
+    }
+
+public:
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * Get the process-wide profiler
+     * @return Profiler shared by every PROFILE_SCOPE
+     */
+    static Profiler& get() {
+        static Profiler instance;
+        return instance;
+    }
+
+    /**
+     * Enable or disable collection (off until someone turns it on)
+     * @param enable True to charge zones
+     */
+    void setEnabled(bool enable) {
+        enabled = enable;
+    }
+
+    /**
+     * Check whether zones are being charged
+     * @return True if enabled
+     */
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Look up or create a zone
+     * @param name Zone name; must outlive the profiler (a string literal)
+     * @param gpu True if the zone is fed GPU times
+     * @return Zone index, or -1 if maxZones are already registered
+     */
+    int registerZone(const char* name, bool gpu = false) {
+        std::lock_guard<std::mutex> lock(zoneMutex);
+        int count = zoneCount.load();
+        for (int i = 0; i < count; ++i) {
+            if (std::strcmp(zones[i].name, name) == 0) {
+                return i;
+            }
+        }
+        if (count == maxZones) {
+            return -1;
+        }
+        zones[count].name = name;
+        zones[count].gpu = gpu;
+        zoneCount = count + 1;
+        return count;
+    }
+
+    /**
+     * Charge CPU time to a zone (any thread)
+     * @param zone Zone index from registerZone (-1 is ignored)
+     * @param start When the timed work began
+     * @param end When it finished
+     */
+    void addTime(int zone, Clock::time_point start, Clock::time_point end) {
+        if (zone < 0 || !isEnabled()) {
+            return;
+        }
+        int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        zones[zone].pendingNanoseconds.fetch_add((uint64_t)nanoseconds, std::memory_order_relaxed);
+        if (tracing.load(std::memory_order_relaxed)) {
+            recordTraceEvent(zone, start, nanoseconds);
+        }
+    }
+
+    /**
+     * Charge GPU time to a zone (render thread)
+     * @param zone Zone index from registerZone (-1 is ignored)
+     * @param nanoseconds Time the GPU spent
+     */
+    void addGpuTime(int zone, uint64_t nanoseconds) {
+        if (zone >= 0 && isEnabled()) {
+            zones[zone].pendingNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Report the current frame's counters (render thread)
+     * @param drawCalls Draw calls issued this frame
+     * @param contacts Contact pairs in the physics state being drawn
+     */
+    void setFrameCounters(uint32_t drawCalls, uint32_t contacts) {
+        frameDrawCalls = drawCalls;
+        frameContacts = contacts;
+    }
+
+    /**
+     * Close the current frame and start the next (render thread, once per frame)
+     * The first call only starts timing. Finishes a trace capture whose frame
+     * count has run out.
+     * @param message Receives a status line when a trace was written or failed
+     * @return True if message was set
+     */
+    bool endFrame(std::string& message) {
+        Clock::time_point now = Clock::now();
+        if (!isEnabled() || !frameStarted) {
+            frameStart = now;
+            frameStarted = isEnabled();
+            if (tracing.load(std::memory_order_relaxed) && !isEnabled()) {
+                message = finishTrace();  // Profiling was turned off mid-capture: keep what was caught
+                return true;
+            }
+            return false;
+        }
+
+        if (tracing.load(std::memory_order_relaxed)) {
+            recordTraceEvent(-1, frameStart, std::chrono::duration_cast<std::chrono::nanoseconds>(now - frameStart).count());
+        }
+
+        frameHistory[frameCursor] = std::chrono::duration<float, std::milli>(now - frameStart).count();
+        drawCallHistory[frameCursor] = frameDrawCalls;
+        contactHistory[frameCursor] = frameContacts;
+        int count = zoneCount.load();
+        for (int i = 0; i < count; ++i) {
+            uint64_t nanoseconds = zones[i].pendingNanoseconds.exchange(0, std::memory_order_relaxed);
+            zones[i].history[frameCursor] = (float)(nanoseconds / 1e6);
+        }
+        frameCursor = (frameCursor + 1) % historySize;
+        frameFilled = std::min(frameFilled + 1, historySize);
+        frameStart = now;
+
+        if (tracing.load(std::memory_order_relaxed) && --traceFramesLeft <= 0) {
+            message = finishTrace();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Forget the frame history and any time charged so far
+     */
+    void reset() {
+        frameFilled = 0;
+        frameCursor = 0;
+        frameStarted = false;
+        int count = zoneCount.load();
+        for (int i = 0; i < count; ++i) {
+            zones[i].pendingNanoseconds = 0;
+        }
+    }
+
+    /**
+     * Summarize the frames in the history ring
+     * @return Frame-time percentiles and mean counters
+     */
+    FrameSummary getFrameSummary() const {
+        FrameSummary summary;
+        summary.frames = frameFilled;
+        if (frameFilled == 0) {
+            return summary;
+        }
+
+        std::vector<float> sorted(frameHistory, frameHistory + frameFilled);
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        double drawCalls = 0.0;
+        double contacts = 0.0;
+        for (size_t i = 0; i < frameFilled; ++i) {
+            total += sorted[i];
+            drawCalls += drawCallHistory[i];
+            contacts += contactHistory[i];
+        }
+        summary.averageMs = total / frameFilled;
+        summary.p50Ms = percentile(sorted, 0.50);
+        summary.p90Ms = percentile(sorted, 0.90);
+        summary.p99Ms = percentile(sorted, 0.99);
+        summary.maxMs = sorted.back();
+        summary.drawCalls = drawCalls / frameFilled;
+        summary.contacts = contacts / frameFilled;
+        return summary;
+    }
+
+    /**
+     * Summarize every zone over the frames in the history ring
+     * @return Zones in registration order
+     */
+    std::vector<ZoneSummary> getZoneSummaries() const {
+        std::vector<ZoneSummary> summaries;
+        int count = zoneCount.load();
+        for (int i = 0; i < count; ++i) {
+            ZoneSummary summary{ zones[i].name, zones[i].gpu, 0.0, 0.0 };
+            for (size_t f = 0; f < frameFilled; ++f) {
+                summary.averageMs += zones[i].history[f];
+                summary.maxMs = std::max(summary.maxMs, (double)zones[i].history[f]);
+            }
+            if (frameFilled > 0) {
+                summary.averageMs /= frameFilled;
+            }
+            summaries.push_back(summary);
+        }
+        return summaries;
+    }
+
+    /**
+     * Look up a registered zone by name
+     * @param name Zone name
+     * @return Zone index, or -1 if no zone of that name has been registered yet
+     */
+    int findZone(const char* name) const {
+        int count = zoneCount.load();
+        for (int i = 0; i < count; ++i) {
+            if (std::strcmp(zones[i].name, name) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Get the length of the most recently closed frame
+     * @param milliseconds Receives the frame time
+     * @return False if profiling is off or no frame has been closed
+     */
+    bool getLastFrameMs(double& milliseconds) const {
+        if (!isEnabled() || frameFilled == 0) {
+            return false;
+        }
+        milliseconds = frameHistory[lastFrameSlot()];
+        return true;
+    }
+
+    /**
+     * Get the time a zone was charged in the most recently closed frame
+     * @param zone Zone index from registerZone or findZone
+     * @return Milliseconds (0 if the zone is invalid or no frame has been closed)
+     */
+    double getLastZoneMs(int zone) const {
+        if (zone < 0 || zone >= zoneCount.load() || frameFilled == 0) {
+            return 0.0;
+        }
+        return zones[zone].history[lastFrameSlot()];
+    }
+
+    /**
+     * Get the total GPU time charged in the most recently closed frame
+     * GPU zones arrive a few frames late, so this trails the CPU zones slightly.
+     * @return Milliseconds summed over every GPU zone
+     */
+    double getLastGpuMs() const {
+        if (frameFilled == 0) {
+            return 0.0;
+        }
+        double total = 0.0;
+        int count = zoneCount.load();
+        for (int i = 0; i < count; ++i) {
+            if (zones[i].gpu) {
+                total += zones[i].history[lastFrameSlot()];
+            }
+        }
+        return total;
+    }
+
+    /**
+     * Name the calling thread in traces
+     * @param name Thread name shown by the trace viewer
+     */
+    void setThreadName(const std::string& name) {
+        uint32_t thread = threadId();
+        std::lock_guard<std::mutex> lock(traceMutex);
+        if (threadNames.size() <= thread) {
+            threadNames.resize(thread + 1);
+        }
+        threadNames[thread] = name;
+    }
+
+    /**
+     * Start capturing a Chrome trace of the next frames
+     * @param path File to write when the capture ends
+     * @param frames Number of frames to capture
+     * @return False if a capture is already running or profiling is off
+     */
+    bool beginTrace(const std::string& path, int frames) {
+        if (!isEnabled() || frames < 1) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(traceMutex);
+        if (tracing) {
+            return false;
+        }
+        traceEvents.clear();
+        tracePath = path;
+        traceFramesLeft = frames;
+        traceStart = Clock::now();
+        tracing = true;
+        return true;
+    }
+
+    /**
+     * Check whether a trace is being captured
+     * @return True while capturing
+     */
+    bool isTracing() const {
+        return tracing.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * Get the calling thread's profiler id, handing out the next one on first use
+     */
+    uint32_t threadId() {
+        thread_local uint32_t id = nextThreadId.fetch_add(1);
+        return id;
+    }
+
+    /**
+     * Log one zone for the trace
+     */
+    void recordTraceEvent(int zone, Clock::time_point start, int64_t duration) {
+        uint32_t thread = threadId();
+        std::lock_guard<std::mutex> lock(traceMutex);
+        if (!tracing || traceEvents.size() >= maxTraceEvents) {
+            return;
+        }
+        int64_t offset = std::chrono::duration_cast<std::chrono::nanoseconds>(start - traceStart).count();
+        traceEvents.push_back(TraceEvent{ zone, thread, offset, duration });
+    }
+
+    /**
+     * Stop capturing and write the trace file
+     * @return Status line for the console
+     */
+    std::string finishTrace() {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        tracing = false;
+
+        std::ofstream file(tracePath);
+        if (!file.is_open()) {
+            return "Failed to write trace: " + tracePath;
+        }
+
+        // Complete ("X") events in microseconds, plus thread name metadata
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for (size_t thread = 0; thread < threadNames.size(); ++thread) {
+            if (threadNames[thread].empty()) {
+                continue;
+            }
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+                 << ",\"args\":{\"name\":\"" << threadNames[thread] << "\"}}";
+            first = false;
+        }
+        for (const TraceEvent& event : traceEvents) {
+            file << (first ? "" : ",\n") << "{\"name\":\"" << (event.zone < 0 ? "frame" : zones[event.zone].name)
+                 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                 << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0 << "}";
+            first = false;
+        }
+        file << "\n]}\n";
+
+        std::string message = "Wrote " + std::to_string(traceEvents.size()) + " trace events to " + tracePath;
+        if (traceEvents.size() >= maxTraceEvents) {
+            message += " (truncated)";
+        }
+        traceEvents.clear();
+        traceEvents.shrink_to_fit();
+        return message;
+    }
+
+    /**
+     * Nearest-rank percentile of sorted values
+     */
+    static double percentile(const std::vector<float>& sorted, double fraction) {
+        size_t rank = (size_t)std::ceil(fraction * sorted.size());
+        return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+    }
+
+    /**
+     * Ring slot of the most recently closed frame (frameFilled must be non-zero)
+     */
+    size_t lastFrameSlot() const {
+        return (frameCursor + historySize - 1) % historySize;
+    }
+};
+
+/**
+ * Charges the time between construction and destruction to a zone
+ */
+class ProfileScope {
+private:
+    int zone;                               // Zone index, -1 when profiling was off at entry
+    Profiler::Clock::time_point start;      // Construction time
+
+public:
+    /**
+     * Constructor - starts timing
+     * @param zoneIndex Zone from Profiler::registerZone
+     */
+    explicit ProfileScope(int zoneIndex)
+        : zone(Profiler::get().isEnabled() ? zoneIndex : -1) {
+        if (zone >= 0) {
+            start = Profiler::Clock::now();
+        }
+    }
+
+    /**
+     * Destructor - charges the elapsed time
+     */
+    ~ProfileScope() {
+        if (zone >= 0) {
+            Profiler::get().addTime(zone, start, Profiler::Clock::now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PHYSICS_PROFILING
+// Time the rest of the enclosing block as zone `name` (a string literal)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CONCAT(profileZone, __LINE__) = Profiler::get().registerZone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,209 @@
+#pragma once
+#include "BodyStore.h"
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Replay file layout shared by ReplayRecorder and ReplayReader
+ *
+ *   FileHeader   magic "PHYSRPLY", format version, byte-order mark
+ *   Records      one per captured tick: RecordHeader, then the payload padded to 8 bytes
+ *
+ * A keyframe payload is a complete WorldCheckpoint. A delta payload holds the
+ * bitwise XOR of every packed state word (positions, velocities, then flags
+ * four to a word) against the previous record. Words that did not change, such
+ * as those of sleeping bodies, are collapsed into runs:
+ *
+ *   repeat { varint unchangedWords, varint changedWords, changedWords raw 32-bit XOR values }
+ *
+ * Deltas only carry the state that changes every tick and require the same
+ * bodies in the same dense order as the record before them; keyframes are
+ * written whenever that does not hold.
+ */
+class ReplayFormat {
+public:
+    static constexpr uint32_t formatVersion = 1;             // Version written by ReplayRecorder
+    static constexpr uint32_t byteOrderMark = 0x01020304u;   // Reads back differently on a foreign byte order
+
+    /**
+     * Record types; values are part of the file format
+     */
+    enum RecordType : uint32_t {
+        Keyframe = 1,       // Payload is a WorldCheckpoint
+        Delta = 2           // Payload is an XOR delta against the previous record
+    };
+
+    /**
+     * Start of every replay file
+     */
+    struct FileHeader {
+        char magic[8];          // "PHYSRPLY"
+        uint32_t version;       // Format version
+        uint32_t byteOrder;     // byteOrderMark as written
+    };
+
+    /**
+     * Start of every record
+     */
+    struct RecordHeader {
+        uint32_t type;          // RecordType
+        uint32_t bodyCount;     // Bodies in the recorded state
+        uint64_t tick;          // World step count when captured
+        uint64_t payloadSize;   // Payload bytes, not counting padding
+    };
+
+    static_assert(sizeof(FileHeader) == 16, "FileHeader layout is part of the file format");
+    static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout is part of the file format");
+
+    /**
+     * Get the number of packed state words for a body count
+     * @param bodies Body count
+     * @return Three position and three velocity words per body, plus the flag words
+     */
+    static size_t wordCount(size_t bodies) {
+        return bodies * 6 + (bodies + 3) / 4;
+    }
+
+    /**
+     * Pack the per-tick state of every body into words
+     * @param state Body state
+     * @param words Receives wordCount(state.count) words
+     */
+    static void packState(const BodyStateView& state, uint32_t* words) {
+        size_t n = state.count;
+        if (n == 0) {
+            return;
+        }
+        std::memcpy(words, state.positions, n * sizeof(Vector3));
+        std::memcpy(words + n * 3, state.velocities, n * sizeof(Vector3));
+        size_t flagWords = (n + 3) / 4;
+        words[n * 6 + flagWords - 1] = 0;  // Zero the padding bytes of the last flag word
+        std::memcpy(words + n * 6, state.flags, n);
+    }
+
+    /**
+     * Read one body's position from packed words
+     */
+    static Vector3 packedPosition(const uint32_t* words, size_t body) {
+        float values[3];
+        std::memcpy(values, words + body * 3, sizeof(values));
+        return Vector3(values[0], values[1], values[2]);
+    }
+
+    /**
+     * Read one body's velocity from packed words
+     */
+    static Vector3 packedVelocity(const uint32_t* words, size_t bodies, size_t body) {
+        float values[3];
+        std::memcpy(values, words + bodies * 3 + body * 3, sizeof(values));
+        return Vector3(values[0], values[1], values[2]);
+    }
+
+    /**
+     * Read one body's flags from packed words
+     */
+    static uint8_t packedFlags(const uint32_t* words, size_t bodies, size_t body) {
+        return ((const uint8_t*)(words + bodies * 6))[body];
+    }
+
+    /**
+     * Encode the change from previous to current words
+     * @param current Words of this record
+     * @param previous Words of the record before
+     * @param count Words in each
+     * @param out Receives the delta payload (previous contents are replaced)
+     */
+    static void encodeDelta(const uint32_t* current, const uint32_t* previous, size_t count, std::vector<uint8_t>& out) {
+        out.clear();
+        size_t i = 0;
+        while (i < count) {
+            size_t unchangedStart = i;
+            while (i < count && current[i] == previous[i]) {
+                i++;
+            }
+            size_t changedStart = i;
+            while (i < count && current[i] != previous[i]) {
+                i++;
+            }
+            writeVarint(out, changedStart - unchangedStart);
+            writeVarint(out, i - changedStart);
+            for (size_t k = changedStart; k < i; ++k) {
+                uint32_t change = current[k] ^ previous[k];
+                const uint8_t* bytes = (const uint8_t*)&change;
+                out.insert(out.end(), bytes, bytes + sizeof(change));
+            }
+        }
+    }
+
+    /**
+     * Apply a delta payload to the previous record's words in place
+     * @param data Delta payload
+     * @param size Payload bytes
+     * @param words Previous words, replaced by this record's words
+     * @param count Number of words
+     * @return False if the payload is malformed
+     */
+    static bool decodeDelta(const uint8_t* data, size_t size, uint32_t* words, size_t count) {
+        size_t cursor = 0;
+        size_t i = 0;
+        while (i < count) {
+            uint64_t unchanged = 0;
+            uint64_t changed = 0;
+            if (!readVarint(data, size, cursor, unchanged) || !readVarint(data, size, cursor, changed) ||
+                unchanged > count - i || changed > count - i - unchanged ||
+                changed > (size - cursor) / sizeof(uint32_t)) {
+                return false;
+            }
+            i += (size_t)unchanged;
+            for (uint64_t k = 0; k < changed; ++k) {
+                uint32_t change;
+                std::memcpy(&change, data + cursor, sizeof(change));
+                words[i++] ^= change;
+                cursor += sizeof(change);
+            }
+        }
+        return cursor == size;
+    }
+
+    /**
+     * Round a payload size up to the record alignment
+     * @param size Payload bytes
+     * @return Bytes the payload occupies including padding
+     */
+    static uint64_t paddedSize(uint64_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+private:
+    /**
+     * Append an unsigned LEB128 varint
+     */
+    static void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((uint8_t)value);
+    }
+
+    /**
+     * Read an unsigned LEB128 varint
+     * @return False if the data ends inside the varint or it overflows 64 bits
+     */
+    static bool readVarint(const uint8_t* data, size_t size, size_t& cursor, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cursor >= size) {
+                return false;
+            }
+            uint8_t byte = data[cursor++];
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
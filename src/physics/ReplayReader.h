@@ -0,0 +1,205 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "WorldCheckpoint.h"
+#include "ReplayFormat.h"
+#include "MappedFile.h"
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * ReplayReader walks the records of a replay file written by ReplayRecorder
+ * The file is memory-mapped and decoded one record at a time: keyframes are
+ * parsed in place, deltas are applied to the state of the record before them.
+ */
+class ReplayReader {
+private:
+    MappedFile file;                        // Replay contents
+    size_t cursor;                          // Offset of the next record
+    bool keyframe;                          // The current record is a keyframe
+    uint64_t tick;                          // World step count of the current record
+    size_t bodyCount;                       // Bodies in the current record
+    std::vector<uint32_t> words;            // Packed state of the current record
+    WorldCheckpoint::Contents checkpoint;   // Views into the current keyframe
+    bool hasState;                          // A keyframe has been read, so deltas can be applied
+
+public:
+    /**
+     * Constructor - creates a reader with no file open
+     */
+    ReplayReader()
+        : cursor(0)
+        , keyframe(false)
+        , tick(0)
+        , bodyCount(0)
+        , checkpoint()
+        , hasState(false) {
+    }
+
+    /**
+     * Open a replay file and check its header
+     * @param path File to read
+     * @param error Receives a description on failure
+     * @return True if records can be read with next()
+     */
+    bool open(const std::string& path, std::string& error) {
+        hasState = false;
+        if (!file.open(path, error)) {
+            return false;
+        }
+        ReplayFormat::FileHeader header;
+        if (file.size() < sizeof(header)) {
+            error = path + ": file too small for a replay header";
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "PHYSRPLY", 8) != 0) {
+            error = path + ": not a physics replay";
+            return false;
+        }
+        if (header.byteOrder != ReplayFormat::byteOrderMark) {
+            error = path + ": replay was written with a different byte order";
+            return false;
+        }
+        if (header.version == 0 || header.version > ReplayFormat::formatVersion) {
+            error = path + ": unsupported replay version " + std::to_string(header.version);
+            return false;
+        }
+        cursor = sizeof(header);
+        return true;
+    }
+
+    /**
+     * Advance to the next record
+     * @param error Receives a description if the file is damaged (left empty at the end)
+     * @return True if a record was read
+     */
+    bool next(std::string& error) {
+        error.clear();
+        if (cursor >= file.size()) {
+            return false;
+        }
+        ReplayFormat::RecordHeader record;
+        size_t remaining = file.size() - cursor;
+        if (remaining < sizeof(record)) {
+            error = "truncated record header";
+            return false;
+        }
+        std::memcpy(&record, file.data() + cursor, sizeof(record));
+        remaining -= sizeof(record);
+        if (record.payloadSize > remaining) {
+            error = "truncated record at tick " + std::to_string(record.tick);
+            return false;
+        }
+        const uint8_t* payload = file.data() + cursor + sizeof(record);
+
+        if (record.type == ReplayFormat::Keyframe) {
+            if (!WorldCheckpoint::parse(payload, (size_t)record.payloadSize, checkpoint, error)) {
+                error = "keyframe at tick " + std::to_string(record.tick) + ": " + error;
+                return false;
+            }
+            if (checkpoint.bodies.count != record.bodyCount) {
+                error = "keyframe body count does not match its record";
+                return false;
+            }
+            words.resize(ReplayFormat::wordCount(record.bodyCount));
+            ReplayFormat::packState(checkpoint.bodies, words.data());
+            hasState = true;
+        } else if (record.type == ReplayFormat::Delta) {
+            if (!hasState || record.bodyCount != bodyCount) {
+                error = "delta at tick " + std::to_string(record.tick) + " does not follow a matching record";
+                return false;
+            }
+            if (!ReplayFormat::decodeDelta(payload, (size_t)record.payloadSize, words.data(), words.size())) {
+                error = "malformed delta at tick " + std::to_string(record.tick);
+                return false;
+            }
+        } else {
+            error = "unknown record type " + std::to_string(record.type);
+            return false;
+        }
+
+        keyframe = record.type == ReplayFormat::Keyframe;
+        tick = record.tick;
+        bodyCount = record.bodyCount;
+        cursor += sizeof(record) + (size_t)std::min<uint64_t>(ReplayFormat::paddedSize(record.payloadSize), remaining);
+        return true;
+    }
+
+    /**
+     * Check whether the current record is a keyframe
+     * @return True for keyframes
+     */
+    bool isKeyframe() const {
+        return keyframe;
+    }
+
+    /**
+     * Get the world step count of the current record
+     * @return Tick
+     */
+    uint64_t getTick() const {
+        return tick;
+    }
+
+    /**
+     * Get the number of bodies in the current record
+     * @return Body count
+     */
+    size_t getBodyCount() const {
+        return bodyCount;
+    }
+
+    /**
+     * Get a body's recorded position
+     * @param body Dense body index
+     * @return Position
+     */
+    Vector3 getPosition(size_t body) const {
+        return ReplayFormat::packedPosition(words.data(), body);
+    }
+
+    /**
+     * Get a body's recorded velocity
+     * @param body Dense body index
+     * @return Velocity
+     */
+    Vector3 getVelocity(size_t body) const {
+        return ReplayFormat::packedVelocity(words.data(), bodyCount, body);
+    }
+
+    /**
+     * Get a body's recorded flags
+     * @param body Dense body index
+     * @return BodyFlags bit set
+     */
+    uint8_t getFlags(size_t body) const {
+        return ReplayFormat::packedFlags(words.data(), bodyCount, body);
+    }
+
+    /**
+     * Get the size of the open file
+     * @return Size in bytes
+     */
+    size_t getFileSize() const {
+        return file.size();
+    }
+
+    /**
+     * Restore a world from the current record
+     * @param world World to restore into
+     * @param error Receives a description on failure
+     * @return False unless the current record is a keyframe
+     */
+    bool restoreWorld(PhysicsWorld& world, std::string& error) const {
+        if (!keyframe) {
+            error = "the world can only be restored from a keyframe";
+            return false;
+        }
+        WorldCheckpoint::apply(checkpoint, world);
+        return true;
+    }
+};
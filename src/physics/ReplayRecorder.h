@@ -0,0 +1,297 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "WorldCheckpoint.h"
+#include "ReplayFormat.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+/**
+ * ReplayRecorder streams a world's state to a replay file, one record per tick
+ * capture() only copies the per-tick state into a pooled frame and queues it;
+ * a background thread delta-encodes the frames (see ReplayFormat) and writes
+ * them, so the simulation never waits on the disk. If the writer falls
+ * maxQueuedFrames behind, frames are dropped and the next capture is written
+ * as a keyframe so the file stays decodable.
+ *
+ * Keyframes are also written for the first capture, whenever bodies were added
+ * or removed, and every keyframeInterval ticks.
+ */
+class ReplayRecorder {
+public:
+    static constexpr size_t maxQueuedFrames = 16;       // Frames waiting for the writer before captures drop
+    static constexpr uint64_t keyframeInterval = 600;   // Ticks between periodic keyframes
+
+private:
+    /**
+     * One captured tick
+     */
+    struct Frame {
+        bool keyframe = false;              // Write the checkpoint instead of a delta
+        uint64_t tick = 0;                  // World step count
+        uint32_t bodyCount = 0;             // Bodies captured
+        std::vector<uint32_t> words;        // Packed per-tick state (ReplayFormat::packState)
+        std::vector<uint8_t> checkpoint;    // Whole world, keyframes only
+    };
+
+    std::ofstream file;                             // Replay being written (writer thread while recording)
+    std::thread writer;                             // Encodes and writes queued frames
+    std::mutex queueMutex;                          // Guards queue, spareFrames and stopping
+    std::condition_variable queueReady;             // Signals the writer
+    std::deque<std::unique_ptr<Frame>> queue;       // Captured frames, oldest first
+    std::vector<std::unique_ptr<Frame>> spareFrames; // Written frames kept for reuse
+    bool stopping;                                  // The writer exits once the queue is empty
+
+    std::atomic<bool> recording;                    // capture() is accepting frames
+    std::atomic<bool> writeFailed;                  // The file could not be written
+    std::atomic<uint64_t> framesWritten;            // Records written
+    std::atomic<uint64_t> framesDropped;            // Captures skipped because the writer was behind
+    std::atomic<uint64_t> bytesWritten;             // File size so far
+
+    // Capture side
+    std::vector<uint32_t> lastLayout;               // Dense-to-handle map at the last keyframe
+    uint64_t lastKeyframeTick;                      // Tick of the last keyframe
+    bool needKeyframe;                              // Force the next capture to be a keyframe
+
+    // Writer side
+    std::vector<uint32_t> previousWords;            // Packed state of the last record written
+    std::vector<uint8_t> encoded;                   // Delta scratch
+
+public:
+    /**
+     * Constructor - creates an idle recorder
+     */
+    ReplayRecorder()
+        : stopping(false)
+        , recording(false)
+        , writeFailed(false)
+        , framesWritten(0)
+        , framesDropped(0)
+        , bytesWritten(0)
+        , lastKeyframeTick(0)
+        , needKeyframe(true) {
+    }
+
+    /**
+     * Destructor - finishes writing queued frames
+     */
+    ~ReplayRecorder() {
+        stop();
+    }
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    /**
+     * Start recording to a file, finishing any recording in progress
+     * @param path Replay file to create
+     * @param error Receives a description on failure
+     * @return True if recording started
+     */
+    bool start(const std::string& path, std::string& error) {
+        stop();
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Failed to create replay file: " + path;
+            return false;
+        }
+
+        ReplayFormat::FileHeader header;
+        std::memcpy(header.magic, "PHYSRPLY", 8);
+        header.version = ReplayFormat::formatVersion;
+        header.byteOrder = ReplayFormat::byteOrderMark;
+        file.write((const char*)&header, sizeof(header));
+
+        writeFailed = false;
+        framesWritten = 0;
+        framesDropped = 0;
+        bytesWritten = sizeof(header);
+        needKeyframe = true;
+        lastLayout.clear();
+        previousWords.clear();
+        stopping = false;
+        recording = true;
+        writer = std::thread([this]() { writerLoop(); });
+        return true;
+    }
+
+    /**
+     * Capture the world's state after a tick
+     * Copies the per-tick arrays (and the whole world for keyframes); never
+     * blocks on the writer
+     * @param world World to capture
+     */
+    void capture(const PhysicsWorld& world) {
+        if (!recording.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (writeFailed) {
+            recording = false;
+            return;
+        }
+
+        std::unique_ptr<Frame> frame;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping) {
+                return;
+            }
+            if (queue.size() >= maxQueuedFrames) {
+                framesDropped++;
+                needKeyframe = true;
+                return;
+            }
+            if (!spareFrames.empty()) {
+                frame = std::move(spareFrames.back());
+                spareFrames.pop_back();
+            }
+        }
+        if (!frame) {
+            frame = std::make_unique<Frame>();
+        }
+
+        const BodyStore& store = world.getBodyStore();
+        BodyStateView state = store.stateView();
+        frame->tick = world.getStepCount();
+        frame->bodyCount = (uint32_t)state.count;
+        frame->keyframe = needKeyframe || store.denseToHandle != lastLayout ||
+                          frame->tick - lastKeyframeTick >= keyframeInterval;
+        if (frame->keyframe) {
+            WorldCheckpoint::serialize(world, frame->checkpoint);
+            lastLayout = store.denseToHandle;
+            lastKeyframeTick = frame->tick;
+            needKeyframe = false;
+        }
+        frame->words.resize(ReplayFormat::wordCount(state.count));
+        ReplayFormat::packState(state, frame->words.data());
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(frame));
+        }
+        queueReady.notify_one();
+    }
+
+    /**
+     * Stop recording, write every queued frame and close the file
+     */
+    void stop() {
+        recording = false;
+        if (!writer.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_one();
+        writer.join();
+        file.close();
+    }
+
+    /**
+     * Check whether captures are being recorded
+     * @return True while recording
+     */
+    bool isRecording() const {
+        return recording;
+    }
+
+    /**
+     * Check whether writing the file failed (recording stops at the next capture)
+     * @return True after a write error
+     */
+    bool hasFailed() const {
+        return writeFailed;
+    }
+
+    /**
+     * Get the number of records written
+     * @return Record count
+     */
+    uint64_t getFramesWritten() const {
+        return framesWritten;
+    }
+
+    /**
+     * Get the number of captures dropped because the writer fell behind
+     * @return Dropped capture count
+     */
+    uint64_t getFramesDropped() const {
+        return framesDropped;
+    }
+
+    /**
+     * Get the number of bytes written so far
+     * @return File size in bytes
+     */
+    uint64_t getBytesWritten() const {
+        return bytesWritten;
+    }
+
+private:
+    /**
+     * Writer thread: encode and write frames until stopped and drained
+     */
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (true) {
+            queueReady.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;  // Stopping and drained
+            }
+            std::unique_ptr<Frame> frame = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+
+            writeFrame(*frame);
+
+            lock.lock();
+            spareFrames.push_back(std::move(frame));
+        }
+        file.flush();
+    }
+
+    /**
+     * Write one record (writer thread)
+     * @param frame Captured frame; its words are swapped into previousWords
+     */
+    void writeFrame(Frame& frame) {
+        if (writeFailed) {
+            return;
+        }
+
+        const std::vector<uint8_t>* payload = &frame.checkpoint;
+        ReplayFormat::RecordHeader record;
+        record.type = frame.keyframe ? ReplayFormat::Keyframe : ReplayFormat::Delta;
+        record.bodyCount = frame.bodyCount;
+        record.tick = frame.tick;
+        if (!frame.keyframe) {
+            ReplayFormat::encodeDelta(frame.words.data(), previousWords.data(), frame.words.size(), encoded);
+            payload = &encoded;
+        }
+        record.payloadSize = payload->size();
+
+        static const char padding[8] = {};
+        uint64_t padded = ReplayFormat::paddedSize(record.payloadSize);
+        file.write((const char*)&record, sizeof(record));
+        file.write((const char*)payload->data(), (std::streamsize)payload->size());
+        file.write(padding, (std::streamsize)(padded - record.payloadSize));
+        if (!file) {
+            writeFailed = true;
+            return;
+        }
+
+        previousWords.swap(frame.words);
+        framesWritten++;
+        bytesWritten += sizeof(record) + padded;
+    }
+};
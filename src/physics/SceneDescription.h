@@ -0,0 +1,319 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "Vector3.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <cstdint>
+
+/**
+ * Starting state of a world, loaded from a small text format so batch runs
+ * can be described without code. One directive per line, '#' starts a comment:
+ *
+ *   bounds <minX> <maxX> <minY> <maxY> <minZ> <maxZ>
+ *   gravity <x> <y> <z>
+ *   seed <n>                              Seeds ball placement and collision jitter
+ *   broadphase <grid|brute>
+ *   contacts <colored|sequential>
+ *   solver <iterations> [warm|cold]
+ *   sleeping <on|off>
+ *   ccd <on|off>
+ *   threads <count|auto>
+ *   ball <x> <y> <z> [<vx> <vy> <vz>]     One ball
+ *   balls <count> <minX> <maxX> <minY> <maxY> <minZ> <maxZ> [speed]
+ *                                         Balls placed uniformly in a box, each
+ *                                         velocity component in [-speed, speed]
+ *
+ * Anything not mentioned keeps the PhysicsWorld default.
+ */
+class SceneDescription {
+public:
+    /**
+     * Balls scattered uniformly through a box (a single ball is a box of zero size)
+     */
+    struct BallGroup {
+        size_t count;                           // Number of balls
+        Vector3 min;                            // Minimum corner of the spawn box
+        Vector3 max;                            // Maximum corner of the spawn box
+        Vector3 velocity;                       // Base velocity of every ball
+        float speed;                            // Random velocity range per component
+    };
+
+    float bounds[6];                            // World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+    Vector3 gravity;                            // Gravity vector
+    uint64_t seed;                              // Seed for placement and jitter
+    BroadphaseMode broadphase;                  // Broadphase algorithm
+    ContactSolveMode contacts;                  // Contact solve mode
+    int solverIterations;                       // Contact solver iterations per step
+    bool warmStarting;                          // Reuse cached contact impulses
+    bool sleeping;                              // Let resting islands sleep
+    bool continuousCollision;                   // Sweep fast bodies
+    size_t threads;                             // Physics threads (0 = one per hardware thread)
+    std::vector<BallGroup> ballGroups;          // Balls to create, in file order
+
+    /**
+     * Constructor - describes an empty default world
+     */
+    SceneDescription()
+        : gravity(0, -9.81f, 0)
+        , seed(0x5EEDull)
+        , broadphase(BroadphaseMode::UniformGrid)
+        , contacts(ContactSolveMode::Colored)
+        , solverIterations(8)
+        , warmStarting(true)
+        , sleeping(true)
+        , continuousCollision(true)
+        , threads(0) {
+        const float defaultBounds[6] = { -15.0f, 15.0f, 0.0f, 10.0f, -15.0f, 15.0f };
+        for (int i = 0; i < 6; ++i) {
+            bounds[i] = defaultBounds[i];
+        }
+    }
+
+    /**
+     * Add a group of balls scattered through a box
+     * @param count Number of balls
+     * @param min Minimum corner of the spawn box
+     * @param max Maximum corner of the spawn box
+     * @param speed Random velocity range per component
+     */
+    void addBalls(size_t count, const Vector3& min, const Vector3& max, float speed) {
+        ballGroups.push_back(BallGroup{ count, min, max, Vector3(0, 0, 0), speed });
+    }
+
+    /**
+     * Get the total number of balls the scene creates
+     * @return Ball count
+     */
+    size_t getBallCount() const {
+        size_t total = 0;
+        for (const BallGroup& group : ballGroups) {
+            total += group.count;
+        }
+        return total;
+    }
+
+    /**
+     * Load a scene file
+     * @param path File to read
+     * @param error Receives a description of the first problem
+     * @return True if the whole file parsed
+     */
+    bool loadFile(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "Failed to open scene file: " + path;
+            return false;
+        }
+        return parse(file, error);
+    }
+
+    /**
+     * Parse scene directives from a stream
+     * @param input Stream of directives
+     * @param error Receives "line N: ..." for the first bad line
+     * @return True if every line parsed
+     */
+    bool parse(std::istream& input, std::string& error) {
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(input, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+
+            std::istringstream words(line);
+            std::string directive;
+            if (!(words >> directive)) {
+                continue;
+            }
+
+            std::string problem;
+            if (!parseDirective(directive, words, problem)) {
+                error = "line " + std::to_string(lineNumber) + ": " + problem;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Configure a world and create the scene's balls
+     * The world is cleared first. Ball placement is driven by seed, so the
+     * same description always produces the same starting state.
+     * @param world World to set up
+     */
+    void apply(PhysicsWorld& world) const {
+        world.clear();
+        world.setWorldBounds(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+        world.setGravity(gravity);
+        world.setRandomSeed(seed);
+        world.setBroadphaseMode(broadphase);
+        world.setContactSolveMode(contacts);
+        world.setSolverIterations(solverIterations);
+        world.setWarmStartingEnabled(warmStarting);
+        world.setSleepingEnabled(sleeping);
+        world.setContinuousCollisionEnabled(continuousCollision);
+        world.setThreadCount(threads);
+
+        std::mt19937 generator((unsigned int)(seed ^ (seed >> 32)));
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float> colorDistribution(0.3f, 1.0f);
+
+        for (const BallGroup& group : ballGroups) {
+            Vector3 extent = group.max - group.min;
+            world.createBalls(group.count, [&](size_t, PhysicsWorld::BallSpawn& spawn) {
+                spawn.position = Vector3(group.min.x + extent.x * unit(generator),
+                                         group.min.y + extent.y * unit(generator),
+                                         group.min.z + extent.z * unit(generator));
+                spawn.velocity = group.velocity + Vector3((unit(generator) * 2.0f - 1.0f) * group.speed,
+                                                          (unit(generator) * 2.0f - 1.0f) * group.speed,
+                                                          (unit(generator) * 2.0f - 1.0f) * group.speed);
+                spawn.color = Vector3(colorDistribution(generator), colorDistribution(generator),
+                                      colorDistribution(generator));
+            });
+        }
+    }
+
+private:
+    /**
+     * Parse one directive
+     * @param directive First word of the line
+     * @param words Rest of the line
+     * @param problem Receives the reason on failure
+     * @return True if the directive was understood
+     */
+    bool parseDirective(const std::string& directive, std::istringstream& words, std::string& problem) {
+        std::string word;
+
+        if (directive == "bounds") {
+            float values[6];
+            if (!readFloats(words, values, 6) || values[0] >= values[1] || values[2] >= values[3] ||
+                values[4] >= values[5]) {
+                problem = "bounds needs six values, each minimum below its maximum";
+                return false;
+            }
+            for (int i = 0; i < 6; ++i) {
+                bounds[i] = values[i];
+            }
+        } else if (directive == "gravity") {
+            float values[3];
+            if (!readFloats(words, values, 3)) {
+                problem = "gravity needs three values";
+                return false;
+            }
+            gravity = Vector3(values[0], values[1], values[2]);
+        } else if (directive == "seed") {
+            if (!(words >> seed)) {
+                problem = "seed needs a non-negative integer";
+                return false;
+            }
+        } else if (directive == "broadphase") {
+            words >> word;
+            if (word == "grid") {
+                broadphase = BroadphaseMode::UniformGrid;
+            } else if (word == "brute") {
+                broadphase = BroadphaseMode::BruteForce;
+            } else {
+                problem = "broadphase must be grid or brute";
+                return false;
+            }
+        } else if (directive == "contacts") {
+            words >> word;
+            if (word == "colored") {
+                contacts = ContactSolveMode::Colored;
+            } else if (word == "sequential") {
+                contacts = ContactSolveMode::Sequential;
+            } else {
+                problem = "contacts must be colored or sequential";
+                return false;
+            }
+        } else if (directive == "solver") {
+            if (!(words >> solverIterations) || solverIterations < 1) {
+                problem = "solver needs an iteration count of at least 1";
+                return false;
+            }
+            if (words >> word) {
+                if (word != "warm" && word != "cold") {
+                    problem = "solver start mode must be warm or cold";
+                    return false;
+                }
+                warmStarting = word == "warm";
+            }
+        } else if (directive == "sleeping" || directive == "ccd") {
+            words >> word;
+            if (word != "on" && word != "off") {
+                problem = directive + " must be on or off";
+                return false;
+            }
+            (directive == "sleeping" ? sleeping : continuousCollision) = word == "on";
+        } else if (directive == "threads") {
+            words >> word;
+            if (word == "auto") {
+                threads = 0;
+            } else {
+                std::istringstream count(word);
+                int value = 0;
+                if (!(count >> value) || value < 1 || value > 256) {
+                    problem = "threads must be auto or between 1 and 256";
+                    return false;
+                }
+                threads = (size_t)value;
+            }
+        } else if (directive == "ball") {
+            float values[6] = { 0, 0, 0, 0, 0, 0 };
+            if (!readFloats(words, values, 3)) {
+                problem = "ball needs a position";
+                return false;
+            }
+            if (hasMore(words) && !readFloats(words, values + 3, 3)) {
+                problem = "ball velocity needs three values";
+                return false;
+            }
+            Vector3 position(values[0], values[1], values[2]);
+            ballGroups.push_back(BallGroup{ 1, position, position, Vector3(values[3], values[4], values[5]), 0.0f });
+        } else if (directive == "balls") {
+            long long count = 0;
+            float box[6];
+            float speed = 0.0f;
+            if (!(words >> count) || count < 0 || !readFloats(words, box, 6)) {
+                problem = "balls needs a count and a spawn box";
+                return false;
+            }
+            if (hasMore(words) && !(words >> speed)) {
+                problem = "balls speed must be a number";
+                return false;
+            }
+            addBalls((size_t)count, Vector3(box[0], box[2], box[4]), Vector3(box[1], box[3], box[5]), speed);
+        } else {
+            problem = "unknown directive '" + directive + "'";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Check whether anything but whitespace is left on the line
+     */
+    static bool hasMore(std::istringstream& words) {
+        words >> std::ws;
+        return !words.eof();
+    }
+
+    /**
+     * Read a fixed number of floats
+     * @return False if any is missing or malformed
+     */
+    static bool readFloats(std::istringstream& words, float* values, int count) {
+        for (int i = 0; i < count; ++i) {
+            if (!(words >> values[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
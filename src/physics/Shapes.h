@@ -0,0 +1,497 @@
+#pragma once
+#include "Vector3.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Collision shape of a body, kept in the BodyStore shapes array
+ * Bodies have no orientation, so every shape is axis-aligned. A body's
+ * extents hold the shape's dimensions:
+ *
+ *   Sphere     (radius, radius, radius); the radius itself comes from radii
+ *   Box        half extents along x, y and z
+ *   Capsule    (radius, halfHeight + radius, radius), a vertical segment swept by a sphere
+ *   Plane      unit normal; the solid half-space lies behind the plane through the body's position
+ *
+ * For every shape but Plane the extents are the half size of the shape's
+ * bounding box. Values are part of the checkpoint format.
+ */
+enum class ShapeType : uint8_t {
+    Sphere = 0,
+    Box = 1,
+    Capsule = 2,
+    Plane = 3
+};
+
+/**
+ * Sphere around a center
+ */
+struct SphereShape {
+    Vector3 center;
+    float radius;
+};
+
+/**
+ * Axis-aligned box
+ */
+struct BoxShape {
+    Vector3 center;
+    Vector3 halfExtents;
+};
+
+/**
+ * Vertical capsule: the points within radius of the segment center +- (0, halfHeight, 0)
+ */
+struct CapsuleShape {
+    Vector3 center;
+    float halfHeight;
+    float radius;
+};
+
+/**
+ * Infinite plane bounding the half-space normal . p <= offset
+ */
+struct PlaneShape {
+    Vector3 normal;
+    float offset;
+};
+
+/**
+ * Result of a narrowphase test
+ */
+struct ContactPoint {
+    Vector3 normal;     // Unit normal pointing from the second shape toward the first
+    float depth;        // Overlap along the normal
+};
+
+/**
+ * Narrowphase kernel for one ordered pair of shape types
+ * Each specialization tests two shapes and, when they overlap, fills in the
+ * contact normal (from b toward a) and depth. Only pairs with the shape types
+ * in ShapeType order are written out; the primary template answers the
+ * swapped order by flipping the normal.
+ */
+template <typename ShapeA, typename ShapeB>
+struct Collide {
+    static bool test(const ShapeA& a, const ShapeB& b, ContactPoint& point) {
+        if (!Collide<ShapeB, ShapeA>::test(b, a, point)) {
+            return false;
+        }
+        point.normal = point.normal * -1.0f;
+        return true;
+    }
+};
+
+/**
+ * Test two shapes for overlap
+ * @param a First shape
+ * @param b Second shape
+ * @param point Receives the normal from b toward a and the depth on overlap
+ * @return True if the shapes overlap
+ */
+template <typename ShapeA, typename ShapeB>
+inline bool collide(const ShapeA& a, const ShapeB& b, ContactPoint& point) {
+    return Collide<ShapeA, ShapeB>::test(a, b, point);
+}
+
+/**
+ * Geometry helpers shared by the kernels
+ */
+class ShapeMath {
+public:
+    /**
+     * Read one component of a vector
+     * @param v Vector
+     * @param axis 0 = x, 1 = y, 2 = z
+     * @return Component
+     */
+    static float axisValue(const Vector3& v, int axis) {
+        return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+
+    /**
+     * Unit vector along an axis
+     * @param axis 0 = x, 1 = y, 2 = z
+     * @param sign 1 or -1
+     * @return Axis direction
+     */
+    static Vector3 axisNormal(int axis, float sign) {
+        return Vector3(axis == 0 ? sign : 0.0f, axis == 1 ? sign : 0.0f, axis == 2 ? sign : 0.0f);
+    }
+
+    /**
+     * Half-space test shared by every shape against a plane
+     * @param plane Plane
+     * @param center Shape center
+     * @param reach Extent of the shape toward the plane from its center
+     * @param point Receives the plane normal and the depth on overlap
+     * @return True if the shape reaches behind the plane
+     */
+    static bool againstPlane(const PlaneShape& plane, const Vector3& center, float reach, ContactPoint& point) {
+        float separation = plane.normal.dot(center) - plane.offset - reach;
+        if (separation >= 0.0f) {
+            return false;
+        }
+        point.normal = plane.normal;
+        point.depth = -separation;
+        return true;
+    }
+
+    /**
+     * Point of a capsule's segment closest to a height
+     * @param capsule Capsule
+     * @param y Height to approach
+     * @return Segment point
+     */
+    static Vector3 segmentPoint(const CapsuleShape& capsule, float y) {
+        float low = capsule.center.y - capsule.halfHeight;
+        float high = capsule.center.y + capsule.halfHeight;
+        return Vector3(capsule.center.x, std::min(std::max(y, low), high), capsule.center.z);
+    }
+};
+
+/**
+ * Sphere against sphere
+ */
+template <>
+struct Collide<SphereShape, SphereShape> {
+    static bool test(const SphereShape& a, const SphereShape& b, ContactPoint& point) {
+        Vector3 offset = a.center - b.center;
+        float distance = offset.magnitude();
+        float reach = a.radius + b.radius;
+        if (!(distance < reach)) {
+            return false;
+        }
+        point.normal = distance > 0.0f ? offset * (1.0f / distance) : Vector3(0, 1, 0);
+        point.depth = reach - distance;
+        return true;
+    }
+};
+
+/**
+ * Sphere against box: nearest point on the box, or the nearest face when the
+ * center is inside
+ */
+template <>
+struct Collide<SphereShape, BoxShape> {
+    static bool test(const SphereShape& a, const BoxShape& b, ContactPoint& point) {
+        Vector3 local = a.center - b.center;
+        const Vector3& half = b.halfExtents;
+        Vector3 closest(std::min(std::max(local.x, -half.x), half.x),
+                        std::min(std::max(local.y, -half.y), half.y),
+                        std::min(std::max(local.z, -half.z), half.z));
+        Vector3 offset = local - closest;
+        float distanceSquared = offset.magnitudeSquared();
+        if (distanceSquared > 0.0f) {
+            if (distanceSquared >= a.radius * a.radius) {
+                return false;
+            }
+            float distance = std::sqrt(distanceSquared);
+            point.normal = offset * (1.0f / distance);
+            point.depth = a.radius - distance;
+            return true;
+        }
+
+        // Center inside the box: leave through the closest face
+        int axis = 0;
+        float gap = half.x - std::fabs(local.x);
+        for (int k = 1; k < 3; ++k) {
+            float faceGap = ShapeMath::axisValue(half, k) - std::fabs(ShapeMath::axisValue(local, k));
+            if (faceGap < gap) {
+                gap = faceGap;
+                axis = k;
+            }
+        }
+        point.normal = ShapeMath::axisNormal(axis, ShapeMath::axisValue(local, axis) < 0.0f ? -1.0f : 1.0f);
+        point.depth = gap + a.radius;
+        return true;
+    }
+};
+
+/**
+ * Sphere against capsule: sphere against the nearest sphere on the segment
+ */
+template <>
+struct Collide<SphereShape, CapsuleShape> {
+    static bool test(const SphereShape& a, const CapsuleShape& b, ContactPoint& point) {
+        SphereShape nearest = { ShapeMath::segmentPoint(b, a.center.y), b.radius };
+        return collide(a, nearest, point);
+    }
+};
+
+/**
+ * Sphere against plane
+ */
+template <>
+struct Collide<SphereShape, PlaneShape> {
+    static bool test(const SphereShape& a, const PlaneShape& b, ContactPoint& point) {
+        return ShapeMath::againstPlane(b, a.center, a.radius, point);
+    }
+};
+
+/**
+ * Box against box: separating axis test over the three world axes
+ */
+template <>
+struct Collide<BoxShape, BoxShape> {
+    static bool test(const BoxShape& a, const BoxShape& b, ContactPoint& point) {
+        Vector3 offset = a.center - b.center;
+        Vector3 reach = a.halfExtents + b.halfExtents;
+        int axis = -1;
+        float depth = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            float overlap = ShapeMath::axisValue(reach, k) - std::fabs(ShapeMath::axisValue(offset, k));
+            if (overlap <= 0.0f) {
+                return false;
+            }
+            if (axis < 0 || overlap < depth) {
+                axis = k;
+                depth = overlap;
+            }
+        }
+        point.normal = ShapeMath::axisNormal(axis, ShapeMath::axisValue(offset, axis) < 0.0f ? -1.0f : 1.0f);
+        point.depth = depth;
+        return true;
+    }
+};
+
+/**
+ * Box against capsule: the segment is vertical, so the sphere on it nearest
+ * the box sits at the box center's height clamped to the segment
+ */
+template <>
+struct Collide<BoxShape, CapsuleShape> {
+    static bool test(const BoxShape& a, const CapsuleShape& b, ContactPoint& point) {
+        SphereShape nearest = { ShapeMath::segmentPoint(b, a.center.y), b.radius };
+        return collide(a, nearest, point);
+    }
+};
+
+/**
+ * Box against plane: the corner deepest behind the plane
+ */
+template <>
+struct Collide<BoxShape, PlaneShape> {
+    static bool test(const BoxShape& a, const PlaneShape& b, ContactPoint& point) {
+        const Vector3& n = b.normal;
+        float reach = std::fabs(n.x) * a.halfExtents.x + std::fabs(n.y) * a.halfExtents.y +
+                      std::fabs(n.z) * a.halfExtents.z;
+        return ShapeMath::againstPlane(b, a.center, reach, point);
+    }
+};
+
+/**
+ * Capsule against capsule: both segments are vertical, so the closest points
+ * share a height where the segments overlap and are the facing ends otherwise
+ */
+template <>
+struct Collide<CapsuleShape, CapsuleShape> {
+    static bool test(const CapsuleShape& a, const CapsuleShape& b, ContactPoint& point) {
+        float low = std::max(a.center.y - a.halfHeight, b.center.y - b.halfHeight);
+        float high = std::min(a.center.y + a.halfHeight, b.center.y + b.halfHeight);
+        float y = low <= high ? 0.5f * (low + high) : (a.center.y > b.center.y ? low : high);
+        SphereShape nearestA = { ShapeMath::segmentPoint(a, y), a.radius };
+        SphereShape nearestB = { ShapeMath::segmentPoint(b, y), b.radius };
+        return collide(nearestA, nearestB, point);
+    }
+};
+
+/**
+ * Capsule against plane: the segment end deepest behind the plane
+ */
+template <>
+struct Collide<CapsuleShape, PlaneShape> {
+    static bool test(const CapsuleShape& a, const PlaneShape& b, ContactPoint& point) {
+        return ShapeMath::againstPlane(b, a.center, std::fabs(b.normal.y) * a.halfHeight + a.radius, point);
+    }
+};
+
+/**
+ * Planes are static and infinite; they never collide with each other
+ */
+template <>
+struct Collide<PlaneShape, PlaneShape> {
+    static bool test(const PlaneShape&, const PlaneShape&, ContactPoint&) {
+        return false;
+    }
+};
+
+/**
+ * Result of a ray test
+ */
+struct RayContact {
+    float distance;     // Distance along the ray to the hit
+    Vector3 normal;     // Unit surface normal at the hit
+};
+
+/**
+ * Ray kernel for one shape type
+ * Each specialization intersects a ray (unit direction) with a shape and
+ * reports the first hit within maxDistance. A ray starting inside a shape
+ * hits it at distance 0 with the normal facing back along the ray.
+ */
+template <typename Shape>
+struct RayCast;
+
+/**
+ * Intersect a ray with a shape
+ * @param start Ray origin
+ * @param direction Unit ray direction
+ * @param maxDistance Length of the ray
+ * @param shape Shape to test
+ * @param hit Receives the distance and normal of the first hit
+ * @return True if the ray hits the shape within maxDistance
+ */
+template <typename Shape>
+inline bool raycast(const Vector3& start, const Vector3& direction, float maxDistance, const Shape& shape,
+                    RayContact& hit) {
+    return RayCast<Shape>::test(start, direction, maxDistance, shape, hit);
+}
+
+/**
+ * Ray against sphere
+ */
+template <>
+struct RayCast<SphereShape> {
+    static bool test(const Vector3& start, const Vector3& direction, float maxDistance, const SphereShape& shape,
+                     RayContact& hit) {
+        Vector3 offset = start - shape.center;
+        float b = offset.dot(direction);
+        float c = offset.magnitudeSquared() - shape.radius * shape.radius;
+        if (c <= 0.0f) {
+            hit.distance = 0.0f;
+            hit.normal = direction * -1.0f;
+            return true;
+        }
+        float discriminant = b * b - c;
+        if (b > 0.0f || discriminant < 0.0f) {
+            return false;
+        }
+        float t = -b - std::sqrt(discriminant);
+        if (t > maxDistance) {
+            return false;
+        }
+        hit.distance = t;
+        hit.normal = (offset + direction * t) * (1.0f / shape.radius);
+        return true;
+    }
+};
+
+/**
+ * Ray against box: slab test over the three world axes
+ */
+template <>
+struct RayCast<BoxShape> {
+    static bool test(const Vector3& start, const Vector3& direction, float maxDistance, const BoxShape& shape,
+                     RayContact& hit) {
+        float enter = 0.0f;
+        float exit = maxDistance;
+        int enterAxis = -1;
+        float enterSign = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            float from = ShapeMath::axisValue(start, k) - ShapeMath::axisValue(shape.center, k);
+            float half = ShapeMath::axisValue(shape.halfExtents, k);
+            float dir = ShapeMath::axisValue(direction, k);
+            if (std::fabs(dir) < 1e-12f) {
+                if (std::fabs(from) > half) {
+                    return false;
+                }
+                continue;
+            }
+            // Entering through the face that looks back toward the ray
+            float near = (dir > 0.0f ? -half : half) - from;
+            float far = (dir > 0.0f ? half : -half) - from;
+            float t0 = near / dir;
+            float t1 = far / dir;
+            if (t0 > enter) {
+                enter = t0;
+                enterAxis = k;
+                enterSign = dir > 0.0f ? -1.0f : 1.0f;
+            }
+            exit = std::min(exit, t1);
+            if (enter > exit) {
+                return false;
+            }
+        }
+        hit.distance = enter;
+        hit.normal = enterAxis < 0 ? direction * -1.0f : ShapeMath::axisNormal(enterAxis, enterSign);
+        return true;
+    }
+};
+
+/**
+ * Ray against capsule: the side of the vertical cylinder, then the two end spheres
+ */
+template <>
+struct RayCast<CapsuleShape> {
+    static bool test(const Vector3& start, const Vector3& direction, float maxDistance, const CapsuleShape& shape,
+                     RayContact& hit) {
+        float low = shape.center.y - shape.halfHeight;
+        float high = shape.center.y + shape.halfHeight;
+        bool found = false;
+
+        float ox = start.x - shape.center.x;
+        float oz = start.z - shape.center.z;
+        float a = direction.x * direction.x + direction.z * direction.z;
+        float b = ox * direction.x + oz * direction.z;
+        float c = ox * ox + oz * oz - shape.radius * shape.radius;
+        if (c <= 0.0f && start.y >= low && start.y <= high) {
+            hit.distance = 0.0f;
+            hit.normal = direction * -1.0f;
+            return true;
+        }
+        if (a > 1e-12f && c > 0.0f && b < 0.0f) {
+            float discriminant = b * b - a * c;
+            if (discriminant >= 0.0f) {
+                float t = (-b - std::sqrt(discriminant)) / a;
+                float y = start.y + direction.y * t;
+                if (t <= maxDistance && y >= low && y <= high) {
+                    hit.distance = t;
+                    hit.normal = Vector3(ox + direction.x * t, 0.0f, oz + direction.z * t) * (1.0f / shape.radius);
+                    found = true;
+                }
+            }
+        }
+
+        float ends[2] = { low, high };
+        for (float y : ends) {
+            SphereShape end = { Vector3(shape.center.x, y, shape.center.z), shape.radius };
+            RayContact endHit;
+            if (raycast(start, direction, found ? hit.distance : maxDistance, end, endHit) &&
+                (!found || endHit.distance < hit.distance)) {
+                hit = endHit;
+                found = true;
+            }
+        }
+        return found;
+    }
+};
+
+/**
+ * Ray against plane: the solid half-space behind it
+ */
+template <>
+struct RayCast<PlaneShape> {
+    static bool test(const Vector3& start, const Vector3& direction, float maxDistance, const PlaneShape& shape,
+                     RayContact& hit) {
+        float height = shape.normal.dot(start) - shape.offset;
+        if (height <= 0.0f) {
+            hit.distance = 0.0f;
+            hit.normal = direction * -1.0f;
+            return true;
+        }
+        float approach = shape.normal.dot(direction);
+        if (approach >= 0.0f) {
+            return false;
+        }
+        float t = -height / approach;
+        if (t > maxDistance) {
+            return false;
+        }
+        hit.distance = t;
+        hit.normal = shape.normal;
+        return true;
+    }
+};
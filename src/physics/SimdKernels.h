@@ -0,0 +1,827 @@
+#pragma once
+#include "Vector3.h"
+#include "VectorMath.h"
+#include "BodyStore.h"
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+// AVX2 kernels are compiled per function so the rest of the build keeps its baseline ISA
+#if defined(PHYSICS_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PHYSICS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PHYSICS_TARGET_AVX2
+#endif
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "SIMD kernels treat Vector3 arrays as packed xyz floats");
+
+/**
+ * Instruction sets available to the batched physics kernels
+ */
+enum class SimdLevel {
+    Scalar,     // Portable reference loop
+    SSE2,       // 4 bodies per iteration on x86
+    AVX2,       // 8 bodies per iteration on x86 with AVX2
+    NEON        // 4 bodies per iteration on ARM
+};
+
+/**
+ * Raw views of the store arrays consumed by the kernels
+ */
+struct BodyArrays {
+    Vector3* positions;
+    Vector3* velocities;
+    Vector3* forces;
+    const float* inverseMasses;
+    const float* radii;
+    const Vector3* extents;
+    const float* restitutions;
+    const float* frictions;
+    const float* spinDampings;
+    const uint8_t* flags;
+    size_t count;
+
+    /**
+     * Constructor - views every array of a body store
+     * @param store Store to view
+     */
+    explicit BodyArrays(BodyStore& store)
+        : positions(store.positions.data())
+        , velocities(store.velocities.data())
+        , forces(store.forces.data())
+        , inverseMasses(store.inverseMasses.data())
+        , radii(store.radii.data())
+        , extents(store.extents.data())
+        , restitutions(store.restitutions.data())
+        , frictions(store.frictions.data())
+        , spinDampings(store.spinDampings.data())
+        , flags(store.flags.data())
+        , count(store.size()) {}
+};
+
+/**
+ * Batched integration and world boundary kernels with runtime CPU dispatch
+ * Every SIMD path performs the same float operations in the same order as
+ * the scalar loop, so results match it bit for bit when the compiler does
+ * not contract multiply-adds into FMA instructions
+ */
+class SimdKernels {
+public:
+    /**
+     * Integration parameters shared by every body
+     */
+    struct IntegrationParams {
+        float deltaTime;        // Time step in seconds
+        Vector3 gravity;        // Gravity acceleration
+        float airResistance;    // Per-step velocity drag factor
+    };
+
+    /**
+     * Detect the best instruction set supported by this CPU
+     * @return Highest usable SIMD level
+     */
+    static SimdLevel detectSimdLevel() {
+#if defined(PHYSICS_SIMD_X86)
+        if (cpuSupportsAvx2()) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::SSE2;
+#elif defined(PHYSICS_SIMD_NEON)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    /**
+     * Check whether a SIMD level can run on this CPU
+     * @param level Level to check
+     * @return True if the level is compiled in and supported
+     */
+    static bool isSupported(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::Scalar:
+                return true;
+#if defined(PHYSICS_SIMD_X86)
+            case SimdLevel::SSE2:
+                return true;
+            case SimdLevel::AVX2:
+                return cpuSupportsAvx2();
+#elif defined(PHYSICS_SIMD_NEON)
+            case SimdLevel::NEON:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * Get a printable name for a SIMD level
+     * @param level SIMD level
+     * @return Lower-case name
+     */
+    static const char* getName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SSE2: return "sse2";
+            case SimdLevel::AVX2: return "avx2";
+            case SimdLevel::NEON: return "neon";
+            default: return "scalar";
+        }
+    }
+
+    /**
+     * Integrate bodies [begin, end) with the given instruction set
+     * Euler step, air resistance, spin damping and the ball floor clamp
+     * @param level SIMD level (must be supported)
+     * @param bodies Body arrays
+     * @param begin First body index
+     * @param end One past the last body index
+     * @param params Integration parameters
+     */
+    static void integrate(SimdLevel level, const BodyArrays& bodies, size_t begin, size_t end,
+                          const IntegrationParams& params) {
+        switch (level) {
+#if defined(PHYSICS_SIMD_X86)
+            case SimdLevel::AVX2:
+                begin = integrateAvx2(bodies, begin, end, params);
+                break;
+            case SimdLevel::SSE2:
+                begin = integrateSse2(bodies, begin, end, params);
+                break;
+#elif defined(PHYSICS_SIMD_NEON)
+            case SimdLevel::NEON:
+                begin = integrateNeon(bodies, begin, end, params);
+                break;
+#endif
+            default:
+                break;
+        }
+        integrateScalar(bodies, begin, end, params);
+    }
+
+    /**
+     * Clamp and reflect bodies [begin, end) against the six world planes
+     * @param level SIMD level (must be supported)
+     * @param bodies Body arrays
+     * @param begin First body index
+     * @param end One past the last body index
+     * @param bounds World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+     */
+    static void boundaries(SimdLevel level, const BodyArrays& bodies, size_t begin, size_t end,
+                           const float* bounds) {
+        size_t first = begin;
+        switch (level) {
+#if defined(PHYSICS_SIMD_X86)
+            case SimdLevel::AVX2:
+                begin = boundariesAvx2(bodies, begin, end, bounds);
+                break;
+            case SimdLevel::SSE2:
+                begin = boundariesSse2(bodies, begin, end, bounds);
+                break;
+#elif defined(PHYSICS_SIMD_NEON)
+            case SimdLevel::NEON:
+                begin = boundariesNeon(bodies, begin, end, bounds);
+                break;
+#endif
+            default:
+                break;
+        }
+        // The vector loops clamp spheres only; shaped bodies in their range are clamped here
+        if (begin > first) {
+            boundariesShaped(bodies, first, begin, bounds);
+        }
+        boundariesScalar(bodies, begin, end, bounds);
+    }
+
+    /**
+     * Scalar reference integration loop
+     */
+    static void integrateScalar(const BodyArrays& bodies, size_t begin, size_t end,
+                                const IntegrationParams& params) {
+        Vector3* positions = bodies.positions;
+        Vector3* velocities = bodies.velocities;
+        Vector3* forces = bodies.forces;
+
+        for (size_t i = begin; i < end; ++i) {
+            if ((bodies.flags[i] & (BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_SLEEPING)) != BODY_ACTIVE) {
+                continue;
+            }
+
+            Vector3 acceleration = forces[i] * bodies.inverseMasses[i] + params.gravity;
+            velocities[i] += acceleration * params.deltaTime;
+            velocities[i] *= params.airResistance;
+            positions[i] += velocities[i] * params.deltaTime;
+            forces[i] = Vector3::ZERO;
+
+            // Ball-specific spin damping (1.0 for plain bodies)
+            velocities[i] *= bodies.spinDampings[i];
+
+            // Keep balls above the floor plane
+            if ((bodies.flags[i] & BODY_BALL) && positions[i].y < bodies.radii[i]) {
+                positions[i].y = bodies.radii[i];
+                if (velocities[i].y < 0) {
+                    velocities[i].y = -velocities[i].y * bodies.restitutions[i];
+                }
+            }
+        }
+    }
+
+    /**
+     * Scalar reference world boundary loop
+     * Spheres are clamped by their radius, shaped bodies by their extents
+     */
+    static void boundariesScalar(const BodyArrays& bodies, size_t begin, size_t end, const float* bounds) {
+        for (size_t i = begin; i < end; ++i) {
+            // Skip static and sleeping bodies
+            if (bodies.flags[i] & (BODY_STATIC | BODY_SLEEPING)) {
+                continue;
+            }
+            float radius = bodies.radii[i];
+            Vector3 half = (bodies.flags[i] & BODY_SHAPED) ? bodies.extents[i] : Vector3(radius, radius, radius);
+            clampToBounds(bodies, i, half, bounds);
+        }
+    }
+
+    /**
+     * World boundary loop for the shaped bodies among [begin, end)
+     */
+    static void boundariesShaped(const BodyArrays& bodies, size_t begin, size_t end, const float* bounds) {
+        for (size_t i = begin; i < end; ++i) {
+            if ((bodies.flags[i] & (BODY_STATIC | BODY_SLEEPING | BODY_SHAPED)) == BODY_SHAPED) {
+                clampToBounds(bodies, i, bodies.extents[i], bounds);
+            }
+        }
+    }
+
+private:
+    /**
+     * Clamp and reflect one body whose bounding box has the given half size
+     */
+    static void clampToBounds(const BodyArrays& bodies, size_t i, const Vector3& half, const float* bounds) {
+        Vector3& position = bodies.positions[i];
+        Vector3& velocity = bodies.velocities[i];
+        float restitution = bodies.restitutions[i];
+        bool collided = false;
+
+        // Check X boundaries (left/right walls)
+        if (position.x - half.x < bounds[0]) {
+            position.x = bounds[0] + half.x;
+            if (velocity.x < 0) {
+                velocity.x = -velocity.x * restitution;
+                collided = true;
+            }
+        } else if (position.x + half.x > bounds[1]) {
+            position.x = bounds[1] - half.x;
+            if (velocity.x > 0) {
+                velocity.x = -velocity.x * restitution;
+                collided = true;
+            }
+        }
+
+        // Check Y boundaries (floor/ceiling)
+        if (position.y - half.y < bounds[2]) {
+            position.y = bounds[2] + half.y;
+            if (velocity.y < 0) {
+                velocity.y = -velocity.y * restitution;
+                collided = true;
+            }
+        } else if (position.y + half.y > bounds[3]) {
+            position.y = bounds[3] - half.y;
+            if (velocity.y > 0) {
+                velocity.y = -velocity.y * restitution;
+                collided = true;
+            }
+        }
+
+        // Check Z boundaries (front/back walls)
+        if (position.z - half.z < bounds[4]) {
+            position.z = bounds[4] + half.z;
+            if (velocity.z < 0) {
+                velocity.z = -velocity.z * restitution;
+                collided = true;
+            }
+        } else if (position.z + half.z > bounds[5]) {
+            position.z = bounds[5] - half.z;
+            if (velocity.z > 0) {
+                velocity.z = -velocity.z * restitution;
+                collided = true;
+            }
+        }
+
+        // Apply friction for ground contact
+        if (position.y <= bounds[2] + half.y + 0.1f && collided) {
+            velocity.x *= (1.0f - bodies.frictions[i]);
+            velocity.z *= (1.0f - bodies.frictions[i]);
+        }
+    }
+
+#if defined(PHYSICS_SIMD_X86)
+    /**
+     * Check CPU and OS support for AVX2
+     * @return True if AVX2 kernels can run
+     */
+    static bool cpuSupportsAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Vector of four bodies with components split into x, y and z registers
+     */
+    struct Soa4 {
+        __m128 x, y, z;
+    };
+
+    /**
+     * Load four packed Vector3 values and transpose them to x/y/z registers
+     */
+    static Soa4 load4(const Vector3* v) {
+        const float* f = &v->x;
+        __m128 a = _mm_loadu_ps(f);         // x0 y0 z0 x1
+        __m128 b = _mm_loadu_ps(f + 4);     // y1 z1 x2 y2
+        __m128 c = _mm_loadu_ps(f + 8);     // z2 x3 y3 z3
+
+        Soa4 r;
+        r.x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        r.y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                             _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        r.z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                             _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        return r;
+    }
+
+    /**
+     * Transpose x/y/z registers back and store four packed Vector3 values
+     */
+    static void store4(Vector3* v, const Soa4& s) {
+        float* f = &v->x;
+        __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(s.x, s.y, _MM_SHUFFLE(0, 0, 0, 0)),
+                                  _mm_shuffle_ps(s.z, s.x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(s.y, s.z, _MM_SHUFFLE(1, 1, 1, 1)),
+                                  _mm_shuffle_ps(s.x, s.y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(s.z, s.x, _MM_SHUFFLE(3, 3, 2, 2)),
+                                  _mm_shuffle_ps(s.y, s.z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        _mm_storeu_ps(f, a);
+        _mm_storeu_ps(f + 4, b);
+        _mm_storeu_ps(f + 8, c);
+    }
+
+    /**
+     * Widen four body flag bytes to 32-bit lanes
+     */
+    static __m128i loadFlags4(const uint8_t* flags) {
+        int32_t packed;
+        std::memcpy(&packed, flags, sizeof(packed));
+        __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+    }
+
+    static __m128 select4(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    static size_t integrateSse2(const BodyArrays& bodies, size_t begin, size_t end,
+                                const IntegrationParams& params) {
+        const __m128 dt = _mm_set1_ps(params.deltaTime);
+        const __m128 drag = _mm_set1_ps(params.airResistance);
+        const __m128 gx = _mm_set1_ps(params.gravity.x);
+        const __m128 gy = _mm_set1_ps(params.gravity.y);
+        const __m128 gz = _mm_set1_ps(params.gravity.z);
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128i stateMask = _mm_set1_epi32(BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_SLEEPING);
+        const __m128i activeBit = _mm_set1_epi32(BODY_ACTIVE);
+        const __m128i ballBit = _mm_set1_epi32(BODY_BALL);
+
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m128i flags = loadFlags4(bodies.flags + i);
+            __m128 moving = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, stateMask), activeBit));
+            if (_mm_movemask_ps(moving) == 0) {
+                continue;
+            }
+            __m128 ball = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, ballBit), ballBit));
+
+            Soa4 p = load4(bodies.positions + i);
+            Soa4 v = load4(bodies.velocities + i);
+            Soa4 f = load4(bodies.forces + i);
+            __m128 inverseMass = _mm_loadu_ps(bodies.inverseMasses + i);
+            __m128 spin = _mm_loadu_ps(bodies.spinDampings + i);
+            __m128 radius = _mm_loadu_ps(bodies.radii + i);
+            __m128 restitution = _mm_loadu_ps(bodies.restitutions + i);
+
+            Soa4 nv, np;
+            nv.x = _mm_mul_ps(_mm_add_ps(v.x, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(f.x, inverseMass), gx), dt)), drag);
+            nv.y = _mm_mul_ps(_mm_add_ps(v.y, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(f.y, inverseMass), gy), dt)), drag);
+            nv.z = _mm_mul_ps(_mm_add_ps(v.z, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(f.z, inverseMass), gz), dt)), drag);
+            np.x = _mm_add_ps(p.x, _mm_mul_ps(nv.x, dt));
+            np.y = _mm_add_ps(p.y, _mm_mul_ps(nv.y, dt));
+            np.z = _mm_add_ps(p.z, _mm_mul_ps(nv.z, dt));
+            nv.x = _mm_mul_ps(nv.x, spin);
+            nv.y = _mm_mul_ps(nv.y, spin);
+            nv.z = _mm_mul_ps(nv.z, spin);
+
+            // Floor clamp for balls
+            __m128 below = _mm_and_ps(ball, _mm_cmplt_ps(np.y, radius));
+            np.y = select4(below, radius, np.y);
+            __m128 bounce = _mm_and_ps(below, _mm_cmplt_ps(nv.y, zero));
+            nv.y = select4(bounce, _mm_mul_ps(_mm_xor_ps(nv.y, signBit), restitution), nv.y);
+
+            p.x = select4(moving, np.x, p.x);
+            p.y = select4(moving, np.y, p.y);
+            p.z = select4(moving, np.z, p.z);
+            v.x = select4(moving, nv.x, v.x);
+            v.y = select4(moving, nv.y, v.y);
+            v.z = select4(moving, nv.z, v.z);
+            f.x = _mm_andnot_ps(moving, f.x);
+            f.y = _mm_andnot_ps(moving, f.y);
+            f.z = _mm_andnot_ps(moving, f.z);
+
+            store4(bodies.positions + i, p);
+            store4(bodies.velocities + i, v);
+            store4(bodies.forces + i, f);
+        }
+        return i;
+    }
+
+    /**
+     * Clamp and reflect one axis of four bodies against a pair of planes
+     */
+    static void clampAxis4(__m128& p, __m128& v, __m128& collided, __m128 radius, __m128 restitution,
+                           float minBound, float maxBound) {
+        const __m128 lo = _mm_set1_ps(minBound);
+        const __m128 hi = _mm_set1_ps(maxBound);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 below = _mm_cmplt_ps(_mm_sub_ps(p, radius), lo);
+        __m128 above = _mm_andnot_ps(below, _mm_cmpgt_ps(_mm_add_ps(p, radius), hi));
+        p = select4(below, _mm_add_ps(lo, radius), p);
+        p = select4(above, _mm_sub_ps(hi, radius), p);
+
+        __m128 reflect = _mm_or_ps(_mm_and_ps(below, _mm_cmplt_ps(v, zero)),
+                                   _mm_and_ps(above, _mm_cmpgt_ps(v, zero)));
+        v = select4(reflect, _mm_mul_ps(_mm_xor_ps(v, _mm_set1_ps(-0.0f)), restitution), v);
+        collided = _mm_or_ps(collided, reflect);
+    }
+
+    static size_t boundariesSse2(const BodyArrays& bodies, size_t begin, size_t end, const float* bounds) {
+        const __m128i fixedBits = _mm_set1_epi32(BODY_STATIC | BODY_SLEEPING | BODY_SHAPED);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 groundBand = _mm_set1_ps(0.1f);
+        const __m128 floorY = _mm_set1_ps(bounds[2]);
+
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m128i flags = loadFlags4(bodies.flags + i);
+            __m128 dynamic = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, fixedBits), _mm_setzero_si128()));
+            if (_mm_movemask_ps(dynamic) == 0) {
+                continue;
+            }
+
+            Soa4 p = load4(bodies.positions + i);
+            Soa4 v = load4(bodies.velocities + i);
+            __m128 radius = _mm_loadu_ps(bodies.radii + i);
+            __m128 restitution = _mm_loadu_ps(bodies.restitutions + i);
+            __m128 friction = _mm_loadu_ps(bodies.frictions + i);
+
+            Soa4 np = p, nv = v;
+            __m128 collided = _mm_setzero_ps();
+            clampAxis4(np.x, nv.x, collided, radius, restitution, bounds[0], bounds[1]);
+            clampAxis4(np.y, nv.y, collided, radius, restitution, bounds[2], bounds[3]);
+            clampAxis4(np.z, nv.z, collided, radius, restitution, bounds[4], bounds[5]);
+
+            // Ground friction
+            __m128 grounded = _mm_and_ps(collided,
+                _mm_cmple_ps(np.y, _mm_add_ps(_mm_add_ps(floorY, radius), groundBand)));
+            __m128 keep = _mm_sub_ps(one, friction);
+            nv.x = select4(grounded, _mm_mul_ps(nv.x, keep), nv.x);
+            nv.z = select4(grounded, _mm_mul_ps(nv.z, keep), nv.z);
+
+            p.x = select4(dynamic, np.x, p.x);
+            p.y = select4(dynamic, np.y, p.y);
+            p.z = select4(dynamic, np.z, p.z);
+            v.x = select4(dynamic, nv.x, v.x);
+            v.y = select4(dynamic, nv.y, v.y);
+            v.z = select4(dynamic, nv.z, v.z);
+
+            store4(bodies.positions + i, p);
+            store4(bodies.velocities + i, v);
+        }
+        return i;
+    }
+
+    /**
+     * Vector of eight bodies with components split into x, y and z registers
+     */
+    struct Soa8 {
+        __m256 x, y, z;
+    };
+
+    PHYSICS_TARGET_AVX2 static __m256 combine8(__m128 lo, __m128 hi) {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+
+    PHYSICS_TARGET_AVX2 static Soa8 load8(const Vector3* v) {
+        Soa4 lo = load4(v);
+        Soa4 hi = load4(v + 4);
+        Soa8 r;
+        r.x = combine8(lo.x, hi.x);
+        r.y = combine8(lo.y, hi.y);
+        r.z = combine8(lo.z, hi.z);
+        return r;
+    }
+
+    PHYSICS_TARGET_AVX2 static void store8(Vector3* v, const Soa8& s) {
+        Soa4 lo, hi;
+        lo.x = _mm256_castps256_ps128(s.x);
+        lo.y = _mm256_castps256_ps128(s.y);
+        lo.z = _mm256_castps256_ps128(s.z);
+        hi.x = _mm256_extractf128_ps(s.x, 1);
+        hi.y = _mm256_extractf128_ps(s.y, 1);
+        hi.z = _mm256_extractf128_ps(s.z, 1);
+        store4(v, lo);
+        store4(v + 4, hi);
+    }
+
+    PHYSICS_TARGET_AVX2 static __m256i loadFlags8(const uint8_t* flags) {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(flags)));
+    }
+
+    PHYSICS_TARGET_AVX2 static size_t integrateAvx2(const BodyArrays& bodies, size_t begin, size_t end,
+                                                    const IntegrationParams& params) {
+        const __m256 dt = _mm256_set1_ps(params.deltaTime);
+        const __m256 drag = _mm256_set1_ps(params.airResistance);
+        const __m256 gx = _mm256_set1_ps(params.gravity.x);
+        const __m256 gy = _mm256_set1_ps(params.gravity.y);
+        const __m256 gz = _mm256_set1_ps(params.gravity.z);
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256i stateMask = _mm256_set1_epi32(BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_SLEEPING);
+        const __m256i activeBit = _mm256_set1_epi32(BODY_ACTIVE);
+        const __m256i ballBit = _mm256_set1_epi32(BODY_BALL);
+
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            __m256i flags = loadFlags8(bodies.flags + i);
+            __m256 moving = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(flags, stateMask), activeBit));
+            if (_mm256_movemask_ps(moving) == 0) {
+                continue;
+            }
+            __m256 ball = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(flags, ballBit), ballBit));
+
+            Soa8 p = load8(bodies.positions + i);
+            Soa8 v = load8(bodies.velocities + i);
+            Soa8 f = load8(bodies.forces + i);
+            __m256 inverseMass = _mm256_loadu_ps(bodies.inverseMasses + i);
+            __m256 spin = _mm256_loadu_ps(bodies.spinDampings + i);
+            __m256 radius = _mm256_loadu_ps(bodies.radii + i);
+            __m256 restitution = _mm256_loadu_ps(bodies.restitutions + i);
+
+            Soa8 nv, np;
+            nv.x = _mm256_mul_ps(_mm256_add_ps(v.x, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(f.x, inverseMass), gx), dt)), drag);
+            nv.y = _mm256_mul_ps(_mm256_add_ps(v.y, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(f.y, inverseMass), gy), dt)), drag);
+            nv.z = _mm256_mul_ps(_mm256_add_ps(v.z, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(f.z, inverseMass), gz), dt)), drag);
+            np.x = _mm256_add_ps(p.x, _mm256_mul_ps(nv.x, dt));
+            np.y = _mm256_add_ps(p.y, _mm256_mul_ps(nv.y, dt));
+            np.z = _mm256_add_ps(p.z, _mm256_mul_ps(nv.z, dt));
+            nv.x = _mm256_mul_ps(nv.x, spin);
+            nv.y = _mm256_mul_ps(nv.y, spin);
+            nv.z = _mm256_mul_ps(nv.z, spin);
+
+            // Floor clamp for balls
+            __m256 below = _mm256_and_ps(ball, _mm256_cmp_ps(np.y, radius, _CMP_LT_OQ));
+            np.y = _mm256_blendv_ps(np.y, radius, below);
+            __m256 bounce = _mm256_and_ps(below, _mm256_cmp_ps(nv.y, zero, _CMP_LT_OQ));
+            nv.y = _mm256_blendv_ps(nv.y, _mm256_mul_ps(_mm256_xor_ps(nv.y, signBit), restitution), bounce);
+
+            p.x = _mm256_blendv_ps(p.x, np.x, moving);
+            p.y = _mm256_blendv_ps(p.y, np.y, moving);
+            p.z = _mm256_blendv_ps(p.z, np.z, moving);
+            v.x = _mm256_blendv_ps(v.x, nv.x, moving);
+            v.y = _mm256_blendv_ps(v.y, nv.y, moving);
+            v.z = _mm256_blendv_ps(v.z, nv.z, moving);
+            f.x = _mm256_andnot_ps(moving, f.x);
+            f.y = _mm256_andnot_ps(moving, f.y);
+            f.z = _mm256_andnot_ps(moving, f.z);
+
+            store8(bodies.positions + i, p);
+            store8(bodies.velocities + i, v);
+            store8(bodies.forces + i, f);
+        }
+        return i;
+    }
+
+    PHYSICS_TARGET_AVX2 static void clampAxis8(__m256& p, __m256& v, __m256& collided, __m256 radius,
+                                               __m256 restitution, float minBound, float maxBound) {
+        const __m256 lo = _mm256_set1_ps(minBound);
+        const __m256 hi = _mm256_set1_ps(maxBound);
+        const __m256 zero = _mm256_setzero_ps();
+
+        __m256 below = _mm256_cmp_ps(_mm256_sub_ps(p, radius), lo, _CMP_LT_OQ);
+        __m256 above = _mm256_andnot_ps(below, _mm256_cmp_ps(_mm256_add_ps(p, radius), hi, _CMP_GT_OQ));
+        p = _mm256_blendv_ps(p, _mm256_add_ps(lo, radius), below);
+        p = _mm256_blendv_ps(p, _mm256_sub_ps(hi, radius), above);
+
+        __m256 reflect = _mm256_or_ps(_mm256_and_ps(below, _mm256_cmp_ps(v, zero, _CMP_LT_OQ)),
+                                      _mm256_and_ps(above, _mm256_cmp_ps(v, zero, _CMP_GT_OQ)));
+        v = _mm256_blendv_ps(v, _mm256_mul_ps(_mm256_xor_ps(v, _mm256_set1_ps(-0.0f)), restitution), reflect);
+        collided = _mm256_or_ps(collided, reflect);
+    }
+
+    PHYSICS_TARGET_AVX2 static size_t boundariesAvx2(const BodyArrays& bodies, size_t begin, size_t end,
+                                                     const float* bounds) {
+        const __m256i fixedBits = _mm256_set1_epi32(BODY_STATIC | BODY_SLEEPING | BODY_SHAPED);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 groundBand = _mm256_set1_ps(0.1f);
+        const __m256 floorY = _mm256_set1_ps(bounds[2]);
+
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            __m256i flags = loadFlags8(bodies.flags + i);
+            __m256 dynamic = _mm256_castsi256_ps(
+                _mm256_cmpeq_epi32(_mm256_and_si256(flags, fixedBits), _mm256_setzero_si256()));
+            if (_mm256_movemask_ps(dynamic) == 0) {
+                continue;
+            }
+
+            Soa8 p = load8(bodies.positions + i);
+            Soa8 v = load8(bodies.velocities + i);
+            __m256 radius = _mm256_loadu_ps(bodies.radii + i);
+            __m256 restitution = _mm256_loadu_ps(bodies.restitutions + i);
+            __m256 friction = _mm256_loadu_ps(bodies.frictions + i);
+
+            Soa8 np = p, nv = v;
+            __m256 collided = _mm256_setzero_ps();
+            clampAxis8(np.x, nv.x, collided, radius, restitution, bounds[0], bounds[1]);
+            clampAxis8(np.y, nv.y, collided, radius, restitution, bounds[2], bounds[3]);
+            clampAxis8(np.z, nv.z, collided, radius, restitution, bounds[4], bounds[5]);
+
+            // Ground friction
+            __m256 grounded = _mm256_and_ps(collided,
+                _mm256_cmp_ps(np.y, _mm256_add_ps(_mm256_add_ps(floorY, radius), groundBand), _CMP_LE_OQ));
+            __m256 keep = _mm256_sub_ps(one, friction);
+            nv.x = _mm256_blendv_ps(nv.x, _mm256_mul_ps(nv.x, keep), grounded);
+            nv.z = _mm256_blendv_ps(nv.z, _mm256_mul_ps(nv.z, keep), grounded);
+
+            p.x = _mm256_blendv_ps(p.x, np.x, dynamic);
+            p.y = _mm256_blendv_ps(p.y, np.y, dynamic);
+            p.z = _mm256_blendv_ps(p.z, np.z, dynamic);
+            v.x = _mm256_blendv_ps(v.x, nv.x, dynamic);
+            v.y = _mm256_blendv_ps(v.y, nv.y, dynamic);
+            v.z = _mm256_blendv_ps(v.z, nv.z, dynamic);
+
+            store8(bodies.positions + i, p);
+            store8(bodies.velocities + i, v);
+        }
+        return i;
+    }
+#endif
+
+#if defined(PHYSICS_SIMD_NEON)
+    static uint32x4_t loadFlagsNeon(const uint8_t* flags) {
+        uint8_t bytes[8] = { flags[0], flags[1], flags[2], flags[3], 0, 0, 0, 0 };
+        return vmovl_u16(vget_low_u16(vmovl_u8(vld1_u8(bytes))));
+    }
+
+    static bool anyLane(uint32x4_t mask) {
+        uint32x2_t folded = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+        return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+    }
+
+    static size_t integrateNeon(const BodyArrays& bodies, size_t begin, size_t end,
+                                const IntegrationParams& params) {
+        const float32x4_t dt = vdupq_n_f32(params.deltaTime);
+        const float32x4_t drag = vdupq_n_f32(params.airResistance);
+        const float32x4_t gx = vdupq_n_f32(params.gravity.x);
+        const float32x4_t gy = vdupq_n_f32(params.gravity.y);
+        const float32x4_t gz = vdupq_n_f32(params.gravity.z);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const uint32x4_t stateMask = vdupq_n_u32(BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_SLEEPING);
+        const uint32x4_t activeBit = vdupq_n_u32(BODY_ACTIVE);
+        const uint32x4_t ballBit = vdupq_n_u32(BODY_BALL);
+
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            uint32x4_t flags = loadFlagsNeon(bodies.flags + i);
+            uint32x4_t moving = vceqq_u32(vandq_u32(flags, stateMask), activeBit);
+            if (!anyLane(moving)) {
+                continue;
+            }
+            uint32x4_t ball = vceqq_u32(vandq_u32(flags, ballBit), ballBit);
+
+            float32x4x3_t p = vld3q_f32(&bodies.positions[i].x);
+            float32x4x3_t v = vld3q_f32(&bodies.velocities[i].x);
+            float32x4x3_t f = vld3q_f32(&bodies.forces[i].x);
+            float32x4_t inverseMass = vld1q_f32(bodies.inverseMasses + i);
+            float32x4_t spin = vld1q_f32(bodies.spinDampings + i);
+            float32x4_t radius = vld1q_f32(bodies.radii + i);
+            float32x4_t restitution = vld1q_f32(bodies.restitutions + i);
+            const float32x4_t gravity[3] = { gx, gy, gz };
+
+            float32x4x3_t np, nv;
+            for (int axis = 0; axis < 3; ++axis) {
+                float32x4_t acceleration = vaddq_f32(vmulq_f32(f.val[axis], inverseMass), gravity[axis]);
+                nv.val[axis] = vmulq_f32(vaddq_f32(v.val[axis], vmulq_f32(acceleration, dt)), drag);
+                np.val[axis] = vaddq_f32(p.val[axis], vmulq_f32(nv.val[axis], dt));
+                nv.val[axis] = vmulq_f32(nv.val[axis], spin);
+            }
+
+            // Floor clamp for balls
+            uint32x4_t below = vandq_u32(ball, vcltq_f32(np.val[1], radius));
+            np.val[1] = vbslq_f32(below, radius, np.val[1]);
+            uint32x4_t bounce = vandq_u32(below, vcltq_f32(nv.val[1], zero));
+            nv.val[1] = vbslq_f32(bounce, vmulq_f32(vnegq_f32(nv.val[1]), restitution), nv.val[1]);
+
+            for (int axis = 0; axis < 3; ++axis) {
+                p.val[axis] = vbslq_f32(moving, np.val[axis], p.val[axis]);
+                v.val[axis] = vbslq_f32(moving, nv.val[axis], v.val[axis]);
+                f.val[axis] = vbslq_f32(moving, zero, f.val[axis]);
+            }
+
+            vst3q_f32(&bodies.positions[i].x, p);
+            vst3q_f32(&bodies.velocities[i].x, v);
+            vst3q_f32(&bodies.forces[i].x, f);
+        }
+        return i;
+    }
+
+    static void clampAxisNeon(float32x4_t& p, float32x4_t& v, uint32x4_t& collided, float32x4_t radius,
+                              float32x4_t restitution, float minBound, float maxBound) {
+        const float32x4_t lo = vdupq_n_f32(minBound);
+        const float32x4_t hi = vdupq_n_f32(maxBound);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+
+        uint32x4_t below = vcltq_f32(vsubq_f32(p, radius), lo);
+        uint32x4_t above = vbicq_u32(vcgtq_f32(vaddq_f32(p, radius), hi), below);
+        p = vbslq_f32(below, vaddq_f32(lo, radius), p);
+        p = vbslq_f32(above, vsubq_f32(hi, radius), p);
+
+        uint32x4_t reflect = vorrq_u32(vandq_u32(below, vcltq_f32(v, zero)),
+                                       vandq_u32(above, vcgtq_f32(v, zero)));
+        v = vbslq_f32(reflect, vmulq_f32(vnegq_f32(v), restitution), v);
+        collided = vorrq_u32(collided, reflect);
+    }
+
+    static size_t boundariesNeon(const BodyArrays& bodies, size_t begin, size_t end, const float* bounds) {
+        const uint32x4_t fixedBits = vdupq_n_u32(BODY_STATIC | BODY_SLEEPING | BODY_SHAPED);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t groundBand = vdupq_n_f32(0.1f);
+        const float32x4_t floorY = vdupq_n_f32(bounds[2]);
+
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            uint32x4_t flags = loadFlagsNeon(bodies.flags + i);
+            uint32x4_t dynamic = vceqq_u32(vandq_u32(flags, fixedBits), vdupq_n_u32(0));
+            if (!anyLane(dynamic)) {
+                continue;
+            }
+
+            float32x4x3_t p = vld3q_f32(&bodies.positions[i].x);
+            float32x4x3_t v = vld3q_f32(&bodies.velocities[i].x);
+            float32x4_t radius = vld1q_f32(bodies.radii + i);
+            float32x4_t restitution = vld1q_f32(bodies.restitutions + i);
+            float32x4_t friction = vld1q_f32(bodies.frictions + i);
+
+            float32x4x3_t np = p, nv = v;
+            uint32x4_t collided = vdupq_n_u32(0);
+            clampAxisNeon(np.val[0], nv.val[0], collided, radius, restitution, bounds[0], bounds[1]);
+            clampAxisNeon(np.val[1], nv.val[1], collided, radius, restitution, bounds[2], bounds[3]);
+            clampAxisNeon(np.val[2], nv.val[2], collided, radius, restitution, bounds[4], bounds[5]);
+
+            // Ground friction
+            uint32x4_t grounded = vandq_u32(collided,
+                vcleq_f32(np.val[1], vaddq_f32(vaddq_f32(floorY, radius), groundBand)));
+            float32x4_t keep = vsubq_f32(one, friction);
+            nv.val[0] = vbslq_f32(grounded, vmulq_f32(nv.val[0], keep), nv.val[0]);
+            nv.val[2] = vbslq_f32(grounded, vmulq_f32(nv.val[2], keep), nv.val[2]);
+
+            for (int axis = 0; axis < 3; ++axis) {
+                p.val[axis] = vbslq_f32(dynamic, np.val[axis], p.val[axis]);
+                v.val[axis] = vbslq_f32(dynamic, nv.val[axis], v.val[axis]);
+            }
+
+            vst3q_f32(&bodies.positions[i].x, p);
+            vst3q_f32(&bodies.velocities[i].x, v);
+        }
+        return i;
+    }
+#endif
+};
@@ -0,0 +1,488 @@
+#pragma once
+#include "Vector3.h"
+#include "BodyStore.h"
+#include "Broadphase.h"
+#include "Narrowphase.h"
+#include "JobSystem.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+/**
+ * Selects which bodies a spatial query may report
+ * A body passes when it has every required flag and none of the excluded ones
+ */
+struct QueryFilter {
+    uint8_t requiredFlags = BODY_ACTIVE;    // BodyFlags a body must have
+    uint8_t excludedFlags = 0;              // BodyFlags a body must not have
+
+    /**
+     * Check a body's flags against the filter
+     * @param flags BodyFlags bit set
+     * @return True if the body passes
+     */
+    bool accepts(uint8_t flags) const {
+        return (flags & requiredFlags) == requiredFlags && !(flags & excludedFlags);
+    }
+};
+
+/**
+ * Ray for raycast queries
+ */
+struct Ray {
+    Vector3 origin;                         // Start point
+    Vector3 direction;                      // Direction (normalized by the query)
+    float maxDistance;                      // Length of the ray
+};
+
+/**
+ * First body hit by a ray
+ */
+struct RayHit {
+    BodyHandle body;                        // Body hit (invalid if the ray hit nothing)
+    float distance;                         // Distance from the ray origin
+    Vector3 point;                          // Hit point in world space
+    Vector3 normal;                         // Surface normal at the hit point
+
+    /**
+     * Check whether the ray hit anything
+     * @return True if body is valid
+     */
+    bool hit() const {
+        return body.isValid();
+    }
+};
+
+/**
+ * Bodies found by a batch of overlap or nearest queries
+ * The bodies of query q are bodies[offsets[q]] up to bodies[offsets[q + 1]].
+ */
+struct QueryResults {
+    std::vector<uint32_t> offsets;          // Start of each query's bodies (query count + 1 entries)
+    std::vector<BodyHandle> bodies;         // Bodies of every query, in query order
+
+    /**
+     * Get the number of queries in the batch
+     * @return Query count
+     */
+    size_t size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    /**
+     * Get the first body of a query
+     * @param query Query index
+     * @return Pointer to its first body
+     */
+    const BodyHandle* begin(size_t query) const {
+        return bodies.data() + offsets[query];
+    }
+
+    /**
+     * Get one past the last body of a query
+     * @param query Query index
+     * @return Pointer past its last body
+     */
+    const BodyHandle* end(size_t query) const {
+        return bodies.data() + offsets[query + 1];
+    }
+
+    /**
+     * Get the number of bodies a query found
+     * @param query Query index
+     * @return Body count
+     */
+    size_t count(size_t query) const {
+        return offsets[query + 1] - offsets[query];
+    }
+};
+
+/**
+ * Raycast, sphere overlap and k-nearest queries over a uniform grid
+ * The grid is built from body centers like the broadphase grid, with cells at
+ * least as wide as the largest diameter, so every body touching a cell has its
+ * center within the 3x3x3 block around it. Plane bodies are filed too but
+ * skipped there; being unbounded, they sit in a separate list tested by
+ * every query.
+ *
+ * The grid is either filed by build() or borrowed from the collision
+ * broadphase with attach(), which costs nothing when the step already built it.
+ *
+ * Queries read positions and shapes straight from the store, so they see the
+ * current state, but the cell lists only change on a build: a body moved
+ * after the build is still found while it stays near its old cell.
+ * An attached collision grid files bodies where they were before that step
+ * moved them, so a body that moved across cells during the step can be
+ * missed until the next step: overlap and raycast only look around the
+ * cells they touch, and nearest stops its ring search once no unsearched
+ * cell can beat its k-th candidate, which a body filed in a far ring but now
+ * close by can.
+ * Queries are const and may run concurrently once the grid is built; the
+ * batched variants fan out across a job system and write results in query
+ * order, so their output does not depend on the thread count.
+ */
+class SpatialQueries {
+private:
+    UniformGridBroadphase ownGrid;          // Cells filed by build()
+    const UniformGridBroadphase* grid;      // Grid the queries walk: ownGrid or one passed to attach()
+    std::vector<uint32_t> unbounded;        // Dense indices of Plane bodies, tested by every query
+    const BodyStore* store;                 // Store of the last build
+    bool hasGrid;                           // Some non-plane body was filed into the grid
+
+    /**
+     * Output and scratch space for one chunk of batched queries
+     */
+    struct QueryChunk {
+        std::vector<BodyHandle> bodies;                 // Bodies found by the chunk's queries, in order
+        std::vector<uint32_t> counts;                   // Bodies found by each query of the chunk
+        std::vector<std::pair<float, uint32_t>> heap;   // Scratch heap for nearest queries
+    };
+    std::vector<QueryChunk> chunks;         // Per-chunk buffers, reused across batches
+
+    static constexpr size_t queryChunkSize = 64;        // Queries per batch chunk
+
+public:
+    using Candidate = std::pair<float, uint32_t>;       // (squared distance, dense index)
+
+    /**
+     * Constructor - creates an empty query grid
+     */
+    SpatialQueries()
+        : grid(&ownGrid)
+        , store(nullptr)
+        , hasGrid(false) {
+    }
+
+    /**
+     * File every body of a store into the query grid
+     * @param bodies Store to query; must outlive the queries
+     * @param bounds World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+     */
+    void build(const BodyStore& bodies, const float* bounds) {
+        store = &bodies;
+        unbounded.clear();
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (bodies.shapes[i] == (uint8_t)ShapeType::Plane) {
+                unbounded.push_back((uint32_t)i);
+            }
+        }
+        hasGrid = bodies.size() > unbounded.size();
+        grid = &ownGrid;
+        if (hasGrid) {
+            ownGrid.buildCells(bodies.positions.data(), bodies.radii.data(), bodies.size(), bounds);
+        }
+    }
+
+    /**
+     * Query a grid that is already built over a store, such as the collision broadphase
+     * Nothing is filed, so this costs only the copy of the plane list
+     * @param bodies Store the grid was built over; must outlive the queries
+     * @param cells Grid built over every body of the store; must stay unchanged while queried
+     * @param planes Dense indices of every Plane-shaped body in the store
+     */
+    void attach(const BodyStore& bodies, const UniformGridBroadphase& cells, const std::vector<uint32_t>& planes) {
+        store = &bodies;
+        unbounded.assign(planes.begin(), planes.end());
+        hasGrid = bodies.size() > unbounded.size();
+        grid = &cells;
+    }
+
+    /**
+     * Find the first body a ray hits
+     * @param ray Ray to cast
+     * @param filter Bodies the ray may hit
+     * @param hit Receives the hit (hit.body is invalid on a miss)
+     * @return True if the ray hit a body
+     */
+    bool raycast(const Ray& ray, const QueryFilter& filter, RayHit& hit) const {
+        hit.body = BodyHandle();
+        float length = ray.direction.magnitude();
+        if (!store || !(length > 0.0f) || !(ray.maxDistance >= 0.0f)) {
+            return false;
+        }
+        Vector3 direction = ray.direction * (1.0f / length);
+        const BodyStore& bodies = *store;
+
+        uint32_t best = BodyHandle::invalidIndex;
+        RayContact bestContact;
+        bestContact.distance = ray.maxDistance;
+        auto test = [&](uint32_t body) {
+            RayContact contact;
+            if (filter.accepts(bodies.flags[body]) &&
+                Narrowphase::raycastBody(bodies, body, ray.origin, direction, bestContact.distance, contact) &&
+                (best == BodyHandle::invalidIndex || contact.distance < bestContact.distance ||
+                 (contact.distance == bestContact.distance && body < best))) {
+                best = body;
+                bestContact = contact;
+            }
+        };
+
+        for (uint32_t body : unbounded) {
+            test(body);
+        }
+        auto testBounded = [&](uint32_t body) {
+            if (bodies.shapes[body] != (uint8_t)ShapeType::Plane) {
+                test(body);
+            }
+        };
+        if (hasGrid) {
+            grid->forEachCellOnRay(ray.origin, direction, ray.maxDistance, [&](int x, int y, int z, float entry) {
+                // A hit inside this cell belongs to a body around it; later cells
+                // cannot beat a hit already closer than their entry point
+                if (best != BodyHandle::invalidIndex && entry > bestContact.distance) {
+                    return false;
+                }
+                grid->forEachAround(x, y, z, testBounded);
+                return true;
+            });
+        }
+
+        if (best == BodyHandle::invalidIndex) {
+            return false;
+        }
+        hit.body = bodies.handleAt(best);
+        hit.distance = bestContact.distance;
+        hit.point = ray.origin + direction * bestContact.distance;
+        hit.normal = bestContact.normal;
+        return true;
+    }
+
+    /**
+     * Find every body overlapping a sphere
+     * @param center Sphere center
+     * @param radius Sphere radius
+     * @param filter Bodies the query may report
+     * @param out Receives the bodies found, appended in grid order
+     * @return Number of bodies appended
+     */
+    size_t overlapSphere(const Vector3& center, float radius, const QueryFilter& filter,
+                         std::vector<BodyHandle>& out) const {
+        if (!store) {
+            return 0;
+        }
+        const BodyStore& bodies = *store;
+        SphereShape sphere = { center, radius };
+        size_t before = out.size();
+        auto test = [&](uint32_t body) {
+            ContactPoint point;
+            if (filter.accepts(bodies.flags[body]) && Narrowphase::sphereOverlapsBody(bodies, sphere, body, point)) {
+                out.push_back(bodies.handleAt(body));
+            }
+        };
+
+        for (uint32_t body : unbounded) {
+            test(body);
+        }
+        auto testBounded = [&](uint32_t body) {
+            if (bodies.shapes[body] != (uint8_t)ShapeType::Plane) {
+                test(body);
+            }
+        };
+        if (hasGrid) {
+            // Body centers lie at most half a cell from anything they touch
+            float reach = radius + 0.5f * grid->getCellSize();
+            Vector3 extent(reach, reach, reach);
+            grid->forEachInBox(center - extent, center + extent, testBounded);
+        }
+        return out.size() - before;
+    }
+
+    /**
+     * Find the bodies whose centers are nearest a point
+     * Plane bodies have no center and are never reported. Distances use
+     * current positions but rings follow the cells bodies were filed in, so
+     * on an attached grid a body that moved closer during the last step may
+     * be missed (see the class comment).
+     * @param point Query point
+     * @param k Largest number of bodies to report
+     * @param maxDistance Only bodies whose centers are closer than this are reported
+     * @param filter Bodies the query may report
+     * @param out Receives up to k bodies, appended nearest first
+     * @return Number of bodies appended
+     */
+    size_t nearest(const Vector3& point, size_t k, float maxDistance, const QueryFilter& filter,
+                   std::vector<BodyHandle>& out) const {
+        std::vector<Candidate> heap;
+        return nearest(point, k, maxDistance, filter, out, heap);
+    }
+
+    /**
+     * Find the bodies whose centers are nearest a point, with caller-owned scratch
+     * @param heap Scratch space for the candidate heap
+     */
+    size_t nearest(const Vector3& point, size_t k, float maxDistance, const QueryFilter& filter,
+                   std::vector<BodyHandle>& out, std::vector<Candidate>& heap) const {
+        heap.clear();
+        if (!store || !hasGrid || k == 0) {
+            return 0;
+        }
+        const BodyStore& bodies = *store;
+        float limit = maxDistance * maxDistance;
+
+        // Max-heap of the best k candidates; ties go to the lower dense index
+        auto offer = [&](uint32_t body) {
+            if (!filter.accepts(bodies.flags[body]) || bodies.shapes[body] == (uint8_t)ShapeType::Plane) {
+                return;
+            }
+            float distanceSquared = (bodies.positions[body] - point).magnitudeSquared();
+            if (!(distanceSquared < limit)) {
+                return;
+            }
+            Candidate candidate(distanceSquared, body);
+            if (heap.size() < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        };
+
+        // Search rings of cells outward until no unsearched cell can hold a
+        // center closer than the current k-th candidate
+        int cell[3];
+        grid->cellOf(point, cell);
+        float coords[3] = { point.x, point.y, point.z };
+        int maxRing = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            maxRing = std::max(maxRing, std::max(cell[axis], grid->getDim(axis) - 1 - cell[axis]));
+        }
+        float cellSize = grid->getCellSize();
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            grid->forEachInRing(cell[0], cell[1], cell[2], ring, offer);
+
+            // Distance from the point to the nearest face of the searched block
+            // that has cells beyond it
+            float gap = INFINITY;
+            for (int axis = 0; axis < 3; ++axis) {
+                if (cell[axis] - ring > 0) {
+                    float face = grid->getOrigin(axis) + (cell[axis] - ring) * cellSize;
+                    gap = std::min(gap, coords[axis] - face);
+                }
+                if (cell[axis] + ring < grid->getDim(axis) - 1) {
+                    float face = grid->getOrigin(axis) + (cell[axis] + ring + 1) * cellSize;
+                    gap = std::min(gap, face - coords[axis]);
+                }
+            }
+            if (gap == INFINITY) {
+                break;  // The whole grid has been searched
+            }
+            if (gap > 0.0f) {
+                float gapSquared = gap * gap;
+                if (!(gapSquared < limit) || (heap.size() == k && heap.front().first <= gapSquared)) {
+                    break;
+                }
+            }
+        }
+
+        std::sort_heap(heap.begin(), heap.end());
+        for (const Candidate& candidate : heap) {
+            out.push_back(bodies.handleAt(candidate.second));
+        }
+        return heap.size();
+    }
+
+    /**
+     * Cast a batch of rays
+     * @param rays Rays to cast
+     * @param count Number of rays
+     * @param filter Bodies the rays may hit
+     * @param hits Receives one hit per ray
+     * @param jobs Optional job system the rays are spread over
+     */
+    void raycastBatch(const Ray* rays, size_t count, const QueryFilter& filter, RayHit* hits,
+                      JobSystem* jobs = nullptr) const {
+        auto castRange = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                raycast(rays[i], filter, hits[i]);
+            }
+        };
+        if (jobs) {
+            jobs->parallelFor(count, queryChunkSize, castRange);
+        } else {
+            castRange(0, count);
+        }
+    }
+
+    /**
+     * Run a batch of sphere overlap queries
+     * @param centers Sphere centers
+     * @param radii Sphere radii
+     * @param count Number of queries
+     * @param filter Bodies the queries may report
+     * @param results Receives the bodies found by each query
+     * @param jobs Optional job system the queries are spread over
+     */
+    void overlapSphereBatch(const Vector3* centers, const float* radii, size_t count, const QueryFilter& filter,
+                            QueryResults& results, JobSystem* jobs = nullptr) {
+        runBatch(count, results, jobs, [&](size_t query, QueryChunk& chunk) {
+            return overlapSphere(centers[query], radii[query], filter, chunk.bodies);
+        });
+    }
+
+    /**
+     * Run a batch of k-nearest queries
+     * @param points Query points
+     * @param count Number of queries
+     * @param k Largest number of bodies to report per query
+     * @param maxDistance Only bodies whose centers are closer than this are reported
+     * @param filter Bodies the queries may report
+     * @param results Receives the bodies found by each query, nearest first
+     * @param jobs Optional job system the queries are spread over
+     */
+    void nearestBatch(const Vector3* points, size_t count, size_t k, float maxDistance, const QueryFilter& filter,
+                      QueryResults& results, JobSystem* jobs = nullptr) {
+        runBatch(count, results, jobs, [&](size_t query, QueryChunk& chunk) {
+            return nearest(points[query], k, maxDistance, filter, chunk.bodies, chunk.heap);
+        });
+    }
+
+private:
+    /**
+     * Run queries in fixed-size chunks (in parallel when a job system is
+     * given) and concatenate their output in chunk order
+     * @param count Number of queries
+     * @param results Receives every query's bodies
+     * @param jobs Optional job system
+     * @param query Runs one query into a chunk and returns the number of bodies it appended
+     */
+    template <typename Query>
+    void runBatch(size_t count, QueryResults& results, JobSystem* jobs, Query query) {
+        size_t chunkCount = (count + queryChunkSize - 1) / queryChunkSize;
+        if (chunks.size() < chunkCount) {
+            chunks.resize(chunkCount);
+        }
+
+        auto runChunks = [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                QueryChunk& chunk = chunks[c];
+                chunk.bodies.clear();
+                chunk.counts.clear();
+                size_t begin = c * queryChunkSize;
+                size_t end = std::min(begin + queryChunkSize, count);
+                for (size_t q = begin; q < end; ++q) {
+                    chunk.counts.push_back((uint32_t)query(q, chunk));
+                }
+            }
+        };
+        if (jobs) {
+            jobs->parallelFor(chunkCount, 1, runChunks);
+        } else {
+            runChunks(0, chunkCount);
+        }
+
+        results.offsets.assign(1, 0);
+        results.offsets.reserve(count + 1);
+        results.bodies.clear();
+        for (size_t c = 0; c < chunkCount; ++c) {
+            for (uint32_t found : chunks[c].counts) {
+                results.offsets.push_back(results.offsets.back() + found);
+            }
+            results.bodies.insert(results.bodies.end(), chunks[c].bodies.begin(), chunks[c].bodies.end());
+        }
+    }
+};
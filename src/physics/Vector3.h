@@ -25,10 +25,10 @@ public:
     Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
 
     /**
-     * Copy constructor
-     * @param other Vector to copy from
+     * Copy constructor and assignment (defaulted, so Vector3 is trivially copyable)
      */
-    Vector3(const Vector3& other) : x(other.x), y(other.y), z(other.z) {}
+    Vector3(const Vector3& other) = default;
+    Vector3& operator=(const Vector3& other) = default;
 
     /**
      * Vector addition operator
@@ -102,6 +102,18 @@ public:
         return *this;
     }
 
+    /**
+     * In-place scalar division operator
+     * @param scalar Scalar value to divide by
+     * @return Reference to this vector
+     */
+    Vector3& operator/=(float scalar) {
+        x /= scalar;
+        y /= scalar;
+        z /= scalar;
+        return *this;
+    }
+
     /**
      * Calculate dot product with another vector
      * @param other Vector to calculate dot product with
@@ -152,6 +164,20 @@ public:
         return Vector3(0, 0, 0);
     }
 
+    /**
+     * Normalize vector to unit length and report the length it had
+     * One square root instead of separate magnitude() and normalized() calls
+     * @param length Receives the magnitude
+     * @return New normalized vector (zero if the magnitude is 0.0001 or less)
+     */
+    Vector3 normalized(float& length) const {
+        length = magnitude();
+        if (length > 0.0001f) {
+            return *this / length;
+        }
+        return Vector3(0, 0, 0);
+    }
+
     /**
      * Normalize this vector in place
      */
@@ -0,0 +1,366 @@
+#pragma once
+#include "Vector3.h"
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PHYSICS_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define PHYSICS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Approximate reciprocal square roots in the fast* helpers; OFF keeps them exact
+#ifndef PHYSICS_FAST_RSQRT
+#define PHYSICS_FAST_RSQRT 0
+#endif
+
+/**
+ * Four-float vector aligned for one SIMD register
+ * Used for homogeneous points and matrix columns; physics state stays in
+ * packed Vector3 arrays.
+ */
+struct alignas(16) Vec4 {
+    float x, y, z, w;
+
+    /**
+     * Default constructor - creates zero vector
+     */
+    Vec4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+
+    /**
+     * Constructor with individual components
+     */
+    Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+    /**
+     * Constructor from a 3D vector
+     * @param v X, Y and Z components
+     * @param w W component (1 for points, 0 for directions)
+     */
+    Vec4(const Vector3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+    /**
+     * Get the X, Y and Z components
+     * @return 3D vector
+     */
+    Vector3 xyz() const {
+        return Vector3(x, y, z);
+    }
+
+    /**
+     * Component-wise addition
+     */
+    Vec4 operator+(const Vec4& other) const {
+#if defined(PHYSICS_SIMD_X86)
+        Vec4 result;
+        _mm_store_ps(&result.x, _mm_add_ps(_mm_load_ps(&x), _mm_load_ps(&other.x)));
+        return result;
+#elif defined(PHYSICS_SIMD_NEON)
+        Vec4 result;
+        vst1q_f32(&result.x, vaddq_f32(vld1q_f32(&x), vld1q_f32(&other.x)));
+        return result;
+#else
+        return Vec4(x + other.x, y + other.y, z + other.z, w + other.w);
+#endif
+    }
+
+    /**
+     * Component-wise subtraction
+     */
+    Vec4 operator-(const Vec4& other) const {
+#if defined(PHYSICS_SIMD_X86)
+        Vec4 result;
+        _mm_store_ps(&result.x, _mm_sub_ps(_mm_load_ps(&x), _mm_load_ps(&other.x)));
+        return result;
+#elif defined(PHYSICS_SIMD_NEON)
+        Vec4 result;
+        vst1q_f32(&result.x, vsubq_f32(vld1q_f32(&x), vld1q_f32(&other.x)));
+        return result;
+#else
+        return Vec4(x - other.x, y - other.y, z - other.z, w - other.w);
+#endif
+    }
+
+    /**
+     * Scalar multiplication
+     */
+    Vec4 operator*(float scalar) const {
+#if defined(PHYSICS_SIMD_X86)
+        Vec4 result;
+        _mm_store_ps(&result.x, _mm_mul_ps(_mm_load_ps(&x), _mm_set1_ps(scalar)));
+        return result;
+#elif defined(PHYSICS_SIMD_NEON)
+        Vec4 result;
+        vst1q_f32(&result.x, vmulq_n_f32(vld1q_f32(&x), scalar));
+        return result;
+#else
+        return Vec4(x * scalar, y * scalar, z * scalar, w * scalar);
+#endif
+    }
+
+    /**
+     * Calculate the four-component dot product
+     * @param other Vector to dot with
+     * @return Dot product, summed as (x + y) + (z + w)
+     */
+    float dot(const Vec4& other) const {
+        return (x * other.x + y * other.y) + (z * other.z + w * other.w);
+    }
+};
+
+/**
+ * Column-major 4x4 matrix aligned for SIMD columns, laid out as OpenGL expects
+ * m[column * 4 + row]
+ */
+struct alignas(16) Mat4 {
+    float m[16];
+
+    /**
+     * Default constructor - creates the identity matrix
+     */
+    Mat4() {
+        for (int i = 0; i < 16; i++) {
+            m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        }
+    }
+
+    /**
+     * Get the elements for glUniformMatrix4fv
+     * @return 16 floats, column-major
+     */
+    const float* data() const {
+        return m;
+    }
+
+    /**
+     * Get the element at a row and column
+     */
+    float at(int row, int column) const {
+        return m[column * 4 + row];
+    }
+
+    /**
+     * Multiply two matrices (this * other)
+     * @param other Right-hand matrix
+     * @return Product
+     */
+    Mat4 operator*(const Mat4& other) const {
+        Mat4 result;
+#if defined(PHYSICS_SIMD_X86)
+        __m128 c0 = _mm_load_ps(m);
+        __m128 c1 = _mm_load_ps(m + 4);
+        __m128 c2 = _mm_load_ps(m + 8);
+        __m128 c3 = _mm_load_ps(m + 12);
+        for (int col = 0; col < 4; ++col) {
+            const float* b = other.m + col * 4;
+            __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(b[0])), _mm_mul_ps(c1, _mm_set1_ps(b[1]))),
+                                    _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(b[2])), _mm_mul_ps(c3, _mm_set1_ps(b[3]))));
+            _mm_store_ps(result.m + col * 4, sum);
+        }
+#elif defined(PHYSICS_SIMD_NEON)
+        float32x4_t c0 = vld1q_f32(m);
+        float32x4_t c1 = vld1q_f32(m + 4);
+        float32x4_t c2 = vld1q_f32(m + 8);
+        float32x4_t c3 = vld1q_f32(m + 12);
+        for (int col = 0; col < 4; ++col) {
+            const float* b = other.m + col * 4;
+            float32x4_t sum = vaddq_f32(vaddq_f32(vmulq_n_f32(c0, b[0]), vmulq_n_f32(c1, b[1])),
+                                        vaddq_f32(vmulq_n_f32(c2, b[2]), vmulq_n_f32(c3, b[3])));
+            vst1q_f32(result.m + col * 4, sum);
+        }
+#else
+        for (int col = 0; col < 4; ++col) {
+            const float* b = other.m + col * 4;
+            for (int row = 0; row < 4; ++row) {
+                result.m[col * 4 + row] = (m[row] * b[0] + m[4 + row] * b[1]) + (m[8 + row] * b[2] + m[12 + row] * b[3]);
+            }
+        }
+#endif
+        return result;
+    }
+
+    /**
+     * Transform a homogeneous vector
+     * @param v Vector (w = 1 for points, 0 for directions)
+     * @return this * v
+     */
+    Vec4 operator*(const Vec4& v) const {
+        Vec4 result;
+        for (int row = 0; row < 4; ++row) {
+            (&result.x)[row] = (m[row] * v.x + m[4 + row] * v.y) + (m[8 + row] * v.z + m[12 + row] * v.w);
+        }
+        return result;
+    }
+
+    /**
+     * Create a translate + per-axis scale matrix
+     * @param position Translation
+     * @param scale Scale along each axis
+     * @return Model matrix
+     */
+    static Mat4 translationScale(const Vector3& position, const Vector3& scale) {
+        Mat4 result;
+        result.m[0] = scale.x;
+        result.m[5] = scale.y;
+        result.m[10] = scale.z;
+        result.m[12] = position.x;
+        result.m[13] = position.y;
+        result.m[14] = position.z;
+        return result;
+    }
+
+    /**
+     * Create a view matrix looking along a direction
+     * @param eye Camera position
+     * @param forward View direction (need not be unit length)
+     * @param up Approximate up direction
+     * @return View matrix (inverse of the camera transform)
+     */
+    static Mat4 lookAt(const Vector3& eye, const Vector3& forward, const Vector3& up);
+
+    /**
+     * Create an OpenGL perspective projection matrix (clip z in [-w, w])
+     * @param fovRadians Vertical field of view
+     * @param aspectRatio Viewport width / height
+     * @param nearPlane Near clipping distance
+     * @param farPlane Far clipping distance
+     * @return Projection matrix
+     */
+    static Mat4 perspective(float fovRadians, float aspectRatio, float nearPlane, float farPlane) {
+        float f = 1.0f / std::tan(fovRadians / 2.0f);
+        float zRange = nearPlane - farPlane;
+        Mat4 result;
+        result.m[0] = f / aspectRatio;
+        result.m[5] = f;
+        result.m[10] = (farPlane + nearPlane) / zRange;
+        result.m[11] = -1.0f;
+        result.m[14] = (2.0f * farPlane * nearPlane) / zRange;
+        result.m[15] = 0.0f;
+        return result;
+    }
+};
+
+/**
+ * Scalar and batched vector helpers for rendering and other non-reference code
+ * Physics keeps to the exact Vector3 operators. With PHYSICS_FAST_RSQRT
+ * these use the hardware reciprocal square root plus one Newton step
+ * (relative error within fastRsqrtTolerance), otherwise they fall back to
+ * the exact operations (fastNormalized is then bit-identical to
+ * Vector3::normalized).
+ */
+class VectorMath {
+public:
+    static constexpr float fastRsqrtTolerance = 1.0e-6f;  // Bound on the fast rsqrt's relative error
+
+    /**
+     * Approximate 1 / sqrt(value)
+     * @param value Positive input
+     * @return Reciprocal square root (exact unless PHYSICS_FAST_RSQRT)
+     */
+    static float fastInverseSqrt(float value) {
+#if PHYSICS_FAST_RSQRT && defined(PHYSICS_SIMD_X86)
+        float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+        return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#elif PHYSICS_FAST_RSQRT && defined(PHYSICS_SIMD_NEON)
+        float32x2_t input = vdup_n_f32(value);
+        float32x2_t estimate = vrsqrte_f32(input);
+        estimate = vmul_f32(estimate, vrsqrts_f32(vmul_f32(input, estimate), estimate));
+        return vget_lane_f32(estimate, 0);
+#else
+        return 1.0f / std::sqrt(value);
+#endif
+    }
+
+    /**
+     * Normalize a vector with fastInverseSqrt
+     * Without PHYSICS_FAST_RSQRT this is Vector3::normalized (divide by the magnitude)
+     * @param v Vector to normalize
+     * @return Unit vector along v, or zero for vectors no longer than 0.0001
+     */
+    static Vector3 fastNormalized(const Vector3& v) {
+#if PHYSICS_FAST_RSQRT
+        float lengthSquared = v.magnitudeSquared();
+        if (lengthSquared > 0.0001f * 0.0001f) {
+            return v * fastInverseSqrt(lengthSquared);
+        }
+        return Vector3(0, 0, 0);
+#else
+        return v.normalized();
+#endif
+    }
+
+    /**
+     * Compute the distance from a point to selected entries of an array
+     * Uses the fast square root rules of fastInverseSqrt.
+     * @param points Packed points
+     * @param indices Entries of points to measure
+     * @param count Number of indices
+     * @param origin Point to measure from
+     * @param distances Receives count distances, in index order
+     */
+    static void fastDistances(const Vector3* points, const uint32_t* indices, size_t count, const Vector3& origin,
+                              float* distances) {
+        size_t i = 0;
+#if defined(PHYSICS_SIMD_X86)
+        __m128 ox = _mm_set1_ps(origin.x);
+        __m128 oy = _mm_set1_ps(origin.y);
+        __m128 oz = _mm_set1_ps(origin.z);
+        for (; i + 4 <= count; i += 4) {
+            const Vector3& p0 = points[indices[i]];
+            const Vector3& p1 = points[indices[i + 1]];
+            const Vector3& p2 = points[indices[i + 2]];
+            const Vector3& p3 = points[indices[i + 3]];
+            __m128 dx = _mm_sub_ps(_mm_setr_ps(p0.x, p1.x, p2.x, p3.x), ox);
+            __m128 dy = _mm_sub_ps(_mm_setr_ps(p0.y, p1.y, p2.y, p3.y), oy);
+            __m128 dz = _mm_sub_ps(_mm_setr_ps(p0.z, p1.z, p2.z, p3.z), oz);
+            __m128 squared = lengthSquared4(dx, dy, dz);
+#if PHYSICS_FAST_RSQRT
+            // d = d2 * rsqrt(d2), refined once; zero distances stay zero
+            __m128 estimate = _mm_rsqrt_ps(_mm_max_ps(squared, _mm_set1_ps(1.0e-30f)));
+            __m128 refined = _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f),
+                _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), squared), _mm_mul_ps(estimate, estimate))));
+            _mm_storeu_ps(distances + i, _mm_mul_ps(squared, refined));
+#else
+            _mm_storeu_ps(distances + i, _mm_sqrt_ps(squared));
+#endif
+        }
+#endif
+        for (; i < count; ++i) {
+            float squared = (points[indices[i]] - origin).magnitudeSquared();
+#if PHYSICS_FAST_RSQRT
+            distances[i] = squared > 0.0f ? squared * fastInverseSqrt(squared) : 0.0f;
+#else
+            distances[i] = std::sqrt(squared);
+#endif
+        }
+    }
+
+private:
+#if defined(PHYSICS_SIMD_X86)
+    /**
+     * Squared lengths of four vectors, summed in Vector3's order ((x*x + y*y) + z*z)
+     */
+    static __m128 lengthSquared4(__m128 x, __m128 y, __m128 z) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    }
+#endif
+};
+
+inline Mat4 Mat4::lookAt(const Vector3& eye, const Vector3& forward, const Vector3& up) {
+    Vector3 zAxis = VectorMath::fastNormalized(Vector3(0, 0, 0) - forward);  // Points towards the camera
+    Vector3 xAxis = VectorMath::fastNormalized(up.cross(zAxis));           // Points to the right
+    Vector3 yAxis = zAxis.cross(xAxis);                                    // Points up
+
+    Mat4 result;
+    result.m[0] = xAxis.x;    result.m[4] = xAxis.y;    result.m[8] = xAxis.z;     result.m[12] = -xAxis.dot(eye);
+    result.m[1] = yAxis.x;    result.m[5] = yAxis.y;    result.m[9] = yAxis.z;     result.m[13] = -yAxis.dot(eye);
+    result.m[2] = zAxis.x;    result.m[6] = zAxis.y;    result.m[10] = zAxis.z;    result.m[14] = -zAxis.dot(eye);
+    result.m[3] = 0.0f;       result.m[7] = 0.0f;       result.m[11] = 0.0f;       result.m[15] = 1.0f;
+    return result;
+}
@@ -0,0 +1,424 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "BodyStore.h"
+#include "MappedFile.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Versioned binary checkpoint of a PhysicsWorld
+ * A checkpoint holds the world settings that affect how the simulation
+ * continues, every persistent BodyStore array including the handle slots,
+ * and the warm-starting contact cache, laid out as:
+ *
+ *   Header          magic "PHYSCKPT", format version, byte order, settings, counts
+ *   Section table   one { id, element size, offset } entry per array
+ *   Sections        each array stored contiguously, 64-byte aligned
+ *
+ * Values are stored in native byte order; the byte-order mark rejects files
+ * from machines that differ. Readers skip section ids they do not know, so
+ * later versions can add arrays without breaking older files.
+ *
+ * Loading maps the file and views each section in place (parse), then copies
+ * the arrays straight into the world's store (apply): no per-field decoding.
+ * A loaded world reaches the same state hash as the one saved, provided the
+ * settings outside the header (such as the sleep energy threshold) match.
+ * Version 1 files have no handle slots or contacts, so their first step
+ * after a load starts its contacts cold; bodies of files before version 3
+ * load as spheres.
+ */
+class WorldCheckpoint {
+public:
+    static constexpr uint32_t formatVersion = 3;             // Version written by serialize (2 added handles and contacts, 3 shapes)
+    static constexpr uint32_t byteOrderMark = 0x01020304u;   // Reads back differently on a foreign byte order
+    static constexpr size_t sectionAlignment = 64;           // Alignment of every section
+    static constexpr uint32_t maxHandleSlot = 1u << 28;      // Handle slots at or above this are rejected
+
+    /**
+     * Section ids; values are part of the file format and must never change
+     */
+    enum SectionId : uint32_t {
+        Positions = 1,
+        Velocities = 2,
+        Forces = 3,
+        Masses = 4,
+        InverseMasses = 5,
+        Radii = 6,
+        Restitutions = 7,
+        Frictions = 8,
+        SpinDampings = 9,
+        Colors = 10,
+        Flags = 11,
+        RestSteps = 12,
+        HandleSlots = 13,   // Version 2
+        Contacts = 14,      // Version 2; holds Header::contactCount SavedContact records, not one per body
+        Shapes = 15,        // Version 3; bodies of older files are spheres
+        Extents = 16        // Version 3
+    };
+
+    /**
+     * File header, followed directly by sectionCount SectionEntry records
+     */
+    struct Header {
+        char magic[8];                  // "PHYSCKPT"
+        uint32_t version;               // Format version
+        uint32_t byteOrder;             // byteOrderMark as written
+        uint64_t bodyCount;             // Bodies in every section
+        uint64_t stepCount;             // Steps simulated when saved (keys the jitter stream)
+        uint64_t randomSeed;            // Collision jitter seed
+        float worldBounds[6];           // [minX, maxX, minY, maxY, minZ, maxZ]
+        float gravity[3];               // Gravity vector
+        float timeStep;                 // Fixed step the world ran at (informational)
+        uint32_t broadphase;            // BroadphaseMode
+        uint32_t contactSolve;          // ContactSolveMode
+        uint32_t solverIterations;      // Contact solver iterations
+        uint32_t options;               // Option bits (see optionWarmStarting and friends)
+        uint32_t sectionCount;          // Entries in the section table
+        uint32_t contactCount;          // Records in the Contacts section (zero before version 2)
+    };
+
+    /**
+     * Location of one array
+     */
+    struct SectionEntry {
+        uint32_t id;                    // SectionId
+        uint32_t elementSize;           // Bytes per body (per record for Contacts)
+        uint64_t offset;                // From the start of the checkpoint
+    };
+
+    /**
+     * Checkpoint parsed in place
+     */
+    struct Contents {
+        Header header;                  // Copy of the header
+        BodyStateView bodies;           // Views into the checkpoint's sections
+        const SavedContact* contacts;   // Contact cache records, or null
+        size_t contactCount;            // Number of contact records
+    };
+
+    static constexpr uint32_t optionWarmStarting = 1 << 0;
+    static constexpr uint32_t optionSleeping = 1 << 1;
+    static constexpr uint32_t optionContinuousCollision = 1 << 2;
+    static constexpr uint32_t optionDeterministic = 1 << 3;
+    static constexpr uint32_t knownOptions = optionWarmStarting | optionSleeping | optionContinuousCollision |
+                                             optionDeterministic;
+
+    /**
+     * Write a checkpoint of a world into memory
+     * @param world World to save
+     * @param out Receives the checkpoint bytes (previous contents are replaced)
+     */
+    static void serialize(const PhysicsWorld& world, std::vector<uint8_t>& out) {
+        BodyStateView view = world.getBodyStore().stateView();
+        size_t count = view.count;
+        std::vector<SavedContact> contacts;
+        world.getSavedContacts(contacts);
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "PHYSCKPT", 8);
+        header.version = formatVersion;
+        header.byteOrder = byteOrderMark;
+        header.bodyCount = count;
+        header.stepCount = world.getStepCount();
+        header.randomSeed = world.getRandomSeed();
+        const float* bounds = world.getWorldBounds();
+        for (int i = 0; i < 6; ++i) {
+            header.worldBounds[i] = bounds[i];
+        }
+        header.gravity[0] = world.getGravity().x;
+        header.gravity[1] = world.getGravity().y;
+        header.gravity[2] = world.getGravity().z;
+        header.timeStep = world.getTimeStep();
+        header.broadphase = (uint32_t)world.getBroadphaseMode();
+        header.contactSolve = (uint32_t)world.getContactSolveMode();
+        header.solverIterations = (uint32_t)world.getSolverIterations();
+        header.options = (world.isWarmStartingEnabled() ? optionWarmStarting : 0) |
+                         (world.isSleepingEnabled() ? optionSleeping : 0) |
+                         (world.isContinuousCollisionEnabled() ? optionContinuousCollision : 0) |
+                         (world.isDeterministicEnabled() ? optionDeterministic : 0);
+        header.contactCount = (uint32_t)contacts.size();
+
+        // Lay out the sections after the header and table, the contacts last
+        std::vector<SectionEntry> entries;
+        forEachSection(view, [&](SectionId id, const auto* array) {
+            entries.push_back(SectionEntry{ id, (uint32_t)sizeof(*array), 0 });
+        });
+        entries.push_back(SectionEntry{ Contacts, (uint32_t)sizeof(SavedContact), 0 });
+        header.sectionCount = (uint32_t)entries.size();
+        size_t offset = alignUp(sizeof(Header) + entries.size() * sizeof(SectionEntry));
+        for (SectionEntry& entry : entries) {
+            entry.offset = offset;
+            offset = alignUp(offset + entry.elementSize * (entry.id == Contacts ? contacts.size() : count));
+        }
+
+        out.assign(offset, 0);
+        std::memcpy(out.data(), &header, sizeof(header));
+        std::memcpy(out.data() + sizeof(header), entries.data(), entries.size() * sizeof(SectionEntry));
+        size_t section = 0;
+        forEachSection(view, [&](SectionId, const auto* array) {
+            const SectionEntry& entry = entries[section++];
+            if (count > 0) {
+                std::memcpy(out.data() + entry.offset, array, entry.elementSize * count);
+            }
+        });
+        if (!contacts.empty()) {
+            std::memcpy(out.data() + entries.back().offset, contacts.data(), contacts.size() * sizeof(SavedContact));
+        }
+    }
+
+    /**
+     * Save a checkpoint of a world to a file
+     * @param world World to save
+     * @param path File to write
+     * @param error Receives a description on failure
+     * @return True if the file was written
+     */
+    static bool save(const PhysicsWorld& world, const std::string& path, std::string& error) {
+        std::vector<uint8_t> bytes;
+        serialize(world, bytes);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write((const char*)bytes.data(), (std::streamsize)bytes.size())) {
+            error = "Failed to write checkpoint: " + path;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Validate a checkpoint and view its arrays in place
+     * @param data Checkpoint bytes (must stay alive while contents are used)
+     * @param size Number of bytes
+     * @param contents Receives the header and array views
+     * @param error Receives a description of the first problem
+     * @return True if the checkpoint is complete and consistent, with every enum and flag value known
+     */
+    static bool parse(const uint8_t* data, size_t size, Contents& contents, std::string& error) {
+        if (size < sizeof(Header)) {
+            error = "file too small for a checkpoint header";
+            return false;
+        }
+        Header& header = contents.header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, "PHYSCKPT", 8) != 0) {
+            error = "not a physics checkpoint";
+            return false;
+        }
+        if (header.byteOrder != byteOrderMark) {
+            error = "checkpoint was written with a different byte order";
+            return false;
+        }
+        if (header.version == 0 || header.version > formatVersion) {
+            error = "unsupported checkpoint version " + std::to_string(header.version);
+            return false;
+        }
+        if (header.broadphase > (uint32_t)BroadphaseMode::UniformGrid ||
+            header.contactSolve > (uint32_t)ContactSolveMode::Colored || header.solverIterations == 0) {
+            error = "invalid solver settings";
+            return false;
+        }
+        if (header.options & ~knownOptions) {
+            error = "unknown option bits";
+            return false;
+        }
+        if (header.sectionCount > (size - sizeof(Header)) / sizeof(SectionEntry) || header.bodyCount > size ||
+            header.contactCount > size) {
+            error = "truncated checkpoint";
+            return false;
+        }
+        if (header.version < 2) {
+            header.contactCount = 0;    // Was a reserved field
+        }
+
+        contents.bodies = BodyStateView();
+        contents.contacts = nullptr;
+        contents.contactCount = header.contactCount;
+        contents.bodies.count = (size_t)header.bodyCount;
+        size_t count = contents.bodies.count;
+        for (uint32_t s = 0; s < header.sectionCount; ++s) {
+            SectionEntry entry;
+            std::memcpy(&entry, data + sizeof(Header) + s * sizeof(SectionEntry), sizeof(entry));
+
+            bool known = false;
+            bool valid = true;
+            if (entry.id == Contacts && header.version >= 2) {
+                known = true;
+                valid = entry.elementSize == sizeof(SavedContact) && entry.offset <= size &&
+                        (size - entry.offset) / sizeof(SavedContact) >= contents.contactCount &&
+                        (uintptr_t)(data + entry.offset) % alignof(SavedContact) == 0;
+                contents.contacts = (const SavedContact*)(data + entry.offset);
+            }
+            forEachSection(contents.bodies, [&](SectionId id, auto*& array) {
+                if (id != entry.id) {
+                    return;
+                }
+                known = true;
+                using Element = std::remove_cv_t<std::remove_reference_t<decltype(*array)>>;
+                valid = entry.elementSize == sizeof(Element) && entry.offset <= size &&
+                        (size - entry.offset) / sizeof(Element) >= count &&
+                        (uintptr_t)(data + entry.offset) % alignof(Element) == 0;
+                array = (const Element*)(data + entry.offset);
+            });
+            if (known && !valid) {
+                error = "section " + std::to_string(entry.id) + " is truncated or malformed";
+                return false;
+            }
+        }
+
+        bool complete = true;
+        forEachSection(contents.bodies, [&](SectionId id, auto*& array) {
+            complete = complete && (array != nullptr || isOptional(id, header.version));
+        });
+        if (!complete || (contents.bodies.shapes == nullptr) != (contents.bodies.extents == nullptr) ||
+            (contents.contactCount > 0 && contents.contacts == nullptr)) {
+            error = "checkpoint is missing a body section";
+            return false;
+        }
+        if (contents.bodies.handleSlots) {
+            std::vector<uint32_t> slots(contents.bodies.handleSlots, contents.bodies.handleSlots + count);
+            std::sort(slots.begin(), slots.end());
+            if ((!slots.empty() && slots.back() >= maxHandleSlot) ||
+                std::adjacent_find(slots.begin(), slots.end()) != slots.end()) {
+                error = "invalid handle slots";
+                return false;
+            }
+        }
+        return validateBodies(contents.bodies, error);
+    }
+
+    /**
+     * Replace a world's settings and bodies with a parsed checkpoint
+     * @param contents Parsed checkpoint
+     * @param world World to restore into
+     */
+    static void apply(const Contents& contents, PhysicsWorld& world) {
+        const Header& header = contents.header;
+        const float* bounds = header.worldBounds;
+        world.setWorldBounds(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+        world.setGravity(Vector3(header.gravity[0], header.gravity[1], header.gravity[2]));
+        world.setRandomSeed(header.randomSeed);
+        world.setStepCount(header.stepCount);
+        world.setBroadphaseMode((BroadphaseMode)header.broadphase);
+        world.setContactSolveMode((ContactSolveMode)header.contactSolve);
+        world.setSolverIterations((int)header.solverIterations);
+        world.setWarmStartingEnabled((header.options & optionWarmStarting) != 0);
+        world.setSleepingEnabled((header.options & optionSleeping) != 0);
+        world.setContinuousCollisionEnabled((header.options & optionContinuousCollision) != 0);
+        world.restoreBodies(contents.bodies);
+        world.restoreSavedContacts(contents.contacts, contents.contactCount);
+        world.setDeterministicEnabled((header.options & optionDeterministic) != 0);
+    }
+
+    /**
+     * Restore a world from checkpoint bytes
+     * @param data Checkpoint bytes
+     * @param size Number of bytes
+     * @param world World to restore into (left untouched on failure)
+     * @param error Receives a description on failure
+     * @return True if the world was restored
+     */
+    static bool restore(const uint8_t* data, size_t size, PhysicsWorld& world, std::string& error) {
+        Contents contents;
+        if (!parse(data, size, contents, error)) {
+            return false;
+        }
+        apply(contents, world);
+        return true;
+    }
+
+    /**
+     * Restore a world from a checkpoint file, memory-mapped where possible
+     * @param world World to restore into (left untouched on failure)
+     * @param path File to read
+     * @param error Receives a description on failure
+     * @return True if the world was restored
+     */
+    static bool load(PhysicsWorld& world, const std::string& path, std::string& error) {
+        MappedFile file;
+        if (!file.open(path, error)) {
+            return false;
+        }
+        if (!restore(file.data(), file.size(), world, error)) {
+            error = path + ": " + error;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Checkpoints store Vector3 as three packed floats");
+    static_assert(sizeof(Header) == 104, "Header layout is part of the file format");
+    static_assert(sizeof(SectionEntry) == 16, "SectionEntry layout is part of the file format");
+    static_assert(sizeof(SavedContact) == 24, "SavedContact layout is part of the file format");
+
+    /**
+     * Call visit(id, array) for every body array of a view, in file order
+     */
+    template <typename View, typename Visit>
+    static void forEachSection(View& view, Visit visit) {
+        visit(Positions, view.positions);
+        visit(Velocities, view.velocities);
+        visit(Forces, view.forces);
+        visit(Masses, view.masses);
+        visit(InverseMasses, view.inverseMasses);
+        visit(Radii, view.radii);
+        visit(Restitutions, view.restitutions);
+        visit(Frictions, view.frictions);
+        visit(SpinDampings, view.spinDampings);
+        visit(Colors, view.colors);
+        visit(Flags, view.flags);
+        visit(RestSteps, view.restSteps);
+        visit(HandleSlots, view.handleSlots);
+        visit(Shapes, view.shapes);
+        visit(Extents, view.extents);
+    }
+
+    /**
+     * Check whether a section may be missing from a file of some version
+     */
+    static bool isOptional(SectionId id, uint32_t version) {
+        return (id == HandleSlots && version < 2) || ((id == Shapes || id == Extents) && version < 3);
+    }
+
+    /**
+     * Check the per-body values that only take a fixed set of values
+     * Shapes index the narrowphase tables, so a shape outside ShapeType would
+     * read past them; BODY_SHAPED and BODY_BALL must agree with the shape.
+     * @param bodies Parsed body arrays
+     * @param error Receives a description of the first bad body
+     * @return True if every body can be applied
+     */
+    static bool validateBodies(const BodyStateView& bodies, std::string& error) {
+        const uint8_t knownFlags = BODY_ACTIVE | BODY_STATIC | BODY_HELD | BODY_BALL | BODY_SLEEPING | BODY_SHAPED;
+        for (size_t i = 0; i < bodies.count; ++i) {
+            if (bodies.flags[i] & ~knownFlags) {
+                error = "body " + std::to_string(i) + " has unknown flag bits";
+                return false;
+            }
+            uint8_t shape = bodies.shapes ? bodies.shapes[i] : (uint8_t)ShapeType::Sphere;
+            if (shape > (uint8_t)ShapeType::Plane) {
+                error = "body " + std::to_string(i) + " has unknown shape " + std::to_string(shape);
+                return false;
+            }
+            bool sphere = shape == (uint8_t)ShapeType::Sphere;
+            if (((bodies.flags[i] & BODY_SHAPED) != 0) == sphere || ((bodies.flags[i] & BODY_BALL) && !sphere)) {
+                error = "body " + std::to_string(i) + " has flags that do not match its shape";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Round an offset up to the section alignment
+     */
+    static size_t alignUp(size_t offset) {
+        return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+    }
+};
@@ -0,0 +1,421 @@
+#pragma once
+#include "PhysicsWorld.h"
+#include "BodyStore.h"
+#include "JobSystem.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * WorldShards steps a PhysicsWorld as a row of spatial shards
+ * The room is cut into equal slabs along its longer horizontal axis. Each
+ * shard is a PhysicsWorld of its own that owns the bodies in its slab and
+ * steps them on its own worker, with no synchronization between phases.
+ *
+ * Every step:
+ *   1. Bodies are bucketed by slab. A body within ghostMargin of a border is
+ *      also mirrored into the neighbouring shard as a ghost, so contacts
+ *      across the border are seen from both sides.
+ *   2. Each shard brings its mirror up to date: bodies that arrived (spawned,
+ *      or migrated from a neighbour) are created, bodies that left are
+ *      removed, and everyone else has their state copied in place, so handles
+ *      and the warm-starting contact cache survive from step to step. Mirrors
+ *      take the handle slot of their source body, so collision jitter and
+ *      contact cache keys are the same as in the source world.
+ *   3. The shards step in parallel.
+ *   4. Each body's state is copied back from the shard that owned it; ghost
+ *      results are discarded.
+ *
+ * The source world stays the only world that Game, the renderer and console
+ * commands see; it just does not run step() itself. Both sides of a border
+ * contact start from identical copies of the pair and solve it the same way;
+ * only pressure from bodies deeper than the margin on the far side is not
+ * seen, so stacks straddling a border may settle slightly differently than
+ * in one world. Results are deterministic for a given shard count.
+ *
+ * The copy in and out is the exchange a multi-process layout would send over
+ * the wire: owned state out, ghosts in.
+ */
+class WorldShards {
+public:
+    static constexpr size_t maxShards = 64;     // Upper bound on setShardCount
+
+private:
+    /**
+     * One slab of the room and the world that simulates it
+     */
+    struct Shard {
+        std::unique_ptr<PhysicsWorld> world;    // Simulates the owned and ghost bodies
+        std::vector<uint32_t> members;          // Source dense indices mirrored this step, ascending
+        std::vector<uint8_t> memberOwned;       // 1 if the shard owns members[k], 0 for a ghost
+        std::vector<BodyHandle> mirrors;        // Mirror of each source handle slot, in the same slot (invalid if none)
+        std::vector<uint32_t> mirrorGenerations; // Source generation each mirror was made for
+        std::vector<uint64_t> seen;             // Sync stamp of each source handle slot's last membership
+        std::vector<BodyHandle> removals;       // Scratch: mirrors to remove
+        size_t ghosts = 0;                      // Ghosts mirrored this step
+    };
+
+    std::vector<Shard> shards;                  // One per slab, in slab order
+    JobSystem jobs;                             // Steps the shards side by side
+    std::vector<uint8_t> owners;                // Owning shard of each source handle slot last step
+    std::vector<uint32_t> ownerGenerations;     // Source generation each owner entry was recorded for
+    uint64_t syncStamp;                         // Incremented every step
+    size_t slotCount;                           // Source handle slots in use this step
+    int axis;                                   // Split axis (0 = x, 2 = z)
+    float ghostMargin;                          // Reach of the ghost zones last step
+    size_t ghostCount;                          // Ghosts mirrored last step, over all shards
+    size_t migrationCount;                      // Bodies that changed owner last step
+
+public:
+    /**
+     * Constructor - creates an unsharded stepper (every step runs in the source world)
+     */
+    WorldShards()
+        : jobs(1)
+        , syncStamp(0)
+        , slotCount(0)
+        , axis(0)
+        , ghostMargin(0.0f)
+        , ghostCount(0)
+        , migrationCount(0) {
+    }
+
+    WorldShards(const WorldShards&) = delete;
+    WorldShards& operator=(const WorldShards&) = delete;
+
+    /**
+     * Set the number of shards
+     * Changing the count drops every shard's mirror, so the next step starts
+     * its contacts cold
+     * @param count Number of slabs (1 = step the source world directly)
+     */
+    void setShardCount(size_t count) {
+        count = std::max<size_t>(1, std::min(count, maxShards));
+        if (count == getShardCount()) {
+            return;
+        }
+        shards.clear();
+        owners.clear();
+        ownerGenerations.clear();
+        if (count > 1) {
+            shards.resize(count);
+            for (Shard& shard : shards) {
+                shard.world = std::make_unique<PhysicsWorld>();
+                shard.world->setThreadCount(1);
+            }
+        }
+        jobs.setThreadCount(count);
+    }
+
+    /**
+     * Get the number of shards
+     * @return Slab count (1 when unsharded)
+     */
+    size_t getShardCount() const {
+        return shards.empty() ? 1 : shards.size();
+    }
+
+    /**
+     * Advance a world by one step, through the shards when there are several
+     * @param world Source world
+     * @param deltaTime Step length in seconds
+     */
+    void step(PhysicsWorld& world, float deltaTime) {
+        if (shards.empty()) {
+            world.step(deltaTime);
+            return;
+        }
+        if (world.isDeterministicEnabled()) {
+            deltaTime = world.getTimeStep();
+        }
+
+        BodyStore& source = world.getBodyStore();
+        syncStamp++;
+        measureMargin(source, deltaTime);
+        configureShards(world);
+        assignBodies(source);
+
+        // Mirror and step each shard on its own worker
+        jobs.parallelFor(shards.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                Shard& shard = shards[s];
+                syncShard(shard, source);
+                shard.world->setStepCount(world.getStepCount());
+                shard.world->step(deltaTime);
+            }
+        });
+
+        // Copy results back only once every shard has read its ghosts from the source
+        jobs.parallelFor(shards.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                collectShard(shards[s], source);
+            }
+        });
+
+        // Sum the shards' counters into the source world
+        ExternalStepStats stats;
+        ghostCount = 0;
+        for (const Shard& shard : shards) {
+            stats.sleeping += countOwnedSleeping(shard, source);
+            stats.swept += shard.world->getSweptCount();
+            stats.contacts += shard.world->getContactCount();
+            stats.cachedContacts += shard.world->getCachedContactCount();
+            ghostCount += shard.ghosts;
+        }
+        world.finishExternalStep(stats);
+    }
+
+    /**
+     * Get the number of ghost bodies mirrored by the last step
+     * @return Ghosts over all shards
+     */
+    size_t getGhostCount() const {
+        return ghostCount;
+    }
+
+    /**
+     * Get the number of bodies that moved to another shard in the last step
+     * @return Migrations
+     */
+    size_t getMigrationCount() const {
+        return migrationCount;
+    }
+
+    /**
+     * Get the reach of the ghost zones used by the last step
+     * @return Distance from a border within which bodies are mirrored (meters)
+     */
+    float getGhostMargin() const {
+        return ghostMargin;
+    }
+
+    /**
+     * Get the number of bodies a shard owned in the last step
+     * @param shard Shard index
+     * @return Owned bodies
+     */
+    size_t getOwnedCount(size_t shard) const {
+        if (shard >= shards.size()) {
+            return 0;
+        }
+        return shards[shard].members.size() - shards[shard].ghosts;
+    }
+
+private:
+    /**
+     * Copy the source world's settings into every shard and fix the slabs
+     * Bounds and gravity are only set when they change, since setting them
+     * wakes every body and would keep the shards from ever sleeping
+     * @param world Source world
+     */
+    void configureShards(const PhysicsWorld& world) {
+        const float* bounds = world.getWorldBounds();
+        axis = (bounds[1] - bounds[0] >= bounds[5] - bounds[4]) ? 0 : 2;
+        float low = bounds[axis * 2];
+        float width = (bounds[axis * 2 + 1] - low) / (float)shards.size();
+
+        for (size_t s = 0; s < shards.size(); ++s) {
+            PhysicsWorld& shard = *shards[s].world;
+            if (!std::equal(bounds, bounds + 6, shard.getWorldBounds())) {
+                shard.setWorldBounds(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+            }
+            const Vector3& gravity = world.getGravity();
+            const Vector3& shardGravity = shard.getGravity();
+            if (gravity.x != shardGravity.x || gravity.y != shardGravity.y || gravity.z != shardGravity.z) {
+                shard.setGravity(world.getGravity());
+            }
+            shard.setRandomSeed(world.getRandomSeed());
+            shard.setBroadphaseMode(world.getBroadphaseMode());
+            shard.setSimdLevel(world.getSimdLevel());
+            shard.setContactSolveMode(world.getContactSolveMode());
+            shard.setSolverIterations(world.getSolverIterations());
+            shard.setWarmStartingEnabled(world.isWarmStartingEnabled());
+            shard.setContinuousCollisionEnabled(world.isContinuousCollisionEnabled());
+            shard.setStepTimingEnabled(world.isStepTimingEnabled());
+            shard.setSleepEnergy(world.getSleepEnergy());
+            if (shard.isSleepingEnabled() != world.isSleepingEnabled()) {
+                shard.setSleepingEnabled(world.isSleepingEnabled());
+            }
+
+            // The grid only needs to cover the slab and its ghost zones
+            float region[6] = { bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] };
+            region[axis * 2] = low + width * (float)s - ghostMargin;
+            region[axis * 2 + 1] = low + width * (float)(s + 1) + ghostMargin;
+            shard.setBroadphaseRegion(region);
+        }
+    }
+
+    /**
+     * Size the ghost zones to hold every body that can touch a border body this step
+     * Two of the largest radii plus two bodies closing at the top speed
+     * @param source Source body store
+     * @param deltaTime Step length in seconds
+     */
+    void measureMargin(const BodyStore& source, float deltaTime) {
+        float maxRadius = 0.0f;
+        float maxSpeedSquared = 0.0f;
+        for (size_t i = 0; i < source.size(); ++i) {
+            maxRadius = std::max(maxRadius, source.radii[i]);
+            maxSpeedSquared = std::max(maxSpeedSquared, source.velocities[i].magnitudeSquared());
+        }
+        ghostMargin = 2.0f * maxRadius + 2.0f * std::sqrt(maxSpeedSquared) * deltaTime;
+    }
+
+    /**
+     * Bucket every source body into the shard owning its slab and the shards whose ghost zone it is in
+     * @param source Source body store
+     */
+    void assignBodies(const BodyStore& source) {
+        size_t count = source.size();
+        for (Shard& shard : shards) {
+            shard.members.clear();
+            shard.memberOwned.clear();
+            shard.ghosts = 0;
+        }
+
+        const float* bounds = shards[0].world->getWorldBounds();
+        float low = bounds[axis * 2];
+        float inverseWidth = (float)shards.size() / std::max(bounds[axis * 2 + 1] - low, 0.001f);
+        int last = (int)shards.size() - 1;
+
+        migrationCount = 0;
+        slotCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const Vector3& position = source.positions[i];
+            float coordinate = axis == 0 ? position.x : position.z;
+            int owner = slabOf(coordinate, low, inverseWidth, last);
+            int first = slabOf(coordinate - ghostMargin, low, inverseWidth, last);
+            int final = slabOf(coordinate + ghostMargin, low, inverseWidth, last);
+            if (source.shapes[i] == (uint8_t)ShapeType::Plane) {
+                // Planes are infinite, so every shard sees them
+                first = 0;
+                final = last;
+            }
+            for (int s = first; s <= final; ++s) {
+                Shard& shard = shards[s];
+                shard.members.push_back((uint32_t)i);
+                shard.memberOwned.push_back(s == owner ? 1 : 0);
+                shard.ghosts += s == owner ? 0 : 1;
+            }
+
+            // A reused slot holds a new body, which arrived rather than migrated
+            BodyHandle handle = source.handleAt((uint32_t)i);
+            uint32_t slot = handle.index;
+            slotCount = std::max<size_t>(slotCount, slot + 1);
+            if (slot >= owners.size()) {
+                owners.resize(slot + 1, 0xFF);
+                ownerGenerations.resize(slot + 1, 0);
+            }
+            if (owners[slot] != 0xFF && owners[slot] != owner && ownerGenerations[slot] == handle.generation) {
+                migrationCount++;
+            }
+            owners[slot] = (uint8_t)owner;
+            ownerGenerations[slot] = handle.generation;
+        }
+    }
+
+    /**
+     * Bring a shard's mirror in line with its members (shard worker)
+     * @param shard Shard to update
+     * @param source Source body store
+     */
+    void syncShard(Shard& shard, const BodyStore& source) {
+        PhysicsWorld& world = *shard.world;
+        if (shard.mirrors.size() < slotCount) {
+            shard.mirrors.resize(slotCount, BodyHandle());
+            shard.mirrorGenerations.resize(slotCount, 0);
+            shard.seen.resize(slotCount, 0);
+        }
+
+        // Stamp this step's members; a reused source slot invalidates its old mirror
+        shard.removals.clear();
+        for (uint32_t dense : shard.members) {
+            BodyHandle handle = source.handleAt(dense);
+            shard.seen[handle.index] = syncStamp;
+            BodyHandle& mirror = shard.mirrors[handle.index];
+            if (mirror.isValid() && shard.mirrorGenerations[handle.index] != handle.generation) {
+                shard.removals.push_back(mirror);
+                mirror = BodyHandle();
+            }
+        }
+
+        // Remove mirrors of bodies that left the shard or no longer exist
+        const BodyStore& local = world.getBodyStore();
+        for (size_t j = 0; j < local.size(); ++j) {
+            uint32_t sourceSlot = local.denseToHandle[j];
+            if (sourceSlot >= shard.seen.size() || shard.seen[sourceSlot] != syncStamp) {
+                shard.removals.push_back(local.handleAt((uint32_t)j));
+                if (sourceSlot < shard.mirrors.size()) {
+                    shard.mirrors[sourceSlot] = BodyHandle();
+                }
+            }
+        }
+        world.removeBodies(shard.removals.data(), shard.removals.size());
+
+        // Create arrivals and copy everyone's state in
+        BodyStateView state = source.stateView();
+        BodyStore& store = world.getBodyStore();
+        for (uint32_t dense : shard.members) {
+            BodyHandle handle = source.handleAt(dense);
+            BodyHandle& mirror = shard.mirrors[handle.index];
+            if (mirror.isValid()) {
+                store.assignBody(store.denseIndex(mirror), state, dense);
+                continue;
+            }
+            mirror = world.addBody(state, dense, handle.index);
+            shard.mirrorGenerations[handle.index] = handle.generation;
+        }
+    }
+
+    /**
+     * Copy the state of the bodies a shard owns back into the source (shard worker)
+     * Shards own disjoint bodies, so workers never write the same element
+     * @param shard Shard that just stepped
+     * @param source Source body store
+     */
+    void collectShard(const Shard& shard, BodyStore& source) {
+        const BodyStore& local = shard.world->getBodyStore();
+        for (size_t k = 0; k < shard.members.size(); ++k) {
+            if (!shard.memberOwned[k]) {
+                continue;
+            }
+            uint32_t dense = shard.members[k];
+            uint32_t mirror = local.denseIndex(shard.mirrors[source.denseToHandle[dense]]);
+            source.positions[dense] = local.positions[mirror];
+            source.velocities[dense] = local.velocities[mirror];
+            source.forces[dense] = local.forces[mirror];
+            source.flags[dense] = local.flags[mirror];
+            source.restSteps[dense] = local.restSteps[mirror];
+        }
+    }
+
+    /**
+     * Count the sleeping bodies a shard owns
+     * @param shard Shard that just stepped
+     * @param source Source body store (already collected)
+     * @return Sleeping owned bodies
+     */
+    static size_t countOwnedSleeping(const Shard& shard, const BodyStore& source) {
+        size_t sleeping = 0;
+        for (size_t k = 0; k < shard.members.size(); ++k) {
+            if (shard.memberOwned[k] && (source.flags[shard.members[k]] & BODY_SLEEPING)) {
+                sleeping++;
+            }
+        }
+        return sleeping;
+    }
+
+    /**
+     * Find the slab containing a coordinate along the split axis
+     * @return Shard index, clamped to the outer slabs
+     */
+    static int slabOf(float coordinate, float low, float inverseWidth, int last) {
+        float slab = (coordinate - low) * inverseWidth;
+        if (!(slab > 0.0f)) {
+            return 0;  // Also catches NaN
+        }
+        return std::min((int)slab, last);
+    }
+};
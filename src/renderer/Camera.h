@@ -1,6 +1,7 @@
 #pragma once
 #define _USE_MATH_DEFINES
 #include "../physics/Vector3.h"
+#include "../physics/VectorMath.h"
 #include <cmath>
 
 #ifndef M_PI
@@ -61,46 +62,19 @@ public:
 
     /**
      * Get the view matrix for rendering
-     * @return 4x4 view matrix as float array (column-major order)
+     * @return 4x4 view matrix (column-major order)
      */
-    void getViewMatrix(float* matrix) const {
-        // Create look-at matrix
-        Vector3 target = position + front;
-        
-        // Calculate camera basis vectors
-        Vector3 zAxis = (position - target).normalized();  // Points towards camera
-        Vector3 xAxis = up.cross(zAxis).normalized();      // Points to the right
-        Vector3 yAxis = zAxis.cross(xAxis);                // Points up
-        
-        // Create view matrix (inverse of camera transform)
-        matrix[0] = xAxis.x;    matrix[4] = xAxis.y;    matrix[8] = xAxis.z;     matrix[12] = -xAxis.dot(position);
-        matrix[1] = yAxis.x;    matrix[5] = yAxis.y;    matrix[9] = yAxis.z;     matrix[13] = -yAxis.dot(position);
-        matrix[2] = zAxis.x;    matrix[6] = zAxis.y;    matrix[10] = zAxis.z;    matrix[14] = -zAxis.dot(position);
-        matrix[3] = 0.0f;       matrix[7] = 0.0f;       matrix[11] = 0.0f;       matrix[15] = 1.0f;
+    Mat4 getViewMatrix() const {
+        return Mat4::lookAt(position, front, up);
     }
 
     /**
      * Get the projection matrix for rendering
      * @param aspectRatio Aspect ratio of the viewport
-     * @return 4x4 projection matrix as float array (column-major order)
+     * @return 4x4 perspective projection matrix (column-major order)
      */
-    void getProjectionMatrix(float aspectRatio, float* matrix) const {
-        // Create perspective projection matrix
-        float fovRad = fov * M_PI / 180.0f;
-        float f = 1.0f / tan(fovRad / 2.0f);
-        float zRange = nearPlane - farPlane;
-        
-        // Initialize to zero
-        for (int i = 0; i < 16; i++) {
-            matrix[i] = 0.0f;
-        }
-        
-        // Set perspective projection values
-        matrix[0] = f / aspectRatio;
-        matrix[5] = f;
-        matrix[10] = (farPlane + nearPlane) / zRange;
-        matrix[11] = -1.0f;
-        matrix[14] = (2.0f * farPlane * nearPlane) / zRange;
+    Mat4 getProjectionMatrix(float aspectRatio) const {
+        return Mat4::perspective(fov * (float)M_PI / 180.0f, aspectRatio, nearPlane, farPlane);
     }
 
     /**
@@ -297,10 +271,10 @@ private:
         newFront.y = sin(pitch * M_PI / 180.0f);
         newFront.z = sin(yaw * M_PI / 180.0f) * cos(pitch * M_PI / 180.0f);
         
-        front = newFront.normalized();
+        front = VectorMath::fastNormalized(newFront);
         
         // Calculate right and up vectors
-        right = front.cross(worldUp).normalized();
-        up = right.cross(front).normalized();
+        right = VectorMath::fastNormalized(front.cross(worldUp));
+        up = VectorMath::fastNormalized(right.cross(front));
     }
 }; 
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#include "../physics/Vector3.h"
+#include "../physics/SimdKernels.h"
+#include "../physics/VectorMath.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * View frustum as six inward-facing planes
+ * Planes are extracted from projection * view (Gribb/Hartmann) and normalized,
+ * so a plane equation evaluates to the signed distance from the plane
+ */
+class Frustum {
+private:
+    float planes[6][4];     // [left, right, bottom, top, near, far] x (a, b, c, d)
+
+public:
+    /**
+     * Constructor - creates a frustum that accepts everything
+     */
+    Frustum() {
+        for (int p = 0; p < 6; ++p) {
+            planes[p][0] = planes[p][1] = planes[p][2] = 0.0f;
+            planes[p][3] = 1.0f;
+        }
+    }
+
+    /**
+     * Extract planes from camera matrices
+     * @param viewMatrix View matrix (Camera::getViewMatrix)
+     * @param projMatrix Projection matrix (Camera::getProjectionMatrix)
+     */
+    void extract(const Mat4& viewMatrix, const Mat4& projMatrix) {
+        // clip = projection * view, column-major
+        Mat4 product = projMatrix * viewMatrix;
+        const float* clip = product.data();
+
+        // Plane p = row3 +/- row(p / 2)
+        for (int p = 0; p < 6; ++p) {
+            int row = p / 2;
+            float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+            for (int c = 0; c < 4; ++c) {
+                planes[p][c] = clip[c * 4 + 3] + sign * clip[c * 4 + row];
+            }
+
+            float length = std::sqrt(planes[p][0] * planes[p][0] +
+                                     planes[p][1] * planes[p][1] +
+                                     planes[p][2] * planes[p][2]);
+            if (length > 0.0f) {
+                for (int c = 0; c < 4; ++c) {
+                    planes[p][c] /= length;
+                }
+            }
+        }
+    }
+
+    /**
+     * Test a sphere against the frustum
+     * @return False if the sphere is entirely outside
+     */
+    bool sphereVisible(const Vector3& center, float radius) const {
+        for (int p = 0; p < 6; ++p) {
+            if (distance(p, center) < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Classify an axis-aligned box against the frustum
+     * @param min Minimum corner
+     * @param max Maximum corner
+     * @return -1 if entirely outside, 1 if entirely inside, 0 if it straddles a plane
+     */
+    int classifyBox(const Vector3& min, const Vector3& max) const {
+        bool inside = true;
+        for (int p = 0; p < 6; ++p) {
+            // Corner furthest along the plane normal, and the one furthest against it
+            Vector3 positive(planes[p][0] > 0.0f ? max.x : min.x,
+                             planes[p][1] > 0.0f ? max.y : min.y,
+                             planes[p][2] > 0.0f ? max.z : min.z);
+            Vector3 negative(planes[p][0] > 0.0f ? min.x : max.x,
+                             planes[p][1] > 0.0f ? min.y : max.y,
+                             planes[p][2] > 0.0f ? min.z : max.z);
+            if (distance(p, positive) < 0.0f) {
+                return -1;
+            }
+            if (distance(p, negative) < 0.0f) {
+                inside = false;
+            }
+        }
+        return inside ? 1 : 0;
+    }
+
+    /**
+     * Cull interpolated spheres [begin, end) and append the visible indices
+     * Positions are blended from previous to current by alpha before testing
+     * @param previous Sphere centers at the start of the tick
+     * @param current Sphere centers at the end of the tick
+     * @param radii Sphere radii
+     * @param alpha Blend factor
+     * @param begin First sphere index
+     * @param end One past the last sphere index
+     * @param visible Receives indices of spheres that intersect the frustum
+     */
+    void cullSpheres(const Vector3* previous, const Vector3* current, const float* radii, float alpha,
+                     size_t begin, size_t end, std::vector<uint32_t>& visible) const {
+        size_t i = begin;
+#if defined(PHYSICS_SIMD_X86)
+        const __m128 blend = _mm_set1_ps(alpha);
+        for (; i + 4 <= end; i += 4) {
+            __m128 px, py, pz, cx, cy, cz;
+            loadCenters4(&previous[i].x, px, py, pz);
+            loadCenters4(&current[i].x, cx, cy, cz);
+            __m128 x = _mm_add_ps(px, _mm_mul_ps(_mm_sub_ps(cx, px), blend));
+            __m128 y = _mm_add_ps(py, _mm_mul_ps(_mm_sub_ps(cy, py), blend));
+            __m128 z = _mm_add_ps(pz, _mm_mul_ps(_mm_sub_ps(cz, pz), blend));
+            __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+
+            __m128 keep = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p][0])),
+                                                 _mm_mul_ps(y, _mm_set1_ps(planes[p][1]))),
+                                      _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planes[p][2])),
+                                                 _mm_set1_ps(planes[p][3])));
+                keep = _mm_and_ps(keep, _mm_cmpge_ps(d, negRadius));
+            }
+
+            int mask = _mm_movemask_ps(keep);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (mask & (1 << lane)) {
+                    visible.push_back((uint32_t)(i + lane));
+                }
+            }
+        }
+#endif
+        for (; i < end; ++i) {
+            Vector3 center = previous[i] + (current[i] - previous[i]) * alpha;
+            if (sphereVisible(center, radii[i])) {
+                visible.push_back((uint32_t)i);
+            }
+        }
+    }
+
+private:
+    /**
+     * Signed distance from a plane
+     */
+    float distance(int p, const Vector3& point) const {
+        return planes[p][0] * point.x + planes[p][1] * point.y + planes[p][2] * point.z + planes[p][3];
+    }
+
+#if defined(PHYSICS_SIMD_X86)
+    /**
+     * Load four packed xyz centers and transpose them into x, y, z lanes
+     */
+    static void loadCenters4(const float* xyz, __m128& x, __m128& y, __m128& z) {
+        x = _mm_setr_ps(xyz[0], xyz[3], xyz[6], xyz[9]);
+        y = _mm_setr_ps(xyz[1], xyz[4], xyz[7], xyz[10]);
+        z = _mm_setr_ps(xyz[2], xyz[5], xyz[8], xyz[11]);
+    }
+#endif
+};
@@ -0,0 +1,562 @@
+#pragma once
+#include <glad/glad.h>
+#include "ShaderProgram.h"
+#include "../physics/PhysicsWorld.h"
+#include "../physics/Profiler.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * GpuPhysics steps sphere bodies with OpenGL 4.3 compute shaders
+ * An optional backend for particle-scale scenes. The bodies of a PhysicsWorld
+ * are uploaded once into a shader storage buffer, and every step then runs on
+ * the GPU:
+ *
+ *   physics_grid.comp        spatial hash: count balls per hashed cell, scatter them into cell order
+ *   physics_scan.comp        prefix sum of the cell counts into cell start offsets
+ *   physics_collide.comp     sphere-sphere push and impulse (Jacobi passes over a ping-pong buffer)
+ *   physics_integrate.comp   gravity, drag and the floor clamp
+ *   physics_boundaries.comp  world boundary clamp and bounce
+ *
+ * The renderer draws balls straight from the current state buffer, so there
+ * is no readback while the backend runs; download() copies positions and
+ * velocities back into the world only when the CPU needs them, and refresh()
+ * writes back just the balls the CPU then edited. The CPU
+ * world stays the reference: the GPU path has no friction between balls,
+ * warm starting, sleeping or continuous collision, and is not deterministic
+ * across runs because balls within a cell are scattered in arbitrary order.
+ * All calls must come from the thread that owns the GL context.
+ */
+class GpuPhysics {
+public:
+    /**
+     * One ball as laid out in the state buffers (std430)
+     * The first member doubles as the renderer's per-instance center + radius
+     */
+    struct GpuBall {
+        float positionRadius[4];        // xyz = center, w = radius
+        float velocityInverseMass[4];   // xyz = velocity, w = 1 / mass (0 = static)
+        float colorRestitution[4];      // rgb = color, a = restitution
+        float material[4];              // x = friction, y = spin damping, z = 1 for balls, w unused
+    };
+    static_assert(sizeof(GpuBall) == 64, "GpuBall must match the std430 Ball struct");
+
+private:
+    ShaderProgram gridProgram;          // physics_grid.comp
+    ShaderProgram scanProgram;          // physics_scan.comp
+    ShaderProgram collideProgram;       // physics_collide.comp
+    ShaderProgram integrateProgram;     // physics_integrate.comp
+    ShaderProgram boundariesProgram;    // physics_boundaries.comp
+
+    unsigned int ballBuffers[2];        // Ball state, ping-ponged by the collide passes
+    unsigned int cellCountBuffer;       // Balls per hash bucket
+    unsigned int cellStartBuffer;       // First sorted slot of each bucket
+    unsigned int cellCursorBuffer;      // Scatter write cursor of each bucket
+    unsigned int sortedBuffer;          // Ball indices in bucket order
+    unsigned int blockSumBuffer;        // Per-block totals of the scan
+    unsigned int ballCellBuffer;        // Hash bucket of each ball
+    int current;                        // Index into ballBuffers of the latest state
+
+    std::vector<uint32_t> bodies;       // Dense index in the world of each GPU ball
+    std::vector<uint32_t> layout;       // Scratch: dense indices refresh() would upload
+    std::vector<GpuBall> staging;       // Upload/download staging; mirrors the GPU state after either
+    size_t ballCount;                   // Balls on the GPU
+    size_t ballCapacity;                // Balls the state buffers have room for
+    uint32_t tableSize;                 // Hash buckets (power of two, at least workGroupSize)
+    uint32_t gridTableSize;             // Hash buckets the grid buffers were allocated for
+    float cellSize;                     // Hash grid cell edge (largest diameter)
+    float bounds[6];                    // World bounds [minX, maxX, minY, maxY, minZ, maxZ]
+    Vector3 gravity;                    // Gravity acceleration
+    float timeStep;                     // Fixed step length
+    float accumulator;                  // Unsimulated time carried between frames
+    uint64_t stepCount;                 // Steps run since upload() started the backend
+
+    bool available;                     // Context is 4.3+ and every program compiled
+    bool active;                        // Balls are on the GPU and stepped there
+
+    static constexpr unsigned int workGroupSize = 256;   // local_size_x of every physics shader
+    static constexpr int solverPasses = 2;               // Jacobi collide passes per step
+    static constexpr int maxSubsteps = 4;                // Steps per frame before dropping time
+    static constexpr float airResistance = 0.999f;       // Matches PhysicsWorld
+    static constexpr float penetrationSlop = 0.01f;      // Matches PhysicsWorld
+    static constexpr float restitutionThreshold = 1.0f;  // Matches PhysicsWorld
+    static constexpr float correction = 0.4f;            // Overlap fraction pushed out per Jacobi pass
+
+public:
+    /**
+     * Constructor - creates no GL objects until initialize()
+     */
+    GpuPhysics()
+        : cellCountBuffer(0)
+        , cellStartBuffer(0)
+        , cellCursorBuffer(0)
+        , sortedBuffer(0)
+        , blockSumBuffer(0)
+        , ballCellBuffer(0)
+        , current(0)
+        , ballCount(0)
+        , ballCapacity(0)
+        , tableSize(0)
+        , gridTableSize(0)
+        , cellSize(1.0f)
+        , gravity(0, -9.81f, 0)
+        , timeStep(1.0f / 60.0f)
+        , accumulator(0.0f)
+        , stepCount(0)
+        , available(false)
+        , active(false) {
+        ballBuffers[0] = ballBuffers[1] = 0;
+        for (float& bound : bounds) {
+            bound = 0.0f;
+        }
+    }
+
+    /**
+     * Destructor - releases the GL objects
+     */
+    ~GpuPhysics() {
+        cleanup();
+    }
+
+    GpuPhysics(const GpuPhysics&) = delete;
+    GpuPhysics& operator=(const GpuPhysics&) = delete;
+
+    /**
+     * Check the context and compile the compute programs
+     * Must be called after the OpenGL context is created.
+     * @return True if the backend can be used
+     */
+    bool initialize() {
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major * 10 + minor < 43 || !glDispatchCompute || !glMemoryBarrier) {
+            return false;
+        }
+
+        available = gridProgram.loadCompute("shaders/physics_grid.comp") &&
+                    scanProgram.loadCompute("shaders/physics_scan.comp") &&
+                    collideProgram.loadCompute("shaders/physics_collide.comp") &&
+                    integrateProgram.loadCompute("shaders/physics_integrate.comp") &&
+                    boundariesProgram.loadCompute("shaders/physics_boundaries.comp");
+        if (!available) {
+            return false;
+        }
+
+        glGenBuffers(2, ballBuffers);
+        glGenBuffers(1, &cellCountBuffer);
+        glGenBuffers(1, &cellStartBuffer);
+        glGenBuffers(1, &cellCursorBuffer);
+        glGenBuffers(1, &sortedBuffer);
+        glGenBuffers(1, &blockSumBuffer);
+        glGenBuffers(1, &ballCellBuffer);
+        return true;
+    }
+
+    /**
+     * Check whether the context supports the backend
+     * @return True if initialize() succeeded
+     */
+    bool isAvailable() const {
+        return available;
+    }
+
+    /**
+     * Check whether balls are currently stepped on the GPU
+     * @return True between upload() and deactivate()
+     */
+    bool isActive() const {
+        return active;
+    }
+
+    /**
+     * Copy every body of a world to the GPU and start stepping it there
+     * The GPU path has no sleeping, so every body is woken first.
+     * @param world World to take the bodies from (its settings are captured too)
+     * @param error Receives a description on failure
+     * @return False if the backend is unavailable or the world has non-sphere bodies
+     */
+    bool upload(PhysicsWorld& world, std::string& error) {
+        if (!available) {
+            error = "GPU physics needs an OpenGL 4.3 context with compute shaders";
+            return false;
+        }
+        if (!checkShapes(world.getBodyStore(), error)) {
+            return false;
+        }
+        world.wakeAll();
+        accumulator = 0.0f;
+        stepCount = 0;
+        current = 0;
+        uploadAll(world);
+        active = true;
+        return true;
+    }
+
+    /**
+     * Write the CPU's edits of a downloaded world back to the running backend
+     * Call after download() once the world has been changed. When the same
+     * bodies are still active only the balls that differ from the GPU state are
+     * written; otherwise every ball is re-uploaded. Either way the step count
+     * and accumulated time carry on and no body is woken.
+     * @param world World the balls were downloaded into
+     * @param error Receives a description on failure
+     * @return False if the world gained non-sphere bodies (the backend should be deactivated)
+     */
+    bool refresh(PhysicsWorld& world, std::string& error) {
+        const BodyStore& store = world.getBodyStore();
+        if (!checkShapes(store, error)) {
+            return false;
+        }
+        layout.clear();
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (store.flags[i] & BODY_ACTIVE) {
+                layout.push_back((uint32_t)i);
+            }
+        }
+        if (layout != bodies) {
+            uploadAll(world);
+            return true;
+        }
+
+        PROFILE_SCOPE("gpu_physics.refresh");
+        float maxRadius = 0.0f;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ballBuffers[current]);
+        size_t runStart = 0;
+        for (size_t k = 0; k <= ballCount; ++k) {
+            bool changed = false;
+            if (k < ballCount) {
+                GpuBall ball = makeBall(store, bodies[k]);
+                maxRadius = std::max(maxRadius, store.radii[bodies[k]]);
+                changed = std::memcmp(&ball, &staging[k], sizeof(GpuBall)) != 0;
+                if (changed) {
+                    staging[k] = ball;
+                }
+            }
+            // Write each run of changed balls with one call
+            if (!changed) {
+                if (k > runStart) {
+                    glBufferSubData(GL_SHADER_STORAGE_BUFFER, (GLintptr)(runStart * sizeof(GpuBall)),
+                                    (GLsizeiptr)((k - runStart) * sizeof(GpuBall)), staging.data() + runStart);
+                }
+                runStart = k + 1;
+            }
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        cellSize = std::max(2.0f * maxRadius, 0.001f);
+        captureSettings(world);
+        return true;
+    }
+
+    /**
+     * Copy the GPU state back into the world the balls were uploaded from
+     * The world must not have gained or lost bodies since upload().
+     * @param world World to write positions and velocities into
+     */
+    void download(PhysicsWorld& world) {
+        if (!active || ballCount == 0) {
+            return;
+        }
+        PROFILE_SCOPE("gpu_physics.download");
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        staging.resize(ballCount);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ballBuffers[current]);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, ballCount * sizeof(GpuBall), staging.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        BodyStore& store = world.getBodyStore();
+        for (size_t k = 0; k < ballCount; ++k) {
+            const GpuBall& ball = staging[k];
+            store.positions[bodies[k]] = Vector3(ball.positionRadius[0], ball.positionRadius[1], ball.positionRadius[2]);
+            store.velocities[bodies[k]] = Vector3(ball.velocityInverseMass[0], ball.velocityInverseMass[1],
+                                                  ball.velocityInverseMass[2]);
+        }
+    }
+
+    /**
+     * Stop stepping on the GPU (call download() first to keep the GPU state)
+     */
+    void deactivate() {
+        active = false;
+    }
+
+    /**
+     * Advance the simulation by real time, in fixed steps
+     * @param deltaTime Frame time in seconds
+     */
+    void update(float deltaTime) {
+        if (!active) {
+            return;
+        }
+        accumulator += deltaTime;
+        int steps = 0;
+        while (accumulator >= timeStep && steps < maxSubsteps) {
+            step();
+            accumulator -= timeStep;
+            steps++;
+        }
+        if (steps == maxSubsteps) {
+            accumulator = 0.0f;  // Too far behind: drop the backlog
+        }
+    }
+
+    /**
+     * Run one physics step on the GPU
+     */
+    void step() {
+        if (!active || ballCount == 0) {
+            return;
+        }
+        PROFILE_SCOPE("gpu_physics.step");
+        GLuint ballGroups = (GLuint)((ballCount + workGroupSize - 1) / workGroupSize);
+        GLuint tableGroups = tableSize / workGroupSize;
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, cellCountBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, cellStartBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, cellCursorBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, sortedBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, blockSumBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, ballCellBuffer);
+
+        // Broadphase: hash every ball into a bucket and sort them by bucket
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ballBuffers[current]);
+        gridProgram.use();
+        setGridUniforms(gridProgram);
+        ShaderProgram::setUnsigned(gridProgram.getUniformLocation("stage"), 0);
+        glDispatchCompute(tableGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        ShaderProgram::setUnsigned(gridProgram.getUniformLocation("stage"), 1);
+        glDispatchCompute(ballGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        scanProgram.use();
+        ShaderProgram::setUnsigned(scanProgram.getUniformLocation("tableSize"), tableSize);
+        ShaderProgram::setUnsigned(scanProgram.getUniformLocation("blockCount"), tableGroups);
+        ShaderProgram::setUnsigned(scanProgram.getUniformLocation("stage"), 0);
+        glDispatchCompute(tableGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        ShaderProgram::setUnsigned(scanProgram.getUniformLocation("stage"), 1);
+        glDispatchCompute(1, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        ShaderProgram::setUnsigned(scanProgram.getUniformLocation("stage"), 2);
+        glDispatchCompute(tableGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        gridProgram.use();
+        ShaderProgram::setUnsigned(gridProgram.getUniformLocation("stage"), 2);
+        glDispatchCompute(ballGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        // Resolution: Jacobi passes from one state buffer into the other
+        collideProgram.use();
+        setGridUniforms(collideProgram);
+        ShaderProgram::setFloat(collideProgram.getUniformLocation("penetrationSlop"), penetrationSlop);
+        ShaderProgram::setFloat(collideProgram.getUniformLocation("correction"), correction);
+        ShaderProgram::setFloat(collideProgram.getUniformLocation("restitutionThreshold"), restitutionThreshold);
+        for (int pass = 0; pass < solverPasses; ++pass) {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ballBuffers[current]);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ballBuffers[1 - current]);
+            glDispatchCompute(ballGroups, 1, 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            current = 1 - current;
+        }
+
+        // Integration and world boundaries, in place on the latest state
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ballBuffers[current]);
+        integrateProgram.use();
+        ShaderProgram::setUnsigned(integrateProgram.getUniformLocation("ballCount"), (unsigned int)ballCount);
+        ShaderProgram::setFloat(integrateProgram.getUniformLocation("deltaTime"), timeStep);
+        ShaderProgram::setVector3(integrateProgram.getUniformLocation("gravity"), gravity);
+        ShaderProgram::setFloat(integrateProgram.getUniformLocation("airResistance"), airResistance);
+        glDispatchCompute(ballGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        boundariesProgram.use();
+        ShaderProgram::setUnsigned(boundariesProgram.getUniformLocation("ballCount"), (unsigned int)ballCount);
+        ShaderProgram::setVector3(boundariesProgram.getUniformLocation("boundsMin"),
+                                  Vector3(bounds[0], bounds[2], bounds[4]));
+        ShaderProgram::setVector3(boundariesProgram.getUniformLocation("boundsMax"),
+                                  Vector3(bounds[1], bounds[3], bounds[5]));
+        glDispatchCompute(ballGroups, 1, 1);
+
+        // The renderer reads the state buffer as instance attributes next
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        glUseProgram(0);
+        stepCount++;
+    }
+
+    /**
+     * Get the buffer holding the latest ball state
+     * @return GL buffer of ballCount GpuBall records
+     */
+    unsigned int getBallBuffer() const {
+        return ballBuffers[current];
+    }
+
+    /**
+     * Get the number of balls on the GPU
+     * @return Ball count
+     */
+    size_t getBallCount() const {
+        return ballCount;
+    }
+
+    /**
+     * Get the number of steps run since upload() started the backend
+     * @return Step count
+     */
+    uint64_t getStepCount() const {
+        return stepCount;
+    }
+
+    /**
+     * Delete the GL objects
+     */
+    void cleanup() {
+        if (ballBuffers[0] != 0) {
+            glDeleteBuffers(2, ballBuffers);
+            glDeleteBuffers(1, &cellCountBuffer);
+            glDeleteBuffers(1, &cellStartBuffer);
+            glDeleteBuffers(1, &cellCursorBuffer);
+            glDeleteBuffers(1, &sortedBuffer);
+            glDeleteBuffers(1, &blockSumBuffer);
+            glDeleteBuffers(1, &ballCellBuffer);
+            ballBuffers[0] = ballBuffers[1] = 0;
+        }
+        ballCapacity = 0;
+        gridTableSize = 0;
+        gridProgram.destroy();
+        scanProgram.destroy();
+        collideProgram.destroy();
+        integrateProgram.destroy();
+        boundariesProgram.destroy();
+        available = false;
+        active = false;
+    }
+
+private:
+    /**
+     * Check that every body is a sphere
+     * @param store Bodies to check
+     * @param error Receives a description on failure
+     * @return False if some body has another shape
+     */
+    static bool checkShapes(const BodyStore& store, std::string& error) {
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (store.shapes[i] != (uint8_t)ShapeType::Sphere) {
+                error = "GPU physics only simulates spheres; remove the boxes, capsules and planes first";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Lay out one body as a GPU ball
+     * @param store Body store
+     * @param i Dense index of the body
+     * @return Ball record
+     */
+    static GpuBall makeBall(const BodyStore& store, uint32_t i) {
+        const Vector3& p = store.positions[i];
+        const Vector3& v = store.velocities[i];
+        const Vector3& c = store.colors[i];
+        bool fixed = (store.flags[i] & (BODY_STATIC | BODY_HELD)) != 0;
+        GpuBall ball = {
+            { p.x, p.y, p.z, store.radii[i] },
+            { v.x, v.y, v.z, fixed ? 0.0f : store.inverseMasses[i] },
+            { c.x, c.y, c.z, store.restitutions[i] },
+            { store.frictions[i], store.spinDampings[i], (store.flags[i] & BODY_BALL) ? 1.0f : 0.0f, 0.0f }
+        };
+        return ball;
+    }
+
+    /**
+     * Copy the world settings the shaders use
+     * @param world Source world
+     */
+    void captureSettings(const PhysicsWorld& world) {
+        std::copy(world.getWorldBounds(), world.getWorldBounds() + 6, bounds);
+        gravity = world.getGravity();
+        timeStep = world.getTimeStep();
+    }
+
+    /**
+     * Stage every active body and write them all into the current state buffer
+     * @param world World to take the bodies from
+     */
+    void uploadAll(const PhysicsWorld& world) {
+        const BodyStore& store = world.getBodyStore();
+        bodies.clear();
+        staging.clear();
+        float maxRadius = 0.0f;
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (!(store.flags[i] & BODY_ACTIVE)) {
+                continue;
+            }
+            staging.push_back(makeBall(store, (uint32_t)i));
+            bodies.push_back((uint32_t)i);
+            maxRadius = std::max(maxRadius, store.radii[i]);
+        }
+
+        ballCount = staging.size();
+        cellSize = std::max(2.0f * maxRadius, 0.001f);
+        tableSize = workGroupSize;
+        while (tableSize < ballCount) {
+            tableSize *= 2;
+        }
+        captureSettings(world);
+
+        allocateBuffers();
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ballBuffers[current]);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, ballCount * sizeof(GpuBall), staging.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    /**
+     * Size the state and grid buffers for the current ball count and table size
+     * State buffers grow geometrically; grid buffers are only reallocated when
+     * the table size changes
+     */
+    void allocateBuffers() {
+        if (ballCount > ballCapacity || ballCapacity == 0) {
+            ballCapacity = std::max(std::max(ballCount, ballCapacity * 2), (size_t)workGroupSize);
+            for (unsigned int buffer : ballBuffers) {
+                resizeBuffer(buffer, ballCapacity * sizeof(GpuBall));
+            }
+            resizeBuffer(sortedBuffer, ballCapacity * sizeof(uint32_t));
+            resizeBuffer(ballCellBuffer, ballCapacity * sizeof(uint32_t));
+        }
+        if (tableSize != gridTableSize) {
+            resizeBuffer(cellCountBuffer, tableSize * sizeof(uint32_t));
+            resizeBuffer(cellStartBuffer, tableSize * sizeof(uint32_t));
+            resizeBuffer(cellCursorBuffer, tableSize * sizeof(uint32_t));
+            resizeBuffer(blockSumBuffer, (tableSize / workGroupSize) * sizeof(uint32_t));
+            gridTableSize = tableSize;
+        }
+    }
+
+    /**
+     * Give a buffer fresh storage of a size
+     */
+    static void resizeBuffer(unsigned int buffer, size_t bytes) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)bytes, NULL, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    /**
+     * Set the hash grid uniforms shared by the grid and collide programs
+     */
+    void setGridUniforms(const ShaderProgram& program) const {
+        ShaderProgram::setUnsigned(program.getUniformLocation("ballCount"), (unsigned int)ballCount);
+        ShaderProgram::setUnsigned(program.getUniformLocation("tableSize"), tableSize);
+        ShaderProgram::setFloat(program.getUniformLocation("cellSize"), cellSize);
+        ShaderProgram::setVector3(program.getUniformLocation("gridOrigin"), Vector3(bounds[0], bounds[2], bounds[4]));
+    }
+};
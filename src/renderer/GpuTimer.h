@@ -0,0 +1,102 @@
+#pragma once
+#include <glad/glad.h>
+#include "../physics/Profiler.h"
+#include <cstdint>
+
+/**
+ * GpuTimer measures the GPU time of one render pass with GL_TIME_ELAPSED queries
+ * Results only become available a few frames later, so each timer cycles
+ * through a small ring of queries and collect() reads back the finished ones
+ * without ever waiting on the GPU. Times are charged to a GPU zone of the
+ * Profiler. Only one GL_TIME_ELAPSED query may be active at a time, so timed
+ * passes must not nest.
+ */
+class GpuTimer {
+private:
+    static constexpr int queryCount = 4;    // Frames a result may lag behind before a frame goes untimed
+
+    unsigned int queries[queryCount];       // Query objects, used round robin
+    bool pending[queryCount];               // Query issued but its result not read yet
+    int next;                               // Query the next begin() uses
+    int zone;                               // Profiler zone the results are charged to
+    bool active;                            // A query is open between begin() and end()
+
+public:
+    /**
+     * Constructor - creates no GL objects until initialize()
+     */
+    GpuTimer()
+        : queries()
+        , pending()
+        , next(0)
+        , zone(-1)
+        , active(false) {
+    }
+
+    /**
+     * Create the query objects - must be called after the OpenGL context is created
+     * @param name Profiler zone name (a string literal)
+     */
+    void initialize(const char* name) {
+        glGenQueries(queryCount, queries);
+        zone = Profiler::get().registerZone(name, true);
+    }
+
+    /**
+     * Delete the query objects
+     */
+    void cleanup() {
+        if (queries[0] != 0) {
+            glDeleteQueries(queryCount, queries);
+            for (int i = 0; i < queryCount; ++i) {
+                queries[i] = 0;
+                pending[i] = false;
+            }
+        }
+    }
+
+    /**
+     * Start timing the pass (skipped while profiling is off or every query is still in flight)
+     */
+    void begin() {
+        if (!PHYSICS_PROFILING || queries[0] == 0 || !Profiler::get().isEnabled() || pending[next]) {
+            return;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+        active = true;
+    }
+
+    /**
+     * Stop timing the pass
+     */
+    void end() {
+        if (!active) {
+            return;
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        pending[next] = true;
+        next = (next + 1) % queryCount;
+        active = false;
+    }
+
+    /**
+     * Charge every finished query to the profiler, oldest first
+     */
+    void collect() {
+        for (int k = 0; k < queryCount; ++k) {
+            int i = (next + k) % queryCount;
+            if (!pending[i]) {
+                continue;
+            }
+            GLint available = 0;
+            glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                break;  // Queries finish in order, so newer ones are not ready either
+            }
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &nanoseconds);
+            Profiler::get().addGpuTime(zone, nanoseconds);
+            pending[i] = false;
+        }
+    }
+};
@@ -1,19 +1,32 @@
 #pragma once
 #define _USE_MATH_DEFINES
 #include "Camera.h"
-#include "../physics/PhysicsWorld.h"
+#include "ShaderProgram.h"
+#include "Frustum.h"
+#include "GpuTimer.h"
+#include "GpuPhysics.h"
+#include "../physics/PhysicsSnapshot.h"
+#include "../physics/VectorMath.h"
 #include <GL/gl.h>
 #include <string>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+/**
+ * Mesh types, each drawn with the cheapest shader its transforms allow
+ */
+enum class MeshType {
+    Sphere,     // Translate + uniform scale, instanced; normals need no transform
+    Cube        // Translate + per-axis scale; normals use a CPU-computed normal matrix
+};
+
 /**
  * Renderer class manages all OpenGL rendering operations
  * Handles shader compilation, mesh generation, and 3D object rendering
@@ -21,10 +34,13 @@
 class Renderer {
 private:
     // OpenGL objects
-    unsigned int shaderProgram;     // Compiled shader program
+    ShaderProgram meshShader;       // Shader program for meshes drawn with a model + normal matrix
+    ShaderProgram sphereShader;     // Shader program for instanced uniform-scale spheres
+    unsigned int frameUBO;          // Uniform buffer holding FrameUniforms
     unsigned int sphereVAO;         // Vertex Array Object for sphere
     unsigned int sphereVBO;         // Vertex Buffer Object for sphere
     unsigned int sphereEBO;         // Element Buffer Object for sphere
+    unsigned int instanceVBO;       // Per-instance sphere data, streamed every frame
     unsigned int cubeVAO;           // VAO for room walls
     unsigned int cubeVBO;           // VBO for room walls
     unsigned int cubeEBO;           // EBO for room walls
@@ -32,13 +48,74 @@ private:
     // Sphere mesh data
     std::vector<float> sphereVertices;
     std::vector<unsigned int> sphereIndices;
-    int sphereIndexCount;
+    
+    /**
+     * One tessellation level of the sphere mesh, stored as a range of sphereIndices
+     */
+    struct SphereLod {
+        int rings;                  // Horizontal rings
+        int sectors;                // Vertical sectors
+        float minScreenRadius;      // Smallest projected radius (pixels) that uses this level
+        size_t indexOffset;         // First index in sphereEBO
+        int indexCount;             // Number of indices
+    };
+    std::vector<SphereLod> sphereLods;            // Finest first
+    std::vector<unsigned char> ballLods;          // Scratch: LOD picked for each ball this frame
+    std::vector<float> ballDistances;             // Scratch: camera distance of each visible ball
+    std::vector<size_t> lodStart;                 // Scratch: first instance of each LOD bucket
+    float lodBias;                                // Scales projected radii before picking an LOD (< 1 is coarser)
+    
+    // Frustum culling
+    Frustum frustum;                              // View frustum of the current frame
+    std::vector<uint32_t> visibleBalls;           // Snapshot indices of balls that passed culling
+    
+    // GPU physics
+    const GpuPhysics* gpuPhysics;                 // Balls drawn straight from its state buffer while active
+    static constexpr size_t gpuDenseBallCount = 50000;  // Above this the GPU path draws the coarsest LOD
+    
+    /**
+     * Per-instance sphere attributes as laid out in instanceVBO
+     */
+    struct SphereInstance {
+        float x, y, z;              // Sphere center
+        float radius;               // Sphere radius
+        float r, g, b;              // Sphere color
+    };
+    std::vector<SphereInstance> sphereInstances;  // CPU staging for instanceVBO
+    size_t instanceCapacity;                      // Instances instanceVBO has storage for
+    
+    /**
+     * Per-frame shader data, laid out to match the std140 FrameData block
+     */
+    struct FrameUniforms {
+        float view[16];             // View matrix
+        float projection[16];       // Projection matrix
+        float lightPos[3];          // Light position
+        float shininess;            // Specular exponent
+        float lightColor[3];        // Light color
+        float padding0;             // std140: vec3 members start on 16-byte boundaries
+        float viewPos[3];           // Camera position
+        float padding1;             // std140: block size rounds up to 16 bytes
+    };
+    static_assert(sizeof(FrameUniforms) == 176, "FrameUniforms must match the std140 FrameData layout");
+    static constexpr unsigned int frameBindingPoint = 0;  // UBO binding point of FrameData
+    
+    // Cached uniform locations of meshShader
+    int meshModelLocation;          // "model"
+    int meshNormalMatrixLocation;   // "normalMatrix"
+    int meshColorLocation;          // "objectColor"
     
     // Cube mesh data (for room walls)
     std::vector<float> cubeVertices;
     std::vector<unsigned int> cubeIndices;
     int cubeIndexCount;
     
+    // Profiling
+    GpuTimer roomGpuTimer;          // GPU time of the room pass
+    GpuTimer ballGpuTimer;          // GPU time of the instanced ball pass
+    GpuTimer overlayGpuTimer;       // GPU time of the crosshair overlay
+    uint32_t drawCalls;             // Draw calls issued by the last render()
+    
     // Lighting properties
     Vector3 lightPos;
     Vector3 lightColor;
@@ -54,15 +131,22 @@ public:
      * @param height Window height
      */
     Renderer(int width, int height) 
-        : shaderProgram(0)
+        : frameUBO(0)
         , sphereVAO(0)
         , sphereVBO(0)
         , sphereEBO(0)
+        , instanceVBO(0)
         , cubeVAO(0)
         , cubeVBO(0)
         , cubeEBO(0)
-        , sphereIndexCount(0)
+        , lodBias(1.0f)
+        , gpuPhysics(nullptr)
+        , instanceCapacity(0)
+        , meshModelLocation(-1)
+        , meshNormalMatrixLocation(-1)
+        , meshColorLocation(-1)
         , cubeIndexCount(0)
+        , drawCalls(0)
         , lightPos(0.0f, 8.0f, 0.0f)
         , lightColor(1.0f, 1.0f, 1.0f)
         , windowWidth(width)
@@ -98,52 +182,116 @@ public:
             return false;
         }
         
-        // Generate sphere mesh
-        generateSphere(1.0f, 32, 16);
+        // Generate sphere meshes, finest to coarsest
+        generateSphereLods();
         
         // Generate cube mesh for room walls
         generateCube();
         
+        // Timer queries for the perf console command
+        roomGpuTimer.initialize("gpu.room");
+        ballGpuTimer.initialize("gpu.balls");
+        overlayGpuTimer.initialize("gpu.overlay");
+        
         return true;
     }
 
     /**
      * Render the entire scene
      * @param camera Camera for view/projection matrices
-     * @param physicsWorld Physics world containing all objects to render
+     * @param snapshot Latest physics snapshot containing all objects to render
+     * @param alpha Interpolation factor between the snapshot's start and end of tick
      * @param deltaTime Time elapsed since last frame
      */
-    void render(const Camera& camera, const PhysicsWorld& physicsWorld, float deltaTime) {
+    void render(const Camera& camera, const PhysicsSnapshot& snapshot, float alpha, float deltaTime) {
+        PROFILE_SCOPE("render");
+        drawCalls = 0;
+        
+        // Pick up GPU times of earlier frames that have finished
+        roomGpuTimer.collect();
+        ballGpuTimer.collect();
+        overlayGpuTimer.collect();
+        
         // Clear the screen
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
-        // Use our shader program
-        glUseProgram(shaderProgram);
-        
         // Set up view and projection matrices
-        float viewMatrix[16];
-        float projMatrix[16];
-        camera.getViewMatrix(viewMatrix);
-        camera.getProjectionMatrix((float)windowWidth / (float)windowHeight, projMatrix);
+        Mat4 viewMatrix = camera.getViewMatrix();
+        Mat4 projMatrix = camera.getProjectionMatrix((float)windowWidth / (float)windowHeight);
         
-        // Set matrix uniforms
-        setMatrix4("view", viewMatrix);
-        setMatrix4("projection", projMatrix);
-        
-        // Set lighting uniforms
-        setVector3("lightPos", lightPos);
-        setVector3("lightColor", lightColor);
-        setVector3("viewPos", camera.getPosition());
-        setFloat("shininess", 32.0f);
+        // Upload camera and lighting once for every program
+        updateFrameUniforms(camera, viewMatrix, projMatrix);
         
         // Render room walls
-        renderRoom(physicsWorld);
-        
-        // Render all balls
-        renderBalls(physicsWorld);
+        roomGpuTimer.begin();
+        shaderFor(MeshType::Cube).use();
+        renderRoom(snapshot);
+        renderBoxes(snapshot, alpha);
+        roomGpuTimer.end();
+        
+        // Render all balls that survive frustum culling, or every GPU-simulated ball
+        bool gpuBalls = gpuPhysics && gpuPhysics->isActive();
+        if (!gpuBalls) {
+            PROFILE_SCOPE("render.cull");
+            frustum.extract(viewMatrix, projMatrix);
+            cullBalls(snapshot, alpha);
+        }
+        ballGpuTimer.begin();
+        shaderFor(MeshType::Sphere).use();
+        if (gpuBalls) {
+            renderGpuBalls();
+        } else {
+            renderBalls(snapshot, alpha, camera, projMatrix);
+        }
+        ballGpuTimer.end();
         
         // Render crosshair/reticle
+        overlayGpuTimer.begin();
         renderCrosshair();
+        overlayGpuTimer.end();
+    }
+
+    /**
+     * Get the number of balls that passed frustum culling in the last frame
+     * @return Visible ball count
+     */
+    size_t getVisibleBallCount() const {
+        if (gpuPhysics && gpuPhysics->isActive()) {
+            return gpuPhysics->getBallCount();
+        }
+        return visibleBalls.size();
+    }
+
+    /**
+     * Set the GPU physics backend whose balls are drawn while it is active
+     * @param physics Backend, or nullptr to always draw from the snapshot
+     */
+    void setGpuPhysics(const GpuPhysics* physics) {
+        gpuPhysics = physics;
+    }
+
+    /**
+     * Bias the sphere LOD choice
+     * @param bias Factor on each ball's projected radius (1 = as tuned, lower picks coarser meshes sooner)
+     */
+    void setLodBias(float bias) {
+        lodBias = std::max(bias, 0.01f);
+    }
+
+    /**
+     * Get the sphere LOD bias
+     * @return Factor on each ball's projected radius
+     */
+    float getLodBias() const {
+        return lodBias;
+    }
+
+    /**
+     * Get the number of draw calls issued in the last frame
+     * @return Draw call count
+     */
+    uint32_t getDrawCallCount() const {
+        return drawCalls;
     }
 
     /**
@@ -179,112 +327,67 @@ private:
      * @return True if successful, false otherwise
      */
     bool loadShaders() {
-        // Load vertex shader source
-        std::string vertexSource = loadShaderFile("shaders/vertex.glsl");
-        if (vertexSource.empty()) {
-            std::cerr << "Failed to load vertex shader!" << std::endl;
+        // Model-matrix path for the room, instanced path for the balls
+        if (!meshShader.load("shaders/mesh_vertex.glsl", "shaders/fragment.glsl") ||
+            !sphereShader.load("shaders/vertex.glsl", "shaders/fragment.glsl")) {
             return false;
         }
         
-        // Load fragment shader source
-        std::string fragmentSource = loadShaderFile("shaders/fragment.glsl");
-        if (fragmentSource.empty()) {
-            std::cerr << "Failed to load fragment shader!" << std::endl;
-            return false;
-        }
+        meshModelLocation = meshShader.getUniformLocation("model");
+        meshNormalMatrixLocation = meshShader.getUniformLocation("normalMatrix");
+        meshColorLocation = meshShader.getUniformLocation("objectColor");
         
-        // Compile vertex shader
-        unsigned int vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
-        if (vertexShader == 0) {
-            return false;
-        }
-        
-        // Compile fragment shader
-        unsigned int fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
-        if (fragmentShader == 0) {
-            glDeleteShader(vertexShader);
-            return false;
-        }
-        
-        // Create shader program
-        shaderProgram = glCreateProgram();
-        glAttachShader(shaderProgram, vertexShader);
-        glAttachShader(shaderProgram, fragmentShader);
-        glLinkProgram(shaderProgram);
-        
-        // Check for linking errors
-        int success;
-        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-            std::cerr << "Shader program linking failed: " << infoLog << std::endl;
-            
-            glDeleteShader(vertexShader);
-            glDeleteShader(fragmentShader);
-            glDeleteProgram(shaderProgram);
-            return false;
-        }
+        // Both programs read camera and lighting from the shared frame UBO
+        meshShader.bindUniformBlock("FrameData", frameBindingPoint);
+        sphereShader.bindUniformBlock("FrameData", frameBindingPoint);
         
-        // Clean up shader objects
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+        glGenBuffers(1, &frameUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, frameBindingPoint, frameUBO);
         
         return true;
     }
 
     /**
-     * Load shader source code from file
-     * @param filePath Path to shader file
-     * @return Shader source code as string
+     * Generate the chain of sphere LODs and upload them into one vertex/index buffer
      */
-    std::string loadShaderFile(const std::string& filePath) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open shader file: " << filePath << std::endl;
-            return "";
-        }
+    void generateSphereLods() {
+        // { rings, sectors, minimum projected radius in pixels }
+        static const struct { int rings; int sectors; float minScreenRadius; } levels[] = {
+            { 32, 16, 40.0f },
+            { 20, 12, 16.0f },
+            { 12,  8,  6.0f },
+            {  6,  6,  0.0f }
+        };
         
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
-    }
-
-    /**
-     * Compile a shader from source code
-     * @param source Shader source code
-     * @param type Shader type (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)
-     * @return Shader object ID, or 0 if compilation failed
-     */
-    unsigned int compileShader(const std::string& source, unsigned int type) {
-        unsigned int shader = glCreateShader(type);
-        const char* src = source.c_str();
-        glShaderSource(shader, 1, &src, NULL);
-        glCompileShader(shader);
-        
-        // Check for compilation errors
-        int success;
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetShaderInfoLog(shader, 512, NULL, infoLog);
-            std::cerr << "Shader compilation failed: " << infoLog << std::endl;
-            glDeleteShader(shader);
-            return 0;
+        sphereVertices.clear();
+        sphereIndices.clear();
+        sphereLods.clear();
+        
+        for (const auto& level : levels) {
+            SphereLod lod;
+            lod.rings = level.rings;
+            lod.sectors = level.sectors;
+            lod.minScreenRadius = level.minScreenRadius;
+            lod.indexOffset = sphereIndices.size();
+            generateSphere(1.0f, level.rings, level.sectors);
+            lod.indexCount = (int)(sphereIndices.size() - lod.indexOffset);
+            sphereLods.push_back(lod);
         }
         
-        return shader;
+        createSphereBuffers();
     }
 
     /**
-     * Generate a sphere mesh with given parameters
+     * Append a sphere mesh with given parameters to sphereVertices/sphereIndices
      * @param radius Sphere radius
      * @param rings Number of horizontal rings
      * @param sectors Number of vertical sectors
      */
     void generateSphere(float radius, int rings, int sectors) {
-        sphereVertices.clear();
-        sphereIndices.clear();
+        unsigned int baseVertex = (unsigned int)(sphereVertices.size() / 8);
         
         // Generate vertices
         for (int ring = 0; ring <= rings; ring++) {
@@ -321,7 +424,7 @@ private:
         // Generate indices
         for (int ring = 0; ring < rings; ring++) {
             for (int sector = 0; sector < sectors; sector++) {
-                int first = ring * (sectors + 1) + sector;
+                int first = baseVertex + ring * (sectors + 1) + sector;
                 int second = first + sectors + 1;
                 
                 // First triangle
@@ -336,8 +439,12 @@ private:
             }
         }
         
-        sphereIndexCount = sphereIndices.size();
-        
+    }
+
+    /**
+     * Create the sphere VAO from sphereVertices/sphereIndices plus the instance buffer
+     */
+    void createSphereBuffers() {
         // Create OpenGL objects
         glGenVertexArrays(1, &sphereVAO);
         glGenBuffers(1, &sphereVBO);
@@ -363,6 +470,18 @@ private:
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
         glEnableVertexAttribArray(2);
         
+        // Per-instance attributes, advanced once per sphere
+        glGenBuffers(1, &instanceVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), (void*)0);
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+        
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(4);
+        glVertexAttribDivisor(4, 1);
+        
         glBindVertexArray(0);
     }
 
@@ -456,90 +575,231 @@ private:
     }
 
     /**
-     * Render all balls in the physics world
-     * @param physicsWorld Physics world containing balls
+     * Collect the balls that intersect the view frustum into visibleBalls
+     * Whole clusters are rejected or accepted by their bounds; only clusters
+     * straddling a frustum plane are tested ball by ball
+     * @param snapshot Snapshot containing the active balls
+     * @param alpha Interpolation factor between the snapshot's start and end of tick
      */
-    void renderBalls(const PhysicsWorld& physicsWorld) {
-        std::vector<Ball*> balls = physicsWorld.getBalls();
-        
-        glBindVertexArray(sphereVAO);
+    void cullBalls(const PhysicsSnapshot& snapshot, float alpha) {
+        visibleBalls.clear();
+        size_t clusters = snapshot.clusterCount();
+        for (size_t c = 0; c < clusters; ++c) {
+            size_t begin = snapshot.clusterStart[c];
+            size_t end = snapshot.clusterStart[c + 1];
+            int side = frustum.classifyBox(snapshot.clusterMin[c], snapshot.clusterMax[c]);
+            if (side < 0) {
+                continue;
+            }
+            if (side > 0) {
+                for (size_t i = begin; i < end; ++i) {
+                    visibleBalls.push_back((uint32_t)i);
+                }
+                continue;
+            }
+            frustum.cullSpheres(snapshot.previousPositions.data(), snapshot.positions.data(),
+                                snapshot.radii.data(), alpha, begin, end, visibleBalls);
+        }
+    }
+
+    /**
+     * Render the visible balls of a physics snapshot
+     * Balls are bucketed by LOD and each bucket is drawn with one instanced call
+     * @param snapshot Snapshot containing the active balls
+     * @param alpha Interpolation factor between the snapshot's start and end of tick
+     * @param camera Camera used to pick LODs
+     * @param projMatrix Projection matrix used to pick LODs
+     */
+    void renderBalls(const PhysicsSnapshot& snapshot, float alpha, const Camera& camera, const Mat4& projMatrix) {
+        PROFILE_SCOPE("render.balls");
+        size_t count = visibleBalls.size();
+        if (count == 0) {
+            return;
+        }
         
-        for (Ball* ball : balls) {
-            if (!ball->isActive) continue;
+        // Pixels covered by one world unit at distance 1, biased by the quality setting
+        float pixelScale = projMatrix.at(1, 1) * windowHeight * 0.5f * lodBias;
+        Vector3 cameraPos = camera.getPosition();
+        size_t lodCount = sphereLods.size();
+        
+        // Pick an LOD per ball from its projected radius and count each bucket
+        ballLods.resize(count);
+        ballDistances.resize(count);
+        lodStart.assign(lodCount + 1, 0);
+        VectorMath::fastDistances(snapshot.positions.data(), visibleBalls.data(), count, cameraPos,
+                                  ballDistances.data());
+        for (size_t v = 0; v < count; ++v) {
+            uint32_t i = visibleBalls[v];
+            float distance = ballDistances[v];
+            float screenRadius = distance > snapshot.radii[i]
+                ? snapshot.radii[i] * pixelScale / distance
+                : sphereLods[0].minScreenRadius;
             
-            // Create model matrix for this ball
-            float modelMatrix[16];
-            createModelMatrix(ball->position, Vector3(ball->radius, ball->radius, ball->radius), modelMatrix);
+            size_t lod = 0;
+            while (lod + 1 < lodCount && screenRadius < sphereLods[lod].minScreenRadius) {
+                lod++;
+            }
+            ballLods[v] = (unsigned char)lod;
+            lodStart[lod + 1]++;
+        }
+        for (size_t lod = 0; lod < lodCount; ++lod) {
+            lodStart[lod + 1] += lodStart[lod];
+        }
+        
+        // Pack interpolated instances on the CPU, grouped by LOD
+        sphereInstances.resize(count);
+        for (size_t v = 0; v < count; ++v) {
+            uint32_t i = visibleBalls[v];
+            Vector3 position = snapshot.interpolatedPosition(i, alpha);
+            const Vector3& color = snapshot.colors[i];
+            sphereInstances[lodStart[ballLods[v]]++] = { position.x, position.y, position.z, snapshot.radii[i],
+                                                         color.x, color.y, color.z };
+        }
+        // The fill pass advanced each start to the next bucket's start; shift back
+        for (size_t lod = lodCount; lod > 0; --lod) {
+            lodStart[lod] = lodStart[lod - 1];
+        }
+        lodStart[0] = 0;
+        
+        uploadInstances();
+        
+        // One instanced draw per non-empty LOD bucket
+        glBindVertexArray(sphereVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        for (size_t lod = 0; lod < lodCount; ++lod) {
+            size_t first = lodStart[lod];
+            size_t instances = lodStart[lod + 1] - first;
+            if (instances == 0) {
+                continue;
+            }
             
-            // Set uniforms
-            setMatrix4("model", modelMatrix);
-            setVector3("objectColor", ball->color);
+            // GL 3.3 has no base instance, so point the instance attributes at the bucket
+            size_t offset = first * sizeof(SphereInstance);
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), (void*)offset);
+            glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), (void*)(offset + 4 * sizeof(float)));
             
-            // Render the sphere
-            glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+            const SphereLod& mesh = sphereLods[lod];
+            glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT,
+                                    (void*)(mesh.indexOffset * sizeof(unsigned int)), (GLsizei)instances);
+            drawCalls++;
         }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    /**
+     * Render the balls of the GPU physics backend straight from its state buffer
+     * The state buffer is bound as the instance attribute source, so nothing is
+     * read back or re-uploaded. There is no per-ball culling or LOD selection on
+     * this path: every ball uses one mesh picked from the ball count.
+     */
+    void renderGpuBalls() {
+        PROFILE_SCOPE("render.gpu_balls");
+        size_t count = gpuPhysics->getBallCount();
+        if (count == 0) {
+            return;
+        }
+        size_t lod = count > gpuDenseBallCount ? sphereLods.size() - 1 : std::min<size_t>(1, sphereLods.size() - 1);
+        const SphereLod& mesh = sphereLods[lod];
         
+        glBindVertexArray(sphereVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, gpuPhysics->getBallBuffer());
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(GpuPhysics::GpuBall),
+                              (void*)offsetof(GpuPhysics::GpuBall, positionRadius));
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(GpuPhysics::GpuBall),
+                              (void*)offsetof(GpuPhysics::GpuBall, colorRestitution));
+        glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT,
+                                (void*)(mesh.indexOffset * sizeof(unsigned int)), (GLsizei)count);
+        drawCalls++;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
     }
 
+    /**
+     * Stream sphereInstances into instanceVBO
+     * The buffer is orphaned every frame so the driver can hand back fresh storage
+     * instead of waiting for the GPU to finish reading last frame's data
+     */
+    void uploadInstances() {
+        size_t count = sphereInstances.size();
+        if (count > instanceCapacity) {
+            instanceCapacity = std::max(count, instanceCapacity * 2);
+        }
+        
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SphereInstance), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SphereInstance), sphereInstances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     /**
      * Render the room walls
-     * @param physicsWorld Physics world for boundary information
+     * @param snapshot Physics snapshot for boundary information
      */
-    void renderRoom(const PhysicsWorld& physicsWorld) {
-        const float* bounds = physicsWorld.getWorldBounds();
+    void renderRoom(const PhysicsSnapshot& snapshot) {
+        PROFILE_SCOPE("render.room");
+        const float* bounds = snapshot.worldBounds;
         
         glBindVertexArray(cubeVAO);
         
         // Set room wall color (light gray)
-        setVector3("objectColor", Vector3(0.8f, 0.8f, 0.8f));
+        ShaderProgram::setVector3(meshColorLocation, Vector3(0.8f, 0.8f, 0.8f));
         
         // Render floor
-        float floorMatrix[16];
-        createModelMatrix(Vector3(0, bounds[2] - 0.1f, 0), Vector3(bounds[1] - bounds[0], 0.1f, bounds[5] - bounds[4]), floorMatrix);
-        setMatrix4("model", floorMatrix);
+        setModelMatrix(Mat4::translationScale(Vector3(0, bounds[2] - 0.1f, 0), Vector3(bounds[1] - bounds[0], 0.1f, bounds[5] - bounds[4])));
         glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
         
         // Render ceiling
-        float ceilingMatrix[16];
-        createModelMatrix(Vector3(0, bounds[3] + 0.1f, 0), Vector3(bounds[1] - bounds[0], 0.1f, bounds[5] - bounds[4]), ceilingMatrix);
-        setMatrix4("model", ceilingMatrix);
+        setModelMatrix(Mat4::translationScale(Vector3(0, bounds[3] + 0.1f, 0), Vector3(bounds[1] - bounds[0], 0.1f, bounds[5] - bounds[4])));
         glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
         
         // Render walls
         float wallThickness = 0.1f;
         
         // Left wall
-        float leftWallMatrix[16];
-        createModelMatrix(Vector3(bounds[0] - wallThickness, (bounds[2] + bounds[3]) / 2, 0), 
-                         Vector3(wallThickness, bounds[3] - bounds[2], bounds[5] - bounds[4]), leftWallMatrix);
-        setMatrix4("model", leftWallMatrix);
+        setModelMatrix(Mat4::translationScale(Vector3(bounds[0] - wallThickness, (bounds[2] + bounds[3]) / 2, 0), 
+                                              Vector3(wallThickness, bounds[3] - bounds[2], bounds[5] - bounds[4])));
         glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
         
         // Right wall
-        float rightWallMatrix[16];
-        createModelMatrix(Vector3(bounds[1] + wallThickness, (bounds[2] + bounds[3]) / 2, 0), 
-                         Vector3(wallThickness, bounds[3] - bounds[2], bounds[5] - bounds[4]), rightWallMatrix);
-        setMatrix4("model", rightWallMatrix);
+        setModelMatrix(Mat4::translationScale(Vector3(bounds[1] + wallThickness, (bounds[2] + bounds[3]) / 2, 0), 
+                                              Vector3(wallThickness, bounds[3] - bounds[2], bounds[5] - bounds[4])));
         glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
         
         // Back wall
-        float backWallMatrix[16];
-        createModelMatrix(Vector3(0, (bounds[2] + bounds[3]) / 2, bounds[4] - wallThickness), 
-                         Vector3(bounds[1] - bounds[0], bounds[3] - bounds[2], wallThickness), backWallMatrix);
-        setMatrix4("model", backWallMatrix);
+        setModelMatrix(Mat4::translationScale(Vector3(0, (bounds[2] + bounds[3]) / 2, bounds[4] - wallThickness), 
+                                              Vector3(bounds[1] - bounds[0], bounds[3] - bounds[2], wallThickness)));
         glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
         
         // Front wall
-        float frontWallMatrix[16];
-        createModelMatrix(Vector3(0, (bounds[2] + bounds[3]) / 2, bounds[5] + wallThickness), 
-                         Vector3(bounds[1] - bounds[0], bounds[3] - bounds[2], wallThickness), frontWallMatrix);
-        setMatrix4("model", frontWallMatrix);
+        setModelMatrix(Mat4::translationScale(Vector3(0, (bounds[2] + bounds[3]) / 2, bounds[5] + wallThickness), 
+                                              Vector3(bounds[1] - bounds[0], bounds[3] - bounds[2], wallThickness)));
         glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
+        drawCalls += 6;  // Floor, ceiling and four walls
         
         glBindVertexArray(0);
     }
 
+    /**
+     * Render box and capsule bodies with the cube mesh (capsules as their bounding box)
+     * @param snapshot Physics snapshot
+     * @param alpha Interpolation factor between the snapshot's tick start and end
+     */
+    void renderBoxes(const PhysicsSnapshot& snapshot, float alpha) {
+        if (snapshot.boxPositions.empty()) {
+            return;
+        }
+        PROFILE_SCOPE("render.boxes");
+        glBindVertexArray(cubeVAO);
+        for (size_t i = 0; i < snapshot.boxPositions.size(); ++i) {
+            setModelMatrix(Mat4::translationScale(snapshot.interpolatedBoxPosition(i, alpha), snapshot.boxExtents[i]));
+            ShaderProgram::setVector3(meshColorLocation, snapshot.boxColors[i]);
+            glDrawElements(GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0);
+        }
+        drawCalls += (uint32_t)snapshot.boxPositions.size();
+        glBindVertexArray(0);
+    }
+
     /**
      * Render a simple crosshair in the center of the screen
      */
@@ -572,6 +832,7 @@ private:
         glVertex2f(centerX, centerY - size);
         glVertex2f(centerX, centerY + size);
         glEnd();
+        drawCalls++;
         
         // Restore matrices
         glPopMatrix();
@@ -584,67 +845,67 @@ private:
     }
 
     /**
-     * Create a model matrix for positioning and scaling an object
-     * @param position Object position
-     * @param scale Object scale
-     * @param matrix Output matrix array
+     * Fill and upload the per-frame uniform block
+     * @param camera Camera for the view position
+     * @param viewMatrix View matrix
+     * @param projMatrix Projection matrix
      */
-    void createModelMatrix(const Vector3& position, const Vector3& scale, float* matrix) {
-        // Initialize to identity matrix
-        for (int i = 0; i < 16; i++) {
-            matrix[i] = 0.0f;
-        }
-        matrix[0] = scale.x;
-        matrix[5] = scale.y;
-        matrix[10] = scale.z;
-        matrix[15] = 1.0f;
-        
-        // Set translation
-        matrix[12] = position.x;
-        matrix[13] = position.y;
-        matrix[14] = position.z;
+    void updateFrameUniforms(const Camera& camera, const Mat4& viewMatrix, const Mat4& projMatrix) {
+        FrameUniforms frame;
+        std::memcpy(frame.view, viewMatrix.data(), sizeof(frame.view));
+        std::memcpy(frame.projection, projMatrix.data(), sizeof(frame.projection));
+        
+        Vector3 viewPos = camera.getPosition();
+        frame.lightPos[0] = lightPos.x;
+        frame.lightPos[1] = lightPos.y;
+        frame.lightPos[2] = lightPos.z;
+        frame.shininess = 32.0f;
+        frame.lightColor[0] = lightColor.x;
+        frame.lightColor[1] = lightColor.y;
+        frame.lightColor[2] = lightColor.z;
+        frame.padding0 = 0.0f;
+        frame.viewPos[0] = viewPos.x;
+        frame.viewPos[1] = viewPos.y;
+        frame.viewPos[2] = viewPos.z;
+        frame.padding1 = 0.0f;
+        
+        glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
     }
 
     /**
-     * Set a 4x4 matrix uniform in the shader
-     * @param name Uniform name
-     * @param matrix Matrix data
+     * Get the shader program used for a mesh type
+     * @param type Mesh type
+     * @return Shader program
      */
-    void setMatrix4(const std::string& name, const float* matrix) {
-        int location = glGetUniformLocation(shaderProgram, name.c_str());
-        if (location != -1) {
-            glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
-        }
+    ShaderProgram& shaderFor(MeshType type) {
+        return type == MeshType::Sphere ? sphereShader : meshShader;
     }
 
     /**
-     * Set a Vector3 uniform in the shader
-     * @param name Uniform name
-     * @param vector Vector data
+     * Upload a model matrix from Mat4::translationScale and its normal matrix to meshShader
+     * The model is translate + per-axis scale, so the inverse transpose of its
+     * upper 3x3 is just the reciprocal scale and no general inverse is needed
+     * @param modelMatrix Model matrix
      */
-    void setVector3(const std::string& name, const Vector3& vector) {
-        int location = glGetUniformLocation(shaderProgram, name.c_str());
-        if (location != -1) {
-            glUniform3f(location, vector.x, vector.y, vector.z);
-        }
-    }
-
-    /**
-     * Set a float uniform in the shader
-     * @param name Uniform name
-     * @param value Float value
-     */
-    void setFloat(const std::string& name, float value) {
-        int location = glGetUniformLocation(shaderProgram, name.c_str());
-        if (location != -1) {
-            glUniform1f(location, value);
-        }
+    void setModelMatrix(const Mat4& modelMatrix) {
+        float normalMatrix[9] = {
+            1.0f / modelMatrix.at(0, 0), 0.0f, 0.0f,
+            0.0f, 1.0f / modelMatrix.at(1, 1), 0.0f,
+            0.0f, 0.0f, 1.0f / modelMatrix.at(2, 2)
+        };
+        ShaderProgram::setMatrix4(meshModelLocation, modelMatrix.data());
+        ShaderProgram::setMatrix3(meshNormalMatrixLocation, normalMatrix);
     }
 
     /**
      * Clean up OpenGL resources
      */
     void cleanup() {
+        roomGpuTimer.cleanup();
+        ballGpuTimer.cleanup();
+        overlayGpuTimer.cleanup();
         if (sphereVAO != 0) {
             glDeleteVertexArrays(1, &sphereVAO);
             sphereVAO = 0;
@@ -657,6 +918,10 @@ private:
             glDeleteBuffers(1, &sphereEBO);
             sphereEBO = 0;
         }
+        if (instanceVBO != 0) {
+            glDeleteBuffers(1, &instanceVBO);
+            instanceVBO = 0;
+        }
         if (cubeVAO != 0) {
             glDeleteVertexArrays(1, &cubeVAO);
             cubeVAO = 0;
@@ -669,9 +934,11 @@ private:
             glDeleteBuffers(1, &cubeEBO);
             cubeEBO = 0;
         }
-        if (shaderProgram != 0) {
-            glDeleteProgram(shaderProgram);
-            shaderProgram = 0;
+        if (frameUBO != 0) {
+            glDeleteBuffers(1, &frameUBO);
+            frameUBO = 0;
         }
+        meshShader.destroy();
+        sphereShader.destroy();
     }
 }; 
\ No newline at end of file
@@ -0,0 +1,314 @@
+#pragma once
+#include <glad/glad.h>
+#include "../physics/Vector3.h"
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+/**
+ * ShaderProgram wraps a linked vertex + fragment program, or a compute program
+ * Every active uniform location is resolved once at link time and cached, so
+ * setting a uniform never has to ask the driver for a location
+ */
+class ShaderProgram {
+private:
+    unsigned int programId;                                 // OpenGL program object
+    std::unordered_map<std::string, int> uniformLocations;  // Active uniform name -> location
+
+public:
+    /**
+     * Constructor - creates an empty program
+     */
+    ShaderProgram()
+        : programId(0) {
+    }
+
+    /**
+     * Destructor - releases the program
+     */
+    ~ShaderProgram() {
+        destroy();
+    }
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    /**
+     * Load, compile and link a program, then cache its uniform locations
+     * @param vertexPath Path to the vertex shader
+     * @param fragmentPath Path to the fragment shader
+     * @return True if successful, false otherwise
+     */
+    bool load(const std::string& vertexPath, const std::string& fragmentPath) {
+        destroy();
+
+        // Load vertex shader source
+        std::string vertexSource = loadShaderFile(vertexPath);
+        if (vertexSource.empty()) {
+            std::cerr << "Failed to load vertex shader!" << std::endl;
+            return false;
+        }
+
+        // Load fragment shader source
+        std::string fragmentSource = loadShaderFile(fragmentPath);
+        if (fragmentSource.empty()) {
+            std::cerr << "Failed to load fragment shader!" << std::endl;
+            return false;
+        }
+
+        // Compile vertex shader
+        unsigned int vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
+        if (vertexShader == 0) {
+            return false;
+        }
+
+        // Compile fragment shader
+        unsigned int fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
+        if (fragmentShader == 0) {
+            glDeleteShader(vertexShader);
+            return false;
+        }
+
+        // Create shader program
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+
+        // Clean up shader objects
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        // Check for linking errors
+        int success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(program, 512, NULL, infoLog);
+            std::cerr << "Shader program linking failed: " << infoLog << std::endl;
+            glDeleteProgram(program);
+            return false;
+        }
+
+        programId = program;
+        cacheUniformLocations();
+        return true;
+    }
+
+    /**
+     * Load, compile and link a compute program, then cache its uniform locations
+     * Needs an OpenGL 4.3 context.
+     * @param computePath Path to the compute shader
+     * @return True if successful, false otherwise
+     */
+    bool loadCompute(const std::string& computePath) {
+        destroy();
+
+        std::string computeSource = loadShaderFile(computePath);
+        if (computeSource.empty()) {
+            std::cerr << "Failed to load compute shader!" << std::endl;
+            return false;
+        }
+
+        unsigned int computeShader = compileShader(computeSource, GL_COMPUTE_SHADER);
+        if (computeShader == 0) {
+            return false;
+        }
+
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, computeShader);
+        glLinkProgram(program);
+        glDeleteShader(computeShader);
+
+        int success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(program, 512, NULL, infoLog);
+            std::cerr << "Compute program linking failed (" << computePath << "): " << infoLog << std::endl;
+            glDeleteProgram(program);
+            return false;
+        }
+
+        programId = program;
+        cacheUniformLocations();
+        return true;
+    }
+
+    /**
+     * Delete the program
+     */
+    void destroy() {
+        if (programId != 0) {
+            glDeleteProgram(programId);
+            programId = 0;
+        }
+        uniformLocations.clear();
+    }
+
+    /**
+     * Make this the current program
+     */
+    void use() const {
+        glUseProgram(programId);
+    }
+
+    /**
+     * Get the OpenGL program object
+     * @return Program ID (0 if not loaded)
+     */
+    unsigned int getId() const {
+        return programId;
+    }
+
+    /**
+     * Look up a cached uniform location
+     * @param name Uniform name
+     * @return Location, or -1 if the program has no such uniform
+     */
+    int getUniformLocation(const std::string& name) const {
+        auto it = uniformLocations.find(name);
+        return it != uniformLocations.end() ? it->second : -1;
+    }
+
+    /**
+     * Bind a uniform block to a buffer binding point
+     * @param blockName Uniform block name
+     * @param bindingPoint Binding point index
+     * @return False if the program has no such block
+     */
+    bool bindUniformBlock(const char* blockName, unsigned int bindingPoint) const {
+        unsigned int blockIndex = glGetUniformBlockIndex(programId, blockName);
+        if (blockIndex == GL_INVALID_INDEX) {
+            return false;
+        }
+        glUniformBlockBinding(programId, blockIndex, bindingPoint);
+        return true;
+    }
+
+    /**
+     * Set a 4x4 matrix uniform on the current program
+     * @param location Cached uniform location
+     * @param matrix Matrix data
+     */
+    static void setMatrix4(int location, const float* matrix) {
+        if (location != -1) {
+            glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
+        }
+    }
+
+    /**
+     * Set a 3x3 matrix uniform on the current program
+     * @param location Cached uniform location
+     * @param matrix Column-major matrix data
+     */
+    static void setMatrix3(int location, const float* matrix) {
+        if (location != -1) {
+            glUniformMatrix3fv(location, 1, GL_FALSE, matrix);
+        }
+    }
+
+    /**
+     * Set a Vector3 uniform on the current program
+     * @param location Cached uniform location
+     * @param vector Vector data
+     */
+    static void setVector3(int location, const Vector3& vector) {
+        if (location != -1) {
+            glUniform3f(location, vector.x, vector.y, vector.z);
+        }
+    }
+
+    /**
+     * Set a float uniform on the current program
+     * @param location Cached uniform location
+     * @param value Float value
+     */
+    static void setFloat(int location, float value) {
+        if (location != -1) {
+            glUniform1f(location, value);
+        }
+    }
+
+    /**
+     * Set an unsigned integer uniform on the current program
+     * @param location Cached uniform location
+     * @param value Unsigned value
+     */
+    static void setUnsigned(int location, unsigned int value) {
+        if (location != -1) {
+            glUniform1ui(location, value);
+        }
+    }
+
+private:
+    /**
+     * Query every active uniform once and remember its location
+     * Uniforms inside blocks have no location and are skipped
+     */
+    void cacheUniformLocations() {
+        int uniformCount = 0;
+        int maxNameLength = 0;
+        glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &uniformCount);
+        glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+        std::string name(maxNameLength > 0 ? maxNameLength : 1, '\0');
+        for (int i = 0; i < uniformCount; ++i) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(programId, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, &name[0]);
+
+            std::string uniformName(name.data(), length);
+            int location = glGetUniformLocation(programId, uniformName.c_str());
+            if (location != -1) {
+                uniformLocations[uniformName] = location;
+            }
+        }
+    }
+
+    /**
+     * Load shader source code from file
+     * @param filePath Path to shader file
+     * @return Shader source code as string
+     */
+    static std::string loadShaderFile(const std::string& filePath) {
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open shader file: " << filePath << std::endl;
+            return "";
+        }
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    /**
+     * Compile a shader from source code
+     * @param source Shader source code
+     * @param type Shader type (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER or GL_COMPUTE_SHADER)
+     * @return Shader object ID, or 0 if compilation failed
+     */
+    static unsigned int compileShader(const std::string& source, unsigned int type) {
+        unsigned int shader = glCreateShader(type);
+        const char* src = source.c_str();
+        glShaderSource(shader, 1, &src, NULL);
+        glCompileShader(shader);
+
+        // Check for compilation errors
+        int success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(shader, 512, NULL, infoLog);
+            std::cerr << "Shader compilation failed: " << infoLog << std::endl;
+            glDeleteShader(shader);
+            return 0;
+        }
+
+        return shader;
+    }
+};